@@ -423,7 +423,8 @@ SEXP CatBoostCV_R(SEXP fitParamsAsJsonParam,
                   SEXP invertedParam,
                   SEXP partitionRandomSeedParam,
                   SEXP shuffleParam,
-                  SEXP stratifiedParam) {
+                  SEXP stratifiedParam,
+                  SEXP maxConcurrentFoldCountParam) {
 
     SEXP result = NULL;
     size_t metricCount;
@@ -438,6 +439,7 @@ SEXP CatBoostCV_R(SEXP fitParamsAsJsonParam,
     cvParams.Shuffle = asLogical(shuffleParam);
     cvParams.Stratified = asLogical(stratifiedParam);
     cvParams.Inverted = asLogical(invertedParam);
+    cvParams.MaxConcurrentFoldCount = asInteger(maxConcurrentFoldCountParam);
 
     TVector<TCVResult> cvResults;
 
@@ -1,16 +1,69 @@
 #include "estimated_features_calcer.h"
 #include "gpu_binarization_helpers.h"
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/cast.h>
+#include <util/generic/xrange.h>
+
 namespace NCatboostCuda {
 
+    namespace {
+        // features calculated by one estimator, they are visited after all concurrently computed estimators finish
+        struct TCalculatedFeatures {
+            TVector<std::pair<ui32, TVector<float>>> Learn;
+            TVector<std::pair<ui32, TVector<float>>> Test;
+
+        public:
+            static NCB::TCalculatedFeatureVisitor MakeVisitor(TVector<std::pair<ui32, TVector<float>>>* features) {
+                return [features] (ui32 featureId, TConstArrayRef<float> values) {
+                    features->emplace_back(featureId, TVector<float>(values.begin(), values.end()));
+                };
+            }
+        };
+    }
+
     void TEstimatorsExecutor::ExecEstimators(
         TConstArrayRef<NCatboostCuda::TEstimatorId> estimatorIds,
         TBinarizedFeatureVisitor learnBinarizedVisitor,
         TMaybe<TBinarizedFeatureVisitor> testBinarizedVisitor
         ) {
 
+        /* Online estimators (naive bayes, BM25, embeddings based) have a sequential learn pass and
+         * few features, so they are computed concurrently into buffers.
+         * Offline estimators (bag of words) might have lots of features that are visited one by one
+         * to save RAM, so they are computed in turn, each one is parallel over documents.
+         * Visitors are always called from this thread in the order of estimatorIds: borders builder,
+         * features manager and compressed index writers are not thread-safe.
+         */
+        TVector<ui32> onlineEstimatorIdxs;
+        for (auto estimatorIdx : xrange(estimatorIds.size())) {
+            if (estimatorIds[estimatorIdx].IsOnline) {
+                onlineEstimatorIdxs.push_back(estimatorIdx);
+            }
+        }
+        TVector<TCalculatedFeatures> onlineFeatures(estimatorIds.size());
+        LocalExecutor->ExecRangeWithThrow(
+            [&] (int i) {
+                const ui32 estimatorIdx = onlineEstimatorIdxs[i];
+                auto& features = onlineFeatures[estimatorIdx];
+                TVector<NCB::TCalculatedFeatureVisitor> testVisitors;
+                if (testBinarizedVisitor) {
+                    testVisitors.push_back(TCalculatedFeatures::MakeVisitor(&features.Test));
+                }
+                Estimators.OnlineFeatureEstimators[estimatorIds[estimatorIdx].Id]->ComputeOnlineFeatures(
+                    PermutationIndices,
+                    TCalculatedFeatures::MakeVisitor(&features.Learn),
+                    testVisitors,
+                    LocalExecutor);
+            },
+            0,
+            SafeIntegerCast<int>(onlineEstimatorIdxs.size()),
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+
         TGpuBordersBuilder bordersBuilder(FeaturesManager);
-        for (const auto& estimator : estimatorIds) {
+        for (auto estimatorIdx : xrange(estimatorIds.size())) {
+            const auto& estimator = estimatorIds[estimatorIdx];
             auto featureVisitor = [&](TBinarizedFeatureVisitor visitor, ui32 featureId, TConstArrayRef<float> values) {
                 TEstimatedFeature feature{estimator, featureId};
                 auto id = FeaturesManager.GetId(feature);
@@ -30,11 +83,14 @@ namespace NCatboostCuda {
             }
 
             if (estimator.IsOnline) {
-                Estimators.OnlineFeatureEstimators[estimator.Id]->ComputeOnlineFeatures(
-                    PermutationIndices,
-                    learnVisitor,
-                    testVisitors,
-                    LocalExecutor);
+                auto& features = onlineFeatures[estimatorIdx];
+                for (const auto& [featureId, values] : features.Learn) {
+                    learnVisitor(featureId, values);
+                }
+                for (const auto& [featureId, values] : features.Test) {
+                    testVisitors[0](featureId, values);
+                }
+                features = TCalculatedFeatures();
             } else {
                 Estimators.FeatureEstimators[estimator.Id]->ComputeFeatures(learnVisitor, testVisitors, LocalExecutor);
             }
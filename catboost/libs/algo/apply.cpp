@@ -14,6 +14,7 @@
 #include <util/generic/utility.h>
 
 #include <cmath>
+#include <type_traits>
 
 using namespace NCB;
 using NPar::TLocalExecutor;
@@ -147,6 +148,7 @@ static void ApplyOnQuantizedFeatures(
                     repackedFeatures,
                     bundledIndexes,
                     packedIndexes,
+                    quantizedObjectsData.GetFloatFeaturesToPackedNibbleIndex(),
                     floatFeature,
                     index);
             },
@@ -169,6 +171,34 @@ static void ApplyOnQuantizedFeatures(
 }
 
 
+static TVector<TVector<double>> PrepareApproxes(
+    const TFullModel& model,
+    int docCount,
+    const EPredictionType predictionType,
+    TVector<double>* approxesFlat,
+    TLocalExecutor* executor)
+{
+    const int approxesDimension = model.ObliviousTrees.ApproxDimension;
+    TVector<TVector<double>> approxes(approxesDimension);
+    if (approxesDimension == 1) { //shortcut
+        approxes[0].swap(*approxesFlat);
+    } else {
+        for (int dim = 0; dim < approxesDimension; ++dim) {
+            approxes[dim].yresize(docCount);
+            for (int doc = 0; doc < docCount; ++doc) {
+                approxes[dim][doc] = (*approxesFlat)[approxesDimension * doc + dim];
+            };
+        }
+    }
+
+    if (predictionType == EPredictionType::InternalRawFormulaVal) {
+        //shortcut
+        return approxes;
+    } else {
+        return PrepareEvalForInternalApprox(predictionType, model, approxes, executor);
+    }
+}
+
 TVector<TVector<double>> ApplyModelMulti(
     const TFullModel& model,
     const TObjectsDataProvider& objectsData,
@@ -215,24 +245,7 @@ TVector<TVector<double>> ApplyModelMulti(
         }
     }
 
-    TVector<TVector<double>> approxes(approxesDimension);
-    if (approxesDimension == 1) { //shortcut
-        approxes[0].swap(approxesFlat);
-    } else {
-        for (int dim = 0; dim < approxesDimension; ++dim) {
-            approxes[dim].yresize(docCount);
-            for (int doc = 0; doc < docCount; ++doc) {
-                approxes[dim][doc] = approxesFlat[approxesDimension * doc + dim];
-            };
-        }
-    }
-
-    if (predictionType == EPredictionType::InternalRawFormulaVal) {
-        //shortcut
-        return approxes;
-    } else {
-        return PrepareEvalForInternalApprox(predictionType, model, approxes, executor);
-    }
+    return PrepareApproxes(model, docCount, predictionType, &approxesFlat, executor);
 }
 
 TVector<TVector<double>> ApplyModelMulti(
@@ -296,6 +309,135 @@ TVector<double> ApplyModel(
     return ApplyModelMulti(model, data, verbose, predictionType, begin, end, threadCount)[0];
 }
 
+template <class TFeatureValue>
+static TVector<TVector<double>> ApplyModelMultiOnDenseFeaturesImpl(
+    const TFullModel& model,
+    const TFeatureValue* features,
+    size_t objectCount,
+    size_t featureCount,
+    size_t objectStride,
+    size_t featureStride,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount)
+{
+    CB_ENSURE(!model.HasCategoricalFeatures(), "Model with categorical features can't be applied to dense float features");
+    const size_t flatFeatureCount = model.ObliviousTrees.GetFlatFeatureVectorExpectedSize();
+    CB_ENSURE(
+        featureCount >= flatFeatureCount,
+        "Not enough features: model expects at least " << flatFeatureCount << ", got " << featureCount);
+
+    const int docCount = SafeIntegerCast<int>(objectCount);
+    const int approxesDimension = model.ObliviousTrees.ApproxDimension;
+    TVector<double> approxesFlat(docCount * approxesDimension);
+
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(threadCount - 1);
+
+    if (docCount > 0) {
+        end = end == 0 ? model.GetTreeCount() : Min<int>(end, model.GetTreeCount());
+        const auto blockParams = GetBlockParams(executor.GetThreadCount(), docCount, begin, end);
+
+        const auto applyOnBlock = [&](int blockId) {
+            const int blockFirstIdx = blockParams.FirstId + blockId * blockParams.GetBlockSize();
+            const int blockLastIdx = Min(blockParams.LastId, blockFirstIdx + blockParams.GetBlockSize());
+            const int blockSize = blockLastIdx - blockFirstIdx;
+            const auto blockApproxes = MakeArrayRef(
+                approxesFlat.data() + blockFirstIdx * approxesDimension,
+                blockSize * approxesDimension);
+
+            TVector<TConstArrayRef<float>> transposedFeatures(flatFeatureCount);
+            if constexpr (std::is_same<TFeatureValue, float>::value) {
+                if (featureStride == 1) { // row-major float features are used as is
+                    TVector<TConstArrayRef<float>> objectsFeatures(blockSize);
+                    for (int objectIdx = 0; objectIdx < blockSize; ++objectIdx) {
+                        objectsFeatures[objectIdx] = MakeArrayRef(
+                            features + (blockFirstIdx + objectIdx) * objectStride,
+                            flatFeatureCount);
+                    }
+                    model.CalcFlat(objectsFeatures, begin, end, blockApproxes);
+                    return;
+                }
+                if (objectStride == 1) { // column-major float features are used as is
+                    for (size_t featureIdx = 0; featureIdx < flatFeatureCount; ++featureIdx) {
+                        transposedFeatures[featureIdx] = MakeArrayRef(
+                            features + featureIdx * featureStride + blockFirstIdx,
+                            blockSize);
+                    }
+                    model.CalcFlatTransposed(transposedFeatures, begin, end, blockApproxes);
+                    return;
+                }
+            }
+
+            TVector<float> featuresBuffer;
+            featuresBuffer.yresize(flatFeatureCount * blockSize);
+            for (size_t featureIdx = 0; featureIdx < flatFeatureCount; ++featureIdx) {
+                float* featureValues = featuresBuffer.data() + featureIdx * blockSize;
+                const TFeatureValue* srcFeatureValues = features + featureIdx * featureStride + blockFirstIdx * objectStride;
+                for (int objectIdx = 0; objectIdx < blockSize; ++objectIdx) {
+                    featureValues[objectIdx] = srcFeatureValues[objectIdx * objectStride];
+                }
+                transposedFeatures[featureIdx] = MakeArrayRef(featureValues, blockSize);
+            }
+            model.CalcFlatTransposed(transposedFeatures, begin, end, blockApproxes);
+        };
+        executor.ExecRangeWithThrow(applyOnBlock, 0, blockParams.GetBlockCount(), TLocalExecutor::WAIT_COMPLETE);
+    }
+
+    return PrepareApproxes(model, docCount, predictionType, &approxesFlat, &executor);
+}
+
+TVector<TVector<double>> ApplyModelMultiOnDenseFeatures(
+    const TFullModel& model,
+    const float* features,
+    size_t objectCount,
+    size_t featureCount,
+    size_t objectStride,
+    size_t featureStride,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount)
+{
+    return ApplyModelMultiOnDenseFeaturesImpl(
+        model,
+        features,
+        objectCount,
+        featureCount,
+        objectStride,
+        featureStride,
+        predictionType,
+        begin,
+        end,
+        threadCount);
+}
+
+TVector<TVector<double>> ApplyModelMultiOnDenseFeatures(
+    const TFullModel& model,
+    const double* features,
+    size_t objectCount,
+    size_t featureCount,
+    size_t objectStride,
+    size_t featureStride,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount)
+{
+    return ApplyModelMultiOnDenseFeaturesImpl(
+        model,
+        features,
+        objectCount,
+        featureCount,
+        objectStride,
+        featureStride,
+        predictionType,
+        begin,
+        end,
+        threadCount);
+}
+
 
 void TModelCalcerOnPool::ApplyModelMulti(
     const EPredictionType predictionType,
@@ -354,6 +496,86 @@ void TModelCalcerOnPool::ApplyModelMulti(
     flatApproxBuffer->clear();
 }
 
+void TModelCalcerOnPool::AddTreesToFlatApprox(int begin, int end, TArrayRef<double> flatApprox) {
+    const int approxDimension = Model->ObliviousTrees.ApproxDimension;
+    CB_ENSURE(flatApprox.size() == ObjectsData->GetObjectCount() * approxDimension, "Unexpected approx size");
+    end = end == 0 ? Model->GetTreeCount() : Min<int>(end, Model->GetTreeCount());
+    if (begin >= end || BlockParams.FirstId == BlockParams.LastId) {
+        return;
+    }
+
+    Executor->ExecRange(
+        [&](int blockId) {
+            const int blockFirstId = BlockParams.FirstId + blockId * BlockParams.GetBlockSize();
+            const int blockLastId = Min(BlockParams.LastId, blockFirstId + BlockParams.GetBlockSize());
+            TArrayRef<double> resultRef(
+                flatApprox.data() + blockFirstId * approxDimension,
+                (blockLastId - blockFirstId) * approxDimension);
+            ThreadCalcers[blockId]->AddTrees(begin, end, resultRef);
+        },
+        0,
+        BlockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+void TModelCalcerOnPool::CalcBinaryClassesWithEarlyExit(
+    int begin,
+    int end,
+    int treeStep,
+    double border,
+    TArrayRef<double> approx,
+    TArrayRef<ui8> classes)
+{
+    const size_t docCount = ObjectsData->GetObjectCount();
+    CB_ENSURE(approx.size() == docCount && classes.size() == docCount, "Unexpected approx or classes size");
+    if (docCount == 0) {
+        return;
+    }
+    end = end == 0 ? Model->GetTreeCount() : Min<int>(end, Model->GetTreeCount());
+
+    Executor->ExecRange(
+        [&](int blockId) {
+            const int blockFirstId = BlockParams.FirstId + blockId * BlockParams.GetBlockSize();
+            const int blockLastId = Min(BlockParams.LastId, blockFirstId + BlockParams.GetBlockSize());
+            ThreadCalcers[blockId]->CalcBinaryClassesWithEarlyExit(
+                begin,
+                end,
+                treeStep,
+                border,
+                approx.Slice(blockFirstId, blockLastId - blockFirstId),
+                classes.Slice(blockFirstId, blockLastId - blockFirstId));
+        },
+        0,
+        BlockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+}
+
+TVector<TVector<double>> PredictBinaryClassesWithEarlyExit(
+    const TFullModel& model,
+    const TDataProvider& data,
+    bool verbose,
+    int begin,
+    int end,
+    int threadCount,
+    int treeStep)
+{
+    TSetLoggingVerboseOrSilent inThisScope(verbose);
+
+    CB_ENSURE(model.ObliviousTrees.ApproxDimension == 1, "Early exit is supported only for binary classification");
+    const size_t docCount = data.ObjectsData->GetObjectCount();
+    TVector<double> approx(docCount, 0.0);
+    if (const auto& baseline = data.RawTargetData.GetBaseline()) {
+        approx.assign((*baseline)[0].begin(), (*baseline)[0].end());
+    }
+    TVector<ui8> classes(docCount);
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(threadCount - 1);
+    TModelCalcerOnPool modelCalcer(model, data.ObjectsData, &executor);
+    // classes are decided by the sign of raw formula value, as in PrepareEval
+    modelCalcer.CalcBinaryClassesWithEarlyExit(begin, end, treeStep, /*border*/ 0.0, approx, classes);
+    return {TVector<double>(classes.begin(), classes.end())};
+}
+
 class TFeatureAccessor {
 public:
     TFeatureAccessor(
@@ -444,6 +666,7 @@ public:
     )
         : HeavyDataHolder(MakeAtomicShared<TQuantizedFeaturesAccessorData>())
         , BundlesMetaData(quantizedObjectsData.GetExclusiveFeatureBundlesMetaData())
+        , NibblePackedIndexes(quantizedObjectsData.GetFloatFeaturesToPackedNibbleIndex())
         , FloatBinsRemapRef(HeavyDataHolder->FloatBinsRemap)
         , RepackedFeaturesRef(HeavyDataHolder->RepackedFeatures)
         , PackedIndexesRef(HeavyDataHolder->PackedIndexes)
@@ -485,6 +708,7 @@ public:
             RepackedFeaturesRef,
             BundledIndexesRef,
             PackedIndexesRef,
+            NibblePackedIndexes,
             floatFeature,
             index
         );
@@ -506,6 +730,7 @@ private:
 private:
     TAtomicSharedPtr<TQuantizedFeaturesAccessorData> HeavyDataHolder;
     TConstArrayRef<TExclusiveFeaturesBundle> BundlesMetaData;
+    TConstArrayRef<TMaybe<TPackedNibbleIndex>> NibblePackedIndexes;
     TVector<TVector<ui8>>& FloatBinsRemapRef;
     TVector<TConstArrayRef<ui8>>& RepackedFeaturesRef;
     TVector<TMaybe<TPackedBinaryIndex>>& PackedIndexesRef;
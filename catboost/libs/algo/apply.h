@@ -61,6 +61,50 @@ TVector<double> ApplyModel(
     int end = 0,
     int threadCount = 1);
 
+/*
+ * Apply model to a dense matrix of feature values without building a data provider.
+ * Value of flat feature featureIdx for object objectIdx is features[objectIdx * objectStride + featureIdx * featureStride],
+ * so both row-major and column-major matrices are used without copying (float values).
+ * Models with categorical features are not supported.
+ */
+TVector<TVector<double>> ApplyModelMultiOnDenseFeatures(
+    const TFullModel& model,
+    const float* features,
+    size_t objectCount,
+    size_t featureCount,
+    size_t objectStride,
+    size_t featureStride,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount);
+
+TVector<TVector<double>> ApplyModelMultiOnDenseFeatures(
+    const TFullModel& model,
+    const double* features,
+    size_t objectCount,
+    size_t featureCount,
+    size_t objectStride,
+    size_t featureStride,
+    const EPredictionType predictionType,
+    int begin,
+    int end,
+    int threadCount);
+
+/*
+ * Same as ApplyModelMulti with EPredictionType::Class for models with one dimensional approx, but
+ * trees are not applied to blocks of objects once the rest of trees can't change their classes.
+ * See TFeatureCachedTreeEvaluator::CalcBinaryClassesWithEarlyExit.
+ */
+TVector<TVector<double>> PredictBinaryClassesWithEarlyExit(
+    const TFullModel& model,
+    const NCB::TDataProvider& data,
+    bool verbose = false,
+    int begin = 0,
+    int end = 0,
+    int threadCount = 1,
+    int treeStep = 8);
+
 /*
  * Tradeoff memory for speed
  * Don't use if you need to compute model only once and on all features
@@ -79,6 +123,21 @@ public:
         TVector<double>* flatApproxBuffer,
         TVector<TVector<double>>* approx);
 
+    /*
+     * Add internal raw approxes of trees [begin, end) to flatApprox, layout is [objectIdx * approxDimension + dim].
+     * Staged prediction keeps a running flatApprox and applies only trees of the next stage.
+     */
+    void AddTreesToFlatApprox(int begin, int end, TArrayRef<double> flatApprox);
+
+    // see TFeatureCachedTreeEvaluator::CalcBinaryClassesWithEarlyExit
+    void CalcBinaryClassesWithEarlyExit(
+        int begin,
+        int end,
+        int treeStep,
+        double border,
+        TArrayRef<double> approx,
+        TArrayRef<ui8> classes);
+
 private:
     void InitForRawFeatures(
         const TFullModel& model,
@@ -1,7 +1,10 @@
 #include "calc_score_cache.h"
 
+#include <catboost/libs/helpers/memory_governor.h>
+
 #include <util/generic/algorithm.h>
 #include <util/generic/xrange.h>
+#include <util/generic/ylimits.h>
 #include <util/generic/ymath.h>
 #include <util/system/guard.h>
 
@@ -245,7 +248,8 @@ void TCalcScoreFold::Create(
     const TVector<TFold>& folds,
     bool isPairwiseScoring,
     int defaultCalcStatsObjBlockSize,
-    float sampleRate
+    float sampleRate,
+    bool hasSparseFeatures
 ) {
     BernoulliSampleRate = sampleRate;
     Y_ASSERT(BernoulliSampleRate > 0.0f && BernoulliSampleRate <= 1.0f);
@@ -282,6 +286,12 @@ void TCalcScoreFold::Create(
         }
     }
     DefaultCalcStatsObjBlockSize = defaultCalcStatsObjBlockSize;
+    HasSparseFeatures = hasSparseFeatures;
+    if (HasSparseFeatures) {
+        const auto& learnPermutationFeaturesSubset
+            = folds[0].LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>();
+        FeaturesSrcSize = *MaxElement(learnPermutationFeaturesSubset.begin(), learnPermutationFeaturesSubset.end()) + 1;
+    }
 }
 
 template <typename TSrcRef, typename TGetElementFunc, typename TDstRef>
@@ -462,6 +472,7 @@ void TCalcScoreFold::SelectSmallestSplitSide(
         blockCount,
         NPar::TLocalExecutor::WAIT_COMPLETE);
     SetPermutationBlockSizeAndCalcStatsRanges(FoldPermutationBlockSizeNotSet, FoldPermutationBlockSizeNotSet);
+    UpdateSparseFeaturesData();
 }
 
 void TCalcScoreFold::Sample(
@@ -523,6 +534,7 @@ void TCalcScoreFold::Sample(
         (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? fold.PermutationBlockSize :
             FoldPermutationBlockSizeNotSet,
         (BernoulliSampleRate == 1.0f || IsPairwiseScoring) ? DocCount : FoldPermutationBlockSizeNotSet);
+    UpdateSparseFeaturesData();
 }
 
 void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLocalExecutor* localExecutor) {
@@ -556,6 +568,7 @@ void TCalcScoreFold::UpdateIndices(const TVector<TIndexType>& indices, NPar::TLo
         0,
         blockCount,
         NPar::TLocalExecutor::WAIT_COMPLETE);
+    UpdateSparseFeaturesData();
 }
 
 int TCalcScoreFold::GetApproxDimension() const {
@@ -566,6 +579,30 @@ int TCalcScoreFold::GetDocCount() const {
     return DocCount;
 }
 
+ui64 TCalcScoreFold::GetMemoryUsage() const {
+    ui64 result = NCB::GetVectorMemoryUsage(Indices)
+        + NCB::GetVectorMemoryUsage(IndexInFold)
+        + NCB::GetVectorMemoryUsage(LearnWeights)
+        + NCB::GetVectorMemoryUsage(SampleWeights)
+        + NCB::GetVectorMemoryUsage(LearnQueriesInfo)
+        + NCB::GetVectorMemoryUsage(BodyTailArr)
+        + NCB::GetVectorMemoryUsage(Control)
+        + NCB::GetVectorMemoryUsage(SparseFeaturesData.SrcToDocIndices)
+        + NCB::GetVectorMemoryUsage(SparseFeaturesData.LeafBodyStats)
+        + NCB::GetVectorMemoryUsage(SparseFeaturesData.LeafTailStats);
+    for (const auto& bodyTail : BodyTailArr) {
+        for (const auto* derivatives : {&bodyTail.WeightedDerivatives, &bodyTail.SampleWeightedDerivatives}) {
+            result += NCB::GetVectorMemoryUsage(*derivatives);
+            for (const auto& dimDerivatives : *derivatives) {
+                result += NCB::GetVectorMemoryUsage(dimDerivatives);
+            }
+        }
+        result += NCB::GetVectorMemoryUsage(bodyTail.PairwiseWeights)
+            + NCB::GetVectorMemoryUsage(bodyTail.SamplePairwiseWeights);
+    }
+    return result;
+}
+
 int TCalcScoreFold::GetBodyTailCount() const {
     return BodyTailCount;
 }
@@ -799,3 +836,63 @@ void TStats3D::Add(const TStats3D& stats3D) {
         Stats[statIdx].Add(stats3D.Stats[statIdx]);
     }
 }
+
+void TCalcScoreFold::UpdateSparseFeaturesData() {
+    if (!HasSparseFeatures) {
+        return;
+    }
+
+    const auto& learnPermutationFeaturesSubset = LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>();
+
+    auto& srcToDocIndices = SparseFeaturesData.SrcToDocIndices;
+    srcToDocIndices.assign(FeaturesSrcSize, Max<ui32>());
+    for (auto doc : xrange(DocCount)) {
+        srcToDocIndices[learnPermutationFeaturesSubset[doc]] = doc;
+    }
+
+    const TIndexType* indices = GetDataPtr(Indices);
+
+    int leafCount = 0;
+    for (auto doc : xrange(DocCount)) {
+        leafCount = Max(leafCount, int(indices[doc]) + 1);
+    }
+    SparseFeaturesData.LeafCount = leafCount;
+
+    const size_t leafStatsCount = size_t(BodyTailCount) * ApproxDimension * leafCount;
+    SparseFeaturesData.LeafBodyStats.assign(leafStatsCount, TBucketStats{0, 0, 0, 0});
+    SparseFeaturesData.LeafTailStats.assign(leafStatsCount, TBucketStats{0, 0, 0, 0});
+
+    // same sums as in CalcStatsKernel in score_calcer.cpp, but for both plain and ordered modes
+    for (int bodyTailIdx : xrange(BodyTailCount)) {
+        const auto& bt = BodyTailArr[bodyTailIdx];
+        const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
+        const float* weightsData = hasPairwiseWeights ?
+            GetDataPtr(bt.PairwiseWeights) : GetDataPtr(LearnWeights);
+        const float* sampleWeightsData = hasPairwiseWeights ?
+            GetDataPtr(bt.SamplePairwiseWeights) : GetDataPtr(SampleWeights);
+        const int bodyFinish = Min((int)bt.BodyFinish, DocCount);
+        const int tailFinish = Min((int)bt.TailFinish, DocCount);
+
+        for (int dim : xrange(ApproxDimension)) {
+            const size_t statsOffset = size_t(bodyTailIdx * ApproxDimension + dim) * leafCount;
+            TBucketStats* bodyStats = SparseFeaturesData.LeafBodyStats.data() + statsOffset;
+            TBucketStats* tailStats = SparseFeaturesData.LeafTailStats.data() + statsOffset;
+
+            const double* weightedDerivatives = GetDataPtr(bt.WeightedDerivatives[dim]);
+            const double* sampleWeightedDerivatives = GetDataPtr(bt.SampleWeightedDerivatives[dim]);
+
+            for (int doc : xrange(bodyFinish)) {
+                TBucketStats& leafStats = bodyStats[indices[doc]];
+                leafStats.SumWeightedDelta += sampleWeightedDerivatives[doc];
+                leafStats.SumWeight += sampleWeightsData[doc];
+                leafStats.SumDelta += weightedDerivatives[doc];
+                leafStats.Count += weightsData ? weightsData[doc] : 1.0;
+            }
+            for (int doc : xrange(bodyFinish, tailFinish)) {
+                TBucketStats& leafStats = tailStats[indices[doc]];
+                leafStats.SumWeightedDelta += sampleWeightedDerivatives[doc];
+                leafStats.SumWeight += sampleWeightsData[doc];
+            }
+        }
+    }
+}
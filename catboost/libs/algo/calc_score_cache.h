@@ -130,6 +130,9 @@ public:
         bool* areStatsDirty
     );
     void GarbageCollect();
+    size_t GetMemoryUsage() const {
+        return MemoryPool ? MemoryPool->MemoryAllocated() : 0;
+    }
     static TVector<TBucketStats> GetStatsInUse(
         int segmentCount,
         int segmentSize,
@@ -223,7 +226,8 @@ public:
         const TVector<TFold>& folds,
         bool isPairwiseScoring,
         int defaultCalcStatsObjBlockSize,
-        float sampleRate = 1.0f
+        float sampleRate = 1.0f,
+        bool hasSparseFeatures = false
     );
     void SelectSmallestSplitSide(
         int curDepth,
@@ -242,6 +246,7 @@ public:
     int GetDocCount() const;
     int GetBodyTailCount() const;
     int GetApproxDimension() const;
+    ui64 GetMemoryUsage() const;
     const TVector<float>& GetLearnWeights() const { return LearnWeights; }
 
     bool HasQueryInfo() const;
@@ -287,6 +292,23 @@ private:
         int ctrDataPermutationBlockSize
     );
 
+    void UpdateSparseFeaturesData();
+
+public:
+    /* data for calculation of stats for sparse features without iteration over all docs
+     * filled only if TCalcScoreFold has been created with hasSparseFeatures
+     */
+    struct TSparseFeaturesData {
+        // inverse of LearnPermutationFeaturesSubset, Max<ui32>() for objects not in fold
+        TVector<ui32> SrcToDocIndices;
+
+        int LeafCount = 0;
+
+        // sums over docs in leaves, [bodyTail & approxDim][leaf]
+        TVector<TBucketStats> LeafBodyStats; // all sums over body docs
+        TVector<TBucketStats> LeafTailStats; // only weighted sums over docs in tail after body
+    };
+
 public:
     TUnsizedVector<TIndexType> Indices;
 
@@ -309,6 +331,7 @@ public:
     bool SmallestSplitSideValue;
     int NonCtrDataPermutationBlockSize = FoldPermutationBlockSizeNotSet;
     int CtrDataPermutationBlockSize = FoldPermutationBlockSizeNotSet;
+    TSparseFeaturesData SparseFeaturesData;
 
 private:
     TUnsizedVector<bool> Control;
@@ -319,6 +342,8 @@ private:
     bool HasPairwiseWeights;
     bool IsPairwiseScoring;
     int DefaultCalcStatsObjBlockSize;
+    bool HasSparseFeatures = false;
+    ui32 FeaturesSrcSize = 0; // size of features buckets arrays, used only if HasSparseFeatures
 
     THolder<NCB::IIndexRangesGenerator<int>> CalcStatsIndexRanges;
 };
@@ -14,8 +14,13 @@ namespace NCB {
         const auto featuresLayout = rawObjectsData.GetFeaturesLayout();
         const ui32 internalFeatureIdx = featuresLayout->GetInternalFeatureIdx(flatFeatureIdx);
         if (featuresLayout->GetExternalFeatureType(flatFeatureIdx) == EFeatureType::Float) {
-            return (*(*(**rawObjectsData.GetFloatFeature(internalFeatureIdx)).GetArrayData().GetSrc()
-                )).data() + consecutiveSubsetBegin;
+            const auto& floatFeature = **rawObjectsData.GetFloatFeature(internalFeatureIdx);
+            CB_ENSURE(
+                !floatFeature.IsSparse(),
+                "Feature #" << flatFeatureIdx << " is sparse, model application to sparse raw features"
+                " is not supported"
+            );
+            return (*(*floatFeature.GetArrayData().GetSrc())).data() + consecutiveSubsetBegin;
         } else {
             return reinterpret_cast<const float*>((*(*(**rawObjectsData.GetCatFeature(internalFeatureIdx))
                 .GetArrayData().GetSrc())).data()) + consecutiveSubsetBegin;
@@ -52,11 +57,13 @@ namespace NCB {
         TConstArrayRef<TConstArrayRef<ui8>> repackedFeatures,
         const TVector<TMaybe<TExclusiveBundleIndex>>& bundledIndexes,
         const TVector<TMaybe<TPackedBinaryIndex>>& packedIndexes,
+        TConstArrayRef<TMaybe<TPackedNibbleIndex>> nibblePackedIndexes,
         const TFloatFeature& floatFeature,
         size_t index)
     {
         const auto& bundleIdx = bundledIndexes[floatFeature.FeatureIndex];
         const auto& packIdx = packedIndexes[floatFeature.FeatureIndex];
+        const auto& nibblePackIdx = nibblePackedIndexes[floatFeature.FeatureIndex];
 
         ui8 unremappedFeatureBin;
         if (bundleIdx.Defined()) {
@@ -76,6 +83,9 @@ namespace NCB {
                 case 2:
                     unremappedFeatureBin = getBundleValueFunction((const ui16*)rawBundlesData);
                     break;
+                case 4:
+                    unremappedFeatureBin = getBundleValueFunction((const ui32*)rawBundlesData);
+                    break;
                 default:
                     CB_ENSURE_INTERNAL(
                         false,
@@ -85,6 +95,11 @@ namespace NCB {
         } else if (packIdx.Defined()) {
             TBinaryFeaturesPack bitIdx = packIdx->BitIdx;
             unremappedFeatureBin = (repackedFeatures[floatFeature.FlatFeatureIndex][index] >> bitIdx) & 1;
+        } else if (nibblePackIdx.Defined()) {
+            unremappedFeatureBin = GetNibbleFromPack(
+                repackedFeatures[floatFeature.FlatFeatureIndex][index],
+                nibblePackIdx->NibbleIdx
+            );
         } else {
             unremappedFeatureBin = repackedFeatures[floatFeature.FlatFeatureIndex][index];
         }
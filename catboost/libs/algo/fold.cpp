@@ -3,11 +3,13 @@
 #include "approx_updater_helpers.h"
 
 #include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/helpers/memory_governor.h>
 #include <catboost/libs/helpers/permutation.h>
 #include <catboost/libs/helpers/query_info_helper.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 
 #include <util/generic/cast.h>
+#include <util/generic/xrange.h>
 
 
 using namespace NCB;
@@ -294,6 +296,41 @@ TFold TFold::BuildPlainFold(
 }
 
 
+ui64 TFold::GetMemoryUsage() const {
+    ui64 result = NCB::GetVectorMemoryUsage(LearnQueriesInfo)
+        + NCB::GetVectorMemoryUsage(BodyTailArr)
+        + NCB::GetVectorMemoryUsage(LearnTarget)
+        + NCB::GetVectorMemoryUsage(SampleWeights)
+        + NCB::GetVectorMemoryUsage(LearnTargetClass)
+        + NCB::GetVectorMemoryUsage(TargetClassesCount)
+        + NCB::GetVectorMemoryUsage(LearnWeights);
+    for (const auto& bodyTail : BodyTailArr) {
+        result += NCB::GetVectorMemoryUsage(bodyTail.Approx)
+            + NCB::GetVectorMemoryUsage(bodyTail.WeightedDerivatives)
+            + NCB::GetVectorMemoryUsage(bodyTail.SampleWeightedDerivatives)
+            + NCB::GetVectorMemoryUsage(bodyTail.PairwiseWeights)
+            + NCB::GetVectorMemoryUsage(bodyTail.SamplePairwiseWeights);
+    }
+    return result;
+}
+
+ui64 TFold::GetOnlineCtrsMemoryUsage() const {
+    ui64 result = 0;
+    for (const auto* ctrs : {&OnlineSingleCtrs, &OnlineCTR}) {
+        for (const auto& [projection, ctr] : *ctrs) {
+            Y_UNUSED(projection);
+            for (const auto& ctrFeature : ctr.Feature) {
+                for (auto y : xrange(ctrFeature.GetYSize())) {
+                    for (auto x : xrange(ctrFeature.GetXSize())) {
+                        result += ctrFeature[y][x].capacity();
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
 void TFold::DropEmptyCTRs() {
     TVector<TProjection> emptyProjections;
     for (auto& projCtr : OnlineSingleCtrs) {
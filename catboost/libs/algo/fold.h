@@ -75,6 +75,14 @@ public:
     }
 
     void DropEmptyCTRs();
+    void ClearOnlineCTRs() {
+        OnlineSingleCtrs.clear();
+        OnlineCTR.clear();
+    }
+
+    // approxes, derivatives, targets and weights, online CTRs are accounted separately
+    ui64 GetMemoryUsage() const;
+    ui64 GetOnlineCtrsMemoryUsage() const;
 
     const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&> GetAllCtrs() const {
         return std::tie(OnlineSingleCtrs, OnlineCTR);
@@ -98,6 +98,18 @@ inline static void MarkFeatureAsExcluded(const TPackedBinaryIndex& packedBinaryI
         &= ~(TBinaryFeaturesPack(1) << packedBinaryIndex.BitIdx);
 }
 
+inline static void MarkFeatureAsIncluded(const TPackedNibbleIndex& packedNibbleIndex,
+                                         TVector<ui8>* perNibblePackMasks) {
+
+    (*perNibblePackMasks)[packedNibbleIndex.PackIdx] |= ui8(1) << packedNibbleIndex.NibbleIdx;
+}
+
+inline static void MarkFeatureAsExcluded(const TPackedNibbleIndex& packedNibbleIndex,
+                                         TVector<ui8>* perNibblePackMasks) {
+
+    (*perNibblePackMasks)[packedNibbleIndex.PackIdx] &= ~(ui8(1) << packedNibbleIndex.NibbleIdx);
+}
+
 
 static void AddFloatFeatures(const TQuantizedForCPUObjectsDataProvider& learnObjectsData,
                              TCandidateList* candList) {
@@ -143,15 +155,24 @@ static void AddOneHotFeatures(const TQuantizedForCPUObjectsDataProvider& learnOb
 }
 
 
+/* nibble packed features are kept as separate candidates if useNibblePacks is false
+ * (pairwise scoring does not support nibble packs)
+ */
 static void CompressCandidates(const TQuantizedForCPUObjectsDataProvider& learnObjectsData,
+                               bool useNibblePacks,
                                TCandidatesContext* candidatesContext) {
 
     auto& candList = candidatesContext->CandidateList;
     auto& selectedFeaturesInBundles = candidatesContext->SelectedFeaturesInBundles;
     auto& perBinaryPackMasks = candidatesContext->PerBinaryPackMasks;
+    auto& perNibblePackMasks = candidatesContext->PerNibblePackMasks;
 
     selectedFeaturesInBundles.assign(learnObjectsData.GetExclusiveFeatureBundlesSize(), TVector<ui32>());
     perBinaryPackMasks.assign(learnObjectsData.GetBinaryFeaturesPacksSize(), TBinaryFeaturesPack(0));
+    perNibblePackMasks.assign(
+        useNibblePacks ? learnObjectsData.GetNibbleFeaturesPacksSize() : 0,
+        ui8(0)
+    );
 
     TCandidateList updatedCandList;
     updatedCandList.reserve(candList.size());
@@ -163,11 +184,15 @@ static void CompressCandidates(const TQuantizedForCPUObjectsDataProvider& learnO
 
         TMaybe<TExclusiveBundleIndex> maybeExclusiveBundleIndex;
         TMaybe<TPackedBinaryIndex> maybePackedBinaryIndex;
+        TMaybe<TPackedNibbleIndex> maybePackedNibbleIndex;
 
         if (splitCandidate.Type == ESplitType::FloatFeature) {
             auto floatFeatureIdx = TFloatFeatureIdx(splitCandidate.FeatureIdx);
             maybeExclusiveBundleIndex = learnObjectsData.GetFeatureToExclusiveBundleIndex(floatFeatureIdx);
             maybePackedBinaryIndex = learnObjectsData.GetFeatureToPackedBinaryIndex(floatFeatureIdx);
+            if (useNibblePacks) {
+                maybePackedNibbleIndex = learnObjectsData.GetFloatFeatureToPackedNibbleIndex(floatFeatureIdx);
+            }
         } else {
             auto catFeatureIdx = TCatFeatureIdx(splitCandidate.FeatureIdx);
             maybeExclusiveBundleIndex = learnObjectsData.GetFeatureToExclusiveBundleIndex(catFeatureIdx);
@@ -189,6 +214,8 @@ static void CompressCandidates(const TQuantizedForCPUObjectsDataProvider& learnO
             selectedFeaturesInBundles[maybeExclusiveBundleIndex->BundleIdx].push_back(maybeExclusiveBundleIndex->InBundleIdx);
         } else if (maybePackedBinaryIndex) {
             MarkFeatureAsIncluded(*maybePackedBinaryIndex, &perBinaryPackMasks);
+        } else if (maybePackedNibbleIndex) {
+            MarkFeatureAsIncluded(*maybePackedNibbleIndex, &perNibblePackMasks);
         } else {
             updatedCandList.push_back(std::move(candSubList));
         }
@@ -214,6 +241,12 @@ static void CompressCandidates(const TQuantizedForCPUObjectsDataProvider& learnO
         updatedCandList.emplace_back(TCandidatesInfoList(candidate));
     }
 
+    for (auto packIdx : xrange(SafeIntegerCast<ui32>(perNibblePackMasks.size()))) {
+        TCandidateInfo candidate;
+        candidate.SplitEnsemble = TSplitEnsemble{TNibbleSplitsPackRef{packIdx}};
+        updatedCandList.emplace_back(TCandidatesInfoList(candidate));
+    }
+
     candList = std::move(updatedCandList);
 }
 
@@ -225,6 +258,7 @@ static void SelectCandidatesAndCleanupStatsFromPrevTree(TLearnContext* ctx,
     auto& candList = candidatesContext->CandidateList;
     auto& selectedFeaturesInBundles = candidatesContext->SelectedFeaturesInBundles;
     auto& perBinaryPackMasks = candidatesContext->PerBinaryPackMasks;
+    auto& perNibblePackMasks = candidatesContext->PerNibblePackMasks;
 
     TCandidateList updatedCandList;
     updatedCandList.reserve(candList.size());
@@ -272,6 +306,22 @@ static void SelectCandidatesAndCleanupStatsFromPrevTree(TLearnContext* ctx,
                     addCandSubListToResult = !selectedFeaturesInBundle.empty();
                 }
                 break;
+            case ESplitEnsembleType::NibbleSplits:
+                {
+                    const ui32 packIdx = splitEnsemble.NibbleSplitsPackRef.PackIdx;
+                    ui8& perPackMask = perNibblePackMasks[packIdx];
+                    for (auto nibbleIdx : xrange(NibblesPerPack)) {
+                        if ((perPackMask >> nibbleIdx) & 1) {
+                            const bool addToCandidates
+                                = ctx->Rand.GenRandReal1() <= ctx->Params.ObliviousTreeOptions->Rsm;
+                            if (!addToCandidates) {
+                                MarkFeatureAsExcluded(TPackedNibbleIndex(packIdx, nibbleIdx), &perNibblePackMasks);
+                            }
+                        }
+                    }
+                    addCandSubListToResult = perPackMask != ui8(0);
+                }
+                break;
         }
 
         if (addCandSubListToResult) {
@@ -587,10 +637,11 @@ void GreedyTensorSearch(const TTrainingForCPUDataProviders& data,
         TCandidatesContext candidatesContext;
         candidatesContext.OneHotMaxSize = ctx->Params.CatFeatureParams->OneHotMaxSize;
         candidatesContext.BundlesMetaData = data.Learn->ObjectsData->GetExclusiveFeatureBundlesMetaData();
+        candidatesContext.NibblePacksMetaData = data.Learn->ObjectsData->GetNibbleFeaturesPacksMetaData();
 
         AddFloatFeatures(*data.Learn->ObjectsData, &candidatesContext.CandidateList);
         AddOneHotFeatures(*data.Learn->ObjectsData, ctx, &candidatesContext.CandidateList);
-        CompressCandidates(*data.Learn->ObjectsData, &candidatesContext);
+        CompressCandidates(*data.Learn->ObjectsData, /*useNibblePacks*/ !isPairwiseScoring, &candidatesContext);
         SelectCandidatesAndCleanupStatsFromPrevTree(ctx, &candidatesContext, &ctx->PrevTreeLevelStats);
 
         AddSimpleCtrs(*data.Learn->ObjectsData, fold, ctx, &ctx->PrevTreeLevelStats, &candidatesContext.CandidateList);
@@ -5,6 +5,9 @@
 
 #include <library/malloc/api/malloc.h>
 
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+
 #include <functional>
 
 
@@ -79,6 +82,109 @@ void ConfigureMalloc() {
 #endif
 }
 
+static THolder<IIncrementalMetricCalcer> MakeIncrementalMetricCalcerIfPossible(
+    const NCB::TTargetDataProvider& targetData,
+    const IMetric& metric
+) {
+    const auto maybeTarget = targetData.GetTarget();
+    if (!maybeTarget && metric.NeedTarget()) {
+        return nullptr;
+    }
+    return MakeIncrementalMetricCalcer(
+        metric,
+        maybeTarget.GetOrElse(TConstArrayRef<float>()),
+        GetWeights(targetData),
+        targetData.GetGroupInfo().GetOrElse(TConstArrayRef<TQueryInfo>()));
+}
+
+static void PrepareIncrementalMetrics(
+    const TTrainingForCPUDataProviders& trainingDataProviders,
+    const TVector<THolder<IMetric>>& errors,
+    TLearnContext* ctx
+) {
+    auto& cache = ctx->IncrementalMetrics;
+    const size_t treeCount = ctx->LearnProgress.TreeStruct.size();
+    if (cache.Metrics == &errors && cache.TreeCount == treeCount) {
+        return;
+    }
+    cache.Reset(treeCount);
+    cache.Metrics = &errors;
+    for (const auto& error : errors) {
+        cache.LearnCalcers.push_back(
+            MakeIncrementalMetricCalcerIfPossible(*trainingDataProviders.Learn->TargetData, *error));
+    }
+    cache.TestCalcers.resize(trainingDataProviders.Test.size());
+    for (auto testIdx : xrange(trainingDataProviders.Test.size())) {
+        const auto& testDataPtr = trainingDataProviders.Test[testIdx];
+        for (const auto& error : errors) {
+            cache.TestCalcers[testIdx].push_back(
+                testDataPtr ? MakeIncrementalMetricCalcerIfPossible(*testDataPtr->TargetData, *error) : nullptr);
+        }
+    }
+}
+
+static TMetricHolder EvalErrorsWithCache(
+    const TVector<TVector<double>>& approx,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    const THolder<IMetric>& error,
+    IIncrementalMetricCalcer* incrementalCalcer, // can be nullptr
+    NPar::TLocalExecutor* localExecutor
+) {
+    if (incrementalCalcer) {
+        return incrementalCalcer->Eval(approx, localExecutor);
+    }
+    return EvalErrors(approx, target, weight, queriesInfo, error, localExecutor);
+}
+
+void UpdateIncrementalMetrics(
+    const TTrainingForCPUDataProviders& trainingDataProviders,
+    const TVector<TIndexType>& indices,
+    const TVector<TVector<double>>& treeDelta,
+    TLearnContext* ctx
+) {
+    auto& cache = ctx->IncrementalMetrics;
+    if (cache.Metrics == nullptr || cache.TreeCount != ctx->LearnProgress.TreeStruct.size()) {
+        return; // out of sync, calcers will be reset before the next evaluation
+    }
+    ++cache.TreeCount;
+
+    NPar::TLocalExecutor* localExecutor = ctx->LocalExecutor;
+    const ui32 learnSampleCount = trainingDataProviders.Learn->GetObjectCount();
+    const bool hasLearnCalcers = AnyOf(
+        cache.LearnCalcers,
+        [] (const auto& calcer) { return calcer != nullptr; });
+    if (hasLearnCalcers && learnSampleCount > 0) {
+        // indices are in averaging fold order, AvrgApprox is in the original order
+        TConstArrayRef<ui32> learnPermutation = ctx->LearnProgress.AveragingFold.GetLearnPermutationArray();
+        TVector<TIndexType> learnIndices;
+        learnIndices.yresize(learnSampleCount);
+        NPar::ParallelFor(*localExecutor, 0, learnSampleCount, [&] (int idx) {
+            learnIndices[learnPermutation[idx]] = indices[idx];
+        });
+        for (auto& calcer : cache.LearnCalcers) {
+            if (calcer) {
+                calcer->AddLeafDelta(learnIndices, treeDelta, localExecutor);
+            }
+        }
+    }
+
+    const TVector<size_t> testOffsets = trainingDataProviders.CalcTestOffsets();
+    for (auto testIdx : xrange(cache.TestCalcers.size())) {
+        const auto& testDataPtr = trainingDataProviders.Test[testIdx];
+        if (testDataPtr == nullptr) {
+            continue;
+        }
+        TConstArrayRef<TIndexType> testIndices(indices.data() + testOffsets[testIdx], testDataPtr->GetObjectCount());
+        for (auto& calcer : cache.TestCalcers[testIdx]) {
+            if (calcer) {
+                calcer->AddLeafDelta(testIndices, treeDelta, localExecutor);
+            }
+        }
+    }
+}
+
 void CalcErrors(
     const TTrainingForCPUDataProviders& trainingDataProviders,
     const TVector<THolder<IMetric>>& errors,
@@ -86,6 +192,18 @@ void CalcErrors(
     bool calcErrorTrackerMetric,
     TLearnContext* ctx
 ) {
+    const bool useIncrementalMetrics = ctx->Params.SystemOptions->IsSingleHost();
+    if (useIncrementalMetrics) {
+        PrepareIncrementalMetrics(trainingDataProviders, errors, ctx);
+    }
+    const auto getIncrementalCalcer = [&] (int testIdx, int errorIdx) -> IIncrementalMetricCalcer* {
+        if (!useIncrementalMetrics) {
+            return nullptr;
+        }
+        auto& cache = ctx->IncrementalMetrics;
+        return testIdx < 0 ? cache.LearnCalcers[errorIdx].Get() : cache.TestCalcers[testIdx][errorIdx].Get();
+    };
+
     if (trainingDataProviders.Learn->GetObjectCount() > 0) {
         ctx->LearnProgress.MetricsAndTimeHistory.LearnMetricsHistory.emplace_back();
         if (calcAllMetrics) {
@@ -99,12 +217,13 @@ void CalcErrors(
                 TVector<bool> skipMetricOnTrain = GetSkipMetricOnTrain(errors);
                 for (int i = 0; i < errors.ysize(); ++i) {
                     if (!skipMetricOnTrain[i]) {
-                        const auto& additiveStats = EvalErrors(
+                        const auto& additiveStats = EvalErrorsWithCache(
                             ctx->LearnProgress.AvrgApprox,
                             target,
                             weights,
                             queryInfo,
                             errors[i],
+                            getIncrementalCalcer(/*testIdx*/ -1, i),
                             ctx->LocalExecutor
                         );
                         ctx->LearnProgress.MetricsAndTimeHistory.AddLearnError(
@@ -149,12 +268,13 @@ void CalcErrors(
                     continue;
                 }
 
-                const auto& additiveStats = EvalErrors(
+                const auto& additiveStats = EvalErrorsWithCache(
                     testApprox,
                     target,
                     weights,
                     queryInfo,
                     errors[i],
+                    getIncrementalCalcer(testIdx, i),
                     ctx->LocalExecutor
                 );
                 bool updateBestIteration = (i == 0) && (testIdx == trainingDataProviders.Test.size() - 1);
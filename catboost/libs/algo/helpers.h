@@ -17,6 +17,14 @@ TVector<TCatFeature> CreateCatFeatures(const NCB::TQuantizedFeaturesInfo& quanti
 
 void ConfigureMalloc();
 
+// Registers a new tree with incremental metric calcers, should be called after approxes update
+void UpdateIncrementalMetrics(
+    const NCB::TTrainingForCPUDataProviders& trainingDataProviders,
+    const TVector<TIndexType>& indices, // learn (in averaging fold order) and test objects
+    const TVector<TVector<double>>& treeDelta,
+    TLearnContext* ctx
+);
+
 void CalcErrors(
     const NCB::TTrainingForCPUDataProviders& trainingDataProviders,
     const TVector<THolder<IMetric>>& errors,
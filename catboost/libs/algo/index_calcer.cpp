@@ -33,7 +33,12 @@ static inline ui16 GetFeatureSplitIdx(const TSplit& split) {
 
 static inline const TVariant<const ui8*, const ui16*> GetFloatHistogram(
     const TSplit& split,
-    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider) {
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    TVector<ui8>* sparseFeatureStorage) { // densified sparse feature data is stored here
+    if (const auto* sparseFeatureHolder = objectsDataProvider.GetSparseFloatFeature((ui32)split.FeatureIdx)) {
+        *sparseFeatureStorage = sparseFeatureHolder->GetSparseSrcData()->ExtractValues();
+        return (const ui8*)sparseFeatureStorage->data();
+    }
     const auto* featureColumnHolder = *objectsDataProvider.GetNonPackedFloatFeature((ui32)split.FeatureIdx);
     if (featureColumnHolder->GetBitsPerKey() == 8) {
         return *featureColumnHolder->GetArrayData<ui8>().GetSrc();
@@ -111,10 +116,12 @@ inline void OfflineCtrBlock(
     int blockIdx,
     TMaybe<TExclusiveBundleIndex> maybeExclusiveBundleIndex,
     TMaybe<TPackedBinaryIndex> maybeBinaryIndex,
+    TMaybe<TPackedNibbleIndex> maybeNibbleIndex,
     const ui32* permutation,
-    const TCount* histogram, // can be nullptr if maybeBinaryIndex
+    const TCount* histogram, // can be nullptr if maybeBinaryIndex or maybeNibbleIndex
     std::function<TFeaturesBundleArraySubset(ui32)>&& getExclusiveFeaturesBundle,
     std::function<TPackedBinaryFeaturesArraySubset(ui32)>&& getBinaryFeaturesPack,
+    std::function<TPackedNibbleFeaturesArraySubset(ui32)>&& getNibbleFeaturesPack,
     TCmpOp cmpOp,
     int level,
     TIndexType* indices) {
@@ -135,6 +142,21 @@ inline void OfflineCtrBlock(
             },
             level,
             indices);
+    } else if (maybeNibbleIndex) {
+        const ui8 nibbleIdx = maybeNibbleIndex->NibbleIdx;
+
+        NCB::TPackedNibbleFeaturesArraySubset packSubset = getNibbleFeaturesPack(maybeNibbleIndex->PackIdx);
+
+        OfflineCtrBlock(
+            params,
+            blockIdx,
+            permutation,
+            (**packSubset.GetSrc()).data(),
+            [nibbleIdx, cmpOp = std::move(cmpOp)] (NCB::TNibbleFeaturesPack featuresPack) {
+                return cmpOp(GetNibbleFromPack(featuresPack, nibbleIdx));
+            },
+            level,
+            indices);
     } else if (maybeExclusiveBundleIndex) {
 
         TFeaturesBundleArraySubset bundleSubset
@@ -162,6 +184,9 @@ inline void OfflineCtrBlock(
             case 2:
                 calcOfflineCtrBlock((const ui16*)bundleSubset.SrcData.data());
                 break;
+            case 4:
+                calcOfflineCtrBlock((const ui32*)bundleSubset.SrcData.data());
+                break;
             default:
                 CB_ENSURE_INTERNAL(
                     false,
@@ -201,11 +226,13 @@ void SetPermutedIndices(
         auto floatFeatureIdx = TFloatFeatureIdx((ui32)split.FeatureIdx);
 
         TVariant<const ui8*, const ui16*> histogram;
+        TVector<ui8> sparseFeatureStorage;
         auto maybeExclusiveFeaturesBundleIndex
             = objectsDataProvider.GetFloatFeatureToExclusiveBundleIndex(floatFeatureIdx);
         auto maybeBinaryIndex = objectsDataProvider.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx);
-        if (!maybeExclusiveFeaturesBundleIndex && !maybeBinaryIndex) {
-            histogram = GetFloatHistogram(split, objectsDataProvider);
+        auto maybeNibbleIndex = objectsDataProvider.GetFloatFeatureToPackedNibbleIndex(floatFeatureIdx);
+        if (!maybeExclusiveFeaturesBundleIndex && !maybeBinaryIndex && !maybeNibbleIndex) {
+            histogram = GetFloatHistogram(split, objectsDataProvider, &sparseFeatureStorage);
         }
 
         localExecutor->ExecRange(
@@ -216,10 +243,12 @@ void SetPermutedIndices(
                         blockIdx,
                         maybeExclusiveFeaturesBundleIndex,
                         maybeBinaryIndex,
+                        maybeNibbleIndex,
                         fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
                         Get<const ui8*>(histogram),
                         [&] (ui32 bundleIdx) { return objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx); },
                         [&] (ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
+                        [&] (ui32 packIdx) { return objectsDataProvider.GetNibbleFeaturesPack(packIdx); },
                         [splitIdx = GetFeatureSplitIdx(split)] (ui8 bucket) {
                             return IsTrueHistogram<ui8>(bucket, splitIdx);
                         },
@@ -231,10 +260,12 @@ void SetPermutedIndices(
                         blockIdx,
                         maybeExclusiveFeaturesBundleIndex,
                         maybeBinaryIndex,
+                        maybeNibbleIndex,
                         fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
                         Get<const ui16*>(histogram),
                         [&] (ui32 bundleIdx) { return objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx); },
                         [&] (ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
+                        [&] (ui32 packIdx) { return objectsDataProvider.GetNibbleFeaturesPack(packIdx); },
                         [splitIdx = GetFeatureSplitIdx(split)] (ui16 bucket) {
                             return IsTrueHistogram<ui16>(bucket, splitIdx);
                         },
@@ -273,10 +304,12 @@ void SetPermutedIndices(
                     blockIdx,
                     maybeExclusiveFeaturesBundleIndex,
                     maybeBinaryIndex,
+                    /*maybeNibbleIndex*/ Nothing(),
                     fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data(),
                     histogram,
                     [&] (ui32 bundleIdx) { return objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx); },
                     [&] (ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
+                    [&] (ui32 packIdx) { return objectsDataProvider.GetNibbleFeaturesPack(packIdx); },
                     [bucketIdx = (ui32)split.BinBorder] (ui32 bucket) {
                         return IsTrueOneHotFeature(bucket, bucketIdx);
                     },
@@ -361,6 +394,8 @@ static void BuildIndicesForDataset(
     TVector<TVariant<const ui8*, const ui16*>> splitFloatHistograms;
     splitFloatHistograms.yresize(tree.GetDepth());
 
+    TVector<TVector<ui8>> splitSparseFeaturesStorage(tree.GetDepth());
+
     TVector<const ui32*> splitRemappedCatHistograms;
     splitRemappedCatHistograms.yresize(tree.GetDepth());
 
@@ -369,9 +404,14 @@ static void BuildIndicesForDataset(
         if (split.Type == ESplitType::FloatFeature) {
             auto floatFeatureIdx = TFloatFeatureIdx((ui32)split.FeatureIdx);
             if (!objectsDataProvider.IsFeaturePackedBinary(floatFeatureIdx) &&
-                !objectsDataProvider.IsFeatureInExclusiveBundle(floatFeatureIdx))
+                !objectsDataProvider.IsFeatureInExclusiveBundle(floatFeatureIdx) &&
+                !objectsDataProvider.IsFeaturePackedNibble(floatFeatureIdx))
             {
-                splitFloatHistograms[splitIdx] = GetFloatHistogram(split, objectsDataProvider);
+                splitFloatHistograms[splitIdx] = GetFloatHistogram(
+                    split,
+                    objectsDataProvider,
+                    &splitSparseFeaturesStorage[splitIdx]
+                );
             }
         } else if (split.Type == ESplitType::OneHotFeature) {
             auto catFeatureIdx = TCatFeatureIdx((ui32)split.FeatureIdx);
@@ -396,10 +436,12 @@ static void BuildIndicesForDataset(
                         blockIdx,
                         objectsDataProvider.GetFloatFeatureToExclusiveBundleIndex(floatFeatureIdx),
                         objectsDataProvider.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx),
+                        objectsDataProvider.GetFloatFeatureToPackedNibbleIndex(floatFeatureIdx),
                         permutation,
                         Get<const ui8*>(splitFloatHistograms[splitIdx]),
                         [&](ui32 bundleIdx) { return objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx); },
                         [&](ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
+                        [&](ui32 packIdx) { return objectsDataProvider.GetNibbleFeaturesPack(packIdx); },
                         [splitIdx = GetFeatureSplitIdx(split)](ui8 bucket) {
                             return IsTrueHistogram<ui8>(bucket, splitIdx);
                         },
@@ -411,10 +453,12 @@ static void BuildIndicesForDataset(
                         blockIdx,
                         objectsDataProvider.GetFloatFeatureToExclusiveBundleIndex(floatFeatureIdx),
                         objectsDataProvider.GetFloatFeatureToPackedBinaryIndex(floatFeatureIdx),
+                        objectsDataProvider.GetFloatFeatureToPackedNibbleIndex(floatFeatureIdx),
                         permutation,
                         Get<const ui16*>(splitFloatHistograms[splitIdx]),
                         [&](ui32 bundleIdx) { return objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx); },
                         [&](ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
+                        [&](ui32 packIdx) { return objectsDataProvider.GetNibbleFeaturesPack(packIdx); },
                         [splitIdx = GetFeatureSplitIdx(split)](ui16 bucket) {
                             return IsTrueHistogram<ui16>(bucket, splitIdx);
                         },
@@ -439,10 +483,12 @@ static void BuildIndicesForDataset(
                     blockIdx,
                     objectsDataProvider.GetCatFeatureToExclusiveBundleIndex(catFeatureIdx),
                     objectsDataProvider.GetCatFeatureToPackedBinaryIndex(catFeatureIdx),
+                    /*maybeNibbleIndex*/ Nothing(),
                     permutation,
                     splitRemappedCatHistograms[splitIdx],
                     [&] (ui32 bundleIdx) { return objectsDataProvider.GetExclusiveFeaturesBundle(bundleIdx); },
                     [&] (ui32 packIdx) { return objectsDataProvider.GetBinaryFeaturesPack(packIdx); },
+                    [&] (ui32 packIdx) { return objectsDataProvider.GetNibbleFeaturesPack(packIdx); },
                     [bucketIdx = (ui32)split.BinBorder] (ui32 bucket) {
                         return IsTrueOneHotFeature(bucket, bucketIdx);
                     },
@@ -614,6 +660,7 @@ static void AssignFeatureBins(
                 repackedBinFeatures,
                 bundledIndexes,
                 packedIndexes,
+                quantizedObjectsData.GetFloatFeaturesToPackedNibbleIndex(),
                 floatFeature,
                 index);
         },
@@ -696,6 +743,9 @@ const ui8* GetFeatureDataBeginPtr(
         return (**quantizedObjectsData.GetBinaryFeaturesPack(
             (*packedIdx)[featureIdx]->PackIdx
         ).GetSrc()).data();
+    } else if (const auto maybeNibbleIdx = quantizedObjectsData.GetFloatFeatureToPackedNibbleIndex(floatFeatureIdx)) {
+        return (**quantizedObjectsData.GetNibbleFeaturesPack(maybeNibbleIdx->PackIdx).GetSrc()).data()
+            + consecutiveSubsetBegin;
     } else {
         return GetQuantizedForCpuFloatFeatureDataBeginPtr(
             quantizedObjectsData,
@@ -67,6 +67,9 @@ inline void ProcessFeatureForCalcHashes(
                 case 2:
                     iterateFunction((const ui16*)featuresBundleArraySubset.SrcData.data());
                     break;
+                case 4:
+                    iterateFunction((const ui32*)featuresBundleArraySubset.SrcData.data());
+                    break;
                 default:
                     CB_ENSURE_INTERNAL(
                         false,
@@ -96,7 +99,18 @@ inline void ProcessFeatureForCalcHashes(
             );
         }
     } else {
-        dynamic_cast<const NCB::TCompressedValuesHolderImpl<IFeatureColumn>*>(getFeatureColumn())->ForEach(std::move(f), &featuresSubsetIndexing);
+        const IFeatureColumn* featureColumn = getFeatureColumn();
+        if (const auto* sparseFeatureColumn
+                = dynamic_cast<const NCB::TSparseValuesHolderImpl<IFeatureColumn>*>(featureColumn))
+        {
+            sparseFeatureColumn->ForEach(std::move(f), &featuresSubsetIndexing);
+        } else if (const auto* packedNibbleFeatureColumn
+                       = dynamic_cast<const NCB::TPackedNibbleValuesHolderImpl<IFeatureColumn>*>(featureColumn))
+        {
+            packedNibbleFeatureColumn->ForEach(std::move(f), &featuresSubsetIndexing);
+        } else {
+            dynamic_cast<const NCB::TCompressedValuesHolderImpl<IFeatureColumn>*>(featureColumn)->ForEach(std::move(f), &featuresSubsetIndexing);
+        }
     }
 }
 
@@ -286,6 +300,9 @@ inline void CalcHashes(
                 case 2:
                     iterateFunction((const ui16*)featuresBundleArraySubset.SrcData.data());
                     break;
+                case 4:
+                    iterateFunction((const ui32*)featuresBundleArraySubset.SrcData.data());
+                    break;
                 default:
                     CB_ENSURE_INTERNAL(
                         false,
@@ -7,16 +7,20 @@
 #include <catboost/libs/helpers/progress_helper.h>
 #include <catboost/libs/helpers/vector_helpers.h>
 #include <catboost/libs/options/defaults_helper.h>
+#include <catboost/libs/options/system_options.h>
 
 #include <library/digest/crc32c/crc32c.h>
 #include <library/digest/md5/md5.h>
 
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/guid.h>
 #include <util/generic/xrange.h>
 #include <util/folder/path.h>
 #include <util/system/fs.h>
 #include <util/stream/file.h>
+#include <util/stream/str.h>
+#include <util/system/mem_info.h>
 
 
 using namespace NCB;
@@ -53,7 +57,88 @@ static int CountLearningFolds(int permutationCount, bool isPermutationNeededForL
     return isPermutationNeededForLearning ? Max<ui32>(1, permutationCount - 1) : 1;
 }
 
-void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data) {
+static const TString LearningFoldsName = "Learning folds";
+static const TString AveragingFoldName = "Averaging fold";
+static const TString OnlineCtrsName = "Online CTRs";
+static const TString LearnApproxesName = "Learn approxes";
+static const TString TestApproxesName = "Test approxes";
+static const TString SampledDocsName = "Sampled docs";
+static const TString SmallestSplitSideDocsName = "Smallest split side docs";
+static const TString PrevTreeLevelStatsName = "Previous tree level stats";
+static const TString SnapshotBufferName = "Snapshot buffer";
+
+/* Registers sizes of training structures planned from the first learning fold and degrades
+ * while the plan does not fit the RAM limit of this context: tree-level caching is dropped first,
+ * then learning folds count is reduced.
+ * Online CTRs are evicted later during training if needed.
+ * Returns false if tree-level caching must not be used.
+ */
+bool TLearnContext::FitTrainingStructuresToRamLimit(
+    const TTrainingForCPUDataProviders& data,
+    int* learningFoldCount) {
+
+    const TFold& firstFold = LearnProgress.Folds[0];
+    const ui64 foldMemoryUsage = Max<ui64>(firstFold.GetMemoryUsage(), 1);
+
+    const ui32 approxDimension = LearnProgress.ApproxDimension;
+    MemoryGovernor.Register(LearningFoldsName, foldMemoryUsage * *learningFoldCount);
+    // averaging fold is plain, so it is not larger than a learning fold
+    MemoryGovernor.Register(AveragingFoldName, foldMemoryUsage);
+    MemoryGovernor.Register(
+        LearnApproxesName,
+        sizeof(double) * approxDimension * data.Learn->GetObjectCount());
+    MemoryGovernor.Register(
+        TestApproxesName,
+        sizeof(double) * approxDimension * data.GetTestSampleCount());
+
+    // score calculation folds keep derivatives of all body tails, like learning folds
+    MemoryGovernor.Register(SampledDocsName, foldMemoryUsage);
+    const bool needTreeLevelCaching = NeedToUseTreeLevelCaching(
+        Params,
+        Max<ui32>(1, firstFold.BodyTailArr.size()),
+        approxDimension);
+    if (needTreeLevelCaching) {
+        MemoryGovernor.Register(SmallestSplitSideDocsName, foldMemoryUsage);
+        MemoryGovernor.Register(
+            PrevTreeLevelStatsName,
+            sizeof(TBucketStats)
+                * CountNonCtrBuckets(
+                    *data.Learn->ObjectsData->GetQuantizedFeaturesInfo(),
+                    Params.CatFeatureParams->OneHotMaxSize)
+                * (1ull << Params.ObliviousTreeOptions->MaxDepth)
+                * approxDimension
+                * Max<size_t>(1, firstFold.BodyTailArr.size()));
+    }
+
+    bool useTreeLevelCaching = true;
+    if (needTreeLevelCaching && MemoryGovernor.IsOverLimit()) {
+        useTreeLevelCaching = false;
+        MemoryGovernor.Unregister(SmallestSplitSideDocsName);
+        MemoryGovernor.Unregister(PrevTreeLevelStatsName);
+        CATBOOST_WARNING_LOG << "Tree level caching is disabled to fit in used_ram_limit" << Endl;
+    }
+    if (MemoryGovernor.IsOverLimit() && (*learningFoldCount > 1) && Params.SystemOptions->IsSingleHost()) {
+        const ui64 excess = MemoryGovernor.GetTotalUsage() - MemoryGovernor.GetRamLimit();
+        const ui64 foldsToDrop = Min<ui64>(
+            *learningFoldCount - 1,
+            (excess + foldMemoryUsage - 1) / foldMemoryUsage);
+        *learningFoldCount -= SafeIntegerCast<int>(foldsToDrop);
+        MemoryGovernor.Register(LearningFoldsName, foldMemoryUsage * *learningFoldCount);
+        CATBOOST_WARNING_LOG << "Learning folds count is reduced to " << *learningFoldCount
+            << " to fit in used_ram_limit" << Endl;
+    }
+    if (MemoryGovernor.IsOverLimit()) {
+        TStringStream breakdown;
+        MemoryGovernor.OutputBreakdown(&breakdown);
+        CATBOOST_WARNING_LOG << "Estimated memory usage of training structures exceeds used_ram_limit:\n"
+            << breakdown.Str();
+    }
+    return useTreeLevelCaching;
+}
+
+void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data, ui64 trainingStructuresRamLimit) {
+    MemoryGovernor.SetRamLimit(trainingStructuresRamLimit);
+
     LearnAndTestDataPackingAreCompatible = true;
     for (const auto& testData : data.Test) {
         if (!testData->ObjectsData->IsPackingCompatibleWith(*data.Learn->ObjectsData)) {
@@ -85,7 +170,7 @@ void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data) {
         isOrderedBoosting, /*isAveragingFold*/
         false
     );
-    const int learningFoldCount = CountLearningFolds(
+    int learningFoldCount = CountLearningFolds(
         Params.BoostingOptions->PermutationCount,
         isLearnFoldPermuted
     );
@@ -115,39 +200,38 @@ void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data) {
     const auto storeExpApproxes = IsStoreExpApprox(Params.LossFunctionDescription->GetLossFunction());
     const bool hasPairwiseWeights = UsesPairsForCalculation(Params.LossFunctionDescription->GetLossFunction());
 
-    if (IsPlainMode(Params.BoostingOptions->BoostingType)) {
-        for (int foldIdx = 0; foldIdx < learningFoldCount; ++foldIdx) {
-            LearnProgress.Folds.emplace_back(
-                TFold::BuildPlainFold(
-                    *data.Learn,
-                    CtrsHelper.GetTargetClassifiers(),
-                    foldIdx != 0,
-                    (Params.SystemOptions->IsSingleHost() ? foldPermutationBlockSize : learnSampleCount),
-                    LearnProgress.ApproxDimension,
-                    storeExpApproxes,
-                    hasPairwiseWeights,
-                    Rand,
-                    LocalExecutor
-                )
-            );
-        }
-    } else {
-        for (int foldIdx = 0; foldIdx < learningFoldCount; ++foldIdx) {
-            LearnProgress.Folds.emplace_back(
-                TFold::BuildDynamicFold(
-                    *data.Learn,
-                    CtrsHelper.GetTargetClassifiers(),
-                    foldIdx != 0,
-                    foldPermutationBlockSize,
-                    LearnProgress.ApproxDimension,
-                    boostingOptions.FoldLenMultiplier,
-                    storeExpApproxes,
-                    hasPairwiseWeights,
-                    Rand,
-                    LocalExecutor
-                )
+    auto buildLearningFold = [&] (int foldIdx) {
+        if (IsPlainMode(Params.BoostingOptions->BoostingType)) {
+            return TFold::BuildPlainFold(
+                *data.Learn,
+                CtrsHelper.GetTargetClassifiers(),
+                foldIdx != 0,
+                (Params.SystemOptions->IsSingleHost() ? foldPermutationBlockSize : learnSampleCount),
+                LearnProgress.ApproxDimension,
+                storeExpApproxes,
+                hasPairwiseWeights,
+                Rand,
+                LocalExecutor
             );
         }
+        return TFold::BuildDynamicFold(
+            *data.Learn,
+            CtrsHelper.GetTargetClassifiers(),
+            foldIdx != 0,
+            foldPermutationBlockSize,
+            LearnProgress.ApproxDimension,
+            boostingOptions.FoldLenMultiplier,
+            storeExpApproxes,
+            hasPairwiseWeights,
+            Rand,
+            LocalExecutor
+        );
+    };
+
+    LearnProgress.Folds.emplace_back(buildLearningFold(0));
+    const bool useTreeLevelCaching = FitTrainingStructuresToRamLimit(data, &learningFoldCount);
+    for (int foldIdx = 1; foldIdx < learningFoldCount; ++foldIdx) {
+        LearnProgress.Folds.emplace_back(buildLearningFold(foldIdx));
     }
 
     const bool isAverageFoldPermuted = IsPermutationNeeded(
@@ -190,16 +274,30 @@ void TLearnContext::InitContext(const TTrainingForCPUDataProviders& data) {
     }
 
     const ui32 maxBodyTailCount = Max(1, GetMaxBodyTailCount(LearnProgress.Folds));
-    UseTreeLevelCachingFlag = NeedToUseTreeLevelCaching(Params, maxBodyTailCount, LearnProgress.ApproxDimension);
+    UseTreeLevelCachingFlag = useTreeLevelCaching
+        && NeedToUseTreeLevelCaching(Params, maxBodyTailCount, LearnProgress.ApproxDimension);
+
+    UpdateMemoryUsage();
 }
 
-void TLearnContext::SaveProgress() {
+void TLearnContext::SaveProgress(bool waitForCompletion) {
     if (!OutputOptions.SaveSnapshot()) {
         return;
     }
-    TProgressHelper(ToString(ETaskType::CPU)).Write(Files.SnapshotFile, [&](IOutputStream* out) {
+    if (waitForCompletion) {
+        SnapshotWriter.Finish();
+    }
+    const bool started = SnapshotWriter.TryWrite(Files.SnapshotFile, [&](IOutputStream* out) {
         ::SaveMany(out, Rand, LearnProgress, Profile.DumpProfileInfo());
     });
+    if (!started) {
+        CATBOOST_DEBUG_LOG << "Previous snapshot is still being written, skip saving progress" << Endl;
+        return;
+    }
+    MemoryGovernor.Register(SnapshotBufferName, SnapshotWriter.GetPendingBufferSize());
+    if (waitForCompletion) {
+        SnapshotWriter.Finish();
+    }
 }
 
 bool TLearnContext::TryLoadProgress() {
@@ -309,6 +407,67 @@ bool TLearnContext::UseTreeLevelCaching() const {
     return UseTreeLevelCachingFlag;
 }
 
+void TLearnContext::UpdateMemoryUsage() {
+    ui64 learningFoldsMemoryUsage = 0;
+    ui64 onlineCtrsMemoryUsage = LearnProgress.AveragingFold.GetOnlineCtrsMemoryUsage();
+    for (const auto& fold : LearnProgress.Folds) {
+        learningFoldsMemoryUsage += fold.GetMemoryUsage();
+        onlineCtrsMemoryUsage += fold.GetOnlineCtrsMemoryUsage();
+    }
+    MemoryGovernor.Register(LearningFoldsName, learningFoldsMemoryUsage);
+    MemoryGovernor.Register(AveragingFoldName, LearnProgress.AveragingFold.GetMemoryUsage());
+    MemoryGovernor.Register(OnlineCtrsName, onlineCtrsMemoryUsage);
+    MemoryGovernor.Register(LearnApproxesName, GetVectorMemoryUsage(LearnProgress.AvrgApprox));
+    MemoryGovernor.Register(
+        TestApproxesName,
+        GetVectorMemoryUsage(LearnProgress.TestApprox) + GetVectorMemoryUsage(LearnProgress.BestTestApprox));
+    MemoryGovernor.Register(SampledDocsName, SampledDocs.GetMemoryUsage());
+    MemoryGovernor.Register(SmallestSplitSideDocsName, SmallestSplitSideDocs.GetMemoryUsage());
+    MemoryGovernor.Register(PrevTreeLevelStatsName, PrevTreeLevelStats.GetMemoryUsage());
+    MemoryGovernor.Register(SnapshotBufferName, SnapshotWriter.GetPendingBufferSize());
+    PeakMemoryUsage = Max(PeakMemoryUsage, MemoryGovernor.GetTotalUsage());
+}
+
+ui64 TLearnContext::GetPeakMemoryUsage() const {
+    return PeakMemoryUsage;
+}
+
+void TLearnContext::EvictOnlineCtrsIfOverRamLimit() {
+    UpdateMemoryUsage();
+    if (!MemoryGovernor.IsOverLimit()) {
+        return;
+    }
+    if (!MemoryGovernor.FitsWithout(OnlineCtrsName)) {
+        // CTRs would be recomputed in each iteration without any gain
+        if (!RamLimitIsUnreachableWarningIsShown) {
+            TStringStream breakdown;
+            MemoryGovernor.OutputBreakdown(&breakdown);
+            CATBOOST_WARNING_LOG << "Memory usage of training structures exceeds used_ram_limit even without "
+                "online CTRs cache, so the cache is kept:\n" << breakdown.Str();
+            RamLimitIsUnreachableWarningIsShown = true;
+        }
+        return;
+    }
+    for (auto& fold : LearnProgress.Folds) {
+        fold.ClearOnlineCTRs();
+    }
+    LearnProgress.AveragingFold.ClearOnlineCTRs();
+    UpdateMemoryUsage();
+    if (!OnlineCtrsEvictionWarningIsShown) {
+        CATBOOST_WARNING_LOG << "Online CTRs cache is evicted to fit in used_ram_limit, "
+            "CTRs will be recomputed when needed" << Endl;
+        OnlineCtrsEvictionWarningIsShown = true;
+    } else {
+        CATBOOST_DEBUG_LOG << "Online CTRs cache is evicted to fit in used_ram_limit" << Endl;
+    }
+}
+
+void TLearnContext::OutputMemoryUsage() const {
+    TStringStream breakdown;
+    MemoryGovernor.OutputBreakdown(&breakdown);
+    CATBOOST_DEBUG_LOG << "Memory usage of training structures:\n" << breakdown.Str();
+}
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
@@ -321,3 +480,12 @@ bool NeedToUseTreeLevelCaching(
         !IsPairwiseScoring(params.LossFunctionDescription->GetLossFunction()) &&
         maxLeafCount * approxDimension * maxBodyTailCount < 64 * 1 * 10);
 }
+
+ui64 GetTrainingStructuresRamLimit(const NCatboostOptions::TSystemOptions& systemOptions) {
+    const ui64 ramLimit = ParseMemorySizeDescription(systemOptions.CpuUsedRamLimit.Get());
+    if (ramLimit == Max<ui64>()) {
+        return ramLimit;
+    }
+    const ui64 processMemoryUsage = NMemInfo::GetMemInfo().RSS;
+    return (processMemoryUsage < ramLimit) ? (ramLimit - processMemoryUsage) : 0;
+}
@@ -9,12 +9,15 @@
 
 #include <catboost/libs/data_new/data_provider.h>
 #include <catboost/libs/data_new/features_layout.h>
+#include <catboost/libs/helpers/memory_governor.h>
+#include <catboost/libs/helpers/progress_helper.h>
 #include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/labels/label_converter.h>
 #include <catboost/libs/loggers/logger.h>
 #include <catboost/libs/loggers/catboost_logger_helpers.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/logging/profile_info.h>
+#include <catboost/libs/metrics/incremental_metric.h>
 #include <catboost/libs/options/catboost_options.h>
 
 #include <library/json/json_reader.h>
@@ -58,6 +61,22 @@ public:
     void Load(IInputStream* s);
 };
 
+// Metric calcers that reuse results of the previous iteration, see incremental_metric.h
+struct TIncrementalMetricsCache {
+    const TVector<THolder<IMetric>>* Metrics = nullptr;
+    TVector<THolder<IIncrementalMetricCalcer>> LearnCalcers;        // [metricIdx], nullptr if not supported
+    TVector<TVector<THolder<IIncrementalMetricCalcer>>> TestCalcers; // [testIdx][metricIdx]
+    size_t TreeCount = 0; // trees registered with calcers
+
+public:
+    void Reset(size_t treeCount) {
+        Metrics = nullptr;
+        LearnCalcers.clear();
+        TestCalcers.clear();
+        TreeCount = treeCount;
+    }
+};
+
 class TCommonContext : public TNonCopyable {
 public:
     TCommonContext(
@@ -106,6 +125,7 @@ public:
         , Rand(Params.RandomSeed)
         , OutputOptions(outputOptions)
         , Files(outputOptions, fileNamesPrefix)
+        , SnapshotWriter(ToString(ETaskType::CPU))
         , RootEnvironment(nullptr)
         , SharedTrainData(nullptr)
         , Profile((int)Params.BoostingOptions->IterationCount)
@@ -123,16 +143,34 @@ public:
     ~TLearnContext();
 
     void OutputMeta();
-    void InitContext(const NCB::TTrainingForCPUDataProviders& data);
-    void SaveProgress();
+    /* trainingStructuresRamLimit is the part of used_ram_limit available to structures of this context,
+     * training degrades to fit them in it, see GetTrainingStructuresRamLimit
+     */
+    void InitContext(const NCB::TTrainingForCPUDataProviders& data, ui64 trainingStructuresRamLimit);
+    /* Snapshot is written in background, if the previous one is still being written the call is skipped.
+     * waitForCompletion forces saving and blocks until the snapshot file is written.
+     */
+    void SaveProgress(bool waitForCompletion = false);
     bool TryLoadProgress();
     bool UseTreeLevelCaching() const;
 
+    // re-registers sizes of folds, approxes, score calculation caches and online CTRs in MemoryGovernor
+    void UpdateMemoryUsage();
+    void OutputMemoryUsage() const;
+    // max of registered training structures memory usage since InitContext
+    ui64 GetPeakMemoryUsage() const;
+
+    /* Online CTRs of all folds are evicted only if it brings memory usage under used_ram_limit,
+     * otherwise a warning is printed once and CTRs are kept
+     */
+    void EvictOnlineCtrsIfOverRamLimit();
+
 public:
     TRestorableFastRng64 Rand;
     TLearnProgress LearnProgress;
     NCatboostOptions::TOutputFilesOptions OutputOptions;
     TOutputFiles Files;
+    TAsyncProgressWriter SnapshotWriter;
 
     TCalcScoreFold SmallestSplitSideDocs;
     TCalcScoreFold SampledDocs;
@@ -140,13 +178,28 @@ public:
     TObj<NPar::IRootEnvironment> RootEnvironment;
     TObj<NPar::IEnvironment> SharedTrainData;
     TProfileInfo Profile;
+    TIncrementalMetricsCache IncrementalMetrics;
+    NCB::TMemoryGovernor MemoryGovernor;
 
     bool LearnAndTestDataPackingAreCompatible;
 
+private:
+    bool FitTrainingStructuresToRamLimit(
+        const NCB::TTrainingForCPUDataProviders& data,
+        int* learningFoldCount);
+
 private:
     bool UseTreeLevelCachingFlag;
+    bool RamLimitIsUnreachableWarningIsShown = false;
+    bool OnlineCtrsEvictionWarningIsShown = false;
+    ui64 PeakMemoryUsage = 0;
 };
 
+/* Part of used_ram_limit left for training structures after memory already used by the process
+ * (mostly by datasets), measured once before training structures are created
+ */
+ui64 GetTrainingStructuresRamLimit(const NCatboostOptions::TSystemOptions& systemOptions);
+
 bool NeedToUseTreeLevelCaching(
     const NCatboostOptions::TCatBoostOptions& params,
     ui32 maxBodyTailCount,
@@ -2,6 +2,8 @@
 #include "pairwise_leaves_calculation.h"
 #include "short_vector_ops.h"
 
+#include <catboost/libs/helpers/exception.h>
+
 #include <util/generic/xrange.h>
 #include <util/system/yassert.h>
 
@@ -382,6 +384,8 @@ void CalculatePairwiseScore(
                 }
             }
             break;
+        case ESplitEnsembleType::NibbleSplits:
+            CB_ENSURE_INTERNAL(false, "Nibble splits packs are not supported in pairwise scoring");
     }
 }
 
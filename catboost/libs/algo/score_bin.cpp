@@ -32,5 +32,7 @@ int CalcScoreBinCount(
                 }
                 return SafeIntegerCast<int>(binCount);
             }
+        case ESplitEnsembleType::NibbleSplits:
+            return SafeIntegerCast<int>(splitEnsembleSpec.NibbleFeaturesPack.GetSplitCount());
     }
 }
@@ -9,6 +9,7 @@
 #include <catboost/libs/options/defaults_helper.h>
 
 #include <util/generic/array_ref.h>
+#include <util/generic/ylimits.h>
 
 #include <type_traits>
 
@@ -147,6 +148,7 @@ inline static void BuildSingleIndex(
     const std::tuple<const TOnlineCTRHash&, const TOnlineCTRHash&>& allCtrs,
     const TSplitEnsemble& splitEnsemble,
     const TStatsIndexer& indexer,
+    TConstArrayRef<ui8> denseSparseFeatureData, // non-empty if split feature is sparse
     NCB::TIndexRange<int> docIndexRange,
     TVector<TFullIndexType>* singleIdx // already of proper size
 ) {
@@ -189,7 +191,9 @@ inline static void BuildSingleIndex(
             case ESplitEnsembleType::OneFeature:
                 {
                     const auto& splitCandidate = splitEnsemble.SplitCandidate;
-                    if (splitCandidate.Type == ESplitType::FloatFeature) {
+                    if (!denseSparseFeatureData.empty()) {
+                        setSingleIndexFunc(denseSparseFeatureData.data());
+                    } else if (splitCandidate.Type == ESplitType::FloatFeature) {
                         const auto* featureColumnValuesHolder = (*objectsDataProvider.GetNonPackedFloatFeature((ui32)splitCandidate.FeatureIdx));
                         if (featureColumnValuesHolder->GetBitsPerKey() == 8) {
                             setSingleIndexFunc(
@@ -233,6 +237,9 @@ inline static void BuildSingleIndex(
                         case 2:
                             setSingleIndexFunc((const ui16*)srcData);
                             break;
+                        case 4:
+                            setSingleIndexFunc((const ui32*)srcData);
+                            break;
                         default:
                             CB_ENSURE_INTERNAL(
                                 false,
@@ -240,6 +247,14 @@ inline static void BuildSingleIndex(
                             );
                     }
                 }
+                break;
+            case ESplitEnsembleType::NibbleSplits:
+                setSingleIndexFunc(
+                    (**objectsDataProvider.GetNibbleFeaturesPack(
+                        splitEnsemble.NibbleSplitsPackRef.PackIdx
+                     ).GetSrc()).data()
+                );
+                break;
         }
     }
 }
@@ -371,6 +386,117 @@ inline static void FixUpStats(
 }
 
 
+static const TQuantizedFloatSparseValuesHolder* GetSparseFloatFeature(
+    const TQuantizedForCPUObjectsDataProvider& objectsDataProvider,
+    const TSplitEnsemble& splitEnsemble
+) {
+    if ((splitEnsemble.Type != ESplitEnsembleType::OneFeature) ||
+        (splitEnsemble.SplitCandidate.Type != ESplitType::FloatFeature))
+    {
+        return nullptr;
+    }
+    return objectsDataProvider.GetSparseFloatFeature((ui32)splitEnsemble.SplitCandidate.FeatureIdx);
+}
+
+
+/* Stats for sparse float features without iteration over all docs:
+ * default bucket of each leaf gets sums over all docs in the leaf (precalculated in fold),
+ * then sums for docs with non-default buckets are moved to their buckets.
+ * Result is the same as CalcStatsKernel's one for all docs.
+ */
+static void CalcSparseFloatFeatureStats(
+    const TCalcScoreFold& fold,
+    const TQuantizedFloatSparseValuesHolder& featureColumnHolder,
+    const TStatsIndexer& indexer,
+    bool isCaching,
+    bool isPlainMode,
+    int depth,
+    int splitStatsCount,
+    TBucketStats* stats
+) {
+    Y_ASSERT(!isCaching || depth > 0);
+
+    const auto& sparseFeaturesData = fold.SparseFeaturesData;
+    const auto& srcToDocIndices = sparseFeaturesData.SrcToDocIndices;
+    const ui32 defaultBin = featureColumnHolder.GetDefaultBin();
+
+    // (doc, bucket) for docs in fold with non-default buckets
+    TVector<std::pair<ui32, ui8>> nonDefaultDocBuckets;
+    featureColumnHolder.GetSparseSrcData()->ForEachNonDefault(
+        [&] (ui32 srcIdx, ui8 bucket) {
+            if (srcIdx < srcToDocIndices.size() && (srcToDocIndices[srcIdx] != Max<ui32>())) {
+                nonDefaultDocBuckets.emplace_back(srcToDocIndices[srcIdx], bucket);
+            }
+        }
+    );
+
+    const TIndexType* indices = GetDataPtr(fold.Indices);
+    const int approxDimension = fold.GetApproxDimension();
+    const int leafBegin = isCaching ? (1 << (depth - 1)) : 0;
+    const int leafEnd = Min(1 << depth, sparseFeaturesData.LeafCount);
+
+    for (int bodyTailIdx : xrange(fold.GetBodyTailCount())) {
+        const auto& bt = fold.BodyTailArr[bodyTailIdx];
+        const bool hasPairwiseWeights = !bt.PairwiseWeights.empty();
+        const float* weightsData = hasPairwiseWeights ?
+            GetDataPtr(bt.PairwiseWeights) : GetDataPtr(fold.LearnWeights);
+        const float* sampleWeightsData = hasPairwiseWeights ?
+            GetDataPtr(bt.SamplePairwiseWeights) : GetDataPtr(fold.SampleWeights);
+
+        for (int dim : xrange(approxDimension)) {
+            const int bodyTailDimIdx = bodyTailIdx * approxDimension + dim;
+            TBucketStats* statsSubset = stats + bodyTailDimIdx * splitStatsCount;
+
+            Fill(
+                statsSubset + indexer.GetIndex(leafBegin, 0),
+                statsSubset + indexer.CalcSize(depth),
+                TBucketStats{0, 0, 0, 0}
+            );
+
+            const TBucketStats* leafBodyStats
+                = sparseFeaturesData.LeafBodyStats.data() + bodyTailDimIdx * sparseFeaturesData.LeafCount;
+            const TBucketStats* leafTailStats
+                = sparseFeaturesData.LeafTailStats.data() + bodyTailDimIdx * sparseFeaturesData.LeafCount;
+            for (int leaf = leafBegin; leaf < leafEnd; ++leaf) {
+                TBucketStats& leafStats = statsSubset[indexer.GetIndex(leaf, defaultBin)];
+                if (isPlainMode) {
+                    leafStats.SumWeightedDelta
+                        = leafBodyStats[leaf].SumWeightedDelta + leafTailStats[leaf].SumWeightedDelta;
+                    leafStats.SumWeight = leafBodyStats[leaf].SumWeight + leafTailStats[leaf].SumWeight;
+                } else {
+                    leafStats.SumWeightedDelta = leafTailStats[leaf].SumWeightedDelta;
+                    leafStats.SumWeight = leafTailStats[leaf].SumWeight;
+                    leafStats.SumDelta = leafBodyStats[leaf].SumDelta;
+                    leafStats.Count = leafBodyStats[leaf].Count;
+                }
+            }
+
+            const double* weightedDerivativesData = GetDataPtr(bt.WeightedDerivatives[dim]);
+            const double* sampleWeightedDerivativesData = GetDataPtr(bt.SampleWeightedDerivatives[dim]);
+
+            for (const auto& [doc, bucket] : nonDefaultDocBuckets) {
+                TBucketStats docStats{0, 0, 0, 0};
+                if (!isPlainMode && (doc < (ui32)bt.BodyFinish)) {
+                    docStats.SumDelta = weightedDerivativesData[doc];
+                    docStats.Count = weightsData ? weightsData[doc] : 1;
+                } else if (doc < (ui32)bt.TailFinish) {
+                    docStats.SumWeightedDelta = sampleWeightedDerivativesData[doc];
+                    docStats.SumWeight = sampleWeightsData[doc];
+                } else {
+                    continue;
+                }
+                statsSubset[indexer.GetIndex(indices[doc], defaultBin)].Remove(docStats);
+                statsSubset[indexer.GetIndex(indices[doc], bucket)].Add(docStats);
+            }
+
+            if (isCaching) {
+                FixUpStats(depth, indexer, fold.SmallestSplitSideValue, statsSubset);
+            }
+        }
+    }
+}
+
+
 template <typename TFullIndexType, typename TIsCaching>
 static void CalcStatsImpl(
     const TCalcScoreFold& fold,
@@ -403,6 +529,12 @@ static void CalcStatsImpl(
     const auto pairCount = pairs.ysize();
     const auto pairPart = CeilDiv(pairCount, blockCount);
 
+    // pairwise stats are calculated for dense data
+    TVector<ui8> denseSparseFeatureData;
+    if (const auto* sparseFeatureColumnHolder = GetSparseFloatFeature(objectsDataProvider, splitEnsemble)) {
+        denseSparseFeatureData = sparseFeatureColumnHolder->GetSparseSrcData()->ExtractValues();
+    }
+
     NCB::MapMerge(
         localExecutor,
         fold.GetCalcStatsIndexRanges(),
@@ -451,25 +583,52 @@ static void CalcStatsImpl(
                                 GetCtr(allCtrs, ctr.Projection)
                                     .Feature[ctr.CtrIdx][ctr.TargetBorderIdx][ctr.PriorIdx];
                             setOutput([buckets](ui32 docIdx) { return buckets[docIdx]; });
+                        } else if (!denseSparseFeatureData.empty()) {
+                            const ui8* bucketSrcData = denseSparseFeatureData.data();
+                            const ui32* bucketIndexing
+                                = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
+                            setOutput(
+                                [bucketSrcData, bucketIndexing](ui32 docIdx) {
+                                    return bucketSrcData[bucketIndexing[docIdx]];
+                                }
+                            );
                         } else if (splitCandidate.Type == ESplitType::FloatFeature) {
-                            const auto* featureColumnHolder = (*objectsDataProvider.GetNonPackedFloatFeature((ui32)splitCandidate.FeatureIdx));
                             const ui32* bucketIndexing
                                 = fold.LearnPermutationFeaturesSubset.Get<TIndexedSubset<ui32>>().data();
-                            if (featureColumnHolder->GetBitsPerKey() == 8) {
-                                const ui8* bucketSrcData = *(featureColumnHolder->GetArrayData<ui8>().GetSrc());
+
+                            // pairwise scoring uses per-feature candidates for nibble packed features
+                            const auto maybePackedNibbleIndex = objectsDataProvider.GetFloatFeatureToPackedNibbleIndex(
+                                TFloatFeatureIdx((ui32)splitCandidate.FeatureIdx)
+                            );
+                            if (maybePackedNibbleIndex) {
+                                const TNibbleFeaturesPack* packSrcData =
+                                    (**objectsDataProvider.GetNibbleFeaturesPack(
+                                        maybePackedNibbleIndex->PackIdx
+                                    ).GetSrc()).data();
+                                const ui8 nibbleIdx = maybePackedNibbleIndex->NibbleIdx;
                                 setOutput(
-                                    [bucketSrcData, bucketIndexing](ui32 docIdx) {
-                                        return bucketSrcData[bucketIndexing[docIdx]];
+                                    [packSrcData, bucketIndexing, nibbleIdx](ui32 docIdx) {
+                                        return GetNibbleFromPack(packSrcData[bucketIndexing[docIdx]], nibbleIdx);
                                     }
                                 );
                             } else {
-                                Y_ASSERT(featureColumnHolder->GetBitsPerKey() == 16);
-                                const ui16* bucketSrcData = *(featureColumnHolder->GetArrayData<ui16>().GetSrc());
-                                setOutput(
-                                    [bucketSrcData, bucketIndexing](ui32 docIdx) {
-                                        return bucketSrcData[bucketIndexing[docIdx]];
-                                    }
-                                );
+                                const auto* featureColumnHolder = (*objectsDataProvider.GetNonPackedFloatFeature((ui32)splitCandidate.FeatureIdx));
+                                if (featureColumnHolder->GetBitsPerKey() == 8) {
+                                    const ui8* bucketSrcData = *(featureColumnHolder->GetArrayData<ui8>().GetSrc());
+                                    setOutput(
+                                        [bucketSrcData, bucketIndexing](ui32 docIdx) {
+                                            return bucketSrcData[bucketIndexing[docIdx]];
+                                        }
+                                    );
+                                } else {
+                                    Y_ASSERT(featureColumnHolder->GetBitsPerKey() == 16);
+                                    const ui16* bucketSrcData = *(featureColumnHolder->GetArrayData<ui16>().GetSrc());
+                                    setOutput(
+                                        [bucketSrcData, bucketIndexing](ui32 docIdx) {
+                                            return bucketSrcData[bucketIndexing[docIdx]];
+                                        }
+                                    );
+                                }
                             }
                         } else {
                             Y_ASSERT(splitCandidate.Type == ESplitType::OneHotFeature);
@@ -565,6 +724,9 @@ static void CalcStatsImpl(
                             case 2:
                                 computeStatsFunc((const ui16*)bucketSrcData);
                                 break;
+                            case 4:
+                                computeStatsFunc((const ui32*)bucketSrcData);
+                                break;
                             default:
                                 CB_ENSURE_INTERNAL(
                                     false,
@@ -577,6 +739,8 @@ static void CalcStatsImpl(
                         );
                     }
                     break;
+                case ESplitEnsembleType::NibbleSplits:
+                    CB_ENSURE_INTERNAL(false, "Nibble splits packs are not supported in pairwise scoring");
             }
         },
         /*mergeFunc*/[&](TPairwiseStats* output, TVector<TPairwiseStats>&& addVector) {
@@ -609,12 +773,36 @@ static void CalcStatsImpl(
 
     const int docCount = fold.GetDocCount();
 
-    TVector<TFullIndexType> singleIdx;
-    singleIdx.yresize(docCount);
-
     const int statsCount = fold.GetBodyTailCount() * fold.GetApproxDimension() * splitStatsCount;
     const int filledSplitStatsCount = indexer.CalcSize(depth);
 
+    const auto* sparseFeatureColumnHolder = GetSparseFloatFeature(objectsDataProvider, splitEnsemble);
+    if (sparseFeatureColumnHolder && !fold.SparseFeaturesData.SrcToDocIndices.empty()) {
+        if (stats->NonInited()) {
+            (*stats) = TBucketStatsRefOptionalHolder(statsCount);
+        }
+        CalcSparseFloatFeatureStats(
+            fold,
+            *sparseFeatureColumnHolder,
+            indexer,
+            isCaching,
+            isPlainMode,
+            depth,
+            splitStatsCount,
+            stats->GetData().data()
+        );
+        return;
+    }
+
+    // fallback for folds without precalculated data for sparse features
+    TVector<ui8> denseSparseFeatureData;
+    if (sparseFeatureColumnHolder) {
+        denseSparseFeatureData = sparseFeatureColumnHolder->GetSparseSrcData()->ExtractValues();
+    }
+
+    TVector<TFullIndexType> singleIdx;
+    singleIdx.yresize(docCount);
+
     // bodyFunc must accept (bodyTailIdx, dim, bucketStatsArrayBegin) params
     auto forEachBodyTailAndApproxDimension = [&](auto bodyFunc) {
         const int approxDimension = fold.GetApproxDimension();
@@ -642,6 +830,7 @@ static void CalcStatsImpl(
                 allCtrs,
                 splitEnsemble,
                 indexer,
+                denseSparseFeatureData,
                 docIndexRange,
                 &singleIdx);
 
@@ -808,6 +997,16 @@ inline static void UpdateScoreBins(
         }
     }
 
+    // used only if splitEnsembleSpec.Type == ESplitEnsembleType::NibbleSplits
+    const auto& nibbleBinCounts = splitEnsembleSpec.NibbleFeaturesPack.BinCounts;
+
+    // allocate one time for all leaves, [nibbleIdx * MaxNibbleFeatureBinCount + binIdx]
+    TVector<TBucketStats> nibbleBinsStats;
+
+    if (splitEnsembleSpec.Type == ESplitEnsembleType::NibbleSplits) {
+        nibbleBinsStats.resize(nibbleBinCounts.size() * MaxNibbleFeatureBinCount);
+    }
+
 
     for (int leaf = 0; leaf < leafCount; ++leaf) {
         switch (splitEnsembleSpec.Type) {
@@ -949,6 +1148,48 @@ inline static void UpdateScoreBins(
                     }
                 }
                 break;
+            case ESplitEnsembleType::NibbleSplits:
+                {
+                    // one pass over pack buckets gives histograms for all features in the pack
+                    for (auto& nibbleBinStats : nibbleBinsStats) {
+                        nibbleBinStats = TBucketStats{0, 0, 0, 0};
+                    }
+                    for (int bucketIdx = 0; bucketIdx < indexer.BucketCount; ++bucketIdx) {
+                        const TBucketStats& leafStats = stats[indexer.GetIndex(leaf, bucketIdx)];
+                        for (auto nibbleIdx : xrange(nibbleBinCounts.size())) {
+                            const ui8 binIdx = NCB::GetNibbleFromPack(
+                                NCB::TNibbleFeaturesPack(bucketIdx),
+                                SafeIntegerCast<ui8>(nibbleIdx)
+                            );
+                            nibbleBinsStats[nibbleIdx * MaxNibbleFeatureBinCount + binIdx].Add(leafStats);
+                        }
+                    }
+
+                    ui32 binsBegin = 0;
+                    for (auto nibbleIdx : xrange(nibbleBinCounts.size())) {
+                        const TBucketStats* nibbleStats
+                            = nibbleBinsStats.data() + nibbleIdx * MaxNibbleFeatureBinCount;
+
+                        TBucketStats trueStats{0, 0, 0, 0};
+                        for (auto binIdx : xrange(nibbleBinCounts[nibbleIdx])) {
+                            trueStats.Add(nibbleStats[binIdx]);
+                        }
+                        TBucketStats falseStats{0, 0, 0, 0};
+
+                        for (ui32 splitIdx = 0; splitIdx < nibbleBinCounts[nibbleIdx] - 1; ++splitIdx) {
+                            falseStats.Add(nibbleStats[splitIdx]);
+                            trueStats.Remove(nibbleStats[splitIdx]);
+
+                            updateScoreBinClosure(
+                                trueStats,
+                                falseStats,
+                                &((*scoreBins)[binsBegin + splitIdx])
+                            );
+                        }
+                        binsBegin += nibbleBinCounts[nibbleIdx] - 1;
+                    }
+                }
+                break;
         }
     }
 }
@@ -1035,10 +1276,15 @@ void CalcStatsAndScores(
         splitEnsemble,
         *objectsDataProvider.GetQuantizedFeaturesInfo(),
         objectsDataProvider.GetPackedBinaryFeaturesSize(),
-        objectsDataProvider.GetExclusiveFeatureBundlesMetaData()
+        objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
+        objectsDataProvider.GetNibbleFeaturesPacksMetaData()
     );
     const TStatsIndexer indexer(bucketCount);
     const int fullIndexBitCount = depth + GetValueBitCount(bucketCount - 1);
+    CB_ENSURE(
+        fullIndexBitCount <= 32,
+        "Too many buckets (" << bucketCount << ") in a feature or a features bundle for depth " << depth
+    );
     const bool isPlainMode = IsPlainMode(fitParams.BoostingOptions->BoostingType);
 
     const float l2Regularizer = static_cast<const float>(fitParams.ObliviousTreeOptions->L2Reg);
@@ -1111,7 +1357,8 @@ void CalcStatsAndScores(
         }
         pairwiseStats->SplitEnsembleSpec = TSplitEnsembleSpec(
             splitEnsemble,
-            objectsDataProvider.GetExclusiveFeatureBundlesMetaData()
+            objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
+            objectsDataProvider.GetNibbleFeaturesPacksMetaData()
         );
 
         selectCalcStatsImpl(/*isCaching*/ std::false_type(), fold, /*splitStatsCount*/0, pairwiseStats);
@@ -1146,7 +1393,8 @@ void CalcStatsAndScores(
                 stats3d->MaxLeafCount = 1U << depth;
                 stats3d->SplitEnsembleSpec = TSplitEnsembleSpec(
                     splitEnsemble,
-                    objectsDataProvider.GetExclusiveFeatureBundlesMetaData()
+                    objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
+                    objectsDataProvider.GetNibbleFeaturesPacksMetaData()
                 );
 
                 extOrInSplitStats = TBucketStatsRefOptionalHolder(stats3d->Stats);
@@ -1188,7 +1436,8 @@ void CalcStatsAndScores(
                 stats3d->MaxLeafCount = 1U << depth;
                 stats3d->SplitEnsembleSpec = TSplitEnsembleSpec(
                     splitEnsemble,
-                    objectsDataProvider.GetExclusiveFeatureBundlesMetaData()
+                    objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
+                    objectsDataProvider.GetNibbleFeaturesPacksMetaData()
                 );
             }
         }
@@ -1197,7 +1446,11 @@ void CalcStatsAndScores(
             CalculateNonPairwiseScore(
                 fold,
                 *initialFold,
-                TSplitEnsembleSpec(splitEnsemble, objectsDataProvider.GetExclusiveFeatureBundlesMetaData()),
+                TSplitEnsembleSpec(
+                    splitEnsemble,
+                    objectsDataProvider.GetExclusiveFeatureBundlesMetaData(),
+                    objectsDataProvider.GetNibbleFeaturesPacksMetaData()
+                ),
                 isPlainMode,
                 leafCount,
                 l2Regularizer,
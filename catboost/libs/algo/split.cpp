@@ -69,7 +69,8 @@ int GetBucketCount(
     const TSplitEnsemble& splitEnsemble,
     const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo,
     size_t packedBinaryFeaturesCount,
-    TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundles
+    TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundles,
+    TConstArrayRef<NCB::TNibbleFeaturesPackMetaData> nibbleFeaturesPacks
 ) {
     switch (splitEnsemble.Type) {
         case ESplitEnsembleType::OneFeature:
@@ -103,5 +104,7 @@ int GetBucketCount(
             }
         case ESplitEnsembleType::ExclusiveBundle:
             return exclusiveFeaturesBundles[splitEnsemble.ExclusiveFeaturesBundleRef.BundleIdx].GetBinCount();
+        case ESplitEnsembleType::NibbleSplits:
+            return int(nibbleFeaturesPacks[splitEnsemble.NibbleSplitsPackRef.PackIdx].GetPackBinCount());
     }
 }
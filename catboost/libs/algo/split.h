@@ -4,6 +4,7 @@
 
 #include <catboost/libs/data_new/exclusive_feature_bundling.h>
 #include <catboost/libs/data_new/packed_binary_features.h>
+#include <catboost/libs/data_new/packed_nibble_features.h>
 #include <catboost/libs/data_new/quantized_features_info.h>
 #include <catboost/libs/model/split.h>
 
@@ -115,6 +116,16 @@ public:
 };
 
 
+struct TNibbleSplitsPackRef {
+    ui32 PackIdx = std::numeric_limits<ui32>::max();
+
+public:
+    bool operator==(const TNibbleSplitsPackRef& other) const {
+        return PackIdx == other.PackIdx;
+    }
+};
+
+
 struct TExclusiveFeaturesBundleRef {
     ui32 BundleIdx = std::numeric_limits<ui32>::max();
 
@@ -128,7 +139,8 @@ public:
 enum class ESplitEnsembleType {
     OneFeature,
     BinarySplits,
-    ExclusiveBundle
+    ExclusiveBundle,
+    NibbleSplits
 };
 
 
@@ -141,9 +153,11 @@ struct TSplitEnsemble {
     TSplitCandidate SplitCandidate;
     TBinarySplitsPackRef BinarySplitsPackRef;
     TExclusiveFeaturesBundleRef ExclusiveFeaturesBundleRef;
+    TNibbleSplitsPackRef NibbleSplitsPackRef;
 
     static constexpr size_t BinarySplitsPackHash = 118223;
     static constexpr size_t ExclusiveBundleHash = 981490;
+    static constexpr size_t NibbleSplitsPackHash = 450361;
 
 public:
     TSplitEnsemble()
@@ -171,6 +185,14 @@ public:
         , ExclusiveFeaturesBundleRef(std::move(exclusiveFeaturesBundleRef))
     {}
 
+    /* move is not really needed for such a simple structure but do it in the same way as splitCandidate for
+     * consistency
+     */
+    explicit TSplitEnsemble(TNibbleSplitsPackRef&& nibbleSplitsPackRef)
+        : Type(ESplitEnsembleType::NibbleSplits)
+        , NibbleSplitsPackRef(std::move(nibbleSplitsPackRef))
+    {}
+
     bool operator==(const TSplitEnsemble& other) const {
         switch (Type) {
             case ESplitEnsembleType::OneFeature:
@@ -182,10 +204,13 @@ public:
             case ESplitEnsembleType::ExclusiveBundle:
                 return (other.Type == ESplitEnsembleType::ExclusiveBundle) &&
                     (ExclusiveFeaturesBundleRef == other.ExclusiveFeaturesBundleRef);
+            case ESplitEnsembleType::NibbleSplits:
+                return (other.Type == ESplitEnsembleType::NibbleSplits) &&
+                    (NibbleSplitsPackRef == other.NibbleSplitsPackRef);
         }
     }
 
-    SAVELOAD(Type, SplitCandidate, BinarySplitsPackRef, ExclusiveFeaturesBundleRef);
+    SAVELOAD(Type, SplitCandidate, BinarySplitsPackRef, ExclusiveFeaturesBundleRef, NibbleSplitsPackRef);
 
     size_t GetHash() const {
         switch (Type) {
@@ -195,6 +220,8 @@ public:
                 return MultiHash(BinarySplitsPackHash, BinarySplitsPackRef.PackIdx);
             case ESplitEnsembleType::ExclusiveBundle:
                 return MultiHash(ExclusiveBundleHash, ExclusiveFeaturesBundleRef.BundleIdx);
+            case ESplitEnsembleType::NibbleSplits:
+                return MultiHash(NibbleSplitsPackHash, NibbleSplitsPackRef.PackIdx);
         }
     }
 
@@ -216,6 +243,7 @@ struct TSplitEnsembleSpec {
 
     ESplitType OneSplitType; // used only if Type == OneFeature
     NCB::TExclusiveFeaturesBundle ExclusiveFeaturesBundle; // used only if Type == ExclusiveBundle
+    NCB::TNibbleFeaturesPackMetaData NibbleFeaturesPack; // used only if Type == NibbleSplits
 
 public:
     explicit TSplitEnsembleSpec(
@@ -230,7 +258,8 @@ public:
 
     TSplitEnsembleSpec(
         const TSplitEnsemble& splitEnsemble,
-        TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundles
+        TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundles,
+        TConstArrayRef<NCB::TNibbleFeaturesPackMetaData> nibbleFeaturesPacks
     )
         : Type(splitEnsemble.Type)
         , OneSplitType(splitEnsemble.SplitCandidate.Type)
@@ -238,10 +267,12 @@ public:
         if (Type == ESplitEnsembleType::ExclusiveBundle) {
             ExclusiveFeaturesBundle
                 = exclusiveFeaturesBundles[splitEnsemble.ExclusiveFeaturesBundleRef.BundleIdx];
+        } else if (Type == ESplitEnsembleType::NibbleSplits) {
+            NibbleFeaturesPack = nibbleFeaturesPacks[splitEnsemble.NibbleSplitsPackRef.PackIdx];
         }
     }
 
-    SAVELOAD(Type, OneSplitType, ExclusiveFeaturesBundle);
+    SAVELOAD(Type, OneSplitType, ExclusiveFeaturesBundle, NibbleFeaturesPack);
 
     bool operator==(const TSplitEnsembleSpec& other) const {
         switch (Type) {
@@ -252,6 +283,9 @@ public:
             case ESplitEnsembleType::ExclusiveBundle:
                 return (other.Type == ESplitEnsembleType::ExclusiveBundle) &&
                     (ExclusiveFeaturesBundle == other.ExclusiveFeaturesBundle);
+            case ESplitEnsembleType::NibbleSplits:
+                return (other.Type == ESplitEnsembleType::NibbleSplits) &&
+                    (NibbleFeaturesPack == other.NibbleFeaturesPack);
         }
     }
 
@@ -272,6 +306,12 @@ public:
             exclusiveFeaturesBundle
         );
     }
+
+    static TSplitEnsembleSpec NibbleSplitsPack(const NCB::TNibbleFeaturesPackMetaData& nibbleFeaturesPack) {
+        TSplitEnsembleSpec result(ESplitEnsembleType::NibbleSplits);
+        result.NibbleFeaturesPack = nibbleFeaturesPack;
+        return result;
+    }
 };
 
 
@@ -279,7 +319,8 @@ int GetBucketCount(
     const TSplitEnsemble& splitEnsemble,
     const NCB::TQuantizedFeaturesInfo& quantizedFeaturesInfo,
     size_t packedBinaryFeaturesCount,
-    TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundles
+    TConstArrayRef<NCB::TExclusiveFeaturesBundle> exclusiveFeaturesBundles,
+    TConstArrayRef<NCB::TNibbleFeaturesPackMetaData> nibbleFeaturesPacks
 );
 
 
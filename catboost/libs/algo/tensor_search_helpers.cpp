@@ -65,6 +65,32 @@ TSplit TCandidateInfo::GetBestSplit(
                 // keep compiler happy
                 return TSplit();
             }
+        case ESplitEnsembleType::NibbleSplits:
+            {
+                const auto packIdx = SplitEnsemble.NibbleSplitsPackRef.PackIdx;
+                const auto& binCounts = objectsData.GetNibbleFeaturesPacksMetaData()[packIdx].BinCounts;
+
+                ui32 binFeatureOffset = 0;
+                for (auto nibbleIdx : xrange(binCounts.size())) {
+                    const ui32 binFeatureSize = binCounts[nibbleIdx] - 1;
+                    const ui32 binInNibble = BestBinId - binFeatureOffset;
+
+                    if (binInNibble < binFeatureSize) {
+                        TSplitCandidate splitCandidate;
+                        splitCandidate.Type = ESplitType::FloatFeature;
+                        splitCandidate.FeatureIdx = objectsData.GetPackedNibbleFeatureSrcIndex(
+                            TPackedNibbleIndex(packIdx, nibbleIdx)
+                        );
+
+                        return TSplit(std::move(splitCandidate), binInNibble);
+                    }
+
+                    binFeatureOffset += binFeatureSize;
+                }
+                Y_FAIL("This should be unreachable");
+                // keep compiler happy
+                return TSplit();
+            }
     }
 }
 
@@ -485,6 +511,26 @@ void SetBestScore(
                     }
                 }
                 break;
+            case ESplitEnsembleType::NibbleSplits:
+                {
+                    const auto packIdx = subcandidateInfo.SplitEnsemble.NibbleSplitsPackRef.PackIdx;
+                    const auto nibbleFeaturesMask = candidatesContext.PerNibblePackMasks[packIdx];
+                    const auto& binCounts = candidatesContext.NibblePacksMetaData[packIdx].BinCounts;
+
+                    ui32 binFeatureOffset = 0;
+                    for (auto nibbleIdx : xrange(binCounts.size())) {
+                        const ui32 binFeatureSize = binCounts[nibbleIdx] - 1;
+                        if ((nibbleFeaturesMask >> nibbleIdx) & 1) {
+                            for (auto binFeatureIdx :
+                                 xrange(binFeatureOffset, binFeatureOffset + binFeatureSize))
+                            {
+                                scoreUpdateFunction(binFeatureIdx);
+                            }
+                        }
+                        binFeatureOffset += binFeatureSize;
+                    }
+                }
+                break;
         }
     }
 }
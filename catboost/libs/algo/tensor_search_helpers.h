@@ -11,6 +11,7 @@
 
 #include <catboost/libs/data_new/exclusive_feature_bundling.h>
 #include <catboost/libs/data_new/packed_binary_features.h>
+#include <catboost/libs/data_new/packed_nibble_features.h>
 #include <catboost/libs/options/enums.h>
 
 #include <library/binsaver/bin_saver.h>
@@ -58,10 +59,12 @@ using TCandidateList = TVector<TCandidatesInfoList>;
 struct TCandidatesContext {
     ui32 OneHotMaxSize; // needed to select for which categorical features in bundles to calc stats
     TConstArrayRef<NCB::TExclusiveFeaturesBundle> BundlesMetaData;
+    TConstArrayRef<NCB::TNibbleFeaturesPackMetaData> NibblePacksMetaData;
 
     TCandidateList CandidateList;
     TVector<TVector<ui32>> SelectedFeaturesInBundles; // [bundleIdx][inBundleIdx]
     TVector<NCB::TBinaryFeaturesPack> PerBinaryPackMasks;
+    TVector<ui8> PerNibblePackMasks; // [packIdx], bit nibbleIdx is set if the feature is selected
 };
 
 
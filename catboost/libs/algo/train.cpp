@@ -4,6 +4,7 @@
 #include "error_functions.h"
 #include "fold.h"
 #include "greedy_tensor_search.h"
+#include "helpers.h"
 #include "online_ctr.h"
 #include "tensor_search_helpers.h"
 
@@ -93,6 +94,8 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
 
         TrimOnlineCTRcache(trainFolds);
         TrimOnlineCTRcache({ &ctx->LearnProgress.AveragingFold });
+        // CTRs needed for the current tree are recomputed below
+        ctx->EvictOnlineCtrsIfOverRamLimit();
         {
             TVector<TFold*> allFolds = trainFolds;
             allFolds.push_back(&ctx->LearnProgress.AveragingFold);
@@ -172,6 +175,7 @@ void TrainOneIteration(const NCB::TTrainingForCPUDataProviders& data, TLearnCont
             );
 
             UpdateAvrgApprox(error->GetIsExpApprox(), data.Learn->GetObjectCount(), indices, treeValues, data.Test, &ctx->LearnProgress, ctx->LocalExecutor);
+            UpdateIncrementalMetrics(data, indices, treeValues, ctx);
         } else {
             if (ctx->LearnProgress.ApproxDimension == 1) {
                 MapSetApproxesSimple(*error, bestSplitTree, data.Test, &treeValues, &sumLeafWeights, ctx);
@@ -0,0 +1,176 @@
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/data_new/objects.h>
+#include <catboost/libs/data_new/quantization.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+static constexpr ui32 GroupSize = 10;
+
+
+// features with 2 to 16 distinct values are packed as nibbles, the last one has too many values
+static TRawDataProviderPtr CreateRawPool(ui32 objectCount, ui32 featureCount, bool hasGroups, ui64 seed) {
+    TFastRng<ui64> prng(seed);
+
+    TVector<TVector<float>> features(objectCount); // [objectIdx][featureIdx]
+    TVector<float> target(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        auto& objectFeatures = features[objectIdx];
+        objectFeatures.resize(featureCount);
+        float sum = 0.0f;
+        for (auto featureIdx : xrange(featureCount)) {
+            const ui32 valueCount = (featureIdx + 1 == featureCount) ? 100 : 2 + (featureIdx * 5) % 15;
+            objectFeatures[featureIdx] = float(prng.Uniform(valueCount));
+            sum += objectFeatures[featureIdx] * (featureIdx % 2 ? 1.0f : -0.5f);
+        }
+        target[objectIdx] = sum + float(prng.GenRandReal1());
+    }
+
+    TDataProviderPtr dataProvider = CreateDataProvider<IRawObjectsOrderDataVisitor>(
+        [&] (IRawObjectsOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.HasGroupId = hasGroups;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                featureCount,
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<TString>{}
+            );
+
+            visitor->Start(false, metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            for (auto objectIdx : xrange(objectCount)) {
+                if (hasGroups) {
+                    visitor->AddGroupId(objectIdx, objectIdx / GroupSize);
+                }
+                visitor->AddAllFloatFeatures(objectIdx, features[objectIdx]);
+                visitor->AddTarget(objectIdx, target[objectIdx]);
+            }
+
+            visitor->Finish();
+        }
+    );
+    return dataProvider->CastMoveTo<TRawObjectsDataProvider>();
+}
+
+static TDataProviderPtr QuantizePool(TRawDataProviderPtr rawData, bool packNibbleFeatures) {
+    TQuantizationOptions options;
+    options.GpuCompatibleFormat = false;
+    options.BundleExclusiveFeaturesForCpu = false;
+    options.PackNibbleFeaturesForCpu = packNibbleFeatures;
+
+    auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+        *rawData->MetaInfo.FeaturesLayout,
+        TConstArrayRef<ui32>(),
+        NCatboostOptions::TBinarizationOptions(EBorderSelectionType::GreedyLogSum, 32)
+    );
+
+    TRestorableFastRng64 rand(0);
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(3);
+
+    TQuantizedDataProviderPtr quantizedData = Quantize(
+        options,
+        std::move(rawData),
+        quantizedFeaturesInfo,
+        &rand,
+        &localExecutor
+    );
+
+    const auto& objectsData
+        = dynamic_cast<const TQuantizedForCPUObjectsDataProvider&>(*quantizedData->ObjectsData);
+    if (packNibbleFeatures) {
+        UNIT_ASSERT(objectsData.GetNibbleFeaturesPacksSize() > 0);
+    } else {
+        UNIT_ASSERT_VALUES_EQUAL(objectsData.GetNibbleFeaturesPacksSize(), 0);
+    }
+
+    return MakeIntrusive<TDataProvider>(
+        std::move(quantizedData->MetaInfo),
+        quantizedData->ObjectsData,
+        quantizedData->ObjectsGrouping,
+        std::move(quantizedData->RawTargetData)
+    );
+}
+
+static TFullModel Train(TDataProviderPtr data, const TString& lossFunction, const TString& boostingType) {
+    TTempDir trainDir;
+
+    NJson::TJsonValue params;
+    params.InsertValue("loss_function", lossFunction);
+    params.InsertValue("iterations", 20);
+    params.InsertValue("depth", 4);
+    params.InsertValue("random_seed", 1);
+    // score noise depends on the order of split candidates, and packed features are ordered differently
+    params.InsertValue("random_strength", 0.0);
+    params.InsertValue("boosting_type", boostingType);
+    params.InsertValue("thread_count", 4);
+    params.InsertValue("train_dir", trainDir.Name());
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = data;
+
+    TFullModel model;
+    TEvalResult evalResult;
+    TrainModel(params, nullptr, {}, {}, std::move(dataProviders), "", &model, {&evalResult});
+    return model;
+}
+
+static void AssertSameTrees(const TFullModel& model1, const TFullModel& model2) {
+    const auto& trees1 = model1.ObliviousTrees;
+    const auto& trees2 = model2.ObliviousTrees;
+
+    UNIT_ASSERT_EQUAL(trees1.TreeSizes, trees2.TreeSizes);
+    UNIT_ASSERT_EQUAL(trees1.TreeSplits, trees2.TreeSplits);
+
+    UNIT_ASSERT_VALUES_EQUAL(trees1.LeafValues.size(), trees2.LeafValues.size());
+    for (auto i : xrange(trees1.LeafValues.size())) {
+        UNIT_ASSERT_DOUBLES_EQUAL(trees1.LeafValues[i], trees2.LeafValues[i], 1e-9);
+    }
+}
+
+
+Y_UNIT_TEST_SUITE(PackedNibbleFeatures) {
+    Y_UNIT_TEST(TreesAreSameAsWithoutPacking) {
+        for (const TString boostingType : {"Plain", "Ordered"}) {
+            const TFullModel unpackedModel = Train(
+                QuantizePool(CreateRawPool(2000, 9, false, 20190515), false),
+                "RMSE",
+                boostingType
+            );
+            const TFullModel packedModel = Train(
+                QuantizePool(CreateRawPool(2000, 9, false, 20190515), true),
+                "RMSE",
+                boostingType
+            );
+            AssertSameTrees(packedModel, unpackedModel);
+        }
+    }
+
+    // pairwise scoring does not support nibble packs, so packed features are used as separate candidates
+    Y_UNIT_TEST(PairwiseScoringUsesPerFeatureCandidates) {
+        const TFullModel unpackedModel = Train(
+            QuantizePool(CreateRawPool(2000, 9, true, 20190516), false),
+            "YetiRankPairwise",
+            "Plain"
+        );
+        const TFullModel packedModel = Train(
+            QuantizePool(CreateRawPool(2000, 9, true, 20190516), true),
+            "YetiRankPairwise",
+            "Plain"
+        );
+        AssertSameTrees(packedModel, unpackedModel);
+    }
+}
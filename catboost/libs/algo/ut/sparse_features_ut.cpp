@@ -0,0 +1,132 @@
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+// mostly zero features with a few distinct integer values so borders are the same for both layouts
+static void GenerateData(
+    ui32 objectCount,
+    ui32 featureCount,
+    ui64 seed,
+    TVector<TVector<float>>* features, // [objectIdx][featureIdx]
+    TVector<float>* target
+) {
+    TFastRng<ui64> prng(seed);
+
+    features->resize(objectCount);
+    target->resize(objectCount);
+    for (auto objectIdx : xrange(objectCount)) {
+        auto& objectFeatures = (*features)[objectIdx];
+        objectFeatures.resize(featureCount);
+        float sum = 0.0f;
+        for (auto featureIdx : xrange(featureCount)) {
+            const bool isNonDefault = prng.GenRandReal1() < 0.1;
+            objectFeatures[featureIdx] = isNonDefault ? float(1 + prng.Uniform(5)) : 0.0f;
+            sum += objectFeatures[featureIdx] * (featureIdx % 2 ? 1.0f : -0.5f);
+        }
+        (*target)[objectIdx] = sum + float(prng.GenRandReal1());
+    }
+}
+
+static TDataProviderPtr CreateFloatPool(
+    const TVector<TVector<float>>& features,
+    const TVector<float>& target,
+    bool markFeaturesAsSparse
+) {
+    const ui32 objectCount = features.size();
+    const ui32 featureCount = features[0].size();
+
+    return CreateDataProvider<IRawObjectsOrderDataVisitor>(
+        [&] (IRawObjectsOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                featureCount,
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<TString>{}
+            );
+            if (markFeaturesAsSparse) {
+                for (auto featureIdx : xrange(featureCount)) {
+                    metaInfo.FeaturesLayout->MarkExternalFeatureAsSparse(featureIdx);
+                }
+            }
+
+            visitor->Start(false, metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            for (auto objectIdx : xrange(objectCount)) {
+                for (auto featureIdx : xrange(featureCount)) {
+                    visitor->AddFloatFeature(objectIdx, featureIdx, features[objectIdx][featureIdx]);
+                }
+                visitor->AddTarget(objectIdx, target[objectIdx]);
+            }
+
+            visitor->Finish();
+        }
+    );
+}
+
+static TFullModel Train(TDataProviderPtr data, const TString& boostingType) {
+    TTempDir trainDir;
+
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 20);
+    params.InsertValue("depth", 4);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("border_count", 32);
+    params.InsertValue("boosting_type", boostingType);
+    params.InsertValue("thread_count", 4);
+    params.InsertValue("train_dir", trainDir.Name());
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = data;
+
+    TFullModel model;
+    TEvalResult evalResult;
+    TrainModel(params, nullptr, {}, {}, std::move(dataProviders), "", &model, {&evalResult});
+    return model;
+}
+
+
+Y_UNIT_TEST_SUITE(SparseFeatures) {
+    Y_UNIT_TEST(SparseScoresAreSameAsDense) {
+        TVector<TVector<float>> features;
+        TVector<float> target;
+        GenerateData(2000, 8, 20190412, &features, &target);
+
+        for (const TString boostingType : {"Plain", "Ordered"}) {
+            const TFullModel denseModel = Train(CreateFloatPool(features, target, false), boostingType);
+            const TFullModel sparseModel = Train(CreateFloatPool(features, target, true), boostingType);
+
+            const auto& denseTrees = denseModel.ObliviousTrees;
+            const auto& sparseTrees = sparseModel.ObliviousTrees;
+
+            UNIT_ASSERT_VALUES_EQUAL(sparseTrees.FloatFeatures.size(), denseTrees.FloatFeatures.size());
+            for (auto featureIdx : xrange(denseTrees.FloatFeatures.size())) {
+                UNIT_ASSERT_EQUAL(
+                    sparseTrees.FloatFeatures[featureIdx].Borders,
+                    denseTrees.FloatFeatures[featureIdx].Borders
+                );
+            }
+
+            // same splits mean the same best scores were chosen for the sparse features
+            UNIT_ASSERT_EQUAL(sparseTrees.TreeSizes, denseTrees.TreeSizes);
+            UNIT_ASSERT_EQUAL(sparseTrees.TreeSplits, denseTrees.TreeSplits);
+
+            UNIT_ASSERT_VALUES_EQUAL(sparseTrees.LeafValues.size(), denseTrees.LeafValues.size());
+            for (auto i : xrange(denseTrees.LeafValues.size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL(sparseTrees.LeafValues[i], denseTrees.LeafValues[i], 1e-9);
+            }
+        }
+    }
+}
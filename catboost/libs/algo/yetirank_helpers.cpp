@@ -3,8 +3,24 @@
 
 #include <catboost/libs/data_types/pair.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/vector.h>
 
+namespace {
+    // Buffers reused by all queries of a block to avoid allocations per query and permutation
+    struct TYetiRankPairsBuffers {
+        TVector<int> Indices;
+        TVector<double> BootstrappedApprox;
+        TVector<float> CompetitorsWeights; // [winnerIndex * querySize + loserIndex]
+
+        void Resize(ui32 querySize) {
+            Indices.yresize(querySize);
+            BootstrappedApprox.yresize(querySize);
+            CompetitorsWeights.assign(static_cast<size_t>(querySize) * querySize, 0.0f);
+        }
+    };
+}
+
 static void GenerateYetiRankPairsForQuery(
     const float* relevs,
     const double* expApproxes,
@@ -13,6 +29,7 @@ static void GenerateYetiRankPairsForQuery(
     int permutationCount,
     double decaySpeed,
     ui64 randomSeed,
+    TYetiRankPairsBuffers* buffers,
     TVector<TVector<TCompetitor>>* competitors
 ) {
     TFastRng64 rand(randomSeed);
@@ -20,15 +37,16 @@ static void GenerateYetiRankPairsForQuery(
     competitorsRef.clear();
     competitorsRef.resize(querySize);
 
-    TVector<int> indices(querySize);
-    TVector<TVector<float>> competitorsWeights(querySize, TVector<float>(querySize));
+    buffers->Resize(querySize);
+    TVector<int>& indices = buffers->Indices;
+    TVector<double>& bootstrappedApprox = buffers->BootstrappedApprox;
+    float* competitorsWeights = buffers->CompetitorsWeights.data();
     for (int permutationIndex = 0; permutationIndex < permutationCount; ++permutationIndex) {
         std::iota(indices.begin(), indices.end(), 0);
-        TVector<double> bootstrappedApprox(expApproxes, expApproxes + querySize);
         for (ui32 docId = 0; docId < querySize; ++docId) {
             const float uniformValue = rand.GenRandReal1();
             // TODO(nikitxskv): try to experiment with different bootstraps.
-            bootstrappedApprox[docId] *= uniformValue / (1.000001f - uniformValue);
+            bootstrappedApprox[docId] = expApproxes[docId] * (uniformValue / (1.000001f - uniformValue));
         }
 
         Sort(indices, [&](int i, int j) {
@@ -43,18 +61,25 @@ static void GenerateYetiRankPairsForQuery(
 
             const float pairWeight = magicConst * decayCoefficient * Abs(relevs[firstCandidate] - relevs[secondCandidate]);
             if (relevs[firstCandidate] > relevs[secondCandidate]) {
-                competitorsWeights[firstCandidate][secondCandidate] += pairWeight;
+                competitorsWeights[static_cast<size_t>(firstCandidate) * querySize + secondCandidate] += pairWeight;
             } else if (relevs[firstCandidate] < relevs[secondCandidate]) {
-                competitorsWeights[secondCandidate][firstCandidate] += pairWeight;
+                competitorsWeights[static_cast<size_t>(secondCandidate) * querySize + firstCandidate] += pairWeight;
             }
             decayCoefficient *= decaySpeed;
         }
     }
 
-    // TODO(nikitxskv): Can be optimized
     for (ui32 winnerIndex = 0; winnerIndex < querySize; ++winnerIndex) {
+        const float* winnerWeights = competitorsWeights + static_cast<size_t>(winnerIndex) * querySize;
+        const ui32 competitorCount = CountIf(winnerWeights, winnerWeights + querySize, [] (float weight) {
+            return weight != 0;
+        });
+        if (competitorCount == 0) {
+            continue;
+        }
+        competitorsRef[winnerIndex].reserve(competitorCount);
         for (ui32 loserIndex = 0; loserIndex < querySize; ++loserIndex) {
-            const float competitorsWeight = queryWeight * competitorsWeights[winnerIndex][loserIndex] / permutationCount;
+            const float competitorsWeight = queryWeight * winnerWeights[loserIndex] / permutationCount;
             if (competitorsWeight != 0) {
                 competitorsRef[winnerIndex].push_back({loserIndex, competitorsWeight});
             }
@@ -81,6 +106,7 @@ void UpdatePairsForYetiRank(
     const TVector<ui64> randomSeeds = GenRandUI64Vector(blockCount, randomSeed);
     NPar::ParallelFor(*localExecutor, 0, blockCount, [&](int blockId) {
         TFastRng64 rand(randomSeeds[blockId]);
+        TYetiRankPairsBuffers buffers;
         const int from = blockId * blockSize;
         const int to = Min<int>((blockId + 1) * blockSize, queryInfoSize);
         for (int queryIndex = from; queryIndex < to; ++queryIndex) {
@@ -93,6 +119,7 @@ void UpdatePairsForYetiRank(
                 permutationCount,
                 decaySpeed,
                 rand.GenRand(),
+                &buffers,
                 &queryInfoRef.Competitors
             );
         }
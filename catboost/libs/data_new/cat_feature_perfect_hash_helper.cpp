@@ -2,8 +2,14 @@
 
 #include "util.h"
 
+#include <catboost/libs/helpers/math_utils.h>
+
+#include <util/digest/numeric.h>
 #include <util/system/guard.h>
 #include <util/system/yassert.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/hash.h>
 #include <util/generic/map.h>
 
 #include <util/generic/ylimits.h>
@@ -13,11 +19,176 @@
 
 namespace NCB {
 
+    // use sequential implementation for smaller data, parallel one does not pay off
+    constexpr ui32 MIN_OBJECT_COUNT_FOR_PARALLEL_PERFECT_HASH = 100000;
+
+    namespace {
+        struct TBlockValueStats {
+            ui32 FirstIdx; // in hashedCatArraySubset
+            ui32 Count;
+        };
+
+        struct TValueStats {
+            ui32 FirstIdx; // in hashedCatArraySubset
+            ui32 Count;
+            ui32 Bin;
+        };
+    }
+
+    static ui32 GetShardIdx(ui32 hashedCatValue, ui32 shardCount) {
+        return IntHash(hashedCatValue) % shardCount;
+    }
+
+    /* Values are counted in blocks of objects in parallel, per-block counts are split into shards by value
+     * and merged per shard in parallel.
+     * New values are then renumbered in the order of their first appearance, so the result is the same as
+     * for the sequential implementation.
+     */
+    static void UpdatePerfectHashAndMaybeQuantizeParallel(
+        const TCatFeatureIdx catFeatureIdx,
+        const TMaybeOwningConstArraySubset<ui32, ui32>& hashedCatArraySubset,
+        size_t maxUniqValuesCount,
+        TMaybe<TArrayRef<ui32>> dstBins,
+        NPar::TLocalExecutor* localExecutor,
+        TCatFeaturePerfectHash* perfectHashMap
+    ) {
+        const auto& subsetIndexing = *hashedCatArraySubset.GetSubsetIndexing();
+        const auto& src = *hashedCatArraySubset.GetSrc();
+
+        const ui32 threadCount = SafeIntegerCast<ui32>(localExecutor->GetThreadCount()) + 1;
+        const ui32 shardCount = threadCount;
+        const TSimpleIndexRangesGenerator<ui32> parallelUnitRanges
+            = subsetIndexing.GetParallelUnitRanges(CeilDiv(subsetIndexing.Size(), threadCount));
+        const int blockCount = SafeIntegerCast<int>(parallelUnitRanges.RangesCount());
+
+        // [blockIdx][shardIdx]
+        TVector<TVector<THashMap<ui32, TBlockValueStats>>> blockShardsStats(blockCount);
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                auto& shardsStats = blockShardsStats[blockIdx];
+                shardsStats.resize(shardCount);
+                subsetIndexing.ForEachInSubRange(
+                    parallelUnitRanges.GetRange(blockIdx),
+                    [&] (ui32 idx, ui32 srcIdx) {
+                        const ui32 hashedCatValue = src[srcIdx];
+                        auto& shardStats = shardsStats[GetShardIdx(hashedCatValue, shardCount)];
+                        auto it = shardStats.find(hashedCatValue);
+                        if (it == shardStats.end()) {
+                            shardStats.emplace(hashedCatValue, TBlockValueStats{idx, 1});
+                        } else {
+                            ++(it->second.Count);
+                        }
+                    }
+                );
+            },
+            0,
+            blockCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        // [shardIdx]
+        TVector<THashMap<ui32, TValueStats>> shardsStats(shardCount);
+
+        // (FirstIdx, hashedCatValue) for values not present in perfectHashMap yet, [shardIdx]
+        TVector<TVector<std::pair<ui32, ui32>>> shardsNewValues(shardCount);
+
+        localExecutor->ExecRangeWithThrow(
+            [&] (int shardIdx) {
+                auto& shardStats = shardsStats[shardIdx];
+
+                // blocks are ordered by object indices so the first FirstIdx seen for the value is minimal
+                for (auto& shardsBlockStats : blockShardsStats) {
+                    for (const auto& [hashedCatValue, blockValueStats] : shardsBlockStats[shardIdx]) {
+                        auto it = shardStats.find(hashedCatValue);
+                        if (it == shardStats.end()) {
+                            shardStats.emplace(
+                                hashedCatValue,
+                                TValueStats{blockValueStats.FirstIdx, blockValueStats.Count, 0}
+                            );
+                        } else {
+                            it->second.Count += blockValueStats.Count;
+                        }
+                    }
+                    THashMap<ui32, TBlockValueStats>().swap(shardsBlockStats[shardIdx]); // free memory early
+                }
+
+                /* perfectHashMap structure is not modified here, only counts of the existing values,
+                 * shards contain different values, so this is thread-safe
+                 */
+                auto& shardNewValues = shardsNewValues[shardIdx];
+                for (auto& [hashedCatValue, valueStats] : shardStats) {
+                    auto it = perfectHashMap->find(hashedCatValue);
+                    if (it == perfectHashMap->end()) {
+                        shardNewValues.emplace_back(valueStats.FirstIdx, hashedCatValue);
+                    } else {
+                        valueStats.Bin = it->second.Value;
+                        it->second.Count += valueStats.Count;
+                    }
+                }
+            },
+            0,
+            SafeIntegerCast<int>(shardCount),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        TVector<TVector<THashMap<ui32, TBlockValueStats>>>().swap(blockShardsStats);
+
+        // deterministic renumbering: new values get bins in the order of their first appearance
+        TVector<std::pair<ui32, ui32>> newValues;
+        {
+            size_t newValuesCount = 0;
+            for (const auto& shardNewValues : shardsNewValues) {
+                newValuesCount += shardNewValues.size();
+            }
+            CB_ENSURE(
+                perfectHashMap->size() + newValuesCount <= maxUniqValuesCount,
+                "Error: categorical feature with id #" << *catFeatureIdx
+                << " has more than " << maxUniqValuesCount
+                << " unique values, which is currently unsupported"
+            );
+
+            newValues.reserve(newValuesCount);
+            for (auto& shardNewValues : shardsNewValues) {
+                newValues.insert(newValues.end(), shardNewValues.begin(), shardNewValues.end());
+                TVector<std::pair<ui32, ui32>>().swap(shardNewValues);
+            }
+        }
+        Sort(newValues);
+
+        ui32 bin = (ui32)perfectHashMap->size();
+        for (auto [firstIdx, hashedCatValue] : newValues) {
+            Y_UNUSED(firstIdx);
+            auto& valueStats = shardsStats[GetShardIdx(hashedCatValue, shardCount)].at(hashedCatValue);
+            valueStats.Bin = bin;
+            perfectHashMap->emplace(hashedCatValue, TValueWithCount{bin, valueStats.Count});
+            ++bin;
+        }
+
+        if (dstBins) {
+            localExecutor->ExecRangeWithThrow(
+                [&] (int blockIdx) {
+                    subsetIndexing.ForEachInSubRange(
+                        parallelUnitRanges.GetRange(blockIdx),
+                        [&] (ui32 idx, ui32 srcIdx) {
+                            const ui32 hashedCatValue = src[srcIdx];
+                            const auto& shardStats = shardsStats[GetShardIdx(hashedCatValue, shardCount)];
+                            (*dstBins)[idx] = shardStats.find(hashedCatValue)->second.Bin;
+                        }
+                    );
+                },
+                0,
+                blockCount,
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+        }
+    }
+
     void TCatFeaturesPerfectHashHelper::UpdatePerfectHashAndMaybeQuantize(
         const TCatFeatureIdx catFeatureIdx,
         TMaybeOwningConstArraySubset<ui32, ui32> hashedCatArraySubset,
         bool mapMostFrequentValueTo0,
-        TMaybe<TArrayRef<ui32>*> dstBins
+        TMaybe<TArrayRef<ui32>*> dstBins,
+        TMaybe<NPar::TLocalExecutor*> localExecutor
     ) {
         QuantizedFeaturesInfo->CheckCorrectPerTypeFeatureIdx(catFeatureIdx);
         auto& featuresHash = QuantizedFeaturesInfo->CatFeaturesPerfectHash;
@@ -50,29 +221,43 @@ namespace NCB {
         constexpr size_t MAX_UNIQ_CAT_VALUES =
             static_cast<size_t>(Max<ui32>()) + ((sizeof(size_t) > sizeof(ui32)) ? 1 : 0);
 
-        hashedCatArraySubset.ForEach(
-            [&] (ui32 idx, ui32 hashedCatValue) {
-                auto it = perfectHashMap.find(hashedCatValue);
-                if (it == perfectHashMap.end()) {
-                    CB_ENSURE(
-                        perfectHashMap.size() != MAX_UNIQ_CAT_VALUES,
-                        "Error: categorical feature with id #" << *catFeatureIdx
-                        << " has more than " << MAX_UNIQ_CAT_VALUES
-                        << " unique values, which is currently unsupported"
-                    );
-                    ui32 bin = (ui32)perfectHashMap.size();
-                    if (dstBins) {
-                        dstBinsValue[idx] = bin;
-                    }
-                    perfectHashMap.emplace_hint(it, hashedCatValue, TValueWithCount{bin, 1});
-                } else {
-                    if (dstBins) {
-                        dstBinsValue[idx] = it->second.Value;
+        if (localExecutor.Defined()
+            && ((*localExecutor)->GetThreadCount() > 0)
+            && (hashedCatArraySubset.Size() >= MIN_OBJECT_COUNT_FOR_PARALLEL_PERFECT_HASH))
+        {
+            UpdatePerfectHashAndMaybeQuantizeParallel(
+                catFeatureIdx,
+                hashedCatArraySubset,
+                MAX_UNIQ_CAT_VALUES,
+                dstBins ? TMaybe<TArrayRef<ui32>>(dstBinsValue) : Nothing(),
+                *localExecutor,
+                &perfectHashMap
+            );
+        } else {
+            hashedCatArraySubset.ForEach(
+                [&] (ui32 idx, ui32 hashedCatValue) {
+                    auto it = perfectHashMap.find(hashedCatValue);
+                    if (it == perfectHashMap.end()) {
+                        CB_ENSURE(
+                            perfectHashMap.size() != MAX_UNIQ_CAT_VALUES,
+                            "Error: categorical feature with id #" << *catFeatureIdx
+                            << " has more than " << MAX_UNIQ_CAT_VALUES
+                            << " unique values, which is currently unsupported"
+                        );
+                        ui32 bin = (ui32)perfectHashMap.size();
+                        if (dstBins) {
+                            dstBinsValue[idx] = bin;
+                        }
+                        perfectHashMap.emplace_hint(it, hashedCatValue, TValueWithCount{bin, 1});
+                    } else {
+                        if (dstBins) {
+                            dstBinsValue[idx] = it->second.Value;
+                        }
+                        ++(it->second.Count);
                     }
-                    ++(it->second.Count);
                 }
-            }
-        );
+            );
+        }
 
         if (mapMostFrequentValueTo0 && !perfectHashMap.empty()) {
             auto iter = perfectHashMap.begin();
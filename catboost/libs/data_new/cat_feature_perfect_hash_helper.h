@@ -4,6 +4,8 @@
 
 #include <catboost/libs/helpers/array_subset.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/array_ref.h>
 #include <util/generic/maybe.h>
 #include <util/generic/ptr.h>
@@ -25,12 +27,18 @@ namespace NCB {
             return QuantizedFeaturesInfo->CatFeaturesPerfectHash.GetUniqueValuesCounts(catFeatureIdx);
         }
 
-        // thread-safe w.r.t. QuantizedFeaturesInfo
+        /* thread-safe w.r.t. QuantizedFeaturesInfo
+         *
+         * if localExecutor is defined and data is big enough, blocks of objects are processed in parallel,
+         * results (bins assigned in the order of the first appearance of values) are the same as for
+         * the sequential implementation
+         */
         void UpdatePerfectHashAndMaybeQuantize(
             const TCatFeatureIdx catFeatureIdx,
             TMaybeOwningConstArraySubset<ui32, ui32> hashedCatArraySubset,
             bool mapMostFrequentValueTo0,
-            TMaybe<TArrayRef<ui32>*> dstBins
+            TMaybe<TArrayRef<ui32>*> dstBins,
+            TMaybe<NPar::TLocalExecutor*> localExecutor = Nothing()
         );
 
     private:
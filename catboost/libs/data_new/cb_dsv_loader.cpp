@@ -21,7 +21,11 @@ namespace NCB {
     TCBDsvDataLoader::TCBDsvDataLoader(TDatasetLoaderPullArgs&& args)
         : TCBDsvDataLoader(
             TLineDataLoaderPushArgs {
-                GetLineDataReader(args.PoolPath, args.CommonArgs.PoolFormat),
+                GetLineDataReader(
+                    args.PoolPath,
+                    args.CommonArgs.PoolFormat,
+                    args.CommonArgs.LocalExecutor->GetThreadCount() + 1
+                ),
                 std::move(args.CommonArgs)
             }
         )
@@ -238,6 +242,11 @@ namespace NCB {
     namespace {
         TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> DefDataLoaderReg("");
         TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvDataLoaderReg("dsv");
+
+        // dsv data compressed with gzip, zstd or lz4
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvGzipDataLoaderReg("gz");
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvZstdDataLoaderReg("zstd");
+        TDatasetLoaderFactory::TRegistrator<TCBDsvDataLoader> CBDsvLz4DataLoaderReg("lz4");
     }
 }
 
@@ -1 +1,19 @@
 #include "columns.h"
+
+#include <util/generic/ylimits.h>
+
+
+TVector<ui32> NCB::GetInverseSubsetIndexing(const TFeaturesArraySubsetIndexing& subsetIndexing, ui32 srcSize) {
+    TVector<ui32> srcToSubsetIndices(srcSize, Max<ui32>());
+    subsetIndexing.ForEach(
+        [&] (ui32 idx, ui32 srcIdx) {
+            CB_ENSURE_INTERNAL(srcIdx < srcSize, "src index " << srcIdx << " is out of range");
+            CB_ENSURE(
+                srcToSubsetIndices[srcIdx] == Max<ui32>(),
+                "Subsets with repeated objects are not supported for sparse features"
+            );
+            srcToSubsetIndices[srcIdx] = idx;
+        }
+    );
+    return srcToSubsetIndices;
+}
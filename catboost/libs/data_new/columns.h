@@ -3,19 +3,25 @@
 #include "exclusive_feature_bundling.h"
 #include "features_layout.h"
 #include "packed_binary_features.h"
+#include "packed_nibble_features.h"
 
 #include <catboost/libs/helpers/array_subset.h>
 #include <catboost/libs/helpers/compression.h>
 #include <catboost/libs/helpers/maybe_owning_array_holder.h>
+#include <catboost/libs/helpers/sparse_array.h>
 
 #include <library/threading/local_executor/local_executor.h>
 
 #include <util/system/types.h>
+#include <util/generic/maybe.h>
 #include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
 #include <util/generic/yexception.h>
 #include <util/stream/buffer.h>
+#include <util/system/guard.h>
+#include <util/system/spinlock.h>
 #include <util/system/yassert.h>
 
 #include <climits>
@@ -42,6 +48,14 @@ namespace NCB {
     template <class T>
     using TConstPtrArraySubset = TArraySubset<const T*, ui32>;
 
+    template <class T>
+    using TConstSparseArrayPtr = TAtomicSharedPtr<const TSparseArray<T, ui32>>;
+
+    /* returns map from src indices to indices in subset, Max<ui32>() for src indices not present in subset
+     * subsets with repeated src indices are not supported
+     */
+    TVector<ui32> GetInverseSubsetIndexing(const TFeaturesArraySubsetIndexing& subsetIndexing, ui32 srcSize);
+
     class IFeatureValuesHolder: TMoveOnly {
     public:
         virtual ~IFeatureValuesHolder() = default;
@@ -106,6 +120,9 @@ namespace NCB {
      * Raw data
      */
 
+    /* values are stored either densely or as a sparse array (only non-default values are stored)
+     * in both cases src data is indexed by src indices and SubsetIndexing is applied on top of it
+     */
     template <class T, EFeatureValuesType TType>
     class TArrayValuesHolder: public IFeatureValuesHolder {
     public:
@@ -121,12 +138,84 @@ namespace NCB {
             CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
         }
 
+        TArrayValuesHolder(ui32 featureId,
+                           TConstSparseArrayPtr<T> sparseSrcData,
+                           const TFeaturesArraySubsetIndexing* subsetIndexing)
+            : IFeatureValuesHolder(TType,
+                                   featureId,
+                                   subsetIndexing->Size())
+            , SparseSrcData(std::move(sparseSrcData))
+            , SubsetIndexing(subsetIndexing)
+        {
+            CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
+            CB_ENSURE_INTERNAL(SparseSrcData, "sparseSrcData is empty");
+        }
+
+        bool IsSparse() const {
+            return SparseSrcData.Get() != nullptr;
+        }
+
         const TMaybeOwningConstArraySubset<T, ui32> GetArrayData() const {
+            CB_ENSURE_INTERNAL(!IsSparse(), "Feature #" << GetId() << " is sparse, array data is not available");
             return {&SrcData, SubsetIndexing};
         }
 
+        const TMaybeOwningConstArrayHolder<T>& GetSrcData() const {
+            CB_ENSURE_INTERNAL(!IsSparse(), "Feature #" << GetId() << " is sparse, array data is not available");
+            return SrcData;
+        }
+
+        const TConstSparseArrayPtr<T>& GetSparseSrcData() const {
+            CB_ENSURE_INTERNAL(IsSparse(), "Feature #" << GetId() << " is not sparse");
+            return SparseSrcData;
+        }
+
+        const TFeaturesArraySubsetIndexing* GetSubsetIndexing() const {
+            return SubsetIndexing;
+        }
+
+        /* f is called with (idx, value) for non-default values only, idx is an index in subset
+         * srcToSubsetIndices is a result of GetInverseSubsetIndexing for SubsetIndexing,
+         *  it can be empty if SubsetIndexing is a full subset
+         */
+        template <class F>
+        void ForEachNonDefault(F&& f, TConstArrayRef<ui32> srcToSubsetIndices = {}) const {
+            if (srcToSubsetIndices.empty()) {
+                CB_ENSURE_INTERNAL(
+                    HoldsAlternative<TFullSubset<ui32>>(*SubsetIndexing),
+                    "srcToSubsetIndices must be specified for non-full subsets"
+                );
+                GetSparseSrcData()->ForEachNonDefault(f);
+            } else {
+                GetSparseSrcData()->ForEachNonDefault(
+                    [&] (ui32 srcIdx, T value) {
+                        const ui32 idx = srcToSubsetIndices[srcIdx];
+                        if (idx != Max<ui32>()) {
+                            f(idx, value);
+                        }
+                    }
+                );
+            }
+        }
+
+        // dense values in subset order, for both dense and sparse storage
+        TMaybeOwningConstArrayHolder<T> ExtractValues(NPar::TLocalExecutor* localExecutor) const {
+            TVector<T> dst;
+            if (IsSparse()) {
+                TVector<T> srcValues = SparseSrcData->ExtractValues();
+                if (HoldsAlternative<TFullSubset<ui32>>(*SubsetIndexing)) {
+                    return TMaybeOwningConstArrayHolder<T>::CreateOwning(std::move(srcValues));
+                }
+                dst = ::NCB::GetSubset<T>(srcValues, *SubsetIndexing, localExecutor);
+            } else {
+                dst = ::NCB::GetSubset<T>(*SrcData, *SubsetIndexing, localExecutor);
+            }
+            return TMaybeOwningConstArrayHolder<T>::CreateOwning(std::move(dst));
+        }
+
     private:
         TMaybeOwningConstArrayHolder<T> SrcData;
+        TConstSparseArrayPtr<T> SparseSrcData; // not null if feature is stored as sparse
         const TFeaturesArraySubsetIndexing* SubsetIndexing;
     };
 
@@ -289,6 +378,82 @@ namespace NCB {
         const TFeaturesArraySubsetIndexing* SubsetIndexing;
     };
 
+    template <class TBase>
+    class TPackedNibbleValuesHolderImpl : public TBase {
+    public:
+        TPackedNibbleValuesHolderImpl(ui32 featureId,
+                                      NCB::TMaybeOwningArrayHolder<NCB::TNibbleFeaturesPack> srcData,
+                                      ui8 nibbleIdx,
+                                      const TFeaturesArraySubsetIndexing* subsetIndexing)
+            : TBase(featureId, subsetIndexing->Size())
+            , SrcData(std::move(srcData))
+            , NibbleIdx(nibbleIdx)
+            , SubsetIndexing(subsetIndexing)
+        {
+            NCB::CheckNibbleIdx(NibbleIdx);
+            CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
+        }
+
+        THolder<TBase> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const override {
+            return MakeHolder<TPackedNibbleValuesHolderImpl>(
+                TBase::GetId(),
+                SrcData,
+                NibbleIdx,
+                subsetIndexing
+            );
+        }
+
+        // in some cases non-standard T can be useful / more efficient
+        template <class T = typename TBase::TValueType>
+        TMaybeOwningArrayHolder<T> ExtractValuesT(NPar::TLocalExecutor* localExecutor) const {
+            TConstArrayRef<NCB::TNibbleFeaturesPack> srcData = *SrcData;
+
+            TVector<T> dst;
+            dst.yresize(SubsetIndexing->Size());
+
+            SubsetIndexing->ParallelForEach(
+                [&dst, srcData, nibbleIdx = NibbleIdx] (ui32 idx, ui32 srcDataIdx) {
+                    dst[idx] = NCB::GetNibbleFromPack(srcData[srcDataIdx], nibbleIdx);
+                },
+                localExecutor
+            );
+
+            return TMaybeOwningArrayHolder<T>::CreateOwning(std::move(dst));
+        }
+
+        TMaybeOwningArrayHolder<typename TBase::TValueType> ExtractValues(
+            NPar::TLocalExecutor* localExecutor
+        ) const override {
+            return ExtractValuesT<typename TBase::TValueType>(localExecutor);
+        }
+
+        template<class F>
+        void ForEach(F&& f, const NCB::TFeaturesArraySubsetIndexing* featuresSubsetIndexing = nullptr) const {
+            if (!featuresSubsetIndexing) {
+                featuresSubsetIndexing = SubsetIndexing;
+            }
+            NCB::TArraySubset<const NCB::TMaybeOwningArrayHolder<NCB::TNibbleFeaturesPack>, ui32>(
+                &SrcData,
+                featuresSubsetIndexing
+            ).ForEach(
+                [nibbleIdx = NibbleIdx, f = std::move(f)] (ui32 i, NCB::TNibbleFeaturesPack featuresPack) {
+                    f(i, NCB::GetNibbleFromPack(featuresPack, nibbleIdx));
+                }
+            );
+        }
+
+        ui8 GetNibbleIdx() const {
+            return NibbleIdx;
+        }
+
+    private:
+        NCB::TMaybeOwningArrayHolder<NCB::TNibbleFeaturesPack> SrcData;
+        ui8 NibbleIdx;
+        const TFeaturesArraySubsetIndexing* SubsetIndexing;
+    };
+
     template <class TBase>
     class TBundlePartValuesHolderImpl : public TBase {
     public:
@@ -304,10 +469,10 @@ namespace NCB {
             , SubsetIndexing(subsetIndexing)
         {
             CB_ENSURE_INTERNAL(
-                (BundleSizeInBytes == 1) || (BundleSizeInBytes == 2),
+                (BundleSizeInBytes == 1) || (BundleSizeInBytes == 2) || (BundleSizeInBytes == 4),
                 "Unsupported BundleSizeInBytes=" << BundleSizeInBytes
             );
-            const ui32 maxBound = ui32(1) << (CHAR_BIT * bundleSizeInBytes);
+            const ui64 maxBound = ui64(1) << (CHAR_BIT * bundleSizeInBytes);
             CB_ENSURE_INTERNAL(
                 (boundsInBundle.Begin < boundsInBundle.End),
                 "boundsInBundle [" << boundsInBundle.Begin << ',' << boundsInBundle.End
@@ -351,6 +516,9 @@ namespace NCB {
                 case 2:
                     extractFunction((ui16*)(*SrcData).data());
                     break;
+                case 4:
+                    extractFunction((ui32*)(*SrcData).data());
+                    break;
                 default:
                     Y_FAIL("Unsupported BundleSizeInBytes");
             }
@@ -379,6 +547,97 @@ namespace NCB {
         const TFeaturesArraySubsetIndexing* SubsetIndexing;
     };
 
+    /* only non-default bins are stored, indexed by src indices as in other holders
+     * used for features with low density of non-default values
+     */
+    template <class TBase>
+    class TSparseValuesHolderImpl : public TBase {
+    public:
+        using TValueType = typename TBase::TValueType;
+
+    public:
+        TSparseValuesHolderImpl(ui32 featureId,
+                                TConstSparseArrayPtr<TValueType> srcData,
+                                const TFeaturesArraySubsetIndexing* subsetIndexing)
+            : TBase(featureId, subsetIndexing->Size())
+            , SrcData(std::move(srcData))
+            , SubsetIndexing(subsetIndexing)
+        {
+            CB_ENSURE_INTERNAL(SrcData, "srcData is empty");
+            CB_ENSURE(SubsetIndexing, "subsetIndexing is empty");
+        }
+
+        THolder<TBase> CloneWithNewSubsetIndexing(
+            const TFeaturesArraySubsetIndexing* subsetIndexing
+        ) const override {
+            return MakeHolder<TSparseValuesHolderImpl>(TBase::GetId(), SrcData, subsetIndexing);
+        }
+
+        const TConstSparseArrayPtr<TValueType>& GetSparseSrcData() const {
+            return SrcData;
+        }
+
+        TValueType GetDefaultBin() const {
+            return SrcData->GetDefaultValue();
+        }
+
+        const TFeaturesArraySubsetIndexing* GetSubsetIndexing() const {
+            return SubsetIndexing;
+        }
+
+        // in some cases non-standard T can be useful / more efficient
+        template <class T = TValueType>
+        TMaybeOwningArrayHolder<T> ExtractValuesT(NPar::TLocalExecutor* localExecutor) const {
+            TVector<T> dst;
+            dst.yresize(SubsetIndexing->Size());
+            const TVector<TValueType> srcValues = SrcData->ExtractValues();
+            SubsetIndexing->ParallelForEach(
+                [&dst, &srcValues] (ui32 idx, ui32 srcDataIdx) {
+                    dst[idx] = srcValues[srcDataIdx];
+                },
+                localExecutor
+            );
+            return TMaybeOwningArrayHolder<T>::CreateOwning(std::move(dst));
+        }
+
+        TMaybeOwningArrayHolder<TValueType> ExtractValues(
+            NPar::TLocalExecutor* localExecutor
+        ) const override {
+            return ExtractValuesT<TValueType>(localExecutor);
+        }
+
+        /* densified src data, calculated on first call and cached
+         * for code paths that need random access by src indices (model application)
+         */
+        const TValueType* GetDenseSrcData() const {
+            with_lock (DenseSrcDataLock) {
+                if (!DenseSrcData) {
+                    DenseSrcData = SrcData->ExtractValues();
+                }
+            }
+            return DenseSrcData->data();
+        }
+
+        // densifies values, prefer iteration over GetSparseSrcData() where possible
+        template <class F>
+        void ForEach(F&& f, const NCB::TFeaturesArraySubsetIndexing* featuresSubsetIndexing = nullptr) const {
+            if (!featuresSubsetIndexing) {
+                featuresSubsetIndexing = SubsetIndexing;
+            }
+            const TVector<TValueType> srcValues = SrcData->ExtractValues();
+            TArraySubset<const TVector<TValueType>, ui32>(&srcValues, featuresSubsetIndexing).ForEach(
+                std::move(f)
+            );
+        }
+
+    private:
+        TConstSparseArrayPtr<TValueType> SrcData;
+        const TFeaturesArraySubsetIndexing* SubsetIndexing;
+
+        mutable TAdaptiveLock DenseSrcDataLock;
+        mutable TMaybe<TVector<TValueType>> DenseSrcData;
+    };
+
 
     /* interface instead of concrete TQuantizedFloatValuesHolder because there is
      * an alternative implementation TExternalFloatValuesHolder for GPU
@@ -411,7 +670,9 @@ namespace NCB {
 
     using TQuantizedFloatValuesHolder = TCompressedValuesHolderImpl<IQuantizedFloatValuesHolder>;
     using TQuantizedFloatPackedBinaryValuesHolder = TPackedBinaryValuesHolderImpl<IQuantizedFloatValuesHolder>;
+    using TQuantizedFloatPackedNibbleValuesHolder = TPackedNibbleValuesHolderImpl<IQuantizedFloatValuesHolder>;
     using TQuantizedFloatBundlePartValuesHolder = TBundlePartValuesHolderImpl<IQuantizedFloatValuesHolder>;
+    using TQuantizedFloatSparseValuesHolder = TSparseValuesHolderImpl<IQuantizedFloatValuesHolder>;
 
     /* interface instead of concrete TQuantizedFloatValuesHolder because there is
      * an alternative implementation TExternalFloatValuesHolder for GPU
@@ -25,6 +25,7 @@
 #include <util/generic/ylimits.h>
 #include <util/generic/ymath.h>
 #include <util/stream/labeled.h>
+#include <util/string/cast.h>
 #include <util/system/yassert.h>
 
 #include <algorithm>
@@ -84,6 +85,10 @@ namespace NCB {
             ui32 prevTailSize = 0;
             if (InBlock) {
                 CB_ENSURE(!metaInfo.HasPairs, "Pairs are not supported in block processing");
+                CB_ENSURE(
+                    !metaInfo.HasGroupId || !metaInfo.FeaturesLayout->HasSparseFeatures(),
+                    "Sparse features are not supported in block processing of data with groups"
+                );
 
                 prevTailSize = (NextCursor < ObjectCount) ? (ObjectCount - NextCursor) : 0;
                 NextCursor = prevTailSize;
@@ -103,9 +108,24 @@ namespace NCB {
             Data.CommonObjectsData.ResourceHolders = std::move(resourceHolders);
             Data.CommonObjectsData.Order = objectsOrder;
 
-            FloatFeaturesStorage.PrepareForInitialization(*metaInfo.FeaturesLayout, ObjectCount, prevTailSize);
-            CatFeaturesStorage.PrepareForInitialization(*metaInfo.FeaturesLayout, ObjectCount, prevTailSize);
-            TextFeaturesStorage.PrepareForInitialization(*metaInfo.FeaturesLayout, ObjectCount, prevTailSize);
+            FloatFeaturesStorage.PrepareForInitialization(
+                *metaInfo.FeaturesLayout,
+                ObjectCount,
+                prevTailSize,
+                LocalExecutor
+            );
+            CatFeaturesStorage.PrepareForInitialization(
+                *metaInfo.FeaturesLayout,
+                ObjectCount,
+                prevTailSize,
+                LocalExecutor
+            );
+            TextFeaturesStorage.PrepareForInitialization(
+                *metaInfo.FeaturesLayout,
+                ObjectCount,
+                prevTailSize,
+                LocalExecutor
+            );
 
             if (metaInfo.HasWeights) {
                 PrepareForInitialization(ObjectCount, prevTailSize, &WeightsBuffer);
@@ -438,22 +458,46 @@ namespace NCB {
             // view into storage for faster access
             TVector<TArrayRef<T>> DstView; // [perTypeFeatureIdx]
 
+            /* values for features stored as sparse are added to per thread parts
+             * and grouped by features in GetResult
+             */
+            struct TSparsePart {
+                TVector<ui32> PerTypeFeatureIndices;
+                TVector<ui32> ObjectIndices;
+                TVector<T> Values;
+            };
+
+            std::array<TSparsePart, CB_THREAD_LIMIT> SparseParts;
+
             // copy from Data.MetaInfo.FeaturesLayout for fast access
-            TVector<bool> IsAvailable; // [perTypeFeatureIdx]
+            TVector<bool> IsAvailable; // [perTypeFeatureIdx], available and stored densely
+            TVector<bool> IsSparse; // [perTypeFeatureIdx], available and stored as sparse
+
+            ui32 ObjectCount = 0;
+
+            NPar::TLocalExecutor* LocalExecutor = nullptr;
 
         public:
             void PrepareForInitialization(
                 const TFeaturesLayout& featuresLayout,
                 ui32 objectCount,
-                ui32 prevTailSize
+                ui32 prevTailSize,
+                NPar::TLocalExecutor* localExecutor
             ) {
                 const size_t featureCount = (size_t) featuresLayout.GetFeatureCount(FeatureType);
                 Storage.resize(featureCount);
                 DstView.resize(featureCount);
                 IsAvailable.yresize(featureCount);
+                IsSparse.yresize(featureCount);
+                ObjectCount = objectCount;
+                LocalExecutor = localExecutor;
+                for (auto& sparsePart : SparseParts) {
+                    sparsePart = TSparsePart();
+                }
                 for (auto perTypeFeatureIdx : xrange(featureCount)) {
-                    if (featuresLayout.GetInternalFeatureMetaInfo(perTypeFeatureIdx, FeatureType).IsAvailable)
-                    {
+                    const auto& metaInfo = featuresLayout.GetInternalFeatureMetaInfo(perTypeFeatureIdx, FeatureType);
+                    IsSparse[perTypeFeatureIdx] = metaInfo.IsAvailable && metaInfo.IsSparse;
+                    if (metaInfo.IsAvailable && !metaInfo.IsSparse) {
                         auto& maybeSharedStoragePtr = Storage[perTypeFeatureIdx];
 
                         if (!maybeSharedStoragePtr) {
@@ -486,7 +530,75 @@ namespace NCB {
             void Set(TFeatureIdx<FeatureType> perTypeFeatureIdx, ui32 objectIdx, T value) {
                 if (IsAvailable[*perTypeFeatureIdx]) {
                     DstView[*perTypeFeatureIdx][objectIdx] = value;
+                } else if (IsSparse[*perTypeFeatureIdx] && (value != T())) {
+                    const int sparsePartIdx = LocalExecutor->GetWorkerThreadId();
+                    CB_ENSURE(
+                        sparsePartIdx < CB_THREAD_LIMIT,
+                        "Internal error: thread ID exceeds CB_THREAD_LIMIT"
+                    );
+                    auto& sparsePart = SparseParts[sparsePartIdx];
+                    sparsePart.PerTypeFeatureIndices.push_back(*perTypeFeatureIdx);
+                    sparsePart.ObjectIndices.push_back(objectIdx);
+                    sparsePart.Values.push_back(std::move(value));
+                }
+            }
+
+            TVector<TConstSparseArrayPtr<T>> GetSparseResult() {
+                const size_t featureCount = IsSparse.size();
+
+                TVector<TConstSparseArrayPtr<T>> result(featureCount);
+                if (!AnyOf(IsSparse, [] (bool isSparse) { return isSparse; })) {
+                    return result;
                 }
+
+                TVector<TVector<std::pair<ui32, T>>> indexedValues(featureCount); // [perTypeFeatureIdx]
+                for (auto& sparsePart : SparseParts) {
+                    for (auto i : xrange(sparsePart.PerTypeFeatureIndices.size())) {
+                        indexedValues[sparsePart.PerTypeFeatureIndices[i]].emplace_back(
+                            sparsePart.ObjectIndices[i],
+                            std::move(sparsePart.Values[i])
+                        );
+                    }
+                    sparsePart = TSparsePart();
+                }
+
+                LocalExecutor->ExecRangeWithThrow(
+                    [&] (int perTypeFeatureIdx) {
+                        if (!IsSparse[perTypeFeatureIdx]) {
+                            return;
+                        }
+                        auto& featureIndexedValues = indexedValues[perTypeFeatureIdx];
+                        Sort(
+                            featureIndexedValues,
+                            [] (const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; }
+                        );
+                        TVector<ui32> indices;
+                        indices.yresize(featureIndexedValues.size());
+                        TVector<T> values;
+                        values.yresize(featureIndexedValues.size());
+                        for (auto i : xrange(featureIndexedValues.size())) {
+                            CB_ENSURE(
+                                (i == 0) || (featureIndexedValues[i - 1].first != featureIndexedValues[i].first),
+                                "Feature with per type index " << perTypeFeatureIdx << ": object #"
+                                << featureIndexedValues[i].first << " has several values specified"
+                            );
+                            indices[i] = featureIndexedValues[i].first;
+                            values[i] = std::move(featureIndexedValues[i].second);
+                        }
+                        TVector<std::pair<ui32, T>>().swap(featureIndexedValues);
+
+                        result[perTypeFeatureIdx] = MakeAtomicShared<const TSparseArray<T, ui32>>(
+                            ObjectCount,
+                            T(),
+                            std::move(indices),
+                            std::move(values)
+                        );
+                    },
+                    0,
+                    SafeIntegerCast<int>(featureCount),
+                    NPar::TLocalExecutor::WAIT_COMPLETE
+                );
+                return result;
             }
 
             template <EFeatureValuesType ColumnType>
@@ -504,6 +616,8 @@ namespace NCB {
                     "Storage is inconsistent with feature Layout"
                 );
 
+                const TVector<TConstSparseArrayPtr<T>> sparseData = GetSparseResult();
+
                 result->clear();
                 result->reserve(featureCount);
                 for (auto perTypeFeatureIdx : xrange(featureCount)) {
@@ -520,6 +634,16 @@ namespace NCB {
                                 subsetIndexing
                             )
                         );
+                    } else if (IsSparse[perTypeFeatureIdx]) {
+                        result->push_back(
+                            MakeHolder<TArrayValuesHolder<T, ColumnType>>(
+                                /* featureId */ (ui32)featuresLayout.GetExternalFeatureIdx(
+                                    perTypeFeatureIdx, FeatureType
+                                ),
+                                sparseData[perTypeFeatureIdx],
+                                subsetIndexing
+                            )
+                        );
                     } else {
                         result->push_back(nullptr);
                     }
@@ -638,6 +762,50 @@ namespace NCB {
         void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TStringBuf> feature) override {
             AddCatFeatureImpl(flatFeatureIdx, feature);
         }
+        void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<i64> feature) override {
+            AddCatFeatureImpl(
+                flatFeatureIdx,
+                [feature] (ui32 objectIdx) {
+                    char buffer[32];
+                    const size_t length = ToString(feature[objectIdx], buffer, sizeof(buffer));
+                    return CalcCatFeatureHash(TStringBuf(buffer, length));
+                },
+                [feature] (ui32 objectIdx) {
+                    return ToString(feature[objectIdx]);
+                }
+            );
+        }
+        void AddCatFeature(
+            ui32 flatFeatureIdx,
+            TConstArrayRef<TString> uniqueValues,
+            TConstArrayRef<ui32> valueIndices
+        ) override {
+            CB_ENSURE_INTERNAL(
+                valueIndices.size() == ObjectCount,
+                "Categorical feature #" << flatFeatureIdx << " has " << valueIndices.size()
+                << " values, expected " << ObjectCount
+            );
+            CB_ENSURE(
+                AllOf(valueIndices, [&] (ui32 valueIdx) { return valueIdx < uniqueValues.size(); }),
+                "Categorical feature #" << flatFeatureIdx << " has value indices out of range"
+            );
+
+            TVector<ui32> hashedUniqueValues;
+            hashedUniqueValues.yresize(uniqueValues.size());
+            for (auto valueIdx : xrange(uniqueValues.size())) {
+                hashedUniqueValues[valueIdx] = CalcCatFeatureHash(uniqueValues[valueIdx]);
+            }
+
+            AddCatFeatureImpl(
+                flatFeatureIdx,
+                [&] (ui32 objectIdx) {
+                    return hashedUniqueValues[valueIndices[objectIdx]];
+                },
+                [&] (ui32 objectIdx) {
+                    return uniqueValues[valueIndices[objectIdx]];
+                }
+            );
+        }
 
         void AddCatFeature(ui32 flatFeatureIdx, TMaybeOwningConstArrayHolder<ui32> features) override {
             auto catFeatureIdx = GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
@@ -744,6 +912,20 @@ namespace NCB {
 
         template <class TStringLike>
         void AddCatFeatureImpl(ui32 flatFeatureIdx, TConstArrayRef<TStringLike> feature) {
+            AddCatFeatureImpl(
+                flatFeatureIdx,
+                [feature] (ui32 objectIdx) {
+                    return CalcCatFeatureHash(feature[objectIdx]);
+                },
+                [feature] (ui32 objectIdx) {
+                    return feature[objectIdx];
+                }
+            );
+        }
+
+        // getValueString is called only for the first object with each hashed value
+        template <class TCalcHash, class TGetValueString>
+        void AddCatFeatureImpl(ui32 flatFeatureIdx, TCalcHash&& calcHash, TGetValueString&& getValueString) {
             auto catFeatureIdx = GetInternalFeatureIdx<EFeatureType::Categorical>(flatFeatureIdx);
 
             TVector<ui32> hashedCatValues;
@@ -751,7 +933,7 @@ namespace NCB {
 
             LocalExecutor->ExecRange(
                 [&](int objectIdx) {
-                    hashedCatValues[objectIdx] = CalcCatFeatureHash(feature[objectIdx]);
+                    hashedCatValues[objectIdx] = calcHash(objectIdx);
                 },
                 *ObjectCalcParams,
                 NPar::TLocalExecutor::WAIT_COMPLETE
@@ -763,7 +945,7 @@ namespace NCB {
                 const ui32 hashedValue = hashedCatValues[objectIdx];
                 THashMap<ui32, TString>::insert_ctx insertCtx;
                 if (!catFeatureHash.contains(hashedValue, insertCtx)) {
-                    catFeatureHash.emplace_direct(insertCtx, hashedValue, feature[objectIdx]);
+                    catFeatureHash.emplace_direct(insertCtx, hashedValue, getValueString(objectIdx));
                 }
             }
 
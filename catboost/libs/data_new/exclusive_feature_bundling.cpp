@@ -297,7 +297,8 @@ next_outer_loop_iter:
         TVector<TFeatureWithDegree> featuresWithDegree;
 
         for (auto flatFeatureIdx : xrange(featuresLayout.GetExternalFeatureCount())) {
-            if (!featuresMetaInfo[flatFeatureIdx].IsAvailable) {
+            // sparse features are not bundled, they are stored separately
+            if (!featuresMetaInfo[flatFeatureIdx].IsAvailable || featuresMetaInfo[flatFeatureIdx].IsSparse) {
                 continue;
             }
 
@@ -315,9 +316,11 @@ next_outer_loop_iter:
 
         TFeatureIntersectionGraph bundleToFeatureIntersectionGraph(false); // first index is bundle index
 
+        // bundle index is used as a tie breaker because bundles with equal degrees must not be merged
         auto bundlesGreaterByDegree = [&] (ui32 bundleIdx1, ui32 bundleIdx2) -> bool {
-            return bundleToFeatureIntersectionGraph.GetDegree(bundleIdx1)
-                > bundleToFeatureIntersectionGraph.GetDegree(bundleIdx2);
+            const ui32 degree1 = bundleToFeatureIntersectionGraph.GetDegree(bundleIdx1);
+            const ui32 degree2 = bundleToFeatureIntersectionGraph.GetDegree(bundleIdx2);
+            return (degree1 > degree2) || ((degree1 == degree2) && (bundleIdx1 < bundleIdx2));
         };
 
         std::set<ui32, decltype(bundlesGreaterByDegree)> bundlesByDegree(bundlesGreaterByDegree);
@@ -360,10 +363,9 @@ next_outer_loop_iter:
                     lowerBoundInBundle + binCountInBundleNeeded
                 );
 
+                // bundle degree is changed so it has to be reinserted to keep bundlesByDegree ordered
                 bundlesByDegree.erase(bundleIdx);
                 bundle.Add(TExclusiveBundlePart(featureType, perTypeFeatureIdx, boundsInBundle));
-                bundlesByDegree.insert(bundleIdx);
-
                 for (const auto& [flatFeatureIdx2, intersectionCount]
                      : featureIntersectionGraph.IntersectionCounts[flatFeatureIdx])
                 {
@@ -373,38 +375,44 @@ next_outer_loop_iter:
                         intersectionCount
                     );
                 }
+                bundlesByDegree.insert(bundleIdx);
+
                 flatFeatureIdxToBundleIdx[flatFeatureIdx] = bundleIdx;
 
                 return true;
             };
 
-            THashSet<ui32> checkedBundlesForNeighbors;
+            TMaybe<ui32> checkedNeighborBundleIdx;
 
             // try neighboring bundles first
+            bool bundleFound = false;
             if ((flatFeatureIdx > 0) && flatFeatureIdxToBundleIdx[flatFeatureIdx - 1].Defined()) {
                 auto bundleIdx = *(flatFeatureIdxToBundleIdx[flatFeatureIdx - 1]);
-                if (tryAddToBundle(bundleIdx)) {
-                    continue;
-                }
-                checkedBundlesForNeighbors.insert(bundleIdx);
+                bundleFound = tryAddToBundle(bundleIdx);
+                checkedNeighborBundleIdx = bundleIdx;
             }
-            if (((flatFeatureIdx + 1) < flatFeatureIdxToBundleIdx.size()) &&
+            if (!bundleFound &&
+                ((flatFeatureIdx + 1) < flatFeatureIdxToBundleIdx.size()) &&
                 flatFeatureIdxToBundleIdx[flatFeatureIdx + 1].Defined())
             {
                 auto bundleIdx = *(flatFeatureIdxToBundleIdx[flatFeatureIdx + 1]);
-                if (checkedBundlesForNeighbors.contains(bundleIdx)) {
-                    continue;
-                }
-                if (tryAddToBundle(bundleIdx)) {
-                    continue;
+                if (checkedNeighborBundleIdx != bundleIdx) {
+                    bundleFound = tryAddToBundle(bundleIdx);
+                    checkedNeighborBundleIdx = bundleIdx;
                 }
-                checkedBundlesForNeighbors.insert(bundleIdx);
+            }
+            if (bundleFound) {
+                continue;
             }
 
-            // try
-            bool bundleFound = false;
+            // try bundles with the highest degrees, search is limited to keep bundling time linear
+            ui32 checkedBundleCount = 0;
             for (auto bundleIdx : bundlesByDegree) {
-                if (checkedBundlesForNeighbors.contains(bundleIdx)) {
+                if (checkedBundleCount == options.MaxBundleCandidates) {
+                    break;
+                }
+                ++checkedBundleCount;
+                if (checkedNeighborBundleIdx == bundleIdx) {
                     continue;
                 }
                 if (tryAddToBundle(bundleIdx)) {
@@ -544,7 +552,10 @@ next_outer_loop_iter:
 
         for (auto flatFeatureIdx : xrange(featureCount)) {
             const auto& featureMetaInfo = featuresMetaInfo[flatFeatureIdx];
-            if (!featureMetaInfo.IsAvailable || featureMetaInfo.Type == EFeatureType::Text) {
+            if (!featureMetaInfo.IsAvailable ||
+                featureMetaInfo.IsSparse ||
+                (featureMetaInfo.Type == EFeatureType::Text))
+            {
                 continue;
             }
 
@@ -591,16 +602,31 @@ next_outer_loop_iter:
         // to improve locality
         Sort(subsetIndices);
 
+        /* conflicts are calculated on a uniformly strided sample of objects,
+         * sampled indices remain sorted.
+         * If no conflicts are allowed all objects are used because conflicts missed by the sample would
+         * make bundled features lossy.
+         */
+        if ((options.MaxConflictFraction > 0.0f) && (objectCount > options.MaxObjectsForConflictsCalc)) {
+            const ui32 maxSampleSize = options.MaxObjectsForConflictsCalc;
+            CB_ENSURE_INTERNAL(maxSampleSize > 0, "MaxObjectsForConflictsCalc must be positive");
+            for (auto sampleIdx : xrange(maxSampleSize)) {
+                subsetIndices[sampleIdx] = subsetIndices[(ui64)sampleIdx * objectCount / maxSampleSize];
+            }
+            subsetIndices.resize(maxSampleSize);
+        }
+        const ui32 sampleSize = (ui32)subsetIndices.size();
+
         TSimpleIndexRangesGenerator<ui32> partRanges(
-            TIndexRange<ui32>(0, objectCount),
-            CeilDiv(objectCount, ui32(localExecutor->GetThreadCount() + 1))
+            TIndexRange<ui32>(0, sampleSize),
+            CeilDiv(sampleSize, ui32(localExecutor->GetThreadCount() + 1))
         );
 
         const int partCount = partRanges.RangesCount();
 
         TVector<TCalcFeatureIntersectionPartData> partsData(partCount);
 
-        const ui32 maxObjectIntersection = ui32(options.MaxConflictFraction * float(objectCount));
+        const ui32 maxObjectIntersection = ui32(options.MaxConflictFraction * float(sampleSize));
 
 
         localExecutor->ExecRange(
@@ -754,7 +780,7 @@ next_outer_loop_iter:
         return CreateExclusiveFeatureBundlesFromGraph(
             quantizedFeaturesInfo,
             std::move(resultFeatureIntersectionGraph),
-            rawDataSubsetIndexing.Size(),
+            sampleSize,
             options
         );
     }
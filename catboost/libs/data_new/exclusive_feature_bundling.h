@@ -96,11 +96,18 @@ namespace NCB {
                 "Non-consecutive bounds in added bundle part"
             );
             Parts.push_back(std::move(part));
-            SizeInBytes = CeilDiv(
-                GetValueBitCount(GetUsedByPartsBinCount()),
-                unsigned(CHAR_BIT)
-            );
-            CB_ENSURE_INTERNAL(SizeInBytes <= 2, "SizeInBytes > 2 is not currently supported");
+            SizeInBytes = GetBundleSizeInBytes(GetUsedByPartsBinCount());
+        }
+
+        // bundles are stored as ui8, ui16 or ui32 arrays
+        static ui32 GetBundleSizeInBytes(ui32 usedByPartsBinCount) {
+            const ui32 bitCount = GetValueBitCount(usedByPartsBinCount);
+            if (bitCount <= 8) {
+                return 1;
+            } else if (bitCount <= 16) {
+                return 2;
+            }
+            return 4;
         }
     };
 
@@ -156,6 +163,15 @@ namespace NCB {
     struct TExclusiveFeaturesBundlingOptions {
         ui32 MaxBuckets = 1 << 10;
         float MaxConflictFraction = 0.0f;
+
+        /* conflicts between features are calculated on a sample of objects of at most this size,
+         * MaxConflictFraction is applied to the sample size.
+         * Not used if MaxConflictFraction is 0, all objects are checked in this case
+         */
+        ui32 MaxObjectsForConflictsCalc = 200000;
+
+        // at most this number of existing bundles is checked when searching a bundle to add a feature to
+        ui32 MaxBundleCandidates = 100;
     };
 
 
@@ -252,6 +252,25 @@ void TFeaturesLayout::IgnoreExternalFeatures(TConstArrayRef<ui32> ignoredFeature
     }
 }
 
+void TFeaturesLayout::MarkExternalFeatureAsSparse(ui32 externalFeatureIdx) {
+    CB_ENSURE(
+        IsCorrectExternalFeatureIdxAndType(externalFeatureIdx, EFeatureType::Float),
+        "Feature #" << externalFeatureIdx << " is not a float feature, only float features can be sparse"
+    );
+    ExternalIdxToMetaInfo[externalFeatureIdx].IsSparse = true;
+}
+
+bool TFeaturesLayout::IsSparseFloatFeature(ui32 internalFeatureIdx) const {
+    return GetInternalFeatureMetaInfo(internalFeatureIdx, EFeatureType::Float).IsSparse;
+}
+
+bool TFeaturesLayout::HasSparseFeatures() const {
+    return AnyOf(
+        ExternalIdxToMetaInfo,
+        [] (const TFeatureMetaInfo& metaInfo) { return metaInfo.IsSparse && metaInfo.IsAvailable; }
+    );
+}
+
 TConstArrayRef<ui32> TFeaturesLayout::GetCatFeatureInternalIdxToExternalIdx() const {
     return CatFeatureInternalIdxToExternalIdx;
 }
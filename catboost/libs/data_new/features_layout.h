@@ -29,6 +29,11 @@ namespace NCB {
          */
         bool IsAvailable = true;
 
+        /* storage hint: feature values are mostly 0.0f and are stored as sparse columns
+         * supported only for float features, not serialized and not compared
+         */
+        bool IsSparse = false;
+
     public:
         // needed for BinSaver
         TFeatureMetaInfo() = default;
@@ -143,6 +148,13 @@ namespace NCB {
         // indices in list can be outside of range of features in layout - such features are ignored
         void IgnoreExternalFeatures(TConstArrayRef<ui32> ignoredFeatures);
 
+        // only float features can be sparse
+        void MarkExternalFeatureAsSparse(ui32 externalFeatureIdx);
+
+        bool IsSparseFloatFeature(ui32 internalFeatureIdx) const;
+
+        bool HasSparseFeatures() const;
+
         // Function must get one param -  TFeatureIdx<FeatureType>
         template <EFeatureType FeatureType, class Function>
         void IterateOverAvailableFeatures(Function&& f) const {
@@ -0,0 +1,215 @@
+#include "libsvm_loader.h"
+
+#include <catboost/libs/column_description/column.h>
+#include <catboost/libs/data_types/groupid.h>
+#include <catboost/libs/data_util/exists_checker.h>
+
+#include <library/object_factory/object_factory.h>
+
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/string/cast.h>
+#include <util/string/iterator.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    static const TStringBuf QidPrefix = "qid:";
+
+
+    static TVector<TStringBuf> SplitLibSvmLine(TStringBuf line) {
+        return StringSplitter(line.Before('#')).SplitBySet(" \t").SkipEmpty();
+    }
+
+    // returns 0-based feature index
+    static ui32 ParseFeatureIdx(TStringBuf token) {
+        ui32 featureIdx = 0;
+        CB_ENSURE(
+            TryFromString<ui32>(token, featureIdx) && (featureIdx > 0),
+            "Feature index \"" << token << "\" is not a positive integer"
+        );
+        return featureIdx - 1;
+    }
+
+    static void ScanLibSvmData(
+        ILineDataReader* lineDataReader,
+        ui32* objectCount,
+        ui32* featureCount,
+        bool* hasGroupId
+    ) {
+        ui64 lineCount = 0;
+        *featureCount = 0;
+
+        TString line;
+        for (; lineDataReader->ReadLine(&line); ++lineCount) {
+            try {
+                TVector<TStringBuf> tokens = SplitLibSvmLine(line);
+                CB_ENSURE(!tokens.empty(), "label is missing");
+
+                const bool lineHasGroupId = (tokens.size() > 1) && tokens[1].StartsWith(QidPrefix);
+                if (lineCount == 0) {
+                    *hasGroupId = lineHasGroupId;
+                } else {
+                    CB_ENSURE(
+                        lineHasGroupId == *hasGroupId,
+                        "qid must be specified either for all objects or for none of them"
+                    );
+                }
+
+                // feature indices are checked to be increasing when data is parsed
+                const size_t featuresBegin = lineHasGroupId ? 2 : 1;
+                if (tokens.size() > featuresBegin) {
+                    *featureCount = Max(*featureCount, ParseFeatureIdx(tokens.back().Before(':')) + 1);
+                }
+            } catch (yexception& e) {
+                throw TCatBoostException() << "Error in libsvm data. Line " << lineCount + 1 << ": "
+                    << e.what();
+            }
+        }
+
+        CB_ENSURE(lineCount, "TLibSvmDataLoader: no data rows in pool");
+        CB_ENSURE(
+            lineCount <= Max<ui32>(), "CatBoost does not support datasets with more than "
+            << Max<ui32>() << " objects"
+        );
+        // cast is safe - was checked above
+        *objectCount = (ui32)lineCount;
+    }
+
+
+    TLibSvmDataLoader::TLibSvmDataLoader(TDatasetLoaderPullArgs&& args)
+        : TAsyncProcDataLoaderBase<TString>(std::move(args.CommonArgs))
+        , LineDataReader(GetLineDataReader(args.PoolPath, {}, Args.LocalExecutor->GetThreadCount() + 1))
+        , BaselineReader(Args.BaselineFilePath, Args.ClassNames)
+    {
+        CB_ENSURE(!Args.PairsFilePath.Inited() || CheckExists(Args.PairsFilePath),
+                  "TLibSvmDataLoader:PairsFilePath does not exist");
+        CB_ENSURE(!Args.GroupWeightsFilePath.Inited() || CheckExists(Args.GroupWeightsFilePath),
+                  "TLibSvmDataLoader:GroupWeightsFilePath does not exist");
+        CB_ENSURE(!Args.BaselineFilePath.Inited() || CheckExists(Args.BaselineFilePath),
+                  "TLibSvmDataLoader:BaselineFilePath does not exist");
+        CB_ENSURE(
+            !Args.CdProvider || !Args.CdProvider->Inited(),
+            "Columns description is not supported for data in libsvm format"
+        );
+        CB_ENSURE(!Args.PoolFormat.HasHeader, "Header is not supported for data in libsvm format");
+
+        ui32 featureCount = 0;
+        ScanLibSvmData(
+            GetLineDataReader(args.PoolPath, {}, Args.LocalExecutor->GetThreadCount() + 1).Get(),
+            &ObjectCount,
+            &featureCount,
+            &HasGroupId
+        );
+
+        TVector<TColumn> columns;
+        columns.push_back(TColumn{EColumn::Label, TString()});
+        if (HasGroupId) {
+            columns.push_back(TColumn{EColumn::GroupId, TString()});
+        }
+        columns.resize(columns.size() + featureCount, TColumn{EColumn::Num, TString()});
+
+        DataMetaInfo = TDataMetaInfo(
+            TDataColumnsMetaInfo{ std::move(columns) },
+            Args.GroupWeightsFilePath.Inited(),
+            Args.PairsFilePath.Inited(),
+            BaselineReader.GetBaselineCount(),
+            /*featureNames*/ Nothing(),
+            Args.ClassNames
+        );
+        for (auto featureIdx : xrange(featureCount)) {
+            DataMetaInfo.FeaturesLayout->MarkExternalFeatureAsSparse(featureIdx);
+        }
+
+        ProcessIgnoredFeaturesList(Args.IgnoredFeatures, &DataMetaInfo, &FeatureIgnored);
+
+        AsyncRowProcessor.ReadBlockAsync(GetReadFunc());
+        if (BaselineReader.Inited()) {
+            AsyncBaselineRowProcessor.ReadBlockAsync(GetReadBaselineFunc());
+        }
+    }
+
+
+    void TLibSvmDataLoader::StartBuilder(bool inBlock,
+                                         ui32 objectCount, ui32 /*offset*/,
+                                         IRawObjectsOrderDataVisitor* visitor)
+    {
+        visitor->Start(inBlock, DataMetaInfo, objectCount, Args.ObjectsOrder, {});
+    }
+
+
+    void TLibSvmDataLoader::ProcessBlock(IRawObjectsOrderDataVisitor* visitor) {
+        visitor->StartNextBlock(AsyncRowProcessor.GetParseBufferSize());
+
+        auto parseBlock = [&](TString& line, int lineIdx) {
+            try {
+                TVector<TStringBuf> tokens = SplitLibSvmLine(line);
+                CB_ENSURE(!tokens.empty(), "label is missing");
+
+                visitor->AddTarget(lineIdx, TString(tokens[0]));
+
+                size_t tokenIdx = 1;
+                if (HasGroupId) {
+                    CB_ENSURE((tokens.size() > 1) && tokens[1].StartsWith(QidPrefix), "qid is missing");
+                    const TStringBuf groupId = tokens[1].SubStr(QidPrefix.size());
+                    CB_ENSURE(groupId.length() != 0, "empty values not supported for qid");
+                    visitor->AddGroupId(lineIdx, CalcGroupIdFor(groupId));
+                    tokenIdx = 2;
+                }
+
+                ui32 featuresEnd = 0; // to check that feature indices are increasing
+                for (; tokenIdx < tokens.size(); ++tokenIdx) {
+                    const TStringBuf token = tokens[tokenIdx];
+                    TStringBuf featureIdxToken;
+                    TStringBuf valueToken;
+                    CB_ENSURE(
+                        token.TrySplit(':', featureIdxToken, valueToken),
+                        "\"" << token << "\" is not in <featureIdx>:<value> format"
+                    );
+                    const ui32 featureIdx = ParseFeatureIdx(featureIdxToken);
+                    // feature count is determined by last indices in lines so out of range is an order error too
+                    CB_ENSURE(
+                        (featureIdx >= featuresEnd) && (featureIdx < FeatureIgnored.size()),
+                        "Feature indices must be specified in increasing order"
+                    );
+                    featuresEnd = featureIdx + 1;
+
+                    if (!FeatureIgnored[featureIdx]) {
+                        float value;
+                        CB_ENSURE(
+                            TryParseFloatFeatureValue(valueToken, &value),
+                            "Feature " << featureIdxToken << " value \"" << valueToken
+                            << "\" cannot be parsed as float"
+                        );
+                        visitor->AddFloatFeature(lineIdx, featureIdx, value);
+                    }
+                }
+            } catch (yexception& e) {
+                throw TCatBoostException() << "Error in libsvm data. Line " <<
+                    AsyncRowProcessor.GetLinesProcessed() + lineIdx + 1 << ": " << e.what();
+            }
+        };
+
+        AsyncRowProcessor.ProcessBlock(parseBlock);
+
+        if (BaselineReader.Inited()) {
+            auto parseBaselineBlock = [&](TString &line, int inBlockIdx) {
+
+                auto addBaselineFunc = [&visitor, inBlockIdx](ui32 baselineIdx, float baseline) {
+                    visitor->AddBaseline(inBlockIdx, baselineIdx, baseline);
+                };
+                const auto lineIdx = AsyncBaselineRowProcessor.GetLinesProcessed() + inBlockIdx + 1;
+
+                BaselineReader.Parse(addBaselineFunc, line, lineIdx);
+            };
+
+            AsyncBaselineRowProcessor.ProcessBlock(parseBaselineBlock);
+        }
+    }
+
+    namespace {
+        TDatasetLoaderFactory::TRegistrator<TLibSvmDataLoader> LibSvmDataLoaderReg("libsvm");
+    }
+}
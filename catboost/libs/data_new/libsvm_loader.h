@@ -0,0 +1,80 @@
+#pragma once
+
+#include "baseline.h"
+#include "loader.h"
+
+#include <catboost/libs/data_util/line_data_reader.h>
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/ylimits.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /* Loader for data in libsvm format:
+     *   <label> [qid:<groupId>] <featureIdx>:<value> <featureIdx>:<value> ... [# comment]
+     *
+     * featureIdx are 1-based and must be in increasing order within a line,
+     * feature values that are not specified are 0.0f.
+     * All features are float and are stored as sparse.
+     */
+    class TLibSvmDataLoader : public IRawObjectsOrderDatasetLoader
+                            , protected TAsyncProcDataLoaderBase<TString>
+    {
+    public:
+        using TBase = TAsyncProcDataLoaderBase<TString>;
+
+    protected:
+        decltype(auto) GetReadFunc() {
+            return [this](TString* line) -> bool {
+                return LineDataReader->ReadLine(line);
+            };
+        }
+
+        decltype(auto) GetReadBaselineFunc() {
+            return [this](TString *line) -> bool {
+                return BaselineReader.ReadLine(line);
+            };
+        }
+
+    public:
+        explicit TLibSvmDataLoader(TDatasetLoaderPullArgs&& args);
+
+        ~TLibSvmDataLoader() {
+            AsyncRowProcessor.FinishAsyncProcessing();
+        }
+
+        void Do(IRawObjectsOrderDataVisitor* visitor) override {
+            TBase::Do(GetReadFunc(), GetReadBaselineFunc(), visitor);
+        }
+
+        bool DoBlock(IRawObjectsOrderDataVisitor* visitor) override {
+            return TBase::DoBlock(GetReadFunc(), GetReadBaselineFunc(), visitor);
+        }
+
+        ui32 GetObjectCount() override {
+            return ObjectCount;
+        }
+
+        void StartBuilder(
+            bool inBlock,
+            ui32 objectCount,
+            ui32 offset,
+            IRawObjectsOrderDataVisitor* visitor
+        ) override;
+
+        void ProcessBlock(IRawObjectsOrderDataVisitor* visitor) override;
+
+    protected:
+        TVector<bool> FeatureIgnored; // init in process
+        ui32 ObjectCount = 0;
+        bool HasGroupId = false;
+        THolder<NCB::ILineDataReader> LineDataReader;
+        TBaselineReader BaselineReader;
+    };
+
+}
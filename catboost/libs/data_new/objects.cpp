@@ -10,6 +10,7 @@
 
 #include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
+#include <util/generic/ylimits.h>
 #include <util/generic/ymath.h>
 #include <util/stream/format.h>
 #include <util/stream/output.h>
@@ -303,6 +304,9 @@ static bool AreFeaturesValuesEqual(
     const TArrayValuesHolder<T, TType>& lhs,
     const TArrayValuesHolder<T, TType>& rhs
 ) {
+    if (lhs.IsSparse() || rhs.IsSparse()) {
+        return *(lhs.ExtractValues(&NPar::LocalExecutor())) == *(rhs.ExtractValues(&NPar::LocalExecutor()));
+    }
     auto lhsArrayData = lhs.GetArrayData();
     auto lhsData = GetSubset<T>(*lhsArrayData.GetSrc(), *lhsArrayData.GetSubsetIndexing());
     return Equal<T>(lhsData, rhs.GetArrayData());
@@ -472,7 +476,15 @@ static void CreateSubsetFeatures(
     dst->reserve(src.size());
     for (const auto& feature : src) {
         auto* srcDataPtr = feature.Get();
-        if (srcDataPtr) {
+        if (srcDataPtr && srcDataPtr->IsSparse()) {
+            dst->emplace_back(
+                MakeHolder<TArrayValuesHolder<T, TType>>(
+                    srcDataPtr->GetId(),
+                    srcDataPtr->GetSparseSrcData(),
+                    subsetIndexing
+                )
+            );
+        } else if (srcDataPtr) {
             dst->emplace_back(
                 MakeHolder<TArrayValuesHolder<T, TType>>(
                     srcDataPtr->GetId(),
@@ -575,7 +587,12 @@ TVector<float> NCB::TRawObjectsDataProvider::GetFeatureDataOldFormat(ui32 flatFe
 
     if (featureMetaInfo.Type == EFeatureType::Float) {
         const auto& feature = **GetFloatFeature(featuresLayout.GetInternalFeatureIdx(flatFeatureIdx));
-        feature.GetArrayData().ForEach([&result](ui32 idx, float value) { result[idx] = value; });
+        if (feature.IsSparse()) {
+            auto values = feature.ExtractValues(&NPar::LocalExecutor());
+            Copy((*values).begin(), (*values).end(), result.begin());
+        } else {
+            feature.GetArrayData().ForEach([&result](ui32 idx, float value) { result[idx] = value; });
+        }
     } else {
         const auto& feature = **GetCatFeature(featuresLayout.GetInternalFeatureIdx(flatFeatureIdx));
         feature.GetArrayData().ForEach(
@@ -788,6 +805,7 @@ static void LoadFeatures(
     const TFeaturesArraySubsetIndexing* subsetIndexing,
     const TMaybe<TPackedBinaryFeaturesData*> packedBinaryFeaturesData,
     const TMaybe<TExclusiveFeatureBundlesData*> exclusiveFeatureBundlesData,
+    const TMaybe<TPackedNibbleFeaturesData*> packedNibbleFeaturesData,
     IBinSaver* binSaver,
     TVector<THolder<IColumnType>>* dst
 ) {
@@ -813,6 +831,14 @@ static void LoadFeatures(
         featureToBundlePart = nullptr;
     }
 
+    // only float features are nibble-packed
+    TVector<TMaybe<TPackedNibbleIndex>>* featureToPackedNibbleIndex;
+    if (packedNibbleFeaturesData && (FeatureType == EFeatureType::Float)) {
+        featureToPackedNibbleIndex = &(**packedNibbleFeaturesData).FloatFeatureToPackedNibbleIndex;
+    } else {
+        featureToPackedNibbleIndex = nullptr;
+    }
+
     dst->clear();
     dst->resize(featuresLayout.GetFeatureCount(FeatureType));
 
@@ -863,6 +889,24 @@ static void LoadFeatures(
                     metaData.Parts[exclusiveBundleIndex.InBundleIdx].Bounds,
                     subsetIndexing
                 );
+            } else if (featureToPackedNibbleIndex && (*featureToPackedNibbleIndex)[*featureIdx]) {
+                TPackedNibbleIndex packedNibbleIndex = *((*featureToPackedNibbleIndex)[*featureIdx]);
+
+                ui8 nibbleIdx = 0;
+                binSaver->Add(0, &nibbleIdx);
+
+                CB_ENSURE_INTERNAL(
+                    packedNibbleIndex.NibbleIdx == nibbleIdx,
+                    "deserialized nibbleIdx (" << nibbleIdx << ") is not equal to expected "
+                    "packedNibbleIndex.NibbleIdx (" << packedNibbleIndex.NibbleIdx << ")"
+                );
+
+                (*dst)[*featureIdx] = MakeHolder<TPackedNibbleValuesHolderImpl<IColumnType>>(
+                    flatFeatureIdx,
+                    (**packedNibbleFeaturesData).SrcData[packedNibbleIndex.PackIdx],
+                    packedNibbleIndex.NibbleIdx,
+                    subsetIndexing
+                );
             } else {
                 ui32 bitsPerKey;
                 binSaver->Add(0, &bitsPerKey);
@@ -895,6 +939,7 @@ void NCB::TQuantizedObjectsData::Load(
         subsetIndexing,
         /*packedBinaryFeaturesData*/ Nothing(),
         /*exclusiveFeatureBundlesData*/ Nothing(),
+        /*packedNibbleFeaturesData*/ Nothing(),
         binSaver,
         &FloatFeatures
     );
@@ -903,6 +948,7 @@ void NCB::TQuantizedObjectsData::Load(
         subsetIndexing,
         /*packedBinaryFeaturesData*/ Nothing(),
         /*exclusiveFeatureBundlesData*/ Nothing(),
+        /*packedNibbleFeaturesData*/ Nothing(),
         binSaver,
         &CatFeatures
     );
@@ -930,6 +976,10 @@ static void SaveFeatures(
                            = dynamic_cast<const TBundlePartValuesHolderImpl<IColumnType>*>(column))
             {
                 SaveMulti(binSaver, column->GetId(), column->GetSize());
+            } else if (auto* packedNibbleValues
+                           = dynamic_cast<const TPackedNibbleValuesHolderImpl<IColumnType>*>(column))
+            {
+                SaveMulti(binSaver, column->GetId(), column->GetSize(), packedNibbleValues->GetNibbleIdx());
             } else {
                 // TODO(akhropov): replace by repacking (possibly in parts) to compressed array in the future
                 const auto values = column->ExtractValues(localExecutor);
@@ -1069,6 +1119,19 @@ void NCB::TExclusiveFeatureBundlesData::Save(
                     }
                 );
                 break;
+            case 4:
+                subsetIndexing.ForEach(
+                    [&](ui32 /*idx*/, ui32 srcIdx) {
+                        SaveMulti(
+                            binSaver,
+                            srcDataElementArray[4 * srcIdx],
+                            srcDataElementArray[4 * srcIdx + 1],
+                            srcDataElementArray[4 * srcIdx + 2],
+                            srcDataElementArray[4 * srcIdx + 3]
+                        );
+                    }
+                );
+                break;
             default:
                 ythrow TCatBoostException() << "Wrong features bundle size in bytes : "
                     << MetaData[bundleIdx].SizeInBytes;
@@ -1115,6 +1178,7 @@ NCB::TPackedBinaryFeaturesData::TPackedBinaryFeaturesData(
     featuresLayout.IterateOverAvailableFeatures<EFeatureType::Float>(
         [&] (TFloatFeatureIdx floatFeatureIdx) {
             if (!exclusiveFeatureBundlesData.FloatFeatureToBundlePart[*floatFeatureIdx] &&
+                !featuresLayout.IsSparseFloatFeature(*floatFeatureIdx) &&
                 (quantizedFeaturesInfo.GetBorders(floatFeatureIdx).size() == 1))
             {
                 FloatFeatureToPackedBinaryIndex[*floatFeatureIdx]
@@ -1233,6 +1297,128 @@ TString NCB::DbgDumpMetaData(const NCB::TPackedBinaryFeaturesData& packedBinaryF
 }
 
 
+NCB::TPackedNibbleFeaturesData::TPackedNibbleFeaturesData(
+    const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+    const TExclusiveFeatureBundlesData& exclusiveFeatureBundlesData,
+    const TPackedBinaryFeaturesData& packedBinaryFeaturesData,
+    bool dontPack
+) {
+    const auto& featuresLayout = *quantizedFeaturesInfo.GetFeaturesLayout();
+    FloatFeatureToPackedNibbleIndex.resize(featuresLayout.GetFloatFeatureCount());
+
+    if (dontPack) {
+        return;
+    }
+
+    featuresLayout.IterateOverAvailableFeatures<EFeatureType::Float>(
+        [&] (TFloatFeatureIdx floatFeatureIdx) {
+            if (exclusiveFeatureBundlesData.FloatFeatureToBundlePart[*floatFeatureIdx] ||
+                packedBinaryFeaturesData.FloatFeatureToPackedBinaryIndex[*floatFeatureIdx] ||
+                featuresLayout.IsSparseFloatFeature(*floatFeatureIdx))
+            {
+                return;
+            }
+            const ui32 binCount = SafeIntegerCast<ui32>(
+                quantizedFeaturesInfo.GetBorders(floatFeatureIdx).size() + 1
+            );
+            if ((binCount < 2) || (binCount > MaxNibbleFeatureBinCount)) {
+                return;
+            }
+
+            const auto packedNibbleIndex = TPackedNibbleIndex::FromLinearIdx(
+                SafeIntegerCast<ui32>(PackedNibbleToSrcIndex.size())
+            );
+            FloatFeatureToPackedNibbleIndex[*floatFeatureIdx] = packedNibbleIndex;
+            PackedNibbleToSrcIndex.push_back(*floatFeatureIdx);
+            if (packedNibbleIndex.NibbleIdx == 0) {
+                MetaData.emplace_back();
+            }
+            MetaData.back().BinCounts.push_back(binCount);
+        }
+    );
+    SrcData.resize(MetaData.size());
+}
+
+void NCB::TPackedNibbleFeaturesData::Save(
+    const TArraySubsetIndexing<ui32>& subsetIndexing,
+    IBinSaver* binSaver
+) const {
+    Y_ASSERT(!binSaver->IsReading());
+
+    SaveMulti(
+        binSaver,
+        FloatFeatureToPackedNibbleIndex,
+        PackedNibbleToSrcIndex,
+        MetaData,
+        subsetIndexing.Size()
+    );
+
+    auto srcDataSize = SafeIntegerCast<IBinSaver::TStoredSize>(SrcData.size());
+    binSaver->Add(0, &srcDataSize);
+
+    for (const auto& srcDataElement : SrcData) {
+        const auto srcDataElementArray = *srcDataElement;
+        subsetIndexing.ForEach(
+            [&](ui32 /*idx*/, ui32 srcIdx) {
+                SaveMulti(binSaver, srcDataElementArray[srcIdx]);
+            }
+        );
+    }
+}
+
+void NCB::TPackedNibbleFeaturesData::Load(IBinSaver* binSaver) {
+    Y_ASSERT(binSaver->IsReading());
+
+    ui32 objectCount = 0;
+    LoadMulti(
+        binSaver,
+        &FloatFeatureToPackedNibbleIndex,
+        &PackedNibbleToSrcIndex,
+        &MetaData,
+        &objectCount
+    );
+
+    IBinSaver::TStoredSize srcDataSize = 0;
+    binSaver->Add(0, &srcDataSize);
+    SrcData.resize(srcDataSize);
+
+    for (auto srcDataIdx : xrange(srcDataSize)) {
+        TVector<TNibbleFeaturesPack> packedData;
+        packedData.yresize(objectCount);
+        binSaver->AddRawData(0, packedData.data(), (i64)objectCount*sizeof(TNibbleFeaturesPack));
+
+        SrcData[srcDataIdx] = TMaybeOwningArrayHolder<TNibbleFeaturesPack>::CreateOwning(
+            std::move(packedData)
+        );
+    }
+}
+
+TString NCB::DbgDumpMetaData(const NCB::TPackedNibbleFeaturesData& packedNibbleFeaturesData) {
+    TStringBuilder sb;
+    sb << "FloatFeatureToPackedNibbleIndex="
+       << NCB::DbgDumpWithIndices(packedNibbleFeaturesData.FloatFeatureToPackedNibbleIndex, true)
+       << "PackedNibbleToSrcIndex=[";
+
+    const auto& packedNibbleToSrcIndex = packedNibbleFeaturesData.PackedNibbleToSrcIndex;
+    if (!packedNibbleToSrcIndex.empty()) {
+        sb << Endl;
+        for (auto linearIdx : xrange(packedNibbleToSrcIndex.size())) {
+            auto packedNibbleIndex = NCB::TPackedNibbleIndex::FromLinearIdx(linearIdx);
+            sb << "LinearIdx=" << linearIdx << "," << DbgDump(packedNibbleIndex) << " : FloatFeatureIdx="
+               << packedNibbleToSrcIndex[linearIdx] << ",BinCount="
+               << packedNibbleFeaturesData.MetaData[packedNibbleIndex.PackIdx].BinCounts[
+                      packedNibbleIndex.NibbleIdx
+                  ]
+               << Endl;
+        }
+        sb << Endl;
+    }
+    sb << "]\n";
+
+    return sb;
+}
+
+
 void NCB::TQuantizedForCPUObjectsData::Load(
     const TArraySubsetIndexing<ui32>* subsetIndexing,
     TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
@@ -1240,12 +1426,14 @@ void NCB::TQuantizedForCPUObjectsData::Load(
 ) {
     PackedBinaryFeaturesData.Load(binSaver);
     ExclusiveFeatureBundlesData.Load(binSaver);
+    PackedNibbleFeaturesData.Load(binSaver);
     Data.QuantizedFeaturesInfo = quantizedFeaturesInfo;
     LoadFeatures<EFeatureType::Float>(
         *(quantizedFeaturesInfo->GetFeaturesLayout()),
         subsetIndexing,
         &PackedBinaryFeaturesData,
         &ExclusiveFeatureBundlesData,
+        &PackedNibbleFeaturesData,
         binSaver,
         &Data.FloatFeatures
     );
@@ -1254,6 +1442,7 @@ void NCB::TQuantizedForCPUObjectsData::Load(
         subsetIndexing,
         &PackedBinaryFeaturesData,
         &ExclusiveFeatureBundlesData,
+        /*packedNibbleFeaturesData*/ Nothing(),
         binSaver,
         &Data.CatFeatures
     );
@@ -1275,11 +1464,20 @@ NCB::TQuantizedForCPUObjectsDataProvider::TQuantizedForCPUObjectsDataProvider(
         localExecutor
       )
 {
+    // nibble packing is optional, data from builders that don't use it has empty lookup
+    if (data.PackedNibbleFeaturesData.FloatFeatureToPackedNibbleIndex.empty()) {
+        data.PackedNibbleFeaturesData.FloatFeatureToPackedNibbleIndex.resize(Data.FloatFeatures.size());
+    }
     if (!skipCheck) {
-        Check(data.PackedBinaryFeaturesData, data.ExclusiveFeatureBundlesData);
+        Check(
+            data.PackedBinaryFeaturesData,
+            data.ExclusiveFeatureBundlesData,
+            data.PackedNibbleFeaturesData
+        );
     }
     PackedBinaryFeaturesData = std::move(data.PackedBinaryFeaturesData);
     ExclusiveFeatureBundlesData = std::move(data.ExclusiveFeatureBundlesData);
+    PackedNibbleFeaturesData = std::move(data.PackedNibbleFeaturesData);
 
     CatFeatureUniqueValuesCounts.yresize(Data.CatFeatures.size());
     for (auto catFeatureIdx : xrange(Data.CatFeatures.size())) {
@@ -1300,6 +1498,7 @@ NCB::TObjectsDataProviderPtr NCB::TQuantizedForCPUObjectsDataProvider::GetSubset
     subsetData.Data = Data.GetSubset(subsetCommonData.SubsetIndexing.Get());
     subsetData.PackedBinaryFeaturesData = PackedBinaryFeaturesData;
     subsetData.ExclusiveFeatureBundlesData = ExclusiveFeatureBundlesData;
+    subsetData.PackedNibbleFeaturesData = PackedNibbleFeaturesData;
 
     return MakeIntrusive<TQuantizedForCPUObjectsDataProvider>(
         objectsGroupingSubset.GetSubsetGrouping(),
@@ -1321,6 +1520,8 @@ static void MakeConsecutiveArrayFeatures(
     const TExclusiveFeatureBundlesData& newExclusiveFeatureBundlesData,
     const TVector<TMaybe<TPackedBinaryIndex>>& featureToPackedBinaryIndex,
     const TVector<TMaybeOwningArrayHolder<TBinaryFeaturesPack>>& newPackedBinaryFeatures,
+    TConstArrayRef<TMaybe<TPackedNibbleIndex>> featureToPackedNibbleIndex, // can be empty if not applicable
+    const TVector<TMaybeOwningArrayHolder<TNibbleFeaturesPack>>& newPackedNibbleFeatures,
     NPar::TLocalExecutor* localExecutor,
     TVector<THolder<IColumnType>>* dst
 ) {
@@ -1353,6 +1554,50 @@ static void MakeConsecutiveArrayFeatures(
                     maybePackedBinaryIndex->BitIdx,
                     newSubsetIndexing
                 );
+            } else if (!featureToPackedNibbleIndex.empty() && featureToPackedNibbleIndex[*featureIdx]) {
+                const auto packedNibbleIndex = *featureToPackedNibbleIndex[*featureIdx];
+                (*dst)[*featureIdx] = MakeHolder<TPackedNibbleValuesHolderImpl<IColumnType>>(
+                    srcColumn.GetId(),
+                    newPackedNibbleFeatures[packedNibbleIndex.PackIdx],
+                    packedNibbleIndex.NibbleIdx,
+                    newSubsetIndexing
+                );
+            } else if (auto* srcSparseValuesHolder
+                           = dynamic_cast<const TSparseValuesHolderImpl<IColumnType>*>(&srcColumn))
+            {
+                tasks.emplace_back(
+                    [&, featureIdx, srcSparseValuesHolder]() {
+                        using TValueType = typename IColumnType::TValueType;
+
+                        const auto& srcSparseData = *srcSparseValuesHolder->GetSparseSrcData();
+                        const TVector<ui32> srcToDstIndices = GetInverseSubsetIndexing(
+                            *srcSparseValuesHolder->GetSubsetIndexing(),
+                            srcSparseData.GetSize()
+                        );
+
+                        TVector<std::pair<ui32, TValueType>> dstIndexedValues;
+                        srcSparseData.ForEachNonDefault(
+                            [&] (ui32 srcIdx, TValueType value) {
+                                const ui32 dstIdx = srcToDstIndices[srcIdx];
+                                if (dstIdx != Max<ui32>()) {
+                                    dstIndexedValues.emplace_back(dstIdx, value);
+                                }
+                            }
+                        );
+
+                        (*dst)[*featureIdx] = MakeHolder<TSparseValuesHolderImpl<IColumnType>>(
+                            srcColumn.GetId(),
+                            MakeAtomicShared<const TSparseArray<TValueType, ui32>>(
+                                TSparseArray<TValueType, ui32>::CreateFromUnordered(
+                                    objectCount,
+                                    srcSparseData.GetDefaultValue(),
+                                    std::move(dstIndexedValues)
+                                )
+                            ),
+                            newSubsetIndexing
+                        );
+                    }
+                );
             } else {
                 tasks.emplace_back(
                     [&, featureIdx, localExecutor]() {
@@ -1455,6 +1700,13 @@ static void MakeConsecutiveExclusiveFeatureBundles(
                             localExecutor
                         );
                         break;
+                    case 4:
+                        bundleData = CreateConsecutiveData(
+                            (const ui32*)(*bundleData).data(),
+                            subsetIndexing,
+                            localExecutor
+                        );
+                        break;
                     default:
                         CB_ENSURE_INTERNAL(false, "unsupported Bundle SizeInBytes = " << sizeInBytes);
                 }
@@ -1467,23 +1719,25 @@ static void MakeConsecutiveExclusiveFeatureBundles(
 
 
 
-static void MakeConsecutivePackedBinaryFeatures(
+// used both for binary and nibble features packs
+template <class TFeaturesPack>
+static void MakeConsecutivePackedFeatures(
     const NCB::TFeaturesArraySubsetIndexing& subsetIndexing,
     NPar::TLocalExecutor* localExecutor,
-    TVector<TMaybeOwningArrayHolder<TBinaryFeaturesPack>>* packedBinaryFeatures
+    TVector<TMaybeOwningArrayHolder<TFeaturesPack>>* packedFeatures
 ) {
     TVector<std::function<void()>> tasks;
 
-    for (auto i : xrange(packedBinaryFeatures->size())) {
+    for (auto i : xrange(packedFeatures->size())) {
         tasks.emplace_back(
             [&, i] () {
-                auto& packedBinaryFeaturesPart = (*packedBinaryFeatures)[i];
-                TVector<TBinaryFeaturesPack> consecutiveData = NCB::GetSubset<TBinaryFeaturesPack>(
-                    *packedBinaryFeaturesPart,
+                auto& packedFeaturesPart = (*packedFeatures)[i];
+                TVector<TFeaturesPack> consecutiveData = NCB::GetSubset<TFeaturesPack>(
+                    *packedFeaturesPart,
                     subsetIndexing,
                     localExecutor
                 );
-                packedBinaryFeaturesPart = TMaybeOwningArrayHolder<TBinaryFeaturesPack>::CreateOwning(
+                packedFeaturesPart = TMaybeOwningArrayHolder<TFeaturesPack>::CreateOwning(
                     std::move(consecutiveData)
                 );
             }
@@ -1520,7 +1774,7 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
 
         tasks.emplace_back(
             [&] () {
-                MakeConsecutivePackedBinaryFeatures(
+                MakeConsecutivePackedFeatures(
                     GetFeaturesArraySubsetIndexing(),
                     localExecutor,
                     &PackedBinaryFeaturesData.SrcData
@@ -1528,6 +1782,16 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
             }
         );
 
+        tasks.emplace_back(
+            [&] () {
+                MakeConsecutivePackedFeatures(
+                    GetFeaturesArraySubsetIndexing(),
+                    localExecutor,
+                    &PackedNibbleFeaturesData.SrcData
+                );
+            }
+        );
+
         ExecuteTasksInParallel(&tasks, localExecutor);
     }
 
@@ -1545,6 +1809,8 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
                     ExclusiveFeatureBundlesData,
                     PackedBinaryFeaturesData.FloatFeatureToPackedBinaryIndex,
                     PackedBinaryFeaturesData.SrcData,
+                    PackedNibbleFeaturesData.FloatFeatureToPackedNibbleIndex,
+                    PackedNibbleFeaturesData.SrcData,
                     localExecutor,
                     &Data.FloatFeatures
                 );
@@ -1561,6 +1827,8 @@ void NCB::TQuantizedForCPUObjectsDataProvider::EnsureConsecutiveFeaturesData(
                     ExclusiveFeatureBundlesData,
                     PackedBinaryFeaturesData.CatFeatureToPackedBinaryIndex,
                     PackedBinaryFeaturesData.SrcData,
+                    /*featureToPackedNibbleIndex*/ TConstArrayRef<TMaybe<TPackedNibbleIndex>>(),
+                    PackedNibbleFeaturesData.SrcData,
                     localExecutor,
                     &Data.CatFeatures
                 );
@@ -1583,6 +1851,8 @@ static void CheckFeaturesByType(
     const TVector<std::pair<EFeatureType, ui32>>& packedBinaryToSrcIndex,
     const TVector<TMaybe<TExclusiveBundleIndex>>& featureToBundlePart,
     const TVector<TExclusiveFeaturesBundle>& bundlesMetaData,
+    TConstArrayRef<TMaybe<TPackedNibbleIndex>> featureToPackedNibbleIndex, // can be empty if not applicable
+    TConstArrayRef<ui32> packedNibbleToSrcIndex,
     const TStringBuf featureTypeName
 ) {
     CB_ENSURE_INTERNAL(
@@ -1599,12 +1869,20 @@ static void CheckFeaturesByType(
 
         auto maybePackedBinaryIndex = featureToPackedBinaryIndex[featureIdx];
         auto maybeBundlePart = featureToBundlePart[featureIdx];
+        auto maybePackedNibbleIndex = featureToPackedNibbleIndex.empty() ?
+            Nothing()
+            : featureToPackedNibbleIndex[featureIdx];
 
         CB_ENSURE_INTERNAL(
             !maybePackedBinaryIndex || !maybeBundlePart,
             "Data." << featureType << "Features[" << featureIdx
             << "] is both binary packed and in exclusive bundle"
         );
+        CB_ENSURE_INTERNAL(
+            !maybePackedNibbleIndex || (!maybePackedBinaryIndex && !maybeBundlePart),
+            "Data." << featureType << "Features[" << featureIdx
+            << "] is nibble packed and also binary packed or in exclusive bundle"
+        );
 
         if (maybePackedBinaryIndex) {
             auto requiredTypePtr = dynamic_cast<TPackedBinaryValuesHolderImpl<TBaseFeatureColumn>*>(dataPtr);
@@ -1658,12 +1936,35 @@ static void CheckFeaturesByType(
                 bundlePart.Bounds == requiredTypePtr->GetBoundsInBundle(),
                 "Bundled feature: Bounds mismatch between metadata and column data"
             );
+        } else if (maybePackedNibbleIndex) {
+            auto requiredTypePtr = dynamic_cast<TPackedNibbleValuesHolderImpl<TBaseFeatureColumn>*>(dataPtr);
+            CB_ENSURE_INTERNAL(
+                requiredTypePtr,
+                "Data." << featureType << "Features[" << featureIdx << "] is not of type TQuantized"
+                << featureTypeName << "PackedNibbleValuesHolder"
+            );
+            CB_ENSURE_INTERNAL(
+                requiredTypePtr->GetNibbleIdx() == maybePackedNibbleIndex->NibbleIdx,
+                "Nibble packed feature: NibbleIdx mismatch between lookup and column data"
+            );
+
+            auto linearPackedNibbleFeatureIdx = maybePackedNibbleIndex->GetLinearIdx();
+            CB_ENSURE_INTERNAL(
+                linearPackedNibbleFeatureIdx < packedNibbleToSrcIndex.size(),
+                "linearPackedNibbleFeatureIdx (" << linearPackedNibbleFeatureIdx << ") is greater than "
+                "packedNibbleToSrcIndex.size (" << packedNibbleToSrcIndex.size() << ')'
+            );
+            CB_ENSURE_INTERNAL(
+                packedNibbleToSrcIndex[linearPackedNibbleFeatureIdx] == featureIdx,
+                "packedNibbleToSrcIndex[" << linearPackedNibbleFeatureIdx << "] feature index is not "
+                << featureIdx
+            );
         } else {
             auto requiredTypePtr = dynamic_cast<TCompressedValuesHolderImpl<TBaseFeatureColumn>*>(dataPtr);
             CB_ENSURE_INTERNAL(
-                requiredTypePtr,
+                requiredTypePtr || dynamic_cast<TSparseValuesHolderImpl<TBaseFeatureColumn>*>(dataPtr),
                 "Data." << featureType << "Features[" << featureIdx << "] is not of type TQuantized"
-                << featureTypeName << "ValuesHolder"
+                << featureTypeName << "ValuesHolder or TQuantized" << featureTypeName << "SparseValuesHolder"
             );
         }
     }
@@ -1675,13 +1976,16 @@ bool NCB::TQuantizedForCPUObjectsDataProvider::IsPackingCompatibleWith(
     return GetQuantizedFeaturesInfo()->IsSupersetOf(*rhs.GetQuantizedFeaturesInfo()) &&
         (PackedBinaryFeaturesData.PackedBinaryToSrcIndex
          == rhs.PackedBinaryFeaturesData.PackedBinaryToSrcIndex) &&
-        (ExclusiveFeatureBundlesData.MetaData == rhs.ExclusiveFeatureBundlesData.MetaData);
+        (ExclusiveFeatureBundlesData.MetaData == rhs.ExclusiveFeatureBundlesData.MetaData) &&
+        (PackedNibbleFeaturesData.PackedNibbleToSrcIndex
+         == rhs.PackedNibbleFeaturesData.PackedNibbleToSrcIndex);
 }
 
 
 void NCB::TQuantizedForCPUObjectsDataProvider::Check(
     const TPackedBinaryFeaturesData& packedBinaryData,
-    const TExclusiveFeatureBundlesData& exclusiveFeatureBundlesData
+    const TExclusiveFeatureBundlesData& exclusiveFeatureBundlesData,
+    const TPackedNibbleFeaturesData& packedNibbleData
 ) const {
     CheckFeaturesByType(
         EFeatureType::Float,
@@ -1690,6 +1994,8 @@ void NCB::TQuantizedForCPUObjectsDataProvider::Check(
         packedBinaryData.PackedBinaryToSrcIndex,
         exclusiveFeatureBundlesData.FloatFeatureToBundlePart,
         exclusiveFeatureBundlesData.MetaData,
+        packedNibbleData.FloatFeatureToPackedNibbleIndex,
+        packedNibbleData.PackedNibbleToSrcIndex,
         "Float"
     );
     CheckFeaturesByType(
@@ -1699,6 +2005,8 @@ void NCB::TQuantizedForCPUObjectsDataProvider::Check(
         packedBinaryData.PackedBinaryToSrcIndex,
         exclusiveFeatureBundlesData.CatFeatureToBundlePart,
         exclusiveFeatureBundlesData.MetaData,
+        /*featureToPackedNibbleIndex*/ TConstArrayRef<TMaybe<TPackedNibbleIndex>>(),
+        /*packedNibbleToSrcIndex*/ TConstArrayRef<ui32>(),
         "Cat"
     );
 }
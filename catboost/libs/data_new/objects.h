@@ -22,6 +22,7 @@
 #include <library/dbg_output/dump.h>
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/maybe.h>
 #include <util/generic/hash.h>
@@ -464,6 +465,35 @@ namespace NCB {
         TPackedBinaryIndex AddFeature(EFeatureType featureType, ui32 perTypeFeatureIdx);
     };
 
+
+    // only float features are nibble-packed
+    struct TPackedNibbleFeaturesData {
+        // lookups
+        TVector<TMaybe<TPackedNibbleIndex>> FloatFeatureToPackedNibbleIndex; // [floatFeatureIdx]
+        TVector<ui32> PackedNibbleToSrcIndex; // [linearPackedNibbleIndex] -> floatFeatureIdx
+
+        TVector<TNibbleFeaturesPackMetaData> MetaData; // [packIdx]
+
+        // shared source data, apply SubsetIndexing
+        TVector<TMaybeOwningArrayHolder<TNibbleFeaturesPack>> SrcData; // [packIdx][objectIdx][nibbleIdx]
+
+    public:
+        TPackedNibbleFeaturesData() = default;
+
+        /* does not init data in SrcData elements, it has to be filled later if necessary
+         * features already in exclusive bundles or binary packs are not packed
+         */
+        TPackedNibbleFeaturesData(
+            const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
+            const TExclusiveFeatureBundlesData& exclusiveFeatureBundlesData,
+            const TPackedBinaryFeaturesData& packedBinaryFeaturesData,
+            bool dontPack = false // set true to disable nibble features packing
+        );
+
+        void Save(const TArraySubsetIndexing<ui32>& subsetIndexing, IBinSaver* binSaver) const;
+        void Load(IBinSaver* binSaver);
+    };
+
 }
 
 template <>
@@ -479,17 +509,35 @@ struct TDumper<TMaybe<NCB::TPackedBinaryIndex>> {
 };
 
 
+template <>
+struct TDumper<TMaybe<NCB::TPackedNibbleIndex>> {
+    template <class S>
+    static inline void Dump(S& s, const TMaybe<NCB::TPackedNibbleIndex>& maybePackedNibbleIndex) {
+        if (maybePackedNibbleIndex) {
+            s << DbgDump(*maybePackedNibbleIndex);
+        } else {
+            s << '-';
+        }
+    }
+};
+
+
 namespace NCB {
     TString DbgDumpMetaData(const TPackedBinaryFeaturesData& packedBinaryFeaturesData);
+    TString DbgDumpMetaData(const TPackedNibbleFeaturesData& packedNibbleFeaturesData);
 
     using TPackedBinaryFeaturesArraySubset
         = TArraySubset<const TMaybeOwningArrayHolder<TBinaryFeaturesPack>, ui32>;
 
+    using TPackedNibbleFeaturesArraySubset
+        = TArraySubset<const TMaybeOwningArrayHolder<TNibbleFeaturesPack>, ui32>;
+
 
     struct TQuantizedForCPUObjectsData {
         TQuantizedObjectsData Data;
         TPackedBinaryFeaturesData PackedBinaryFeaturesData;
         TExclusiveFeatureBundlesData ExclusiveFeatureBundlesData;
+        TPackedNibbleFeaturesData PackedNibbleFeaturesData;
 
     public:
         void Load(
@@ -543,6 +591,16 @@ namespace NCB {
                 "Called TQuantizedForCPUObjectsDataProvider::GetFloatFeature for bundled float feature #"
                 << floatFeatureIdx
             );
+            CB_ENSURE_INTERNAL(
+                !PackedNibbleFeaturesData.FloatFeatureToPackedNibbleIndex[floatFeatureIdx],
+                "Called TQuantizedForCPUObjectsDataProvider::GetFloatFeature for nibble packed float feature #"
+                << floatFeatureIdx
+            );
+            CB_ENSURE_INTERNAL(
+                !GetSparseFloatFeature(floatFeatureIdx),
+                "Called TQuantizedForCPUObjectsDataProvider::GetFloatFeature for sparse float feature #"
+                << floatFeatureIdx
+            );
             return MakeMaybeData(
                 // checked above that this cast is safe
                 static_cast<const TQuantizedFloatValuesHolder*>(
@@ -551,8 +609,26 @@ namespace NCB {
             );
         }
 
+        // returns nullptr if feature is not available or is not stored as sparse
+        const TQuantizedFloatSparseValuesHolder* GetSparseFloatFeature(ui32 floatFeatureIdx) const {
+            return dynamic_cast<const TQuantizedFloatSparseValuesHolder*>(
+                Data.FloatFeatures[floatFeatureIdx].Get()
+            );
+        }
+
+        bool HasSparseFloatFeatures() const {
+            return AnyOf(
+                xrange(Data.FloatFeatures.size()),
+                [this] (size_t floatFeatureIdx) { return GetSparseFloatFeature(floatFeatureIdx) != nullptr; }
+            );
+        }
+
         // low-level function, data is without subset indexing, apply external subset indexing!
+        // sparse features data is densified on first call
         const ui8* GetFloatFeatureRawSrcData(ui32 floatFeatureIdx) const {
+            if (const auto* sparseFeature = GetSparseFloatFeature(floatFeatureIdx)) {
+                return sparseFeature->GetDenseSrcData();
+            }
             return *((*GetNonPackedFloatFeature(floatFeatureIdx))->GetArrayData<ui8>().GetSrc());
         }
 
@@ -631,6 +707,39 @@ namespace NCB {
         }
 
 
+        size_t GetNibbleFeaturesPacksSize() const {
+            return PackedNibbleFeaturesData.SrcData.size();
+        }
+
+        TPackedNibbleFeaturesArraySubset GetNibbleFeaturesPack(ui32 packIdx) const {
+            return TPackedNibbleFeaturesArraySubset(
+                &PackedNibbleFeaturesData.SrcData[packIdx],
+                CommonData.SubsetIndexing.Get()
+            );
+        }
+
+        TConstArrayRef<TNibbleFeaturesPackMetaData> GetNibbleFeaturesPacksMetaData() const {
+            return PackedNibbleFeaturesData.MetaData;
+        }
+
+        TMaybe<TPackedNibbleIndex> GetFloatFeatureToPackedNibbleIndex(TFloatFeatureIdx floatFeatureIdx) const {
+            return PackedNibbleFeaturesData.FloatFeatureToPackedNibbleIndex[*floatFeatureIdx];
+        }
+
+        TConstArrayRef<TMaybe<TPackedNibbleIndex>> GetFloatFeaturesToPackedNibbleIndex() const {
+            return PackedNibbleFeaturesData.FloatFeatureToPackedNibbleIndex;
+        }
+
+        bool IsFeaturePackedNibble(TFloatFeatureIdx floatFeatureIdx) const {
+            return GetFloatFeatureToPackedNibbleIndex(floatFeatureIdx).Defined();
+        }
+
+        // returns floatFeatureIdx
+        ui32 GetPackedNibbleFeatureSrcIndex(TPackedNibbleIndex packedNibbleIndex) const {
+            return PackedNibbleFeaturesData.PackedNibbleToSrcIndex[packedNibbleIndex.GetLinearIdx()];
+        }
+
+
         size_t GetExclusiveFeatureBundlesSize() const {
             return ExclusiveFeatureBundlesData.MetaData.size();
         }
@@ -675,7 +784,7 @@ namespace NCB {
             return GetFeatureToExclusiveBundleIndex(featureIdx).Defined();
         }
 
-        /* binary packs and bundles in *this are compatible with rhs
+        /* binary packs, nibble packs and bundles in *this are compatible with rhs
          * useful for low-level compatibility (for example when calculating hashes by packs/bundles)
          */
         bool IsPackingCompatibleWith(const TQuantizedForCPUObjectsDataProvider& rhs) const;
@@ -687,18 +796,21 @@ namespace NCB {
         void SaveDataNonSharedPart(IBinSaver* binSaver) const {
             PackedBinaryFeaturesData.Save(*CommonData.SubsetIndexing, binSaver);
             ExclusiveFeatureBundlesData.Save(*CommonData.SubsetIndexing, binSaver);
+            PackedNibbleFeaturesData.Save(*CommonData.SubsetIndexing, binSaver);
             Data.SaveNonSharedPart(binSaver);
         }
 
     private:
         void Check(
             const TPackedBinaryFeaturesData& packedBinaryData,
-            const TExclusiveFeatureBundlesData& exclusiveFeatureBundlesData
+            const TExclusiveFeatureBundlesData& exclusiveFeatureBundlesData,
+            const TPackedNibbleFeaturesData& packedNibbleData
         ) const;
 
     private:
         TPackedBinaryFeaturesData PackedBinaryFeaturesData;
         TExclusiveFeatureBundlesData ExclusiveFeatureBundlesData;
+        TPackedNibbleFeaturesData PackedNibbleFeaturesData;
 
         // store directly instead of looking up in Data.QuantizedFeaturesInfo for runtime efficiency
         TVector<TCatFeatureUniqueValuesCounts> CatFeatureUniqueValuesCounts; // [catFeatureIdx]
@@ -0,0 +1,165 @@
+#pragma once
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/binsaver/bin_saver.h>
+#include <library/dbg_output/dump.h>
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
+#include <util/generic/utility.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/system/types.h>
+#include <util/system/yassert.h>
+
+#include <climits>
+#include <tuple>
+#include <type_traits>
+
+
+namespace NCB {
+
+    static_assert(CHAR_BIT == 8, "CatBoost requires CHAR_BIT == 8");
+
+    /* Features with no more than 16 bins (15 borders) are stored as 4-bit values (nibbles),
+     * two features per pack. Histograms for both features in the pack are calculated by a single pass
+     * over pack data.
+     */
+    using TNibbleFeaturesPack = ui8;
+
+    constexpr ui32 NibbleBits = 4;
+    constexpr ui32 NibblesPerPack = sizeof(TNibbleFeaturesPack) * CHAR_BIT / NibbleBits;
+    constexpr ui32 MaxNibbleFeatureBinCount = 1 << NibbleBits;
+
+    // 2d index: [PackIdx][NibbleIdx]
+    struct TPackedNibbleIndex {
+        ui32 PackIdx;
+        ui8 NibbleIdx;
+
+    public:
+        // needed for BinSaver
+        explicit TPackedNibbleIndex(ui32 packIdx = 0, ui32 nibbleIdx = 0)
+            : PackIdx(packIdx)
+            , NibbleIdx(nibbleIdx)
+        {}
+
+        static TPackedNibbleIndex FromLinearIdx(ui32 linearIdx) {
+            return TPackedNibbleIndex(linearIdx / NibblesPerPack, linearIdx % NibblesPerPack);
+        }
+
+        bool operator==(const TPackedNibbleIndex rhs) const {
+            return std::tie(PackIdx, NibbleIdx) == std::tie(rhs.PackIdx, rhs.NibbleIdx);
+        }
+
+        SAVELOAD(PackIdx, NibbleIdx);
+
+        ui32 GetLinearIdx() const {
+            return NibblesPerPack*PackIdx + NibbleIdx;
+        }
+
+        ui8 GetShift() const {
+            return NibbleIdx * NibbleBits;
+        }
+    };
+
+
+    // bin counts of features in the pack, needed for score calculation
+    struct TNibbleFeaturesPackMetaData {
+        TVector<ui32> BinCounts; // [nibbleIdx]
+
+    public:
+        bool operator==(const TNibbleFeaturesPackMetaData& rhs) const {
+            return BinCounts == rhs.BinCounts;
+        }
+
+        // max pack value + 1, pack values are used as histogram buckets directly
+        ui32 GetPackBinCount() const {
+            ui32 maxPackValue = 0;
+            for (auto nibbleIdx : xrange(BinCounts.size())) {
+                maxPackValue |= (BinCounts[nibbleIdx] - 1) << (nibbleIdx * NibbleBits);
+            }
+            return maxPackValue + 1;
+        }
+
+        ui32 GetSplitCount() const {
+            ui32 splitCount = 0;
+            for (auto binCount : BinCounts) {
+                splitCount += binCount - 1;
+            }
+            return splitCount;
+        }
+
+        SAVELOAD(BinCounts);
+    };
+
+
+    inline ui8 GetNibbleFromPack(TNibbleFeaturesPack pack, ui8 nibbleIdx) {
+        return (pack >> (nibbleIdx * NibbleBits)) & TNibbleFeaturesPack(MaxNibbleFeatureBinCount - 1);
+    }
+
+    inline void CheckNibbleIdx(ui8 nibbleIdx) {
+        CB_ENSURE_INTERNAL(
+            nibbleIdx < NibblesPerPack,
+            "nibbleIdx=" << nibbleIdx << " is out of range (nibbleIdx exclusive upper bound for "
+            "TNibbleFeaturesPack =" << NibblesPerPack << ')'
+        );
+    }
+
+    // Do not call for different nibbles in parallel!
+    template <class TSrcElement>
+    void ParallelSetNibbleFeatureInPackArray(
+        TConstArrayRef<TSrcElement> srcFeature,
+        ui8 nibbleIdx,
+        NPar::TLocalExecutor* localExecutor,
+        TArrayRef<TNibbleFeaturesPack>* dstFeaturePacks) {
+
+        static_assert(
+            std::is_unsigned<TSrcElement>::value,
+            "ParallelSetNibbleFeatureInPackArray requires unsigned source data"
+        );
+
+        CheckNibbleIdx(nibbleIdx);
+
+        const ui8 shift = nibbleIdx * NibbleBits;
+        const TNibbleFeaturesPack clearMask
+            = ~(TNibbleFeaturesPack(MaxNibbleFeatureBinCount - 1) << shift);
+
+        int objectCount = SafeIntegerCast<int>(srcFeature.size());
+        NPar::TLocalExecutor::TExecRangeParams rangeParams(0, objectCount);
+        rangeParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+
+        localExecutor->ExecRangeWithThrow(
+            [&](int i) {
+                int startIdx = i*rangeParams.GetBlockSize();
+                int endIdx = Min(startIdx + rangeParams.GetBlockSize(), objectCount);
+
+                TNibbleFeaturesPack* dstIt = dstFeaturePacks->data() + startIdx;
+                for (auto srcIdx : xrange(startIdx, endIdx)) {
+                    const auto value = srcFeature[srcIdx];
+                    CB_ENSURE_INTERNAL(
+                        value < MaxNibbleFeatureBinCount,
+                        "attempt to pack feature value " << value << " into a nibble"
+                    );
+                    *dstIt = (*dstIt & clearMask) | (TNibbleFeaturesPack(value) << shift);
+                    ++dstIt;
+                }
+            },
+            0,
+            rangeParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+    }
+
+}
+
+
+template <>
+struct TDumper<NCB::TPackedNibbleIndex> {
+    template <class S>
+    static inline void Dump(S& s, const NCB::TPackedNibbleIndex& packedNibbleIndex) {
+        s << "PackIdx=" << ui32(packedNibbleIndex.PackIdx)
+          << ",NibbleIdx=" << ui32(packedNibbleIndex.NibbleIdx);
+    }
+};
@@ -86,6 +86,35 @@ namespace NCB {
     }
 
 
+    // for sparse features data is densified, result holds the ownership in this case
+    static TMaybeOwningConstArrayHolder<float> GetDenseSrcData(const TFloatValuesHolder& srcFeature) {
+        if (srcFeature.IsSparse()) {
+            return TMaybeOwningConstArrayHolder<float>::CreateOwning(
+                srcFeature.GetSparseSrcData()->ExtractValues()
+            );
+        }
+        return srcFeature.GetSrcData();
+    }
+
+    // for code paths that do not support sparse data
+    static THolder<TFloatValuesHolder> MakeDenseFloatValuesHolder(const TFloatValuesHolder& srcFeature) {
+        return MakeHolder<TFloatValuesHolder>(
+            srcFeature.GetId(),
+            GetDenseSrcData(srcFeature),
+            srcFeature.GetSubsetIndexing()
+        );
+    }
+
+    /* number of occurrences of each src object in subset
+     * needed to calculate weights of default values of sparse features
+     */
+    static TVector<ui32> GetSrcObjectCounts(const TFeaturesArraySubsetIndexing& subsetIndexing, ui32 srcSize) {
+        TVector<ui32> srcObjectCounts(srcSize, 0);
+        subsetIndexing.ForEach([&] (ui32 /*idx*/, ui32 srcIdx) { ++srcObjectCounts[srcIdx]; });
+        return srcObjectCounts;
+    }
+
+
     static ui64 EstimateMaxMemUsageForFloatFeature(
         ui32 objectCount,
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
@@ -123,9 +152,67 @@ namespace NCB {
     }
 
 
+    static bool IsWeightedSplitSupported(EBorderSelectionType borderSelectionType) {
+        switch (borderSelectionType) {
+            case EBorderSelectionType::MinEntropy:
+            case EBorderSelectionType::MaxLogSum:
+            case EBorderSelectionType::GreedyLogSum:
+            case EBorderSelectionType::GreedyMinEntropy:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    /* default value is added once with weight equal to the number of its occurrences in subset
+     * so the cost does not depend on the number of default values
+     */
+    static void GetSparseFeatureValuesForBuildBorders(
+        const TFloatValuesHolder& srcFeature,
+        const TFeaturesArraySubsetIndexing& subsetForBuildBorders,
+        TConstArrayRef<ui32> srcObjectCountsForBuildBorders, // empty if subsetForBuildBorders is full
+        TVector<float>* values, // does not contain nans
+        TVector<float>* weights,
+        bool* hasNans
+    ) {
+        const auto& sparseSrcData = *srcFeature.GetSparseSrcData();
+
+        ui32 nonDefaultCount = 0;
+
+        sparseSrcData.ForEachNonDefault(
+            [&] (ui32 srcIdx, float value) {
+                const ui32 count
+                    = srcObjectCountsForBuildBorders.empty() ? 1 : srcObjectCountsForBuildBorders[srcIdx];
+                if (!count) {
+                    return;
+                }
+                nonDefaultCount += count;
+                if (IsNan(value)) {
+                    *hasNans = true;
+                } else {
+                    values->push_back(value);
+                    weights->push_back(float(count));
+                }
+            }
+        );
+
+        const ui32 defaultCount = subsetForBuildBorders.Size() - nonDefaultCount;
+        const float defaultValue = sparseSrcData.GetDefaultValue();
+        if (defaultCount) {
+            if (IsNan(defaultValue)) {
+                *hasNans = true;
+            } else {
+                values->push_back(defaultValue);
+                weights->push_back(float(defaultCount));
+            }
+        }
+    }
+
+
     static void CalcBordersAndNanMode(
         const TFloatValuesHolder& srcFeature,
         const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
+        TConstArrayRef<ui32> srcObjectCountsForBuildBorders, // used only for sparse features
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
         ENanMode* nanMode,
         TVector<float>* borders
@@ -134,28 +221,43 @@ namespace NCB {
 
         Y_VERIFY(binarizationOptions.BorderCount > 0);
 
-        TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
-
-        TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
-            srcFeatureData.GetSrc(),
-            subsetForBuildBorders
-        );
-
         // does not contain nans
         TVector<float> srcFeatureValuesForBuildBorders;
-        srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+
+        // non-empty only for sparse features
+        TVector<float> srcFeatureWeightsForBuildBorders;
 
         bool hasNans = false;
 
-        srcDataForBuildBorders.ForEach(
-            [&] (ui32 /*idx*/, float value) {
-                if (IsNan(value)) {
-                    hasNans = true;
-                } else {
-                    srcFeatureValuesForBuildBorders.push_back(value);
+        if (srcFeature.IsSparse()) {
+            GetSparseFeatureValuesForBuildBorders(
+                srcFeature,
+                *subsetForBuildBorders,
+                srcObjectCountsForBuildBorders,
+                &srcFeatureValuesForBuildBorders,
+                &srcFeatureWeightsForBuildBorders,
+                &hasNans
+            );
+        } else {
+            TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
+
+            TMaybeOwningConstArraySubset<float, ui32> srcDataForBuildBorders(
+                srcFeatureData.GetSrc(),
+                subsetForBuildBorders
+            );
+
+            srcFeatureValuesForBuildBorders.reserve(srcDataForBuildBorders.Size());
+
+            srcDataForBuildBorders.ForEach(
+                [&] (ui32 /*idx*/, float value) {
+                    if (IsNan(value)) {
+                        hasNans = true;
+                    } else {
+                        srcFeatureValuesForBuildBorders.push_back(value);
+                    }
                 }
-            }
-        );
+            );
+        }
 
         CB_ENSURE(
             (binarizationOptions.NanMode != ENanMode::Forbidden) ||
@@ -175,11 +277,35 @@ namespace NCB {
         THashSet<float> borderSet;
 
         if (nonNanValuesBorderCount > 0) {
-            borderSet = BestSplit(
-                srcFeatureValuesForBuildBorders,
-                nonNanValuesBorderCount,
-                binarizationOptions.BorderSelectionType
-            );
+            if (srcFeatureWeightsForBuildBorders.empty()) {
+                borderSet = BestSplit(
+                    srcFeatureValuesForBuildBorders,
+                    nonNanValuesBorderCount,
+                    binarizationOptions.BorderSelectionType
+                );
+            } else if (IsWeightedSplitSupported(binarizationOptions.BorderSelectionType)) {
+                borderSet = BestWeightedSplit(
+                    srcFeatureValuesForBuildBorders,
+                    srcFeatureWeightsForBuildBorders,
+                    nonNanValuesBorderCount,
+                    binarizationOptions.BorderSelectionType
+                );
+            } else {
+                // other border selection types need all values
+                TVector<float> allValues;
+                for (auto i : xrange(srcFeatureValuesForBuildBorders.size())) {
+                    allValues.insert(
+                        allValues.end(),
+                        (size_t)srcFeatureWeightsForBuildBorders[i],
+                        srcFeatureValuesForBuildBorders[i]
+                    );
+                }
+                borderSet = BestSplit(
+                    allValues,
+                    nonNanValuesBorderCount,
+                    binarizationOptions.BorderSelectionType
+                );
+            }
 
             if (borderSet.contains(-0.0f)) { // BestSplit might add negative zeros
                 borderSet.erase(-0.0f);
@@ -197,7 +323,6 @@ namespace NCB {
         }
     }
 
-
     using TGetBinFunction = std::function<ui32(size_t, size_t)>;
 
     TGetBinFunction GetQuantizedFloatFeatureFunction(
@@ -205,8 +330,9 @@ namespace NCB {
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
         TFloatFeatureIdx floatFeatureIdx
     ) {
-        TConstArrayRef<float> srcRawData
-            = **(rawObjectsData.FloatFeatures[*floatFeatureIdx]->GetArrayData().GetSrc());
+        // can be densified if feature is sparse in raw data but is not sparse in quantized data
+        const TMaybeOwningConstArrayHolder<float> srcRawData
+            = GetDenseSrcData(*rawObjectsData.FloatFeatures[*floatFeatureIdx]);
 
         auto flatFeatureIdx = quantizedFeaturesInfo.GetFeaturesLayout()->GetExternalFeatureIdx(
             *floatFeatureIdx,
@@ -244,8 +370,9 @@ namespace NCB {
         const TQuantizedFeaturesInfo& quantizedFeaturesInfo,
         TFloatFeatureIdx floatFeatureIdx
     ) {
-        TConstArrayRef<float> srcRawData
-            = **(rawObjectsData.FloatFeatures[*floatFeatureIdx]->GetArrayData().GetSrc());
+        // can be densified if feature is sparse in raw data but is not sparse in quantized data
+        const TMaybeOwningConstArrayHolder<float> srcRawData
+            = GetDenseSrcData(*rawObjectsData.FloatFeatures[*floatFeatureIdx]);
 
         auto flatFeatureIdx = quantizedFeaturesInfo.GetFeaturesLayout()->GetExternalFeatureIdx(
             *floatFeatureIdx,
@@ -432,6 +559,17 @@ namespace NCB {
                                     &bundleData
                                 );
                                 break;
+                            case 4:
+                                BundleFeatures<ui32>(
+                                    bundleMetaData,
+                                    objectCount,
+                                    *rawObjectsData,
+                                    *quantizedObjectsData,
+                                    *rawDataSubsetIndexingPtr,
+                                    localExecutor,
+                                    &bundleData
+                                );
+                                break;
                             default:
                                 CB_ENSURE_INTERNAL(
                                     false,
@@ -527,6 +665,90 @@ namespace NCB {
     }
 
 
+    // only non-default bins are stored, feature must be sparse in raw data and have no more than 255 borders
+    static THolder<IQuantizedFloatValuesHolder> MakeSparseQuantizedFloatColumn(
+        const TFloatValuesHolder& srcFeature,
+        ENanMode nanMode,
+        bool allowNans,
+        TConstArrayRef<float> borders,
+        const TFeaturesArraySubsetIndexing* dstSubsetIndexing
+    ) {
+        const auto& srcSparseData = *srcFeature.GetSparseSrcData();
+        const auto& srcSubsetIndexing = *srcFeature.GetSubsetIndexing();
+        const ui32 featureId = srcFeature.GetId();
+
+        auto quantize = [=] (float value) -> ui8 {
+            return Quantize<ui8>(featureId, allowNans, nanMode, borders, value);
+        };
+
+        const ui8 defaultBin = quantize(srcSparseData.GetDefaultValue());
+
+        TSparseArray<ui8, ui32> dstSparseData;
+        if (HoldsAlternative<TFullSubset<ui32>>(srcSubsetIndexing)) {
+            dstSparseData = srcSparseData.MapValues(defaultBin, quantize);
+        } else {
+            const TVector<ui32> srcToDstIndices = GetInverseSubsetIndexing(
+                srcSubsetIndexing,
+                srcSparseData.GetSize()
+            );
+            TVector<std::pair<ui32, ui8>> dstIndexedBins;
+            srcSparseData.ForEachNonDefault(
+                [&] (ui32 srcIdx, float value) {
+                    const ui32 dstIdx = srcToDstIndices[srcIdx];
+                    if (dstIdx != Max<ui32>()) {
+                        dstIndexedBins.emplace_back(dstIdx, quantize(value));
+                    }
+                }
+            );
+            dstSparseData = TSparseArray<ui8, ui32>::CreateFromUnordered(
+                srcSubsetIndexing.Size(),
+                defaultBin,
+                std::move(dstIndexedBins)
+            );
+        }
+
+        return MakeHolder<TQuantizedFloatSparseValuesHolder>(
+            featureId,
+            MakeAtomicShared<const TSparseArray<ui8, ui32>>(std::move(dstSparseData)),
+            dstSubsetIndexing
+        );
+    }
+
+
+    // features that are sparse both in raw data and in features layout are stored as sparse if possible
+    static THolder<IQuantizedFloatValuesHolder> MakeQuantizedFloatColumnForCPU(
+        const TFloatValuesHolder& srcFeature,
+        bool isSparseInLayout,
+        ENanMode nanMode,
+        bool allowNans,
+        TConstArrayRef<float> borders,
+        const TFeaturesArraySubsetIndexing* dstSubsetIndexing,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        if (!srcFeature.IsSparse()) {
+            return MakeQuantizedFloatColumn(
+                srcFeature,
+                nanMode,
+                allowNans,
+                borders,
+                dstSubsetIndexing,
+                localExecutor
+            );
+        }
+        if (isSparseInLayout && (CalHistogramWidthForBorders(borders.size()) == 8)) {
+            return MakeSparseQuantizedFloatColumn(srcFeature, nanMode, allowNans, borders, dstSubsetIndexing);
+        }
+        return MakeQuantizedFloatColumn(
+            *MakeDenseFloatValuesHolder(srcFeature),
+            nanMode,
+            allowNans,
+            borders,
+            dstSubsetIndexing,
+            localExecutor
+        );
+    }
+
+
     static THolder<IQuantizedCatValuesHolder> MakeQuantizedCatColumn(
         const THashedCatValuesHolder& srcFeature,
         const TCatFeaturePerfectHash& perfectHash,
@@ -618,8 +840,11 @@ namespace NCB {
                                 quantizedFeaturesInfo.GetFloatFeaturesAllowNansInTestOnly();
 
                             quantizedObjectsData->Data.FloatFeatures[*floatFeatureIdx]
-                                = MakeQuantizedFloatColumn(
+                                = MakeQuantizedFloatColumnForCPU(
                                     *(rawObjectsData->FloatFeatures[*floatFeatureIdx]),
+                                    quantizedFeaturesInfo.GetFeaturesLayout()->IsSparseFloatFeature(
+                                        *floatFeatureIdx
+                                    ),
                                     nanMode,
                                     allowNans,
                                     quantizedFeaturesInfo.GetBorders(floatFeatureIdx),
@@ -691,8 +916,9 @@ namespace NCB {
         const TQuantizedObjectsData& quantizedObjectsData,
         TFloatFeatureIdx floatFeatureIdx
     ) {
-        TConstArrayRef<float> srcRawData
-            = **(rawObjectsData.FloatFeatures[*floatFeatureIdx]->GetArrayData().GetSrc());
+        // can be densified if feature is sparse in raw data but is not sparse in quantized data
+        const TMaybeOwningConstArrayHolder<float> srcRawData
+            = GetDenseSrcData(*rawObjectsData.FloatFeatures[*floatFeatureIdx]);
         float border = quantizedObjectsData.QuantizedFeaturesInfo->GetBorders(floatFeatureIdx)[0];
 
         return [srcRawData, border](ui32 /*idx*/, ui32 srcIdx) -> TBinaryFeaturesPack {
@@ -853,10 +1079,65 @@ namespace NCB {
     }
 
 
+    // called after quantization, source columns for nibble features must already be dense ui8 arrays
+    static void PackNibbleFeatures(
+        const TFeaturesArraySubsetIndexing* quantizedDataSubsetIndexing,
+        NPar::TLocalExecutor* localExecutor,
+        TQuantizedForCPUObjectsData* quantizedObjectsData
+    ) {
+        auto& packedNibbleFeaturesData = quantizedObjectsData->PackedNibbleFeaturesData;
+        const auto& packedNibbleToSrcIndex = packedNibbleFeaturesData.PackedNibbleToSrcIndex;
+
+        const ui32 objectCount = quantizedDataSubsetIndexing->Size();
+
+        for (auto packIdx : xrange(SafeIntegerCast<ui32>(packedNibbleFeaturesData.SrcData.size()))) {
+            TVector<TNibbleFeaturesPack> dstPackedFeaturesData(objectCount, TNibbleFeaturesPack(0));
+            TArrayRef<TNibbleFeaturesPack> dstPackedFeaturesDataRef = dstPackedFeaturesData;
+
+            const ui32 startIdx = packIdx * NibblesPerPack;
+            const ui32 endIdx = Min(startIdx + NibblesPerPack, (ui32)packedNibbleToSrcIndex.size());
+
+            for (auto linearIdx : xrange(startIdx, endIdx)) {
+                const ui32 floatFeatureIdx = packedNibbleToSrcIndex[linearIdx];
+                const auto* srcColumn = dynamic_cast<const TQuantizedFloatValuesHolder*>(
+                    quantizedObjectsData->Data.FloatFeatures[floatFeatureIdx].Get()
+                );
+                CB_ENSURE_INTERNAL(
+                    srcColumn && (srcColumn->GetBitsPerKey() == 8),
+                    "Float feature #" << floatFeatureIdx << " cannot be packed into a nibble"
+                );
+                ParallelSetNibbleFeatureInPackArray(
+                    TConstArrayRef<ui8>(*srcColumn->GetArrayData<ui8>().GetSrc(), objectCount),
+                    SafeIntegerCast<ui8>(linearIdx - startIdx),
+                    localExecutor,
+                    &dstPackedFeaturesDataRef
+                );
+            }
+
+            packedNibbleFeaturesData.SrcData[packIdx]
+                = TMaybeOwningArrayHolder<TNibbleFeaturesPack>::CreateOwning(
+                    std::move(dstPackedFeaturesData)
+                );
+
+            for (auto linearIdx : xrange(startIdx, endIdx)) {
+                const ui32 floatFeatureIdx = packedNibbleToSrcIndex[linearIdx];
+                auto& column = quantizedObjectsData->Data.FloatFeatures[floatFeatureIdx];
+                column = MakeHolder<TQuantizedFloatPackedNibbleValuesHolder>(
+                    column->GetId(),
+                    packedNibbleFeaturesData.SrcData[packIdx],
+                    SafeIntegerCast<ui8>(linearIdx - startIdx),
+                    quantizedDataSubsetIndexing
+                );
+            }
+        }
+    }
+
+
     static void ProcessFloatFeature(
         TFloatFeatureIdx floatFeatureIdx,
         const TFloatValuesHolder& srcFeature,
         const TFeaturesArraySubsetIndexing* subsetForBuildBorders,
+        TConstArrayRef<ui32> srcObjectCountsForBuildBorders, // used only for sparse features
         const TQuantizationOptions& options,
         bool clearSrcData,
         bool calcBordersAndNanModeOnly,
@@ -894,6 +1175,7 @@ namespace NCB {
             CalcBordersAndNanMode(
                 srcFeature,
                 subsetForBuildBorders,
+                srcObjectCountsForBuildBorders,
                 *quantizedFeaturesInfo,
                 &nanMode,
                 &calculatedBorders
@@ -903,32 +1185,47 @@ namespace NCB {
         }
 
         if (!calcBordersAndNanModeOnly && !borders.empty()) {
-            TMaybeOwningConstArraySubset<float, ui32> srcFeatureData = srcFeature.GetArrayData();
+            // sparse features are not binarized by packs
+            const bool isSparseInLayout
+                = quantizedFeaturesInfo->GetFeaturesLayout()->IsSparseFloatFeature(*floatFeatureIdx);
 
             if (!options.CpuCompatibleFormat && !clearSrcData) {
                 // use GPU-only external columns
                 *dstQuantizedFeature = MakeHolder<TExternalFloatValuesHolder>(
                     srcFeature.GetId(),
-                    *srcFeatureData.GetSrc(),
+                    GetDenseSrcData(srcFeature),
                     dstSubsetIndexing,
                     quantizedFeaturesInfo
                 );
             } else if (!options.CpuCompatibleFormat ||
                 !options.PackBinaryFeaturesForCpu ||
+                isSparseInLayout ||
                 (borders.size() > 1)) // binary features are binarized later by packs
             {
                 // it's ok even if it is learn data, for learn nans are checked at CalcBordersAndNanMode stage
                 bool allowNans = (nanMode != ENanMode::Forbidden) ||
                     quantizedFeaturesInfo->GetFloatFeaturesAllowNansInTestOnly();
 
-                *dstQuantizedFeature = MakeQuantizedFloatColumn(
-                    srcFeature,
-                    nanMode,
-                    allowNans,
-                    borders,
-                    dstSubsetIndexing,
-                    localExecutor
-                );
+                if (options.CpuCompatibleFormat) {
+                    *dstQuantizedFeature = MakeQuantizedFloatColumnForCPU(
+                        srcFeature,
+                        isSparseInLayout,
+                        nanMode,
+                        allowNans,
+                        borders,
+                        dstSubsetIndexing,
+                        localExecutor
+                    );
+                } else {
+                    *dstQuantizedFeature = MakeQuantizedFloatColumn(
+                        srcFeature.IsSparse() ? *MakeDenseFloatValuesHolder(srcFeature) : srcFeature,
+                        nanMode,
+                        allowNans,
+                        borders,
+                        dstSubsetIndexing,
+                        localExecutor
+                    );
+                }
             }
         }
 
@@ -963,6 +1260,10 @@ namespace NCB {
         // assuming worst-case that all values will be added to Features Perfect Hash as new.
         result += ESTIMATED_FEATURES_PERFECT_HASH_MAP_NODE_SIZE * objectCount;
 
+        // parallel perfect hashing: per block counts, per shard counts and renumbering data (same worst-case)
+        constexpr ui32 ESTIMATED_PARALLEL_PERFECT_HASH_TMP_DATA_SIZE_PER_VALUE = 2 * 24 + 8;
+        result += ESTIMATED_PARALLEL_PERFECT_HASH_TMP_DATA_SIZE_PER_VALUE * objectCount;
+
         if (options.CpuCompatibleFormat || clearSrcData) {
             // for storing quantized data
             // TODO(akhropov): support other bitsPerKey. MLTOOLS-2425
@@ -981,6 +1282,7 @@ namespace NCB {
         bool updatePerfectHashOnly,
         bool mapMostFrequentValueTo0,
         const TFeaturesArraySubsetIndexing* dstSubsetIndexing,
+        NPar::TLocalExecutor* localExecutor,
         TQuantizedFeaturesInfoPtr quantizedFeaturesInfo,
         THolder<IQuantizedCatValuesHolder>* dstQuantizedFeature
     ) {
@@ -1011,7 +1313,8 @@ namespace NCB {
                 catFeatureIdx,
                 srcFeatureData,
                 mapMostFrequentValueTo0,
-                quantizeData ? TMaybe<TArrayRef<ui32>*>(&quantizedDataValue) : Nothing()
+                quantizeData ? TMaybe<TArrayRef<ui32>*>(&quantizedDataValue) : Nothing(),
+                localExecutor
             );
         }
 
@@ -1057,10 +1360,12 @@ namespace NCB {
         {
             TReadGuard guard(quantizedFeaturesInfo.GetRWMutex());
 
-            if (quantizedFeaturesInfo.GetFeaturesLayout()->GetInternalFeatureMetaInfo(
-                    *floatFeatureIdx,
-                    EFeatureType::Float
-                ).IsAvailable &&
+            const auto& featureMetaInfo = quantizedFeaturesInfo.GetFeaturesLayout()->GetInternalFeatureMetaInfo(
+                *floatFeatureIdx,
+                EFeatureType::Float
+            );
+            if (featureMetaInfo.IsAvailable &&
+                !featureMetaInfo.IsSparse &&
                 (quantizedFeaturesInfo.GetBorders(floatFeatureIdx).size() == 1))
             {
                 return true;
@@ -1150,6 +1455,24 @@ namespace NCB {
                 rand
             );
 
+            const TFeaturesArraySubsetIndexing& srcSubsetForBuildBorders = subsetForBuildBorders ?
+                *subsetForBuildBorders
+                : *(srcObjectsCommonData.SubsetIndexing);
+
+            // calculated once for all sparse features, they share src objects
+            TVector<ui32> srcObjectCountsForBuildBorders;
+            if (!HoldsAlternative<TFullSubset<ui32>>(srcSubsetForBuildBorders)) {
+                for (const auto& srcFloatFeatureHolder : rawDataProvider->ObjectsData->Data.FloatFeatures) {
+                    if (srcFloatFeatureHolder && srcFloatFeatureHolder->IsSparse()) {
+                        srcObjectCountsForBuildBorders = GetSrcObjectCounts(
+                            srcSubsetForBuildBorders,
+                            srcFloatFeatureHolder->GetSparseSrcData()->GetSize()
+                        );
+                        break;
+                    }
+                }
+            }
+
             TMaybe<TQuantizedForCPUBuilderData> data;
             TAtomicSharedPtr<TArraySubsetIndexing<ui32>> subsetIndexing;
 
@@ -1211,9 +1534,8 @@ namespace NCB {
                                     ProcessFloatFeature(
                                         floatFeatureIdx,
                                         *srcFloatFeatureHolder,
-                                        subsetForBuildBorders ?
-                                            subsetForBuildBorders.Get()
-                                            : srcObjectsCommonData.SubsetIndexing.Get(),
+                                        &srcSubsetForBuildBorders,
+                                        srcObjectCountsForBuildBorders,
                                         options,
                                         clearSrcObjectsData,
                                         calcBordersAndNanModeOnlyInProcessFloatFeatures,
@@ -1268,6 +1590,7 @@ namespace NCB {
                                             /*updatePerfectHashOnly*/ bundleExclusiveFeatures,
                                             /*mapMostFrequentValueTo0*/ bundleExclusiveFeatures,
                                             subsetIndexing.Get(),
+                                            localExecutor,
                                             quantizedFeaturesInfo,
                                             &(data->ObjectsData.Data.CatFeatures[*catFeatureIdx])
                                         );
@@ -1378,6 +1701,15 @@ namespace NCB {
                 resourceConstrainedExecutor.ExecTasks();
             }
 
+            if (options.CpuCompatibleFormat && options.PackNibbleFeaturesForCpu) {
+                data->ObjectsData.PackedNibbleFeaturesData = TPackedNibbleFeaturesData(
+                    *data->ObjectsData.Data.QuantizedFeaturesInfo,
+                    data->ObjectsData.ExclusiveFeatureBundlesData,
+                    data->ObjectsData.PackedBinaryFeaturesData
+                );
+                PackNibbleFeatures(subsetIndexing.Get(), localExecutor, &data->ObjectsData);
+            }
+
             if (clearSrcData) {
                 data->MetaInfo = std::move(rawDataProvider->MetaInfo);
                 data->TargetData = std::move(rawDataProvider->RawTargetData.Data);
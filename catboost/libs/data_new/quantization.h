@@ -25,6 +25,7 @@ namespace NCB {
         bool BundleExclusiveFeaturesForCpu = true;
         TExclusiveFeaturesBundlingOptions ExclusiveFeaturesBundlingOptions{};
         bool PackBinaryFeaturesForCpu = true;
+        bool PackNibbleFeaturesForCpu = true;
         bool AllowWriteFiles = true;
 
         // TODO(akhropov): remove after checking global tests consistency
@@ -9,6 +9,7 @@
 
 #include <library/dbg_output/dump.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/mapfindptr.h>
 #include <util/generic/xrange.h>
@@ -142,9 +143,17 @@ namespace NCB {
         if (floatFeaturesBinarization.NanMode == ENanMode::Forbidden) {
             return ENanMode::Forbidden;
         }
-        TMaybeOwningConstArraySubset<float, ui32> arrayData = feature.GetArrayData();
-
-        bool hasNans = arrayData.Find([] (size_t /*idx*/, float value) { return IsNan(value); });
+        bool hasNans;
+        if (feature.IsSparse()) {
+            // all src values are checked, a subset can get nan mode without nans in it, this is harmless
+            hasNans = AnyOf(
+                feature.GetSparseSrcData()->GetValues(),
+                [] (float value) { return IsNan(value); }
+            );
+        } else {
+            TMaybeOwningConstArraySubset<float, ui32> arrayData = feature.GetArrayData();
+            hasNans = arrayData.Find([] (size_t /*idx*/, float value) { return IsNan(value); });
+        }
         if (hasNans) {
             return floatFeaturesBinarization.NanMode;
         }
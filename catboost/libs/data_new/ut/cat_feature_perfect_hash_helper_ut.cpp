@@ -0,0 +1,122 @@
+#include <catboost/libs/data_new/cat_feature_perfect_hash_helper.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/random/shuffle.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+static TQuantizedFeaturesInfoPtr MakeQuantizedFeaturesInfo() {
+    TFeaturesLayout featuresLayout(ui32(1), TVector<ui32>{0}, TVector<ui32>{}, TVector<TString>{});
+    return MakeIntrusive<TQuantizedFeaturesInfo>(
+        featuresLayout,
+        TConstArrayRef<ui32>(),
+        NCatboostOptions::TBinarizationOptions()
+    );
+}
+
+// first updates perfect hash using the first half of the subset, then quantizes the whole subset
+static void UpdatePerfectHashAndQuantize(
+    const TMaybeOwningConstArrayHolder<ui32>& hashedCatValues,
+    const TArraySubsetIndexing<ui32>& subsetIndexing,
+    bool mapMostFrequentValueTo0,
+    TMaybe<NPar::TLocalExecutor*> localExecutor,
+    TCatFeaturePerfectHash* perfectHash,
+    TVector<ui32>* bins
+) {
+    auto quantizedFeaturesInfo = MakeQuantizedFeaturesInfo();
+    TCatFeaturesPerfectHashHelper catFeaturesPerfectHashHelper(quantizedFeaturesInfo);
+
+    const ui32 halfSize = subsetIndexing.Size() / 2;
+    TArraySubsetIndexing<ui32> firstHalfIndexing = Compose(
+        subsetIndexing,
+        TArraySubsetIndexing<ui32>(
+            TRangesSubset<ui32>(halfSize, TVector<TSubsetBlock<ui32>>{{{0, halfSize}, 0}})
+        )
+    );
+    catFeaturesPerfectHashHelper.UpdatePerfectHashAndMaybeQuantize(
+        TCatFeatureIdx(0),
+        TMaybeOwningConstArraySubset<ui32, ui32>(&hashedCatValues, &firstHalfIndexing),
+        mapMostFrequentValueTo0,
+        Nothing(),
+        localExecutor
+    );
+
+    bins->yresize(subsetIndexing.Size());
+    TArrayRef<ui32> binsRef(*bins);
+    catFeaturesPerfectHashHelper.UpdatePerfectHashAndMaybeQuantize(
+        TCatFeatureIdx(0),
+        TMaybeOwningConstArraySubset<ui32, ui32>(&hashedCatValues, &subsetIndexing),
+        mapMostFrequentValueTo0,
+        &binsRef,
+        localExecutor
+    );
+
+    *perfectHash = quantizedFeaturesInfo->GetCategoricalFeaturesPerfectHash(TCatFeatureIdx(0));
+}
+
+
+Y_UNIT_TEST_SUITE(CatFeaturesPerfectHashHelper) {
+    Y_UNIT_TEST(ParallelIsSameAsSequential) {
+        const ui32 objectCount = 300000;
+
+        TFastRng64 rng(0);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (ui32 uniqueValuesBound : {10u, 5000u, 1000000u}) {
+            TVector<ui32> hashedCatValues;
+            for (auto i : xrange(objectCount)) {
+                Y_UNUSED(i);
+                hashedCatValues.push_back((ui32)rng.Uniform(uniqueValuesBound));
+            }
+            auto hashedCatValuesHolder = TMaybeOwningConstArrayHolder<ui32>::CreateOwning(
+                std::move(hashedCatValues)
+            );
+
+            TVector<ui32> permutation(objectCount);
+            Iota(permutation.begin(), permutation.end(), ui32(0));
+            Shuffle(permutation.begin(), permutation.end(), rng);
+
+            TVector<TArraySubsetIndexing<ui32>> subsetIndexings;
+            subsetIndexings.emplace_back(TFullSubset<ui32>(objectCount));
+            subsetIndexings.emplace_back(TIndexedSubset<ui32>(std::move(permutation)));
+
+            for (const auto& subsetIndexing : subsetIndexings) {
+                for (auto mapMostFrequentValueTo0 : {false, true}) {
+                    TCatFeaturePerfectHash expectedPerfectHash;
+                    TVector<ui32> expectedBins;
+                    UpdatePerfectHashAndQuantize(
+                        hashedCatValuesHolder,
+                        subsetIndexing,
+                        mapMostFrequentValueTo0,
+                        Nothing(),
+                        &expectedPerfectHash,
+                        &expectedBins
+                    );
+
+                    TCatFeaturePerfectHash perfectHash;
+                    TVector<ui32> bins;
+                    UpdatePerfectHashAndQuantize(
+                        hashedCatValuesHolder,
+                        subsetIndexing,
+                        mapMostFrequentValueTo0,
+                        &localExecutor,
+                        &perfectHash,
+                        &bins
+                    );
+
+                    UNIT_ASSERT_EQUAL(perfectHash, expectedPerfectHash);
+                    UNIT_ASSERT_EQUAL(bins, expectedBins);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,141 @@
+#include <catboost/libs/data_new/exclusive_feature_bundling.h>
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/quantization.h>
+
+#include <catboost/libs/data_new/ut/lib/for_objects.h>
+
+#include <util/generic/xrange.h>
+#include <util/system/types.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+Y_UNIT_TEST_SUITE(ExclusiveFeaturesBundle) {
+    Y_UNIT_TEST(SizeInBytes) {
+        TExclusiveFeaturesBundle bundle;
+
+        bundle.Add(TExclusiveBundlePart(EFeatureType::Float, 0, TBoundsInBundle(0, 200)));
+        UNIT_ASSERT_VALUES_EQUAL(bundle.SizeInBytes, 1);
+
+        bundle.Add(TExclusiveBundlePart(EFeatureType::Float, 1, TBoundsInBundle(200, 254)));
+        UNIT_ASSERT_VALUES_EQUAL(bundle.SizeInBytes, 1);
+
+        bundle.Add(TExclusiveBundlePart(EFeatureType::Categorical, 0, TBoundsInBundle(254, 60000)));
+        UNIT_ASSERT_VALUES_EQUAL(bundle.SizeInBytes, 2);
+
+        // 3 bytes would be enough but bundles are stored only as ui8, ui16 or ui32
+        bundle.Add(TExclusiveBundlePart(EFeatureType::Categorical, 1, TBoundsInBundle(60000, 100000)));
+        UNIT_ASSERT_VALUES_EQUAL(bundle.SizeInBytes, 4);
+        UNIT_ASSERT_VALUES_EQUAL(bundle.GetBinCount(), 100001);
+
+        UNIT_ASSERT_VALUES_EQUAL(GetBinFromBundle<ui32>(ui32(60010), bundle.Parts[3].Bounds), 11);
+        UNIT_ASSERT_VALUES_EQUAL(GetBinFromBundle<ui32>(ui32(100000), bundle.Parts[3].Bounds), 0);
+    }
+
+    Y_UNIT_TEST(NoConflictsMissedWhenDataIsLargerThanSample) {
+        const ui32 objectCount = 1000;
+
+        /* values are 0, 1, 2 so bins are equal to values.
+         * features #0 and #2 never intersect, features #0 and #1 intersect only at object #5 that is
+         * not in the strided sample of size MaxObjectsForConflictsCalc
+         */
+        TVector<TVector<float>> floatFeatures(3, TVector<float>(objectCount, 0.0f));
+        for (auto objectIdx : xrange(objectCount)) {
+            const float value = float(1 + objectIdx % 2);
+            if (objectIdx % 10 == 1) {
+                floatFeatures[0][objectIdx] = value;
+            } else if (objectIdx % 10 == 2) {
+                floatFeatures[1][objectIdx] = value;
+            } else if (objectIdx % 10 == 3) {
+                floatFeatures[2][objectIdx] = value;
+            }
+        }
+        floatFeatures[0][5] = 1.0f;
+        floatFeatures[1][5] = 2.0f;
+
+        TRawBuilderData srcData;
+
+        TDataColumnsMetaInfo dataColumnsMetaInfo;
+        dataColumnsMetaInfo.Columns.push_back(TColumn{EColumn::Label, ""});
+        for (auto featureIdx : xrange(floatFeatures.size())) {
+            Y_UNUSED(featureIdx);
+            dataColumnsMetaInfo.Columns.push_back(TColumn{EColumn::Num, ""});
+        }
+        srcData.MetaInfo = TDataMetaInfo(std::move(dataColumnsMetaInfo), false, false, Nothing());
+        srcData.TargetData.Target = TVector<TString>(objectCount, "0");
+        srcData.TargetData.SetTrivialWeights(objectCount);
+        srcData.CommonObjectsData.FeaturesLayout = srcData.MetaInfo.FeaturesLayout;
+        srcData.CommonObjectsData.SubsetIndexing = MakeAtomicShared<TArraySubsetIndexing<ui32>>(
+            TFullSubset<ui32>(objectCount)
+        );
+        ui32 featureId = 0;
+        InitFeatures(
+            floatFeatures,
+            *srcData.CommonObjectsData.SubsetIndexing,
+            &featureId,
+            &srcData.ObjectsData.FloatFeatures
+        );
+
+        auto quantizedFeaturesInfo = MakeIntrusive<TQuantizedFeaturesInfo>(
+            *srcData.MetaInfo.FeaturesLayout,
+            TConstArrayRef<ui32>(),
+            NCatboostOptions::TBinarizationOptions(EBorderSelectionType::GreedyLogSum, 4, ENanMode::Min)
+        );
+
+        TQuantizationOptions quantizationOptions{true, false};
+        quantizationOptions.PackBinaryFeaturesForCpu = false;
+        quantizationOptions.PackNibbleFeaturesForCpu = false;
+        quantizationOptions.ExclusiveFeaturesBundlingOptions.MaxObjectsForConflictsCalc = 100;
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        TRestorableFastRng64 rand(0);
+
+        TRawDataProviderPtr rawDataProvider = MakeDataProvider<TRawObjectsDataProvider>(
+            Nothing(),
+            std::move(srcData),
+            false,
+            &localExecutor
+        );
+
+        TDataProviderPtr quantizedDataProvider = Quantize(
+            quantizationOptions,
+            std::move(rawDataProvider),
+            quantizedFeaturesInfo,
+            &rand,
+            &localExecutor)->CastMoveTo<TObjectsDataProvider>();
+
+        const auto& objectsData = dynamic_cast<const TQuantizedForCPUObjectsDataProvider&>(
+            *quantizedDataProvider->ObjectsData
+        );
+
+        // features #0 and #2 can be bundled, otherwise the test does not check anything
+        UNIT_ASSERT(objectsData.GetExclusiveFeatureBundlesSize() > 0);
+
+        for (auto featureIdx : xrange(floatFeatures.size())) {
+            const auto bundleIndex = objectsData.GetFloatFeatureToExclusiveBundleIndex(
+                TFloatFeatureIdx(featureIdx)
+            );
+            if (!bundleIndex) {
+                continue;
+            }
+            const auto bundle = objectsData.GetExclusiveFeaturesBundle(bundleIndex->BundleIdx);
+            UNIT_ASSERT_VALUES_EQUAL(bundle.MetaData->SizeInBytes, 1);
+            const auto bounds = bundle.MetaData->Parts[bundleIndex->InBundleIdx].Bounds;
+
+            bundle.SubsetIndexing->ForEach(
+                [&] (ui32 objectIdx, ui32 srcObjectIdx) {
+                    UNIT_ASSERT_VALUES_EQUAL(
+                        GetBinFromBundle<ui8>(bundle.SrcData[srcObjectIdx], bounds),
+                        ui8(floatFeatures[featureIdx][objectIdx])
+                    );
+                }
+            );
+        }
+    }
+}
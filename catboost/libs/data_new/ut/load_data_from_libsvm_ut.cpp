@@ -0,0 +1,126 @@
+#include <catboost/libs/data_new/ut/lib/for_loader.h>
+
+#include <catboost/libs/data_new/load_data.h>
+
+#include <catboost/libs/data_new/data_provider.h>
+#include <catboost/libs/data_new/objects_grouping.h>
+
+#include <util/generic/strbuf.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+using namespace NCB::NDataNewUT;
+
+
+Y_UNIT_TEST_SUITE(LoadDataFromLibSvm) {
+    TDataProviderPtr ReadLibSvmDataset(const TSrcData& srcData) {
+        TReadDatasetMainParams readDatasetMainParams;
+
+        // TODO(akhropov): temporarily use THolder until TTempFile move semantic are fixed
+        TVector<THolder<TTempFile>> srcDataFiles;
+
+        SaveSrcData(srcData, &readDatasetMainParams, &srcDataFiles);
+        readDatasetMainParams.PoolPath.Scheme = "libsvm";
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        return ReadDataset(
+            readDatasetMainParams.PoolPath,
+            readDatasetMainParams.PairsFilePath, // can be uninited
+            readDatasetMainParams.GroupWeightsFilePath, // can be uninited
+            readDatasetMainParams.BaselineFilePath, // can be uninited
+            readDatasetMainParams.DsvPoolFormatParams,
+            srcData.IgnoredFeatures,
+            srcData.ObjectsOrder,
+            /*classNames*/Nothing(),
+            &localExecutor
+        );
+    }
+
+    void CheckSparseFeature(
+        const TRawObjectsDataProvider& objectsData,
+        ui32 floatFeatureIdx,
+        const TVector<ui32>& expectedIndices,
+        const TVector<float>& expectedValues
+    ) {
+        const auto& feature = **objectsData.GetFloatFeature(floatFeatureIdx);
+        UNIT_ASSERT(feature.IsSparse());
+        const auto& sparseData = *feature.GetSparseSrcData();
+        UNIT_ASSERT_VALUES_EQUAL(sparseData.GetSize(), objectsData.GetObjectCount());
+        UNIT_ASSERT_VALUES_EQUAL(sparseData.GetDefaultValue(), 0.0f);
+        UNIT_ASSERT_EQUAL(sparseData.GetIndices(), TConstArrayRef<ui32>(expectedIndices));
+        UNIT_ASSERT_EQUAL(sparseData.GetValues(), TConstArrayRef<float>(expectedValues));
+    }
+
+    Y_UNIT_TEST(ReadDataset) {
+        TSrcData srcData;
+        srcData.DsvFileData = AsStringBuf(
+            "1 1:0.5 3:2.0\n"
+            "0 4:-1.0 # comment\n"
+            "1\n"
+            "0 1:0.1 2:0 4:3.5\n"
+        );
+
+        TDataProviderPtr dataProvider = ReadLibSvmDataset(srcData);
+
+        const auto& featuresLayout = *dataProvider->MetaInfo.FeaturesLayout;
+        UNIT_ASSERT_VALUES_EQUAL(featuresLayout.GetExternalFeatureCount(), 4);
+        UNIT_ASSERT_VALUES_EQUAL(featuresLayout.GetFloatFeatureCount(), 4);
+        for (auto featureIdx : xrange(4)) {
+            UNIT_ASSERT(featuresLayout.IsSparseFloatFeature(featureIdx));
+        }
+        UNIT_ASSERT(!dataProvider->MetaInfo.HasGroupId);
+
+        UNIT_ASSERT_VALUES_EQUAL(dataProvider->GetObjectCount(), 4);
+        UNIT_ASSERT_EQUAL(
+            dataProvider->RawTargetData.GetTarget(),
+            TMaybeData<TConstArrayRef<TString>>(TVector<TString>{"1", "0", "1", "0"})
+        );
+
+        const auto& objectsData = dynamic_cast<const TRawObjectsDataProvider&>(*dataProvider->ObjectsData);
+        CheckSparseFeature(objectsData, 0, {0, 3}, {0.5f, 0.1f});
+        CheckSparseFeature(objectsData, 1, {}, {});
+        CheckSparseFeature(objectsData, 2, {0}, {2.0f});
+        CheckSparseFeature(objectsData, 3, {1, 3}, {-1.0f, 3.5f});
+
+        UNIT_ASSERT_EQUAL(
+            objectsData.GetFeatureDataOldFormat(3),
+            (TVector<float>{0.0f, -1.0f, 0.0f, 3.5f})
+        );
+    }
+
+    Y_UNIT_TEST(ReadDatasetWithGroupsAndIgnoredFeatures) {
+        TSrcData srcData;
+        srcData.DsvFileData = AsStringBuf(
+            "2 qid:1 1:0.5 2:1.5\n"
+            "1 qid:1 2:2.5\n"
+            "0 qid:7 1:0.2\n"
+        );
+        srcData.IgnoredFeatures = {0};
+
+        TDataProviderPtr dataProvider = ReadLibSvmDataset(srcData);
+
+        UNIT_ASSERT(dataProvider->MetaInfo.HasGroupId);
+        UNIT_ASSERT_EQUAL(
+            *dataProvider->ObjectsGrouping,
+            TObjectsGrouping(TVector<TGroupBounds>{{0, 2}, {2, 3}})
+        );
+
+        const auto& objectsData = dynamic_cast<const TRawObjectsDataProvider&>(*dataProvider->ObjectsData);
+        UNIT_ASSERT(!objectsData.GetFloatFeature(0));
+        CheckSparseFeature(objectsData, 1, {0, 1}, {1.5f, 2.5f});
+    }
+
+    Y_UNIT_TEST(BadFeatureIndicesOrder) {
+        TSrcData srcData;
+        srcData.DsvFileData = AsStringBuf(
+            "1 2:0.5 1:2.0\n"
+        );
+        UNIT_ASSERT_EXCEPTION(ReadLibSvmDataset(srcData), TCatBoostException);
+    }
+}
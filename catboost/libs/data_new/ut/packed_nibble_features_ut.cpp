@@ -0,0 +1,72 @@
+#include <catboost/libs/data_new/packed_nibble_features.h>
+
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(PackedNibbleFeatures) {
+    Y_UNIT_TEST(SetAndGet) {
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(2);
+
+        TVector<ui8> feature0 = {0, 3, 15, 7, 1, 0, 9};
+        TVector<ui8> feature1 = {5, 0, 2, 15, 14, 1, 0};
+
+        TVector<TNibbleFeaturesPack> packs(feature0.size(), TNibbleFeaturesPack(0));
+        TArrayRef<TNibbleFeaturesPack> packsRef = packs;
+
+        ParallelSetNibbleFeatureInPackArray(TConstArrayRef<ui8>(feature0), 0, &localExecutor, &packsRef);
+        ParallelSetNibbleFeatureInPackArray(TConstArrayRef<ui8>(feature1), 1, &localExecutor, &packsRef);
+
+        for (auto i : xrange(packs.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(packs[i], TNibbleFeaturesPack(feature0[i] | (feature1[i] << 4)));
+            UNIT_ASSERT_VALUES_EQUAL(GetNibbleFromPack(packs[i], 0), feature0[i]);
+            UNIT_ASSERT_VALUES_EQUAL(GetNibbleFromPack(packs[i], 1), feature1[i]);
+        }
+
+        // overwrite the first nibble, the second one must stay the same
+        TVector<ui8> feature0Updated = {1, 1, 2, 2, 3, 3, 4};
+        ParallelSetNibbleFeatureInPackArray(
+            TConstArrayRef<ui8>(feature0Updated),
+            0,
+            &localExecutor,
+            &packsRef
+        );
+        for (auto i : xrange(packs.size())) {
+            UNIT_ASSERT_VALUES_EQUAL(GetNibbleFromPack(packs[i], 0), feature0Updated[i]);
+            UNIT_ASSERT_VALUES_EQUAL(GetNibbleFromPack(packs[i], 1), feature1[i]);
+        }
+
+        TVector<ui8> tooWideFeature = {16, 0, 0, 0, 0, 0, 0};
+        UNIT_ASSERT_EXCEPTION(
+            ParallelSetNibbleFeatureInPackArray(
+                TConstArrayRef<ui8>(tooWideFeature),
+                0,
+                &localExecutor,
+                &packsRef
+            ),
+            TCatBoostException
+        );
+    }
+
+    Y_UNIT_TEST(PackMetaData) {
+        TNibbleFeaturesPackMetaData metaData;
+        metaData.BinCounts = {16, 3};
+        UNIT_ASSERT_VALUES_EQUAL(metaData.GetPackBinCount(), 0x2F + 1);
+        UNIT_ASSERT_VALUES_EQUAL(metaData.GetSplitCount(), 17);
+
+        metaData.BinCounts = {5};
+        UNIT_ASSERT_VALUES_EQUAL(metaData.GetPackBinCount(), 5);
+        UNIT_ASSERT_VALUES_EQUAL(metaData.GetSplitCount(), 4);
+
+        UNIT_ASSERT_VALUES_EQUAL(TPackedNibbleIndex::FromLinearIdx(5).PackIdx, 2);
+        UNIT_ASSERT_VALUES_EQUAL(TPackedNibbleIndex::FromLinearIdx(5).NibbleIdx, 1);
+        UNIT_ASSERT_VALUES_EQUAL(TPackedNibbleIndex(2, 1).GetLinearIdx(), 5);
+    }
+}
@@ -146,6 +146,17 @@ namespace NCB {
         virtual void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TString> feature) = 0;
         virtual void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<TStringBuf> feature) = 0;
 
+        // integer values are treated as their decimal string representations
+        virtual void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef<i64> feature) = 0;
+
+        // values are specified as indices in uniqueValues (like pandas.Categorical codes),
+        // each unique value is hashed only once
+        virtual void AddCatFeature(
+            ui32 flatFeatureIdx,
+            TConstArrayRef<TString> uniqueValues,
+            TConstArrayRef<ui32> valueIndices
+        ) = 0;
+
         // when hashes already computed
         // shared ownership is passed to IRawFeaturesOrderDataVisitor
         virtual void AddCatFeature(ui32 flatFeatureIdx, TMaybeOwningConstArrayHolder<ui32> features) = 0;
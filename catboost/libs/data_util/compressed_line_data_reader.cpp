@@ -0,0 +1,727 @@
+#include "line_data_reader.h"
+
+#include <catboost/libs/helpers/exception.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <contrib/libs/lz4/lz4frame.h>
+#include <contrib/libs/zlib/zlib.h>
+
+#define ZSTD_STATIC_LINKING_ONLY
+#include <contrib/libs/zstd/zstd.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/deque.h>
+#include <util/generic/hash.h>
+#include <util/generic/maybe.h>
+#include <util/generic/ptr.h>
+#include <util/generic/singleton.h>
+#include <util/generic/strbuf.h>
+#include <util/generic/string.h>
+#include <util/generic/utility.h>
+#include <util/generic/vector.h>
+#include <util/stream/file.h>
+#include <util/string/builder.h>
+#include <util/string/cast.h>
+#include <util/string/iterator.h>
+#include <util/system/fs.h>
+#include <util/system/fstat.h>
+#include <util/system/getpid.h>
+#include <util/system/guard.h>
+#include <util/system/mutex.h>
+#include <util/system/unaligned_mem.h>
+
+
+namespace NCB {
+
+    namespace {
+
+    /* Line counts of compressed files are cached to avoid an additional decompression pass
+     * when the same file is loaded again: in memory for the process lifetime and in
+     * a '<path>.linecount' sidecar file for subsequent runs.
+     * File size and modification time are used to detect stale entries.
+     * Sidecar format: "<line count>\t<file size>\t<modification time>".
+     */
+    class TLineCountCache {
+    public:
+        TMaybe<ui64> Get(const TString& path) {
+            const TEntry fileKey = GetFileKey(path);
+            with_lock (Lock) {
+                const auto it = Entries.find(path);
+                if ((it != Entries.end()) && it->second.HasSameKey(fileKey)) {
+                    return it->second.LineCount;
+                }
+            }
+            const TMaybe<TEntry> sidecarEntry = ReadSidecar(path);
+            if (sidecarEntry && sidecarEntry->HasSameKey(fileKey)) {
+                with_lock (Lock) {
+                    Entries[path] = *sidecarEntry;
+                }
+                return sidecarEntry->LineCount;
+            }
+            return Nothing();
+        }
+
+        void Set(const TString& path, ui64 lineCount) {
+            TEntry entry = GetFileKey(path);
+            entry.LineCount = lineCount;
+            with_lock (Lock) {
+                Entries[path] = entry;
+            }
+            WriteSidecar(path, entry);
+        }
+
+    private:
+        struct TEntry {
+            ui64 LineCount = 0;
+            ui64 FileSize = 0;
+            time_t MTime = 0;
+
+        public:
+            bool HasSameKey(const TEntry& rhs) const {
+                return (FileSize == rhs.FileSize) && (MTime == rhs.MTime);
+            }
+        };
+
+    private:
+        static TEntry GetFileKey(const TString& path) {
+            const TFileStat fileStat(path);
+            TEntry entry;
+            entry.FileSize = fileStat.Size;
+            entry.MTime = fileStat.MTime;
+            return entry;
+        }
+
+        static TString GetSidecarPath(const TString& path) {
+            return path + ".linecount";
+        }
+
+        static TMaybe<TEntry> ReadSidecar(const TString& path) {
+            const TString sidecarPath = GetSidecarPath(path);
+            if (!NFs::Exists(sidecarPath)) {
+                return Nothing();
+            }
+            try {
+                TVector<TStringBuf> fields;
+                const TString content = TIFStream(sidecarPath).ReadAll();
+                StringSplitter(TStringBuf(content).Before('\n')).Split('\t').Collect(&fields);
+                if (fields.size() != 3) {
+                    return Nothing();
+                }
+                TEntry entry;
+                entry.LineCount = FromString<ui64>(fields[0]);
+                entry.FileSize = FromString<ui64>(fields[1]);
+                entry.MTime = FromString<time_t>(fields[2]);
+                return entry;
+            } catch (...) {
+                CATBOOST_DEBUG_LOG << "Ignoring unreadable line count file " << sidecarPath << ": "
+                    << CurrentExceptionMessage() << Endl;
+                return Nothing();
+            }
+        }
+
+        // best effort: sidecar is written atomically, data directory can be read-only
+        static void WriteSidecar(const TString& path, const TEntry& entry) {
+            const TString sidecarPath = GetSidecarPath(path);
+            const TString tmpPath = TStringBuilder() << sidecarPath << ".tmp." << GetPID();
+            try {
+                {
+                    TOFStream out(tmpPath);
+                    out << entry.LineCount << '\t' << entry.FileSize << '\t' << entry.MTime << '\n';
+                    out.Finish();
+                }
+                CB_ENSURE(NFs::Rename(tmpPath, sidecarPath), "cannot rename " << tmpPath);
+            } catch (...) {
+                CATBOOST_DEBUG_LOG << "Cannot save line count to " << sidecarPath << ": "
+                    << CurrentExceptionMessage() << Endl;
+                NFs::Remove(tmpPath);
+            }
+        }
+
+    private:
+        TMutex Lock;
+        THashMap<TString, TEntry> Entries;
+    };
+
+
+    // returns chunks of decompressed data in order, chunks boundaries are arbitrary
+    class IDecompressedChunks {
+    public:
+        virtual ~IDecompressedChunks() = default;
+
+        // returns false if there is no more data
+        virtual bool Next(TString* chunk) = 0;
+    };
+
+
+    // zlib is used directly because util's stream does not report truncated input
+    class TGzipDecompressedChunks : public IDecompressedChunks {
+    public:
+        explicit TGzipDecompressedChunks(const TString& path)
+            : Input(path)
+        {
+            Zero(ZStream);
+            // 16 is added to window bits for gzip format
+            const int result = inflateInit2(&ZStream, MAX_WBITS + 16);
+            CB_ENSURE(result == Z_OK, "gzip error: cannot init inflate engine");
+        }
+
+        ~TGzipDecompressedChunks() override {
+            inflateEnd(&ZStream);
+        }
+
+        bool Next(TString* chunk) override {
+            chunk->ReserveAndResize(ChunkSize);
+            ZStream.next_out = (Bytef*)chunk->begin();
+            ZStream.avail_out = ChunkSize;
+            while (ZStream.avail_out) {
+                if (!ZStream.avail_in) {
+                    const size_t loaded = Input.Load(InBuffer.begin(), InBuffer.size());
+                    if (!loaded) {
+                        CB_ENSURE(AtStreamEnd, "Compressed data is truncated or corrupted");
+                        break;
+                    }
+                    ZStream.next_in = (Bytef*)InBuffer.data();
+                    ZStream.avail_in = loaded;
+                    if (AtStreamEnd) {
+                        // concatenated gzip members
+                        CB_ENSURE(inflateReset(&ZStream) == Z_OK, "gzip error: inflate reset failed");
+                        AtStreamEnd = false;
+                    }
+                }
+                const int result = inflate(&ZStream, Z_NO_FLUSH);
+                CB_ENSURE(
+                    (result == Z_OK) || (result == Z_STREAM_END),
+                    "gzip error: " << (ZStream.msg ? ZStream.msg : "inflate failed")
+                );
+                if (result == Z_STREAM_END) {
+                    AtStreamEnd = true;
+                    if (ZStream.avail_in) {
+                        CB_ENSURE(inflateReset(&ZStream) == Z_OK, "gzip error: inflate reset failed");
+                        AtStreamEnd = false;
+                    }
+                }
+            }
+            chunk->resize(ChunkSize - ZStream.avail_out);
+            return !chunk->empty();
+        }
+
+    private:
+        static constexpr size_t ChunkSize = 1 << 20;
+        static constexpr size_t ReadSize = 1 << 16;
+
+        TFileInput Input;
+        TString InBuffer = TString(ReadSize, '\0');
+        z_stream ZStream;
+        bool AtStreamEnd = true; // no data is also a valid input
+    };
+
+
+    // decompresses one frame incrementally
+    class IFrameDecoder {
+    public:
+        virtual ~IFrameDecoder() = default;
+
+        /* decompresses a prefix of data, appends at most about maxOutputSize bytes to dst,
+         * returns the size of the consumed data. Sets *frameEnd when the frame is fully decoded,
+         * data after the frame end is not consumed.
+         */
+        virtual size_t Decompress(TStringBuf data, size_t maxOutputSize, TString* dst, bool* frameEnd) = 0;
+    };
+
+
+    /* Codec for formats that consist of independent frames with sizes known from headers,
+     * frames are decompressed in parallel
+     */
+    class IFramesCodec {
+    public:
+        virtual ~IFramesCodec() = default;
+
+        // returns Nothing() if data does not contain the whole frame
+        virtual TMaybe<size_t> GetFrameSize(TStringBuf data) const = 0;
+
+        virtual THolder<IFrameDecoder> CreateFrameDecoder() const = 0;
+
+        void DecompressFrame(TStringBuf frame, TString* dst) const {
+            THolder<IFrameDecoder> decoder = CreateFrameDecoder();
+            bool frameEnd = false;
+            while (!frameEnd) {
+                const size_t consumedSize = decoder->Decompress(frame, Max<size_t>(), dst, &frameEnd);
+                CB_ENSURE(consumedSize || frameEnd, "Compressed data is truncated or corrupted");
+                frame.Skip(consumedSize);
+            }
+        }
+    };
+
+
+    class TZstdFrameDecoder : public IFrameDecoder {
+    public:
+        TZstdFrameDecoder()
+            : DStream(ZSTD_createDStream())
+        {
+            CB_ENSURE(DStream, "Failed to create zstd decompression stream");
+            const size_t result = ZSTD_initDStream(DStream.Get());
+            CB_ENSURE(!ZSTD_isError(result), "zstd error: " << ZSTD_getErrorName(result));
+        }
+
+        size_t Decompress(TStringBuf data, size_t maxOutputSize, TString* dst, bool* frameEnd) override {
+            *frameEnd = false;
+            const size_t outBufferSize = ZSTD_DStreamOutSize();
+            const size_t dstStart = dst->size();
+            ZSTD_inBuffer input{data.data(), data.size(), 0};
+            while (dst->size() - dstStart < maxOutputSize) {
+                const size_t dstOffset = dst->size();
+                dst->ReserveAndResize(dstOffset + outBufferSize);
+                ZSTD_outBuffer output{dst->begin() + dstOffset, outBufferSize, 0};
+                const size_t result = ZSTD_decompressStream(DStream.Get(), &output, &input);
+                CB_ENSURE(!ZSTD_isError(result), "zstd error: " << ZSTD_getErrorName(result));
+                dst->resize(dstOffset + output.pos);
+
+                if (result == 0) { // frame is fully decoded and flushed
+                    *frameEnd = true;
+                    break;
+                }
+                // output buffer is not full only if all decompressed data has been flushed
+                if ((input.pos == input.size) && (output.pos < output.size)) {
+                    break;
+                }
+            }
+            return input.pos;
+        }
+
+    private:
+        struct TZstdDStreamDeleter {
+            static void Destroy(ZSTD_DStream* dstream) {
+                ZSTD_freeDStream(dstream);
+            }
+        };
+
+    private:
+        THolder<ZSTD_DStream, TZstdDStreamDeleter> DStream;
+    };
+
+
+    class TZstdFramesCodec : public IFramesCodec {
+    public:
+        TMaybe<size_t> GetFrameSize(TStringBuf data) const override {
+            const size_t frameSize = ZSTD_findFrameCompressedSize(data.data(), data.size());
+            if (ZSTD_isError(frameSize)) {
+                /* truncated and corrupted frames are not distinguishable here,
+                 * corrupted ones are reported by the decoder
+                 */
+                return Nothing();
+            }
+            return frameSize;
+        }
+
+        THolder<IFrameDecoder> CreateFrameDecoder() const override {
+            return MakeHolder<TZstdFrameDecoder>();
+        }
+    };
+
+
+    class TLz4FrameDecoder : public IFrameDecoder {
+    public:
+        TLz4FrameDecoder() {
+            LZ4F_dctx* dctxPtr = nullptr;
+            const LZ4F_errorCode_t errorCode = LZ4F_createDecompressionContext(&dctxPtr, LZ4F_VERSION);
+            CB_ENSURE(!LZ4F_isError(errorCode), "lz4 error: " << LZ4F_getErrorName(errorCode));
+            Dctx.Reset(dctxPtr);
+        }
+
+        size_t Decompress(TStringBuf data, size_t maxOutputSize, TString* dst, bool* frameEnd) override {
+            *frameEnd = false;
+            const size_t dstStart = dst->size();
+            const char* src = data.data();
+            size_t srcLeft = data.size();
+            while (dst->size() - dstStart < maxOutputSize) {
+                const size_t dstOffset = dst->size();
+                dst->ReserveAndResize(dstOffset + OutBufferSize);
+                size_t dstSize = OutBufferSize;
+                size_t srcSize = srcLeft;
+                const size_t result = LZ4F_decompress(
+                    Dctx.Get(),
+                    dst->begin() + dstOffset,
+                    &dstSize,
+                    src,
+                    &srcSize,
+                    /*dOptPtr*/ nullptr
+                );
+                CB_ENSURE(!LZ4F_isError(result), "lz4 error: " << LZ4F_getErrorName(result));
+                dst->resize(dstOffset + dstSize);
+                src += srcSize;
+                srcLeft -= srcSize;
+                if (result == 0) { // frame is fully decoded
+                    *frameEnd = true;
+                    break;
+                }
+                if (!srcSize && !dstSize) { // more data is needed
+                    break;
+                }
+            }
+            return data.size() - srcLeft;
+        }
+
+    private:
+        static constexpr size_t OutBufferSize = 1 << 16;
+
+        struct TLz4DctxDeleter {
+            static void Destroy(LZ4F_dctx* dctx) {
+                LZ4F_freeDecompressionContext(dctx);
+            }
+        };
+
+    private:
+        THolder<LZ4F_dctx, TLz4DctxDeleter> Dctx;
+    };
+
+
+    // frame format is described in https://github.com/lz4/lz4/blob/dev/doc/lz4_Frame_format.md
+    class TLz4FramesCodec : public IFramesCodec {
+    public:
+        TMaybe<size_t> GetFrameSize(TStringBuf data) const override {
+            if (data.size() < 8) {
+                return Nothing();
+            }
+            const ui32 magic = ReadUnaligned<ui32>(data.data());
+            if ((magic & SkippableMagicMask) == SkippableMagic) {
+                const size_t frameSize = 8 + ReadUnaligned<ui32>(data.data() + 4);
+                return (frameSize <= data.size()) ? TMaybe<size_t>(frameSize) : Nothing();
+            }
+            CB_ENSURE(magic == FrameMagic, "Data is not in lz4 frame format");
+
+            const ui8 flags = data[4];
+            const bool hasBlockChecksum = flags & (1 << 4);
+            const bool hasContentSize = flags & (1 << 3);
+            const bool hasContentChecksum = flags & (1 << 2);
+            const bool hasDictId = flags & 1;
+
+            // magic, FLG, BD, optional content size and dictionary id, HC
+            size_t offset = 4 + 2 + (hasContentSize ? 8 : 0) + (hasDictId ? 4 : 0) + 1;
+            while (true) {
+                if (offset + 4 > data.size()) {
+                    return Nothing();
+                }
+                const ui32 blockSize = ReadUnaligned<ui32>(data.data() + offset) & 0x7FFFFFFF;
+                offset += 4;
+                if (blockSize == 0) { // end mark
+                    break;
+                }
+                offset += blockSize + (hasBlockChecksum ? 4 : 0);
+            }
+            offset += hasContentChecksum ? 4 : 0;
+            return (offset <= data.size()) ? TMaybe<size_t>(offset) : Nothing();
+        }
+
+        THolder<IFrameDecoder> CreateFrameDecoder() const override {
+            return MakeHolder<TLz4FrameDecoder>();
+        }
+
+    private:
+        static constexpr ui32 FrameMagic = 0x184D2204;
+        static constexpr ui32 SkippableMagic = 0x184D2A50;
+        static constexpr ui32 SkippableMagicMask = 0xFFFFFFF0;
+    };
+
+
+    /* Frames not bigger than MaxParallelFrameSize are decompressed in parallel in batches.
+     * Bigger frames (e.g. the only frame of data compressed by zstd or lz4 command line tools)
+     * cannot be split, they are decompressed sequentially by OutputChunkSize parts, so
+     * the whole frame is never buffered. Buffered compressed data is limited by MaxBufferSize.
+     */
+    class TFramedDecompressedChunks : public IDecompressedChunks {
+    public:
+        TFramedDecompressedChunks(
+            const TString& path,
+            THolder<IFramesCodec> codec,
+            NPar::TLocalExecutor* localExecutor
+        )
+            : Input(path)
+            , Codec(std::move(codec))
+            , LocalExecutor(*localExecutor)
+        {}
+
+        bool Next(TString* chunk) override {
+            while (DecompressedChunks.empty()) {
+                Buffer.erase(0, BufferOffset);
+                BufferOffset = 0;
+
+                const bool hasMoreData = FrameDecoder ? DecompressFramePart() : DecompressFrames();
+                if (!hasMoreData) {
+                    return false;
+                }
+            }
+            *chunk = std::move(DecompressedChunks.front());
+            DecompressedChunks.pop_front();
+            return true;
+        }
+
+    private:
+        // returns false if there is no more data
+        bool ReadMore() {
+            const size_t offset = Buffer.size();
+            Buffer.ReserveAndResize(offset + ReadSize);
+            const size_t loaded = Input.Load(Buffer.begin() + offset, ReadSize);
+            Buffer.resize(offset + loaded);
+            return loaded != 0;
+        }
+
+        // returns false if there is no more data
+        bool DecompressFrames() {
+            // frame bounds are stored as offsets because Buffer can be reallocated
+            TVector<std::pair<size_t, size_t>> frameBounds;
+            const size_t maxFramesInBatch = LocalExecutor.GetThreadCount() + 1;
+            while (frameBounds.size() < maxFramesInBatch) {
+                const TStringBuf data = TStringBuf(Buffer).SubStr(BufferOffset);
+                const TMaybe<size_t> frameSize = Codec->GetFrameSize(data);
+                if (frameSize && (*frameSize <= MaxParallelFrameSize)) {
+                    frameBounds.emplace_back(BufferOffset, *frameSize);
+                    BufferOffset += *frameSize;
+                } else if (frameSize || (data.size() > MaxParallelFrameSize)) {
+                    if (frameBounds.empty()) {
+                        FrameDecoder = Codec->CreateFrameDecoder();
+                        return DecompressFramePart();
+                    }
+                    break; // decompress the frames before it first
+                } else if (Buffer.size() >= MaxBufferSize) {
+                    break; // not reached without complete frames: MaxParallelFrameSize < MaxBufferSize
+                } else if (!ReadMore()) {
+                    CB_ENSURE(data.empty(), "Compressed data is truncated or corrupted");
+                    break;
+                }
+            }
+            if (frameBounds.empty()) {
+                return false;
+            }
+
+            TVector<TString> decompressedFrames(frameBounds.size());
+            LocalExecutor.ExecRangeWithThrow(
+                [&] (int frameIdx) {
+                    Codec->DecompressFrame(
+                        TStringBuf(Buffer).SubStr(frameBounds[frameIdx].first, frameBounds[frameIdx].second),
+                        &decompressedFrames[frameIdx]
+                    );
+                },
+                0,
+                SafeIntegerCast<int>(frameBounds.size()),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+            for (auto& decompressedFrame : decompressedFrames) {
+                DecompressedChunks.push_back(std::move(decompressedFrame));
+            }
+            return true;
+        }
+
+        // decompresses the next part of a frame that is too big to be buffered
+        bool DecompressFramePart() {
+            TString chunk;
+            while (chunk.empty() && FrameDecoder) {
+                if (BufferOffset == Buffer.size()) {
+                    Buffer.clear();
+                    BufferOffset = 0;
+                    CB_ENSURE(ReadMore(), "Compressed data is truncated or corrupted");
+                }
+                bool frameEnd = false;
+                const size_t consumedSize = FrameDecoder->Decompress(
+                    TStringBuf(Buffer).SubStr(BufferOffset),
+                    OutputChunkSize,
+                    &chunk,
+                    &frameEnd
+                );
+                BufferOffset += consumedSize;
+                if (frameEnd) {
+                    FrameDecoder.Destroy();
+                } else if (!consumedSize && chunk.empty()) {
+                    CB_ENSURE(
+                        (Buffer.size() - BufferOffset < MaxBufferSize) && ReadMore(),
+                        "Compressed data is truncated or corrupted"
+                    );
+                }
+            }
+            if (!chunk.empty()) {
+                DecompressedChunks.push_back(std::move(chunk));
+            }
+            return true;
+        }
+
+    private:
+        static constexpr size_t ReadSize = 1 << 20;
+        static constexpr size_t MaxParallelFrameSize = 1 << 22;
+        static constexpr size_t MaxBufferSize = 1 << 26;
+        static constexpr size_t OutputChunkSize = 1 << 20;
+
+        TFileInput Input;
+        THolder<IFramesCodec> Codec;
+        NPar::TLocalExecutor& LocalExecutor;
+
+        TString Buffer;
+        size_t BufferOffset = 0;
+
+        // not empty while a frame bigger than MaxParallelFrameSize is decompressed
+        THolder<IFrameDecoder> FrameDecoder;
+
+        TDeque<TString> DecompressedChunks;
+    };
+
+
+    // splits data from chunks into lines, the same way as IInputStream::ReadLine does
+    class TChunkedLineReader {
+    public:
+        explicit TChunkedLineReader(THolder<IDecompressedChunks> chunks)
+            : Chunks(std::move(chunks))
+        {}
+
+        bool ReadLine(TString* line) {
+            line->clear();
+            bool hasData = false;
+            while (true) {
+                if (ChunkOffset == Chunk.size()) {
+                    if (!Chunks->Next(&Chunk)) {
+                        break;
+                    }
+                    ChunkOffset = 0;
+                    continue;
+                }
+                hasData = true;
+                const size_t lineEnd = Chunk.find('\n', ChunkOffset);
+                if (lineEnd == TString::npos) {
+                    line->append(Chunk, ChunkOffset, TString::npos);
+                    ChunkOffset = Chunk.size();
+                } else {
+                    line->append(Chunk, ChunkOffset, lineEnd - ChunkOffset);
+                    ChunkOffset = lineEnd + 1;
+                    break;
+                }
+            }
+            if (line->EndsWith('\r')) {
+                line->pop_back();
+            }
+            return hasData;
+        }
+
+    private:
+        THolder<IDecompressedChunks> Chunks;
+        TString Chunk;
+        size_t ChunkOffset = 0;
+    };
+
+
+    ui64 CountLines(IDecompressedChunks* chunks) {
+        ui64 lineCount = 0;
+        bool lastLineIsIncomplete = false;
+        TString chunk;
+        while (chunks->Next(&chunk)) {
+            if (chunk.empty()) {
+                continue;
+            }
+            lineCount += Count(chunk.cbegin(), chunk.cend(), '\n');
+            lastLineIsIncomplete = chunk.back() != '\n';
+        }
+        return lineCount + (lastLineIsIncomplete ? 1 : 0);
+    }
+
+
+    template <class TDecompressedChunksFactory>
+    class TCompressedFileLineDataReader : public ILineDataReader {
+    public:
+        TCompressedFileLineDataReader(const TLineDataReaderArgs& args)
+            : Args(args)
+            , LocalExecutor(CreateLocalExecutor(args.ThreadCount))
+            , LineReader(CreateChunks(args.PathWithScheme.Path, LocalExecutor.Get()))
+            , HeaderProcessed(!Args.Format.HasHeader)
+        {}
+
+        ui64 GetDataLineCount() override {
+            const TString& path = Args.PathWithScheme.Path;
+            auto& lineCountCache = *Singleton<TLineCountCache>();
+            TMaybe<ui64> lineCount = lineCountCache.Get(path);
+            if (!lineCount) {
+                lineCount = CountLines(CreateChunks(path, LocalExecutor.Get()).Get());
+                lineCountCache.Set(path, *lineCount);
+            }
+            if (Args.Format.HasHeader) {
+                CB_ENSURE(*lineCount > 0, "TCompressedFileLineDataReader: no header in file");
+                --*lineCount;
+            }
+            return *lineCount;
+        }
+
+        TMaybe<TString> GetHeader() override {
+            if (Args.Format.HasHeader) {
+                CB_ENSURE(!HeaderProcessed, "TCompressedFileLineDataReader: multiple calls to GetHeader");
+                TString header;
+                CB_ENSURE(LineReader.ReadLine(&header), "TCompressedFileLineDataReader: no header in file");
+                HeaderProcessed = true;
+                return header;
+            }
+
+            return {};
+        }
+
+        bool ReadLine(TString* line) override {
+            // skip header if it hasn't been read
+            if (!HeaderProcessed) {
+                GetHeader();
+            }
+            return LineReader.ReadLine(line);
+        }
+
+    private:
+        static THolder<NPar::TLocalExecutor> CreateLocalExecutor(int threadCount) {
+            auto localExecutor = MakeHolder<NPar::TLocalExecutor>();
+            localExecutor->RunAdditionalThreads(Max(threadCount, 1) - 1);
+            return localExecutor;
+        }
+
+        static THolder<IDecompressedChunks> CreateChunks(
+            const TString& path,
+            NPar::TLocalExecutor* localExecutor
+        ) {
+            CB_ENSURE(NFs::Exists(path), "pool file '" << path << "' is not found");
+            return TDecompressedChunksFactory::Create(path, localExecutor);
+        }
+
+    private:
+        TLineDataReaderArgs Args;
+
+        // shared by data reading and line counting
+        THolder<NPar::TLocalExecutor> LocalExecutor;
+
+        TChunkedLineReader LineReader;
+        bool HeaderProcessed;
+    };
+
+
+    struct TGzipChunksFactory {
+        static THolder<IDecompressedChunks> Create(
+            const TString& path,
+            NPar::TLocalExecutor* /*localExecutor*/
+        ) {
+            return MakeHolder<TGzipDecompressedChunks>(path);
+        }
+    };
+
+    struct TZstdChunksFactory {
+        static THolder<IDecompressedChunks> Create(const TString& path, NPar::TLocalExecutor* localExecutor) {
+            return MakeHolder<TFramedDecompressedChunks>(path, MakeHolder<TZstdFramesCodec>(), localExecutor);
+        }
+    };
+
+    struct TLz4ChunksFactory {
+        static THolder<IDecompressedChunks> Create(const TString& path, NPar::TLocalExecutor* localExecutor) {
+            return MakeHolder<TFramedDecompressedChunks>(path, MakeHolder<TLz4FramesCodec>(), localExecutor);
+        }
+    };
+
+
+    TLineDataReaderFactory::TRegistrator<TCompressedFileLineDataReader<TGzipChunksFactory>>
+        GzipLineDataReaderReg("gz");
+    TLineDataReaderFactory::TRegistrator<TCompressedFileLineDataReader<TZstdChunksFactory>>
+        ZstdLineDataReaderReg("zstd");
+    TLineDataReaderFactory::TRegistrator<TCompressedFileLineDataReader<TLz4ChunksFactory>>
+        Lz4LineDataReaderReg("lz4");
+
+    }
+}
@@ -13,6 +13,10 @@ namespace NCB {
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSExistsCheckerReg("");
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSFileExistsCheckerReg("file");
     TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSDsvExistsCheckerReg("dsv");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSLibSvmExistsCheckerReg("libsvm");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSGzipExistsCheckerReg("gz");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSZstdExistsCheckerReg("zstd");
+    TExistsCheckerFactory::TRegistrator<TFSExistsChecker> FSLz4ExistsCheckerReg("lz4");
 
     }
 }
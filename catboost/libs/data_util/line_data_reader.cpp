@@ -9,10 +9,11 @@
 namespace NCB {
 
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
-                                               const TDsvFormatOptions& format)
+                                               const TDsvFormatOptions& format,
+                                               int threadCount)
     {
         return GetProcessor<ILineDataReader, TLineDataReaderArgs>(
-            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format}
+            pathWithScheme, TLineDataReaderArgs{pathWithScheme, format, threadCount}
         );
     }
 
@@ -77,6 +78,7 @@ namespace NCB {
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DefLineDataReaderReg("");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> FileLineDataReaderReg("file");
     TLineDataReaderFactory::TRegistrator<TFileLineDataReader> DsvLineDataReaderReg("dsv");
+    TLineDataReaderFactory::TRegistrator<TFileLineDataReader> LibSvmLineDataReaderReg("libsvm");
 
     }
 }
@@ -19,6 +19,9 @@ namespace NCB {
     struct TLineDataReaderArgs {
         TPathWithScheme PathWithScheme;
         TDsvFormatOptions Format;
+
+        // used by readers that decompress data in parallel
+        int ThreadCount = 1;
     };
 
 
@@ -45,6 +48,7 @@ namespace NCB {
         NObjectFactory::TParametrizedObjectFactory<ILineDataReader, TString, TLineDataReaderArgs>;
 
     THolder<ILineDataReader> GetLineDataReader(const TPathWithScheme& pathWithScheme,
-                                               const TDsvFormatOptions& format = {});
+                                               const TDsvFormatOptions& format = {},
+                                               int threadCount = 1);
 
 }
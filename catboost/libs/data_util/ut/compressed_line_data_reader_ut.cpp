@@ -0,0 +1,285 @@
+#include <catboost/libs/data_util/line_data_reader.h>
+
+#include <contrib/libs/lz4/lz4frame.h>
+#include <contrib/libs/zstd/zstd.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/format.h>
+#include <util/stream/file.h>
+#include <util/stream/zlib.h>
+#include <util/string/builder.h>
+#include <util/string/cast.h>
+#include <util/system/fs.h>
+#include <util/system/fstat.h>
+
+
+using namespace NCB;
+
+
+static TVector<TString> GenerateLines(ui32 lineCount) {
+    TVector<TString> lines;
+    for (auto lineIdx : xrange(lineCount)) {
+        lines.push_back(TStringBuilder() << lineIdx << '\t' << TString(lineIdx % 37, char('a' + lineIdx % 26)));
+    }
+    return lines;
+}
+
+// last line has no terminating newline, some lines end with "\r\n"
+static TString JoinLines(const TVector<TString>& lines) {
+    TString data;
+    for (auto lineIdx : xrange(lines.size())) {
+        data += lines[lineIdx];
+        if (lineIdx + 1 != lines.size()) {
+            data += (lineIdx % 3 ? "\n" : "\r\n");
+        }
+    }
+    return data;
+}
+
+// data is split into frames at arbitrary positions, not at line ends
+static TVector<TStringBuf> SplitToFrames(TStringBuf data, size_t frameSize) {
+    TVector<TStringBuf> frames;
+    for (size_t offset = 0; offset < data.size(); offset += frameSize) {
+        frames.push_back(data.SubStr(offset, frameSize));
+    }
+    return frames;
+}
+
+static TString CompressGzip(TStringBuf data, size_t memberSize) {
+    TString result;
+    TStringOutput out(result);
+    for (auto member : SplitToFrames(data, memberSize)) {
+        TZLibCompress compress(&out, ZLib::GZip);
+        compress.Write(member.data(), member.size());
+        compress.Finish();
+    }
+    return result;
+}
+
+static TString CompressZstd(TStringBuf data, size_t frameSize) {
+    TString result;
+    for (auto frame : SplitToFrames(data, frameSize)) {
+        TString compressedFrame;
+        compressedFrame.ReserveAndResize(ZSTD_compressBound(frame.size()));
+        const size_t compressedSize = ZSTD_compress(
+            compressedFrame.begin(),
+            compressedFrame.size(),
+            frame.data(),
+            frame.size(),
+            /*compressionLevel*/ 1
+        );
+        UNIT_ASSERT(!ZSTD_isError(compressedSize));
+        result.append(compressedFrame.data(), compressedSize);
+    }
+    return result;
+}
+
+static TString CompressLz4(TStringBuf data, size_t frameSize) {
+    TString result;
+    for (auto frame : SplitToFrames(data, frameSize)) {
+        TString compressedFrame;
+        compressedFrame.ReserveAndResize(LZ4F_compressFrameBound(frame.size(), nullptr));
+        const size_t compressedSize = LZ4F_compressFrame(
+            compressedFrame.begin(),
+            compressedFrame.size(),
+            frame.data(),
+            frame.size(),
+            nullptr
+        );
+        UNIT_ASSERT(!LZ4F_isError(compressedSize));
+        result.append(compressedFrame.data(), compressedSize);
+    }
+    return result;
+}
+
+static TString Compress(const TString& scheme, TStringBuf data, size_t frameSize) {
+    if (scheme == "gz") {
+        return CompressGzip(data, frameSize);
+    } else if (scheme == "zstd") {
+        return CompressZstd(data, frameSize);
+    } else {
+        return CompressLz4(data, frameSize);
+    }
+}
+
+// poorly compressible lines so that the data is compressed into a frame of several megabytes
+static TVector<TString> GenerateRandomLines(ui32 lineCount, ui64 seed) {
+    TFastRng<ui64> prng(seed);
+    TVector<TString> lines;
+    for (auto lineIdx : xrange(lineCount)) {
+        lines.push_back(TStringBuilder() << lineIdx << '\t' << Hex(prng.GenRand()) << '\t' << Hex(prng.GenRand()));
+    }
+    return lines;
+}
+
+static TVector<TString> ReadAllLines(ILineDataReader* reader) {
+    TVector<TString> lines;
+    TString line;
+    while (reader->ReadLine(&line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+
+Y_UNIT_TEST_SUITE(CompressedLineDataReader) {
+    Y_UNIT_TEST(RoundTrip) {
+        TTempDir tempDir;
+        const TString path = tempDir.Name() + "/data";
+
+        const TVector<TString> lines = GenerateLines(5000);
+        const TString data = JoinLines(lines);
+
+        for (const TString scheme : {"gz", "zstd", "lz4"}) {
+            // several frames per decompression batch and one frame for all data
+            for (size_t frameSize : {size_t(1000), data.size()}) {
+                TOFStream(path).Write(Compress(scheme, data, frameSize));
+
+                for (int threadCount : {1, 4}) {
+                    for (bool hasHeader : {false, true}) {
+                        const TPathWithScheme pathWithScheme(scheme + "://" + path);
+                        TDsvFormatOptions format;
+                        format.HasHeader = hasHeader;
+
+                        auto reader = GetLineDataReader(pathWithScheme, format, threadCount);
+                        UNIT_ASSERT_VALUES_EQUAL(
+                            reader->GetDataLineCount(),
+                            lines.size() - (hasHeader ? 1 : 0)
+                        );
+
+                        TVector<TString> expectedLines = lines;
+                        if (hasHeader) {
+                            UNIT_ASSERT_VALUES_EQUAL(*reader->GetHeader(), lines[0]);
+                            expectedLines.erase(expectedLines.begin());
+                        }
+                        UNIT_ASSERT_EQUAL(ReadAllLines(reader.Get()), expectedLines);
+
+                        // line count is cached, but the cache must not return stale counts
+                        UNIT_ASSERT_VALUES_EQUAL(
+                            GetLineDataReader(pathWithScheme, format, threadCount)->GetDataLineCount(),
+                            lines.size() - (hasHeader ? 1 : 0)
+                        );
+                    }
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(ChangedFileIsRecounted) {
+        TTempDir tempDir;
+        const TString path = tempDir.Name() + "/data";
+        const TPathWithScheme pathWithScheme("zstd://" + path);
+
+        for (ui32 lineCount : {100u, 2000u}) {
+            TOFStream(path).Write(CompressZstd(JoinLines(GenerateLines(lineCount)), 1000));
+            UNIT_ASSERT_VALUES_EQUAL(GetLineDataReader(pathWithScheme)->GetDataLineCount(), lineCount);
+        }
+    }
+
+    Y_UNIT_TEST(TruncatedInput) {
+        TTempDir tempDir;
+        const TString path = tempDir.Name() + "/data";
+
+        const TString data = JoinLines(GenerateLines(5000));
+
+        for (const TString scheme : {"gz", "zstd", "lz4"}) {
+            const TString compressedData = Compress(scheme, data, 1000);
+            for (size_t truncatedSize : {compressedData.size() - 1, compressedData.size() / 2}) {
+                TOFStream(path).Write(compressedData.substr(0, truncatedSize));
+
+                const TPathWithScheme pathWithScheme(scheme + "://" + path);
+                UNIT_ASSERT_EXCEPTION(
+                    ReadAllLines(GetLineDataReader(pathWithScheme, {}, 4).Get()),
+                    yexception
+                );
+                UNIT_ASSERT_EXCEPTION(
+                    GetLineDataReader(pathWithScheme, {}, 4)->GetDataLineCount(),
+                    yexception
+                );
+            }
+        }
+    }
+
+    // zstd and lz4 command line tools compress the whole file into one frame
+    Y_UNIT_TEST(SingleBigFrame) {
+        TTempDir tempDir;
+        const TString path = tempDir.Name() + "/data";
+
+        const TVector<TString> lines = GenerateRandomLines(400000, 20190501);
+        const TString data = JoinLines(lines);
+
+        for (const TString scheme : {"zstd", "lz4"}) {
+            const TString compressedData = Compress(scheme, data, data.size());
+            // bigger than frames that are decompressed whole
+            UNIT_ASSERT(compressedData.size() > (1 << 22));
+
+            TOFStream(path).Write(compressedData);
+            const TPathWithScheme pathWithScheme(scheme + "://" + path);
+            for (int threadCount : {1, 4}) {
+                auto reader = GetLineDataReader(pathWithScheme, {}, threadCount);
+                UNIT_ASSERT_VALUES_EQUAL(reader->GetDataLineCount(), lines.size());
+                UNIT_ASSERT_EQUAL(ReadAllLines(reader.Get()), lines);
+            }
+
+            TOFStream(path).Write(compressedData.substr(0, compressedData.size() - 100));
+            UNIT_ASSERT_EXCEPTION(ReadAllLines(GetLineDataReader(pathWithScheme, {}, 4).Get()), yexception);
+        }
+    }
+
+    Y_UNIT_TEST(CorruptedInput) {
+        TTempDir tempDir;
+        const TString path = tempDir.Name() + "/data";
+
+        // not a valid frame header, data must not be buffered until the end of the file
+        const TString garbage = JoinLines(GenerateRandomLines(400000, 20190502));
+
+        for (const TString scheme : {"zstd", "lz4"}) {
+            TOFStream(path).Write(garbage);
+            UNIT_ASSERT_EXCEPTION(
+                ReadAllLines(GetLineDataReader(TPathWithScheme(scheme + "://" + path), {}, 4).Get()),
+                yexception
+            );
+        }
+    }
+
+    Y_UNIT_TEST(LineCountIsSavedToSidecarFile) {
+        TTempDir tempDir;
+        const TString path = tempDir.Name() + "/data";
+        const TString sidecarPath = path + ".linecount";
+        const TPathWithScheme pathWithScheme("zstd://" + path);
+
+        TOFStream(path).Write(CompressZstd(JoinLines(GenerateLines(100)), 1000));
+        UNIT_ASSERT_VALUES_EQUAL(GetLineDataReader(pathWithScheme)->GetDataLineCount(), 100);
+        UNIT_ASSERT(NFs::Exists(sidecarPath));
+
+        // line count is taken from the sidecar file if the data file is the same
+        const TString otherPath = tempDir.Name() + "/other_data";
+        TOFStream(otherPath).Write(CompressZstd(JoinLines(GenerateLines(200)), 1000));
+        const TFileStat fileStat(otherPath);
+        TOFStream(otherPath + ".linecount").Write(
+            TStringBuilder() << 12345 << '\t' << fileStat.Size << '\t' << fileStat.MTime << '\n'
+        );
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetLineDataReader(TPathWithScheme("zstd://" + otherPath))->GetDataLineCount(),
+            12345
+        );
+
+        // stale and unreadable sidecar files are ignored
+        for (const TString sidecarContent : {"12345\t1\t1\n", "garbage"}) {
+            const TString dataPath = tempDir.Name() + "/data_with_bad_sidecar_" + ToString(sidecarContent.size());
+            TOFStream(dataPath).Write(CompressZstd(JoinLines(GenerateLines(300)), 1000));
+            TOFStream(dataPath + ".linecount").Write(sidecarContent);
+            UNIT_ASSERT_VALUES_EQUAL(
+                GetLineDataReader(TPathWithScheme("zstd://" + dataPath))->GetDataLineCount(),
+                300
+            );
+        }
+    }
+}
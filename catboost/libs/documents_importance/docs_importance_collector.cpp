@@ -0,0 +1,122 @@
+#include "docs_importance_collector.h"
+
+#include <util/generic/algorithm.h>
+#include <util/generic/utility.h>
+#include <util/generic/ymath.h>
+#include <util/system/yassert.h>
+
+
+static bool IsMoreImportant(const std::pair<double, ui32>& lhs, const std::pair<double, ui32>& rhs) {
+    const double lhsAbs = Abs(lhs.first);
+    const double rhsAbs = Abs(rhs.first);
+    return lhsAbs > rhsAbs || (lhsAbs == rhsAbs && lhs.second < rhs.second);
+}
+
+void TTopImportances::Add(ui32 trainDocId, double importance, size_t topSize) {
+    if (Heap.size() < topSize) {
+        Heap.emplace_back(importance, trainDocId);
+        PushHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+    } else if (topSize != 0 && IsMoreImportant({importance, trainDocId}, Heap.front())) {
+        PopHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+        Heap.back() = {importance, trainDocId};
+        PushHeap(Heap.begin(), Heap.end(), IsMoreImportant);
+    }
+}
+
+void TTopImportances::MoveTo(
+    const std::function<bool(double)>& predicate,
+    TVector<ui32>* indices,
+    TVector<double>* scores
+) {
+    Sort(Heap.begin(), Heap.end(), IsMoreImportant);
+    for (const auto& [importance, trainDocId] : Heap) {
+        if (predicate(importance)) {
+            scores->push_back(importance);
+            indices->push_back(trainDocId);
+        }
+    }
+    Heap = {};
+}
+
+
+static std::function<bool(double)> GetImportanceValuesPredicate(EImportanceValuesSign importanceValuesSign) {
+    if (importanceValuesSign == EImportanceValuesSign::Positive) {
+        return [](double v){return v > 0;};
+    } else if (importanceValuesSign == EImportanceValuesSign::Negative) {
+        return [](double v){return v < 0;};
+    }
+    Y_ASSERT(importanceValuesSign == EImportanceValuesSign::All);
+    return [](double){return true;};
+}
+
+TDocumentImportancesCollector::TDocumentImportancesCollector(
+    EDocumentStrengthType docImpMethod,
+    int topSize,
+    EImportanceValuesSign importanceValuesSign,
+    ui32 trainDocCount,
+    ui32 testDocCount,
+    NPar::TLocalExecutor* localExecutor
+)
+    : DocImpMethod(docImpMethod)
+    , TopSize(topSize < 0 ? Max<size_t>() : size_t(topSize))
+    , Predicate(GetImportanceValuesPredicate(importanceValuesSign))
+    , TrainDocCount(trainDocCount)
+    , TestDocCount(testDocCount)
+    , LocalExecutor(localExecutor)
+{
+    if (DocImpMethod == EDocumentStrengthType::Average) {
+        AverageImportances.resize(TrainDocCount);
+        Result = TDStrResult(1);
+    } else {
+        Y_ASSERT(DocImpMethod == EDocumentStrengthType::PerObject || DocImpMethod == EDocumentStrengthType::Raw);
+        Result = TDStrResult(TestDocCount);
+        if (DocImpMethod == EDocumentStrengthType::PerObject) {
+            TopImportances.resize(TestDocCount);
+        }
+    }
+}
+
+void TDocumentImportancesCollector::AddBlock(ui32 trainDocBegin, TConstArrayRef<TVector<double>> importances) {
+    const ui32 blockSize = importances.size();
+    if (DocImpMethod == EDocumentStrengthType::Average) {
+        NPar::ParallelFor(*LocalExecutor, 0, blockSize, [&] (ui32 blockDocId) {
+            double& averageImportance = AverageImportances[trainDocBegin + blockDocId];
+            for (ui32 testDocId = 0; testDocId < TestDocCount; ++testDocId) {
+                averageImportance += importances[blockDocId][testDocId];
+            }
+        });
+    } else if (DocImpMethod == EDocumentStrengthType::PerObject) {
+        NPar::ParallelFor(*LocalExecutor, 0, TestDocCount, [&] (ui32 testDocId) {
+            for (ui32 blockDocId = 0; blockDocId < blockSize; ++blockDocId) {
+                TopImportances[testDocId].Add(trainDocBegin + blockDocId, importances[blockDocId][testDocId], TopSize);
+            }
+        });
+    } else {
+        // raw importances are not sorted, so only the first topSize train docs are taken
+        const ui32 rawBlockSize = trainDocBegin < TopSize ? Min<size_t>(blockSize, TopSize - trainDocBegin) : 0;
+        NPar::ParallelFor(*LocalExecutor, 0, TestDocCount, [&] (ui32 testDocId) {
+            for (ui32 blockDocId = 0; blockDocId < rawBlockSize; ++blockDocId) {
+                const double importance = importances[blockDocId][testDocId];
+                if (Predicate(importance)) {
+                    Result.Scores[testDocId].push_back(importance);
+                    Result.Indices[testDocId].push_back(trainDocBegin + blockDocId);
+                }
+            }
+        });
+    }
+}
+
+TDStrResult TDocumentImportancesCollector::GetResult() {
+    if (DocImpMethod == EDocumentStrengthType::Average) {
+        TTopImportances topImportances;
+        for (ui32 trainDocId = 0; trainDocId < TrainDocCount; ++trainDocId) {
+            topImportances.Add(trainDocId, AverageImportances[trainDocId] / TestDocCount, TopSize);
+        }
+        topImportances.MoveTo(Predicate, &Result.Indices[0], &Result.Scores[0]);
+    } else if (DocImpMethod == EDocumentStrengthType::PerObject) {
+        NPar::ParallelFor(*LocalExecutor, 0, TestDocCount, [&] (ui32 testDocId) {
+            TopImportances[testDocId].MoveTo(Predicate, &Result.Indices[testDocId], &Result.Scores[testDocId]);
+        });
+    }
+    return std::move(Result);
+}
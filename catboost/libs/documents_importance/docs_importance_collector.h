@@ -0,0 +1,57 @@
+#pragma once
+
+#include "docs_importance.h"
+#include "enums.h"
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+#include <functional>
+#include <utility>
+
+
+// Bounded heap of the train docs with the largest absolute importance, ties are resolved by smaller train doc id.
+class TTopImportances {
+public:
+    void Add(ui32 trainDocId, double importance, size_t topSize);
+
+    // sorted by decreasing absolute importance, values not satisfying predicate are skipped
+    void MoveTo(const std::function<bool(double)>& predicate, TVector<ui32>* indices, TVector<double>* scores);
+
+private:
+    TVector<std::pair<double, ui32>> Heap; // least important on top
+};
+
+
+// Reduces blocks of raw importances [trainDocId][testDocId] to the final result as they are evaluated.
+class TDocumentImportancesCollector {
+public:
+    TDocumentImportancesCollector(
+        EDocumentStrengthType docImpMethod,
+        int topSize, // negative means no limit
+        EImportanceValuesSign importanceValuesSign,
+        ui32 trainDocCount,
+        ui32 testDocCount,
+        NPar::TLocalExecutor* localExecutor
+    );
+
+    // blocks must be added in the order of train docs
+    void AddBlock(ui32 trainDocBegin, TConstArrayRef<TVector<double>> importances);
+
+    TDStrResult GetResult();
+
+private:
+    EDocumentStrengthType DocImpMethod;
+    size_t TopSize;
+    std::function<bool(double)> Predicate;
+    ui32 TrainDocCount;
+    ui32 TestDocCount;
+    NPar::TLocalExecutor* LocalExecutor;
+
+    TVector<double> AverageImportances; // [trainDocCount], for Average
+    TVector<TTopImportances> TopImportances; // [testDocCount], for PerObject
+    TDStrResult Result;
+};
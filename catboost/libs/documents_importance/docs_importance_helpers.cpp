@@ -18,8 +18,18 @@
 using namespace NCB;
 
 
-TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
-    const TProcessedDataProvider& processedData, int logPeriod
+// Importances of a block of train objects are kept in memory at once, so block size is limited by pool size.
+static ui32 GetTrainDocBlockSize(ui32 trainDocCount, ui32 testDocCount, int threadCount) {
+    const size_t maxBlockImportancesCount = 1 << 25; // 256MB of doubles
+    const size_t maxBlockSize = 1000;
+    const size_t blockSize = Max<size_t>(threadCount, maxBlockImportancesCount / Max<size_t>(testDocCount, 1));
+    return Max<size_t>(1, Min<size_t>(Min(blockSize, maxBlockSize), trainDocCount));
+}
+
+void TDocumentImportancesEvaluator::GetDocumentImportances(
+    const TProcessedDataProvider& processedData,
+    const TImportancesBlockCallback& processImportancesBlock,
+    int logPeriod
 ) {
     TVector<TVector<ui32>> leafIndices(TreeCount);
     const TVector<ui8> binarizedFeatures = GetModelCompatibleQuantizedFeatures(Model, *processedData.ObjectsData.Get());
@@ -29,8 +39,10 @@ TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
 
 
     UpdateFinalFirstDerivatives(leafIndices, *processedData.TargetData->GetTarget());
-    TVector<TVector<double>> documentImportances(DocCount, TVector<double>(processedData.GetObjectCount()));
-    const size_t docBlockSize = 1000;
+    const ui32 testDocCount = processedData.GetObjectCount();
+    const int threadCount = LocalExecutor->GetThreadCount() + 1;
+    const size_t docBlockSize = GetTrainDocBlockSize(DocCount, testDocCount, threadCount);
+    TVector<TVector<double>> documentImportances(docBlockSize, TVector<double>(testDocCount)); // [docBlockSize][testDocCount]
     TImportanceLogger documentsLogger(DocCount, "documents processed", "Processing documents...", logPeriod);
     TProfileInfo processDocumentsProfile(DocCount);
 
@@ -38,18 +50,27 @@ TVector<TVector<double>> TDocumentImportancesEvaluator::GetDocumentImportances(
         const size_t end = Min<size_t>(start + docBlockSize, DocCount);
         processDocumentsProfile.StartIterationBlock();
 
-        LocalExecutor->ExecRange([&] (int docId) {
+        // each thread processes a contiguous range of train docs reusing its buffers
+        NPar::TLocalExecutor::TExecRangeParams blockParams(start, end);
+        blockParams.SetBlockCount(threadCount);
+        LocalExecutor->ExecRange([&] (int blockId) {
+            const ui32 blockStart = start + blockId * blockParams.GetBlockSize();
+            const ui32 blockEnd = Min<ui32>(blockStart + blockParams.GetBlockSize(), end);
             // The derivative of leaf values with respect to train doc weight.
             TVector<TVector<TVector<double>>> leafDerivatives(TreeCount, TVector<TVector<double>>(LeavesEstimationIterations)); // [treeCount][LeavesEstimationIterationsCount][leafCount]
-            UpdateLeavesDerivatives(docId, &leafDerivatives);
-            GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId]);
-        }, NPar::TLocalExecutor::TExecRangeParams(start, end), NPar::TLocalExecutor::WAIT_COMPLETE);
+            TVector<double> jacobian;
+            for (ui32 docId = blockStart; docId < blockEnd; ++docId) {
+                UpdateLeavesDerivatives(docId, &jacobian, &leafDerivatives);
+                GetDocumentImportancesForOneTrainDoc(leafDerivatives, leafIndices, &documentImportances[docId - start]);
+            }
+        }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        processImportancesBlock(start, MakeArrayRef(documentImportances.data(), end - start));
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
-        }
-    return documentImportances;
+    }
 }
 
 void TDocumentImportancesEvaluator::UpdateFinalFirstDerivatives(const TVector<TVector<ui32>>& leafIndices, TConstArrayRef<float> target) {
@@ -99,8 +120,13 @@ TVector<ui32> TDocumentImportancesEvaluator::GetLeafIdToUpdate(ui32 treeId, cons
     return leafIdToUpdate;
 }
 
-void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives) {
-    TVector<double> jacobian(DocCount);
+void TDocumentImportancesEvaluator::UpdateLeavesDerivatives(
+    ui32 removedDocId,
+    TVector<double>* jacobianBuffer,
+    TVector<TVector<TVector<double>>>* leafDerivatives
+) {
+    TVector<double>& jacobian = *jacobianBuffer;
+    jacobian.assign(DocCount, 0.0);
     for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
         auto& treeStatistics = TreesStatistics[treeId];
         for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
@@ -139,20 +165,25 @@ void TDocumentImportancesEvaluator::GetDocumentImportancesForOneTrainDoc(
     TVector<double>* documentImportance
 ) {
     const ui32 docCount = documentImportance->size();
-    TVector<double> predictedDerivatives(docCount);
-
-    for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
-        const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
-        for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
-            const TVector<double>& leafDerivativesRef = leafDerivatives[treeId][it];
-            for (ui32 docId = 0; docId < docCount; ++docId) {
-                predictedDerivatives[docId] += leafDerivativesRef[leafIndicesRef[docId]];
+    TVector<double>& predictedDerivatives = *documentImportance;
+
+    // docs are processed in batches so that predicted derivatives stay in cache while walking all trees
+    const ui32 docBatchSize = 4096;
+    for (ui32 batchStart = 0; batchStart < docCount; batchStart += docBatchSize) {
+        const ui32 batchEnd = Min(batchStart + docBatchSize, docCount);
+        Fill(predictedDerivatives.begin() + batchStart, predictedDerivatives.begin() + batchEnd, 0.0);
+        for (ui32 treeId = 0; treeId < TreeCount; ++treeId) {
+            const TVector<ui32>& leafIndicesRef = leafIndices[treeId];
+            for (ui32 it = 0; it < LeavesEstimationIterations; ++it) {
+                const TVector<double>& leafDerivativesRef = leafDerivatives[treeId][it];
+                for (ui32 docId = batchStart; docId < batchEnd; ++docId) {
+                    predictedDerivatives[docId] += leafDerivativesRef[leafIndicesRef[docId]];
+                }
             }
         }
-    }
-
-    for (ui32 docId = 0; docId < docCount; ++docId) {
-        (*documentImportance)[docId] = FinalFirstDerivatives[docId] * predictedDerivatives[docId];
+        for (ui32 docId = batchStart; docId < batchEnd; ++docId) {
+            predictedDerivatives[docId] *= FinalFirstDerivatives[docId];
+        }
     }
 }
 
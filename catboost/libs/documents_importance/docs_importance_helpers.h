@@ -11,11 +11,14 @@
 
 #include <library/threading/local_executor/local_executor.h>
 
+#include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 #include <util/generic/ptr.h>
 #include <util/system/types.h>
 #include <util/system/yassert.h>
 
+#include <functional>
+
 
 /*
  * This is the implementation of the LeafInfluence algorithm from the following paper:
@@ -70,8 +73,16 @@ public:
         TreesStatistics = treeStatisticsEvaluator->EvaluateTreeStatistics(model, processedData, logPeriod);
     }
 
+    // Called sequentially for consecutive blocks of train objects with importances [blockTrainDocId][docId].
+    using TImportancesBlockCallback = std::function<void(ui32 trainDocBegin, TConstArrayRef<TVector<double>> importances)>;
+
     // Getting the importance of all train objects for all objects from pool.
-    TVector<TVector<double>> GetDocumentImportances(const NCB::TProcessedDataProvider& processedData, int logPeriod = 0);
+    // Importances are streamed block by block, the whole [trainDocCount][docCount] matrix is never stored.
+    void GetDocumentImportances(
+        const NCB::TProcessedDataProvider& processedData,
+        const TImportancesBlockCallback& processImportancesBlock,
+        int logPeriod = 0
+    );
 
 private:
     // Evaluate first derivatives at the final approxes
@@ -79,7 +90,11 @@ private:
     // Leaves derivatives will be updated based on objects from these leaves.
     TVector<ui32> GetLeafIdToUpdate(ui32 treeId, const TVector<double>& jacobian);
     // Algorithm 4 from paper.
-    void UpdateLeavesDerivatives(ui32 removedDocId, TVector<TVector<TVector<double>>>* leafDerivatives);
+    void UpdateLeavesDerivatives(
+        ui32 removedDocId,
+        TVector<double>* jacobian,
+        TVector<TVector<TVector<double>>>* leafDerivatives
+    );
     // Getting the importance of one train object for all objects from pool.
     void GetDocumentImportancesForOneTrainDoc(
         const TVector<TVector<TVector<double>>>& leafDerivatives,
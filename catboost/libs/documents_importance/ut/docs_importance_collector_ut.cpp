@@ -0,0 +1,122 @@
+#include <catboost/libs/documents_importance/docs_importance_collector.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+
+#include <numeric>
+
+
+// reduction of the materialized [trainDocId][testDocId] matrix as it was done before streaming by blocks,
+// stable sort resolves ties by smaller train doc id
+static TDStrResult GetFinalDocumentImportancesFromMatrix(
+    const TVector<TVector<double>>& rawImportances,
+    EDocumentStrengthType docImpMethod,
+    int topSize,
+    EImportanceValuesSign importanceValuesSign
+) {
+    const ui32 trainDocCount = rawImportances.size();
+    const ui32 testDocCount = rawImportances[0].size();
+    TVector<TVector<double>> preprocessedImportances;
+    if (docImpMethod == EDocumentStrengthType::Average) {
+        preprocessedImportances = TVector<TVector<double>>(1, TVector<double>(trainDocCount));
+        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
+            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
+                preprocessedImportances[0][trainDocId] += rawImportances[trainDocId][testDocId];
+            }
+            preprocessedImportances[0][trainDocId] /= testDocCount;
+        }
+    } else {
+        preprocessedImportances = TVector<TVector<double>>(testDocCount, TVector<double>(trainDocCount));
+        for (ui32 trainDocId = 0; trainDocId < trainDocCount; ++trainDocId) {
+            for (ui32 testDocId = 0; testDocId < testDocCount; ++testDocId) {
+                preprocessedImportances[testDocId][trainDocId] = rawImportances[trainDocId][testDocId];
+            }
+        }
+    }
+
+    TDStrResult result(preprocessedImportances.size());
+    for (ui32 testDocId = 0; testDocId < preprocessedImportances.size(); ++testDocId) {
+        const TVector<double>& importances = preprocessedImportances[testDocId];
+
+        TVector<ui32> indices(importances.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        if (docImpMethod != EDocumentStrengthType::Raw) {
+            StableSort(indices.begin(), indices.end(), [&](ui32 first, ui32 second) {
+                return Abs(importances[first]) > Abs(importances[second]);
+            });
+        }
+
+        int currentSize = 0;
+        for (ui32 idx : indices) {
+            if (currentSize == topSize) {
+                break;
+            }
+            const double importance = importances[idx];
+            const bool matchesSign = (importanceValuesSign == EImportanceValuesSign::All)
+                || ((importanceValuesSign == EImportanceValuesSign::Positive) && (importance > 0))
+                || ((importanceValuesSign == EImportanceValuesSign::Negative) && (importance < 0));
+            if (matchesSign) {
+                result.Scores[testDocId].push_back(importance);
+                result.Indices[testDocId].push_back(idx);
+            }
+            ++currentSize;
+        }
+    }
+    return result;
+}
+
+
+Y_UNIT_TEST_SUITE(DocumentImportancesCollector) {
+    Y_UNIT_TEST(SameAsMaterializedMatrix) {
+        const ui32 trainDocCount = 57;
+        const ui32 testDocCount = 13;
+
+        // values from a small set to have a lot of ties in absolute values
+        TFastRng64 rng(0);
+        TVector<TVector<double>> rawImportances(trainDocCount, TVector<double>(testDocCount));
+        for (auto& trainDocImportances : rawImportances) {
+            for (auto& importance : trainDocImportances) {
+                importance = 0.5 * ((int)rng.Uniform(9) - 4);
+            }
+        }
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (auto docImpMethod : {EDocumentStrengthType::Average, EDocumentStrengthType::PerObject, EDocumentStrengthType::Raw}) {
+            for (auto sign : {EImportanceValuesSign::All, EImportanceValuesSign::Positive, EImportanceValuesSign::Negative}) {
+                for (int topSize : {0, 1, 5, 20, (int)trainDocCount, -1}) {
+                    for (ui32 blockSize : {1u, 7u, 16u, trainDocCount}) {
+                        TDocumentImportancesCollector collector(
+                            docImpMethod,
+                            topSize,
+                            sign,
+                            trainDocCount,
+                            testDocCount,
+                            &localExecutor
+                        );
+                        for (ui32 blockBegin = 0; blockBegin < trainDocCount; blockBegin += blockSize) {
+                            const ui32 blockEnd = Min(blockBegin + blockSize, trainDocCount);
+                            collector.AddBlock(
+                                blockBegin,
+                                MakeArrayRef(rawImportances.data() + blockBegin, blockEnd - blockBegin)
+                            );
+                        }
+                        const TDStrResult result = collector.GetResult();
+                        const TDStrResult expectedResult
+                            = GetFinalDocumentImportancesFromMatrix(rawImportances, docImpMethod, topSize, sign);
+
+                        UNIT_ASSERT_VALUES_EQUAL(result.Indices, expectedResult.Indices);
+                        UNIT_ASSERT_VALUES_EQUAL(result.Scores, expectedResult.Scores);
+                    }
+                }
+            }
+        }
+    }
+}
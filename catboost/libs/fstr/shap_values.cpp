@@ -12,6 +12,7 @@
 #include <util/generic/algorithm.h>
 #include <util/generic/utility.h>
 #include <util/generic/ymath.h>
+#include <util/stream/str.h>
 
 
 using namespace NCB;
@@ -36,66 +37,91 @@ namespace {
     };
 } //anonymous
 
-static TVector<TFeaturePathElement> ExtendFeaturePath(
-    const TVector<TFeaturePathElement>& oldFeaturePath,
+/* Feature paths are kept in one buffer allocated per leaf: the path of each recursion level is stored right
+ * after the path of its parent, and oblivious trees have one split per depth, so the buffer takes
+ * (depth + 1) * (depth + 2) / 2 elements and no memory is allocated during the recursion.
+ */
+static size_t GetFeaturePathBufferSize(int treeDepth) {
+    return size_t(treeDepth + 1) * (treeDepth + 2) / 2;
+}
+
+// appends an element to the path of pathLength elements
+static void ExtendFeaturePath(
+    TFeaturePathElement* featurePath,
+    size_t pathLength,
     double zeroPathsFraction,
     double onePathsFraction,
     int feature
 ) {
-    const size_t pathLength = oldFeaturePath.size();
-
-    TVector<TFeaturePathElement> newFeaturePath(pathLength + 1);
-    Copy(oldFeaturePath.begin(), oldFeaturePath.begin() + pathLength, newFeaturePath.begin());
-
     const double weight = pathLength == 0 ? 1.0 : 0.0;
-    newFeaturePath[pathLength] = TFeaturePathElement(feature, zeroPathsFraction, onePathsFraction, weight);
+    featurePath[pathLength] = TFeaturePathElement(feature, zeroPathsFraction, onePathsFraction, weight);
 
     for (int elementIdx = pathLength - 1; elementIdx >= 0; --elementIdx) {
-        newFeaturePath[elementIdx + 1].Weight += onePathsFraction * newFeaturePath[elementIdx].Weight * (elementIdx + 1) / (pathLength + 1);
-        newFeaturePath[elementIdx].Weight = zeroPathsFraction * newFeaturePath[elementIdx].Weight * (pathLength - elementIdx) / (pathLength + 1);
+        featurePath[elementIdx + 1].Weight += onePathsFraction * featurePath[elementIdx].Weight * (elementIdx + 1) / (pathLength + 1);
+        featurePath[elementIdx].Weight = zeroPathsFraction * featurePath[elementIdx].Weight * (pathLength - elementIdx) / (pathLength + 1);
     }
-
-    return newFeaturePath;
 }
 
-static TVector<TFeaturePathElement> UnwindFeaturePath(
-    const TVector<TFeaturePathElement>& oldFeaturePath,
+// removes the element from the path of pathLength elements
+static void UnwindFeaturePath(
+    TFeaturePathElement* featurePath,
+    size_t pathLength,
     size_t eraseElementIdx)
 {
-    const size_t pathLength = oldFeaturePath.size();
     CB_ENSURE(pathLength > 0, "Path to unwind must have at least one element");
 
-    TVector<TFeaturePathElement> newFeaturePath(
-        oldFeaturePath.begin(),
-        oldFeaturePath.begin() + pathLength - 1);
-
-    for (size_t elementIdx = eraseElementIdx; elementIdx < pathLength - 1; ++elementIdx) {
-        newFeaturePath[elementIdx].Feature = oldFeaturePath[elementIdx + 1].Feature;
-        newFeaturePath[elementIdx].ZeroPathsFraction = oldFeaturePath[elementIdx + 1].ZeroPathsFraction;
-        newFeaturePath[elementIdx].OnePathsFraction = oldFeaturePath[elementIdx + 1].OnePathsFraction;
-    }
-
-    const double onePathsFraction = oldFeaturePath[eraseElementIdx].OnePathsFraction;
-    const double zeroPathsFraction = oldFeaturePath[eraseElementIdx].ZeroPathsFraction;
-    double weightDiff = oldFeaturePath[pathLength - 1].Weight;
+    const double onePathsFraction = featurePath[eraseElementIdx].OnePathsFraction;
+    const double zeroPathsFraction = featurePath[eraseElementIdx].ZeroPathsFraction;
+    double weightDiff = featurePath[pathLength - 1].Weight;
 
     if (!FuzzyEquals(1 + onePathsFraction, 1 + 0.0)) {
         for (int elementIdx = pathLength - 2; elementIdx >= 0; --elementIdx) {
-            double oldWeight = newFeaturePath[elementIdx].Weight;
-            newFeaturePath[elementIdx].Weight = weightDiff * pathLength
+            double oldWeight = featurePath[elementIdx].Weight;
+            featurePath[elementIdx].Weight = weightDiff * pathLength
                 / (onePathsFraction * (elementIdx + 1));
             weightDiff = oldWeight
-                - newFeaturePath[elementIdx].Weight * zeroPathsFraction * (pathLength - elementIdx - 1)
+                - featurePath[elementIdx].Weight * zeroPathsFraction * (pathLength - elementIdx - 1)
                     / pathLength;
         }
     } else {
         for (int elementIdx = pathLength - 2; elementIdx >= 0; --elementIdx) {
-            newFeaturePath[elementIdx].Weight *= pathLength
+            featurePath[elementIdx].Weight *= pathLength
                 / (zeroPathsFraction * (pathLength - elementIdx - 1));
         }
     }
 
-    return newFeaturePath;
+    for (size_t elementIdx = eraseElementIdx; elementIdx < pathLength - 1; ++elementIdx) {
+        featurePath[elementIdx].Feature = featurePath[elementIdx + 1].Feature;
+        featurePath[elementIdx].ZeroPathsFraction = featurePath[elementIdx + 1].ZeroPathsFraction;
+        featurePath[elementIdx].OnePathsFraction = featurePath[elementIdx + 1].OnePathsFraction;
+    }
+}
+
+// sum of weights of the path with the element removed, the path itself is not changed
+static double CalcUnwoundFeaturePathWeightSum(
+    const TFeaturePathElement* featurePath,
+    size_t pathLength,
+    size_t eraseElementIdx)
+{
+    const double onePathsFraction = featurePath[eraseElementIdx].OnePathsFraction;
+    const double zeroPathsFraction = featurePath[eraseElementIdx].ZeroPathsFraction;
+    double weightDiff = featurePath[pathLength - 1].Weight;
+    double weightSum = 0.0;
+
+    if (!FuzzyEquals(1 + onePathsFraction, 1 + 0.0)) {
+        for (int elementIdx = pathLength - 2; elementIdx >= 0; --elementIdx) {
+            const double weight = weightDiff * pathLength / (onePathsFraction * (elementIdx + 1));
+            weightSum += weight;
+            weightDiff = featurePath[elementIdx].Weight
+                - weight * zeroPathsFraction * (pathLength - elementIdx - 1) / pathLength;
+        }
+    } else {
+        for (int elementIdx = pathLength - 2; elementIdx >= 0; --elementIdx) {
+            weightSum += featurePath[elementIdx].Weight * pathLength
+                / (zeroPathsFraction * (pathLength - elementIdx - 1));
+        }
+    }
+    return weightSum;
 }
 
 static size_t CalcLeafToFallForDocument(
@@ -122,26 +148,23 @@ static void CalcInternalShapValuesForLeafRecursive(
     int depth,
     const TVector<TVector<double>>& subtreeWeights,
     size_t nodeIdx,
-    const TVector<TFeaturePathElement>& oldFeaturePath,
+    TFeaturePathElement* oldFeaturePath, // not changed, the path is extended in the buffer after it
+    size_t oldPathLength,
     double zeroPathsFraction,
     double onePathsFraction,
     int feature,
     bool calcInternalValues,
     TVector<TShapValue>* shapValuesInternal
 ) {
-    TVector<TFeaturePathElement> featurePath = ExtendFeaturePath(
-        oldFeaturePath,
-        zeroPathsFraction,
-        onePathsFraction,
-        feature);
+    TFeaturePathElement* featurePath = oldFeaturePath + oldPathLength;
+    Copy(oldFeaturePath, oldFeaturePath + oldPathLength, featurePath);
+    ExtendFeaturePath(featurePath, oldPathLength, zeroPathsFraction, onePathsFraction, feature);
+    size_t pathLength = oldPathLength + 1;
+
     auto firstLeafPtr = forest.GetFirstLeafPtrForTree(treeIdx);
     if (depth == forest.TreeSizes[treeIdx]) {
-        for (size_t elementIdx = 1; elementIdx < featurePath.size(); ++elementIdx) {
-            TVector<TFeaturePathElement> unwoundPath = UnwindFeaturePath(featurePath, elementIdx);
-            double weightSum = 0.0;
-            for (const TFeaturePathElement& unwoundPathElement : unwoundPath) {
-                weightSum += unwoundPathElement.Weight;
-            }
+        for (size_t elementIdx = 1; elementIdx < pathLength; ++elementIdx) {
+            const double weightSum = CalcUnwoundFeaturePathWeightSum(featurePath, pathLength, elementIdx);
             const TFeaturePathElement& element = featurePath[elementIdx];
             const int approxDimension = forest.ApproxDimension;
             const auto sameFeatureShapValue = FindIf(
@@ -175,18 +198,19 @@ static void CalcInternalShapValuesForLeafRecursive(
         ];
 
         const auto sameFeatureElement = FindIf(
-            featurePath.begin(),
-            featurePath.end(),
+            featurePath,
+            featurePath + pathLength,
             [combinationClass](const TFeaturePathElement& element) {
                 return element.Feature == combinationClass;
             }
         );
 
-        if (sameFeatureElement != featurePath.end()) {
-            const size_t sameFeatureIndex = sameFeatureElement - featurePath.begin();
+        if (sameFeatureElement != featurePath + pathLength) {
+            const size_t sameFeatureIndex = sameFeatureElement - featurePath;
             newZeroPathsFraction = featurePath[sameFeatureIndex].ZeroPathsFraction;
             newOnePathsFraction = featurePath[sameFeatureIndex].OnePathsFraction;
-            featurePath = UnwindFeaturePath(featurePath, sameFeatureIndex);
+            UnwindFeaturePath(featurePath, pathLength, sameFeatureIndex);
+            --pathLength;
         }
 
         const size_t goNodeIdx = nodeIdx | (documentLeafIdx & (size_t(1) << depth));
@@ -204,6 +228,7 @@ static void CalcInternalShapValuesForLeafRecursive(
                 subtreeWeights,
                 goNodeIdx,
                 featurePath,
+                pathLength,
                 newZeroPathsFractionGoNode,
                 newOnePathsFraction,
                 combinationClass,
@@ -224,6 +249,7 @@ static void CalcInternalShapValuesForLeafRecursive(
                 subtreeWeights,
                 skipNodeIdx,
                 featurePath,
+                pathLength,
                 newZeroPathsFractionSkipNode,
                 /*onePathFraction*/ 0,
                 combinationClass,
@@ -280,7 +306,7 @@ static inline void CalcShapValuesForLeaf(
 ) {
     shapValues->clear();
 
-    TVector<TFeaturePathElement> initialFeaturePath;
+    TVector<TFeaturePathElement> featurePathBuffer(GetFeaturePathBufferSize(forest.TreeSizes[treeIdx]));
     if (calcInternalValues) {
         CalcInternalShapValuesForLeafRecursive(
             forest,
@@ -290,7 +316,8 @@ static inline void CalcShapValuesForLeaf(
             /*depth*/ 0,
             subtreeWeights,
             /*nodeIdx*/ 0,
-            initialFeaturePath,
+            featurePathBuffer.data(),
+            /*oldPathLength*/ 0,
             /*zeroPathFraction*/ 1,
             /*onePathFraction*/ 1,
             /*feature*/ -1,
@@ -307,7 +334,8 @@ static inline void CalcShapValuesForLeaf(
             /*depth*/ 0,
             subtreeWeights,
             /*nodeIdx*/ 0,
-            initialFeaturePath,
+            featurePathBuffer.data(),
+            /*oldPathLength*/ 0,
             /*zeroPathFraction*/ 1,
             /*onePathFraction*/ 1,
             /*feature*/ -1,
@@ -481,6 +509,106 @@ void CalcShapValuesForDocumentMulti(
     }
 }
 
+// documents are processed tree by tree to reuse SHAP values of a leaf for all its documents
+static constexpr size_t ShapDocumentBlockSize = 4096;
+
+static void CalcLeafIndicesForDocuments(
+    const TObliviousTrees& forest,
+    size_t treeIdx,
+    const TVector<ui8>& binarizedFeaturesForBlock,
+    size_t documentCount,
+    size_t begin,
+    size_t end,
+    TVector<ui32>* leafIndices // [documentIdx - begin]
+) {
+    leafIndices->assign(end - begin, 0);
+    ui32* leafIndicesData = leafIndices->data();
+    for (int depth = 0; depth < forest.TreeSizes[treeIdx]; ++depth) {
+        const TRepackedBin& split = forest.GetRepackedBins()[forest.TreeStartOffsets[treeIdx] + depth];
+        const ui8* featureValues = binarizedFeaturesForBlock.data() + split.FeatureIndex * documentCount + begin;
+        const ui8 xorMask = split.XorMask;
+        const ui8 splitIdx = split.SplitIdx;
+        for (size_t idx = 0; idx < end - begin; ++idx) {
+            leafIndicesData[idx] |= ui32((featureValues[idx] ^ xorMask) >= splitIdx) << depth;
+        }
+    }
+}
+
+static void AddShapValues(
+    const TVector<TShapValue>& shapValuesByLeaf,
+    int approxDimension,
+    size_t valueCount, // flat features and the mean value
+    double* documentShapValues // [dimension][feature]
+) {
+    for (const TShapValue& shapValue : shapValuesByLeaf) {
+        for (int dimension = 0; dimension < approxDimension; ++dimension) {
+            documentShapValues[dimension * valueCount + shapValue.Feature] += shapValue.Value[dimension];
+        }
+    }
+}
+
+static void CalcShapValuesForDocumentRangeMulti(
+    const TObliviousTrees& forest,
+    const TShapPreparedTrees& preparedTrees,
+    const TVector<ui8>& binarizedFeaturesForBlock,
+    int flatFeatureCount,
+    size_t documentCount,
+    size_t begin,
+    size_t end,
+    double* shapValues // [documentIdx - begin][dimension][feature]
+) {
+    const int approxDimension = forest.ApproxDimension;
+    const size_t valueCount = flatFeatureCount + 1;
+    const size_t documentValueCount = approxDimension * valueCount;
+    Fill(shapValues, shapValues + (end - begin) * documentValueCount, 0.0);
+
+    TVector<ui32> leafIndices;
+    TVector<TVector<TShapValue>> shapValuesByLeaf; // used if SHAP values are not precalculated
+    TVector<bool> isLeafCalculated;
+    const size_t treeCount = forest.GetTreeCount();
+    for (size_t treeIdx = 0; treeIdx < treeCount; ++treeIdx) {
+        CalcLeafIndicesForDocuments(forest, treeIdx, binarizedFeaturesForBlock, documentCount, begin, end, &leafIndices);
+
+        const TVector<TVector<TShapValue>>* treeShapValuesByLeaf = &preparedTrees.ShapValuesByLeafForAllTrees[treeIdx];
+        if (!preparedTrees.CalcShapValuesByLeafForAllTrees) {
+            // calculate values only for leaves that documents fall to, once per leaf
+            const size_t leafCount = size_t(1) << forest.TreeSizes[treeIdx];
+            shapValuesByLeaf.resize(leafCount);
+            isLeafCalculated.assign(leafCount, false);
+            for (ui32 leafIdx : leafIndices) {
+                if (!isLeafCalculated[leafIdx]) {
+                    CalcShapValuesForLeaf(
+                        forest,
+                        preparedTrees.BinFeatureCombinationClass,
+                        preparedTrees.CombinationClassFeatures,
+                        leafIdx,
+                        treeIdx,
+                        preparedTrees.SubtreeWeightsForAllTrees[treeIdx],
+                        preparedTrees.CalcInternalValues,
+                        &shapValuesByLeaf[leafIdx]
+                    );
+                    isLeafCalculated[leafIdx] = true;
+                }
+            }
+            treeShapValuesByLeaf = &shapValuesByLeaf;
+        }
+
+        const TVector<double>& meanValues = preparedTrees.MeanValuesForAllTrees[treeIdx];
+        for (size_t documentIdx = begin; documentIdx < end; ++documentIdx) {
+            double* documentShapValues = shapValues + (documentIdx - begin) * documentValueCount;
+            AddShapValues(
+                (*treeShapValuesByLeaf)[leafIndices[documentIdx - begin]],
+                approxDimension,
+                valueCount,
+                documentShapValues
+            );
+            for (int dimension = 0; dimension < approxDimension; ++dimension) {
+                documentShapValues[dimension * valueCount + flatFeatureCount] += meanValues[dimension];
+            }
+        }
+    }
+}
+
 static void CalcShapValuesForDocumentBlockMulti(
     const TFullModel& model,
     const TObjectsDataProvider& objectsData,
@@ -488,7 +616,7 @@ static void CalcShapValuesForDocumentBlockMulti(
     size_t start,
     size_t end,
     NPar::TLocalExecutor* localExecutor,
-    TVector<TVector<TVector<double>>>* shapValuesForAllDocuments
+    TVector<double>* shapValuesForBlock // [documentIdx - start][dimension][feature]
 ) {
     const TObliviousTrees& forest = model.ObliviousTrees;
     const size_t documentCount = end - start;
@@ -496,25 +624,26 @@ static void CalcShapValuesForDocumentBlockMulti(
     TVector<ui8> binarizedFeaturesForBlock = GetModelCompatibleQuantizedFeatures(model, objectsData, start, end);
 
     const int flatFeatureCount = objectsData.GetFeaturesLayout()->GetExternalFeatureCount();
+    const size_t documentValueCount = size_t(forest.ApproxDimension) * (flatFeatureCount + 1);
 
-    const int oldShapValuesSize = shapValuesForAllDocuments->size();
-    shapValuesForAllDocuments->resize(oldShapValuesSize + end - start);
+    shapValuesForBlock->yresize(documentCount * documentValueCount);
 
     NPar::TLocalExecutor::TExecRangeParams blockParams(0, documentCount);
-    localExecutor->ExecRange([&] (size_t documentIdx) {
-        TVector<TVector<double>>& shapValues = (*shapValuesForAllDocuments)[oldShapValuesSize + documentIdx];
-
-        CalcShapValuesForDocumentMulti(
+    blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+    localExecutor->ExecRange([&] (int blockId) {
+        const size_t blockBegin = blockId * blockParams.GetBlockSize();
+        const size_t blockEnd = Min<size_t>(blockBegin + blockParams.GetBlockSize(), documentCount);
+        CalcShapValuesForDocumentRangeMulti(
             forest,
             preparedTrees,
             binarizedFeaturesForBlock,
             flatFeatureCount,
-            documentIdx,
             documentCount,
-            &shapValues
+            blockBegin,
+            blockEnd,
+            shapValuesForBlock->data() + blockBegin * documentValueCount
         );
-
-    }, blockParams, NPar::TLocalExecutor::WAIT_COMPLETE);
+    }, 0, blockParams.GetBlockCount(), NPar::TLocalExecutor::WAIT_COMPLETE);
 }
 
 static void CalcShapValuesByLeafForTreeBlock(
@@ -763,15 +892,19 @@ TVector<TVector<TVector<double>>> CalcShapValuesMulti(
     );
 
     const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
-    const size_t documentBlockSize = CB_THREAD_LIMIT; // least necessary for threading
+    const size_t documentBlockSize = ShapDocumentBlockSize;
 
     TImportanceLogger documentsLogger(documentCount, "documents processed", "Processing documents...", logPeriod);
 
+    const int approxDimension = model.ObliviousTrees.ApproxDimension;
+    const size_t valueCount = dataset.ObjectsData->GetFeaturesLayout()->GetExternalFeatureCount() + 1;
+
     TVector<TVector<TVector<double>>> shapValues;
     shapValues.reserve(documentCount);
 
     TProfileInfo processDocumentsProfile(documentCount);
 
+    TVector<double> shapValuesForBlock;
     for (size_t start = 0; start < documentCount; start += documentBlockSize) {
         size_t end = Min(start + documentBlockSize, documentCount);
 
@@ -784,9 +917,20 @@ TVector<TVector<TVector<double>>> CalcShapValuesMulti(
             start,
             end,
             localExecutor,
-            &shapValues
+            &shapValuesForBlock
         );
 
+        for (size_t documentIdx = start; documentIdx < end; ++documentIdx) {
+            const double* documentShapValues = shapValuesForBlock.data() + (documentIdx - start) * approxDimension * valueCount;
+            shapValues.emplace_back(approxDimension);
+            for (int dimension = 0; dimension < approxDimension; ++dimension) {
+                shapValues.back()[dimension].assign(
+                    documentShapValues + dimension * valueCount,
+                    documentShapValues + (dimension + 1) * valueCount
+                );
+            }
+        }
+
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
         documentsLogger.Log(profileResults);
@@ -820,14 +964,30 @@ TVector<TVector<double>> CalcShapValues(
     return shapValues;
 }
 
-static void OutputShapValuesMulti(const TVector<TVector<TVector<double>>>& shapValues, TFileOutput& out) {
-    for (const auto& shapValuesForDocument : shapValues) {
-        for (const auto& shapValuesForClass : shapValuesForDocument) {
-            int valuesCount = shapValuesForClass.size();
-            for (int valueIdx = 0; valueIdx < valuesCount; ++valueIdx) {
-                out << shapValuesForClass[valueIdx] << (valueIdx + 1 == valuesCount ? '\n' : '\t');
+static void OutputShapValuesMulti(
+    const TVector<double>& shapValues, // [documentIdx][dimension][feature]
+    int approxDimension,
+    size_t valueCount, // flat features and the mean value
+    NPar::TLocalExecutor* localExecutor,
+    TFileOutput& out
+) {
+    const size_t documentValueCount = approxDimension * valueCount;
+    const size_t documentCount = shapValues.size() / documentValueCount;
+
+    // formatting is the bottleneck for large blocks, so documents are formatted in parallel
+    TVector<TString> formattedDocuments(documentCount);
+    NPar::ParallelFor(*localExecutor, 0, documentCount, [&] (int documentIdx) {
+        TStringOutput documentOut(formattedDocuments[documentIdx]);
+        const double* documentShapValues = shapValues.data() + documentIdx * documentValueCount;
+        for (int dimension = 0; dimension < approxDimension; ++dimension) {
+            for (size_t valueIdx = 0; valueIdx < valueCount; ++valueIdx) {
+                documentOut << documentShapValues[dimension * valueCount + valueIdx]
+                    << (valueIdx + 1 == valueCount ? '\n' : '\t');
             }
         }
+    });
+    for (const auto& formattedDocument : formattedDocuments) {
+        out << formattedDocument;
     }
 }
 
@@ -849,20 +1009,22 @@ void CalcAndOutputShapValues(
     );
 
     const size_t documentCount = dataset.ObjectsGrouping->GetObjectCount();
-    const size_t documentBlockSize = CB_THREAD_LIMIT; // least necessary for threading
+    const size_t documentBlockSize = ShapDocumentBlockSize;
 
     TImportanceLogger documentsLogger(documentCount, "documents processed", "Processing documents...", logPeriod);
 
     TProfileInfo processDocumentsProfile(documentCount);
 
+    const int approxDimension = model.ObliviousTrees.ApproxDimension;
+    const size_t valueCount = dataset.ObjectsData->GetFeaturesLayout()->GetExternalFeatureCount() + 1;
+
     TFileOutput out(outputPath);
+    // reused between blocks, results are never materialized for all documents
+    TVector<double> shapValuesForBlock;
     for (size_t start = 0; start < documentCount; start += documentBlockSize) {
         size_t end = Min(start + documentBlockSize, documentCount);
         processDocumentsProfile.StartIterationBlock();
 
-        TVector<TVector<TVector<double>>> shapValuesForBlock;
-        shapValuesForBlock.reserve(end - start);
-
         CalcShapValuesForDocumentBlockMulti(
             model,
             *dataset.ObjectsData,
@@ -873,7 +1035,7 @@ void CalcAndOutputShapValues(
             &shapValuesForBlock
         );
 
-        OutputShapValuesMulti(shapValuesForBlock, out);
+        OutputShapValuesMulti(shapValuesForBlock, approxDimension, valueCount, localExecutor, out);
 
         processDocumentsProfile.FinishIterationBlock(end - start);
         auto profileResults = processDocumentsProfile.GetProfileResults();
@@ -0,0 +1,260 @@
+#include <catboost/libs/fstr/shap_values.h>
+
+#include <catboost/libs/algo/index_calcer.h>
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+// more than one block of documents processed by CalcShapValuesMulti
+static constexpr ui32 ObjectCount = 5000;
+static constexpr ui32 FeatureCount = 4;
+
+static TDataProviderPtr CreateRandomPool(ui64 seed) {
+    TFastRng<ui64> prng(seed);
+
+    TVector<TVector<float>> features;
+    ResizeRank2(FeatureCount, ObjectCount, features);
+    for (auto& feature : features) {
+        for (auto& value : feature) {
+            value = prng.GenRandReal1();
+        }
+    }
+    TVector<float> target(ObjectCount);
+    for (auto objectIdx : xrange(ObjectCount)) {
+        target[objectIdx] = features[0][objectIdx] + 2 * features[1][objectIdx] * features[2][objectIdx]
+            + 0.1 * prng.GenRandReal1();
+    }
+
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                FeatureCount,
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<TString>{}
+            );
+
+            visitor->Start(metaInfo, ObjectCount, EObjectsOrder::Undefined, {});
+            for (auto featureIdx : xrange(FeatureCount)) {
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(features[featureIdx]))
+                );
+            }
+            visitor->AddTarget(target);
+            visitor->Finish();
+        }
+    );
+}
+
+
+static TFullModel Train(TDataProviderPtr pool, const TString& trainDir) {
+    TDataProviders dataProviders;
+    dataProviders.Learn = pool;
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 30);
+    params.InsertValue("depth", 4);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("train_dir", trainDir);
+    TrainModel(params, nullptr, {}, {}, std::move(dataProviders), "", &model, {&evalResult});
+    return model;
+}
+
+static double Factorial(size_t n) {
+    double result = 1.0;
+    for (size_t i = 2; i <= n; ++i) {
+        result *= i;
+    }
+    return result;
+}
+
+/* SHAP values of the tree by the definition: over all subsets of the tree features, with the expected value
+ * for a subset taken over the leaves weighted by the fractions of leaf weights at splits by other features
+ * returned: [feature], the last element is the expected value
+ */
+static TVector<double> CalcShapValuesByDefinition(
+    const TObliviousTrees& forest,
+    size_t treeIdx,
+    size_t documentLeafIdx,
+    ui32 featureCount
+) {
+    const int depth = forest.TreeSizes[treeIdx];
+    const size_t leafCount = size_t(1) << depth;
+    const TVector<double>& leafWeights = forest.LeafWeights[treeIdx];
+    const double* leafValues = forest.GetFirstLeafPtrForTree(treeIdx);
+
+    // pool has only float features, so float feature indices are flat ones
+    TVector<int> splitFeatures;
+    for (auto splitIdx : xrange(depth)) {
+        const auto& split = forest.GetBinFeatures()[forest.TreeSplits[forest.TreeStartOffsets[treeIdx] + splitIdx]];
+        splitFeatures.push_back(split.FloatFeature.FloatFeature);
+    }
+    TVector<int> treeFeatures = splitFeatures;
+    SortUnique(treeFeatures);
+
+    const auto calcPrefixWeight = [&] (size_t leafIdx, int prefixDepth) {
+        const size_t prefixMask = (size_t(1) << prefixDepth) - 1;
+        double weight = 0.0;
+        for (auto otherLeafIdx : xrange(leafCount)) {
+            if ((otherLeafIdx & prefixMask) == (leafIdx & prefixMask)) {
+                weight += leafWeights[otherLeafIdx];
+            }
+        }
+        return weight;
+    };
+    // subset is a mask of treeFeatures
+    const auto calcExpectedValue = [&] (size_t subset) {
+        double expectedValue = 0.0;
+        for (auto leafIdx : xrange(leafCount)) {
+            double leafFraction = 1.0;
+            for (auto splitIdx : xrange(depth)) {
+                const size_t featurePosition = LowerBound(treeFeatures.begin(), treeFeatures.end(), splitFeatures[splitIdx])
+                    - treeFeatures.begin();
+                if (subset & (size_t(1) << featurePosition)) {
+                    const size_t bit = size_t(1) << splitIdx;
+                    leafFraction *= ((leafIdx & bit) == (documentLeafIdx & bit)) ? 1.0 : 0.0;
+                } else {
+                    const double parentWeight = calcPrefixWeight(leafIdx, splitIdx);
+                    leafFraction *= parentWeight > 0 ? calcPrefixWeight(leafIdx, splitIdx + 1) / parentWeight : 0.0;
+                }
+            }
+            expectedValue += leafFraction * leafValues[leafIdx];
+        }
+        return expectedValue;
+    };
+
+    TVector<double> shapValues(featureCount + 1, 0.0);
+    const size_t treeFeatureCount = treeFeatures.size();
+    for (auto featurePosition : xrange(treeFeatureCount)) {
+        const size_t featureBit = size_t(1) << featurePosition;
+        for (size_t subset = 0; subset < (size_t(1) << treeFeatureCount); ++subset) {
+            if (subset & featureBit) {
+                continue;
+            }
+            size_t subsetSize = 0;
+            for (auto otherPosition : xrange(treeFeatureCount)) {
+                subsetSize += (subset >> otherPosition) & 1;
+            }
+            const double subsetWeight = Factorial(subsetSize) * Factorial(treeFeatureCount - subsetSize - 1)
+                / Factorial(treeFeatureCount);
+            shapValues[treeFeatures[featurePosition]]
+                += subsetWeight * (calcExpectedValue(subset | featureBit) - calcExpectedValue(subset));
+        }
+    }
+    shapValues[featureCount] = calcExpectedValue(0);
+    return shapValues;
+}
+
+
+Y_UNIT_TEST_SUITE(ShapValues) {
+    // tree by tree calculation over blocks of documents must give the same values as per document one
+    Y_UNIT_TEST(BlockwiseIsSameAsPerDocument) {
+        TTempDir trainDir;
+
+        TDataProviderPtr pool = CreateRandomPool(/*seed*/ 20191019);
+
+        const TFullModel model = Train(pool, trainDir.Name());
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const TObjectsDataProvider& objectsData = *pool->ObjectsData;
+        const TVector<ui8> binarizedFeatures = GetModelCompatibleQuantizedFeatures(model, objectsData);
+
+        for (auto mode : {EPreCalcShapValues::UsePreCalc, EPreCalcShapValues::NoPreCalc}) {
+            const TVector<TVector<TVector<double>>> shapValues = CalcShapValuesMulti(
+                model,
+                *pool,
+                /*logPeriod*/ 0,
+                mode,
+                &localExecutor
+            );
+            UNIT_ASSERT_VALUES_EQUAL(shapValues.size(), ObjectCount);
+
+            const TShapPreparedTrees preparedTrees = PrepareTrees(
+                model,
+                pool.Get(),
+                /*logPeriod*/ 0,
+                mode,
+                &localExecutor
+            );
+
+            for (auto documentIdx : xrange(ObjectCount)) {
+                TVector<TVector<double>> expectedShapValues;
+                CalcShapValuesForDocumentMulti(
+                    model.ObliviousTrees,
+                    preparedTrees,
+                    binarizedFeatures,
+                    (int)FeatureCount,
+                    documentIdx,
+                    ObjectCount,
+                    &expectedShapValues
+                );
+
+                UNIT_ASSERT_VALUES_EQUAL(shapValues[documentIdx].size(), expectedShapValues.size());
+                for (auto dimension : xrange(expectedShapValues.size())) {
+                    const auto& values = shapValues[documentIdx][dimension];
+                    const auto& expectedValues = expectedShapValues[dimension];
+                    UNIT_ASSERT_VALUES_EQUAL(values.size(), expectedValues.size());
+                    for (auto featureIdx : xrange(expectedValues.size())) {
+                        UNIT_ASSERT_DOUBLES_EQUAL(values[featureIdx], expectedValues[featureIdx], 1e-9);
+                    }
+                }
+            }
+        }
+    }
+
+    Y_UNIT_TEST(LeafValuesAreSameAsByDefinition) {
+        TTempDir trainDir;
+
+        TDataProviderPtr pool = CreateRandomPool(/*seed*/ 20191020);
+        const TFullModel model = Train(pool, trainDir.Name());
+        const TObliviousTrees& forest = model.ObliviousTrees;
+        UNIT_ASSERT_VALUES_EQUAL(forest.LeafWeights.size(), forest.GetTreeCount());
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        const TShapPreparedTrees preparedTrees = PrepareTrees(
+            model,
+            pool.Get(),
+            /*logPeriod*/ 0,
+            EPreCalcShapValues::UsePreCalc,
+            &localExecutor
+        );
+
+        for (auto treeIdx : xrange(forest.GetTreeCount())) {
+            for (auto leafIdx : xrange(size_t(1) << forest.TreeSizes[treeIdx])) {
+                const TVector<double> expectedShapValues
+                    = CalcShapValuesByDefinition(forest, treeIdx, leafIdx, FeatureCount);
+
+                TVector<double> shapValues(FeatureCount + 1, 0.0);
+                for (const TShapValue& shapValue : preparedTrees.ShapValuesByLeafForAllTrees[treeIdx][leafIdx]) {
+                    shapValues[shapValue.Feature] += shapValue.Value[0];
+                }
+                shapValues[FeatureCount] = preparedTrees.MeanValuesForAllTrees[treeIdx][0];
+
+                for (auto featureIdx : xrange(FeatureCount + 1)) {
+                    UNIT_ASSERT_DOUBLES_EQUAL(shapValues[featureIdx], expectedShapValues[featureIdx], 1e-9);
+                }
+            }
+        }
+    }
+}
@@ -16,6 +16,7 @@
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ymath.h>
+#include <util/system/compiler.h>
 
 #include <algorithm>
 #include <cmath>
@@ -808,6 +809,108 @@ namespace NCB {
         return !rhs.Find([&](TSize idx, T element) { return !EqualWithNans(element, lhs[idx]); });
     }
 
+    namespace NPrivate {
+
+        // distance (in elements) at which source elements are prefetched when gathering by indices
+        constexpr size_t GatherPrefetchDistance = 16;
+
+        /* Copies src elements for parallel unit range unitSubRange of subsetIndexing to dst:
+         *  contiguous parts (TFullSubset, TRangesSubset blocks) are copied as blocks,
+         *  TIndexedSubset is gathered with software prefetch of upcoming source elements.
+         */
+        template <class T, class TSize>
+        void GatherSubRange(
+            TConstArrayRef<T> src,
+            const TArraySubsetIndexing<TSize>& subsetIndexing,
+            NCB::TIndexRange<TSize> unitSubRange,
+            T* dst
+        ) {
+            using TVariantType = typename TArraySubsetIndexing<TSize>::TBase;
+
+            switch (subsetIndexing.index()) {
+                case TVariantIndexV<TFullSubset<TSize>, TVariantType>:
+                    std::copy(src.begin() + unitSubRange.Begin, src.begin() + unitSubRange.End, dst + unitSubRange.Begin);
+                    break;
+                case TVariantIndexV<TRangesSubset<TSize>, TVariantType>:
+                    {
+                        const auto& blocks = subsetIndexing.template Get<TRangesSubset<TSize>>().Blocks;
+                        for (TSize blockIndex : unitSubRange.Iter()) {
+                            const auto& block = blocks[blockIndex];
+                            std::copy(src.begin() + block.SrcBegin, src.begin() + block.SrcEnd, dst + block.DstBegin);
+                        }
+                    }
+                    break;
+                case TVariantIndexV<TIndexedSubset<TSize>, TVariantType>:
+                    {
+                        const TSize* srcIndices = subsetIndexing.template Get<TIndexedSubset<TSize>>().data();
+                        const T* srcData = src.data();
+
+                        TSize index = unitSubRange.Begin;
+                        const TSize prefetchedEnd = (unitSubRange.GetSize() > GatherPrefetchDistance) ?
+                            (unitSubRange.End - GatherPrefetchDistance)
+                            : unitSubRange.Begin;
+                        for (; index < prefetchedEnd; ++index) {
+                            Y_PREFETCH_READ(srcData + srcIndices[index + GatherPrefetchDistance], 3);
+                            dst[index] = srcData[srcIndices[index]];
+                        }
+                        for (; index < unitSubRange.End; ++index) {
+                            dst[index] = srcData[srcIndices[index]];
+                        }
+                    }
+                    break;
+            }
+        }
+
+        template <class T, class TSize>
+        void Gather(
+            TConstArrayRef<T> src,
+            const TArraySubsetIndexing<TSize>& subsetIndexing,
+            TMaybe<NPar::TLocalExecutor*> localExecutor,
+            TMaybe<TSize> approximateBlockSize,
+            T* dst
+        ) {
+            if (!subsetIndexing.Size()) {
+                return;
+            }
+            if (!localExecutor.Defined()) {
+                GatherSubRange(
+                    src,
+                    subsetIndexing,
+                    NCB::TIndexRange<TSize>(subsetIndexing.GetParallelizableUnitsCount()),
+                    dst
+                );
+                return;
+            }
+
+            if (!approximateBlockSize.Defined()) {
+                TSize localExecutorThreadsPlusCurrentCount = (TSize)(*localExecutor)->GetThreadCount() + 1;
+                approximateBlockSize = CeilDiv(subsetIndexing.Size(), localExecutorThreadsPlusCurrentCount);
+            }
+
+            const NCB::TSimpleIndexRangesGenerator<TSize> parallelUnitRanges =
+                subsetIndexing.GetParallelUnitRanges(*approximateBlockSize);
+
+            CB_ENSURE(
+                    (sizeof(TSize) < sizeof(int))
+                 || (parallelUnitRanges.RangesCount() <= (TSize)std::numeric_limits<int>::max()),
+                "Number of parallel processing data ranges (" << parallelUnitRanges.RangesCount()
+                << ") is greater than the max limit for LocalExecutor (" << std::numeric_limits<int>::max()
+                << ')'
+            );
+
+            (*localExecutor)->ExecRangeWithThrow(
+                [&] (int id) {
+                    GatherSubRange(src, subsetIndexing, parallelUnitRanges.GetRange(id), dst);
+                },
+                0,
+                (int)parallelUnitRanges.RangesCount(),
+                NPar::TLocalExecutor::WAIT_COMPLETE
+            );
+        }
+
+    }
+
+
     template <class TDst, class TSrcArrayLike, class TSize=size_t>
     inline TVector<TDst> GetSubset(
         const TSrcArrayLike& srcArrayLike,
@@ -818,6 +921,18 @@ namespace NCB {
         TVector<TDst> dst;
         dst.yresize(subsetIndexing.Size());
 
+        // contiguous source of the same element type: use blocked copy/gather instead of per element visitor
+        if constexpr (std::is_convertible<const TSrcArrayLike&, TConstArrayRef<TDst>>::value) {
+            NPrivate::Gather<TDst, TSize>(
+                TConstArrayRef<TDst>(srcArrayLike),
+                subsetIndexing,
+                localExecutor,
+                approximateBlockSize,
+                dst.data()
+            );
+            return dst;
+        }
+
         TArraySubset<const TSrcArrayLike, TSize> arraySubset(&srcArrayLike, &subsetIndexing);
         if (localExecutor.Defined()) {
             arraySubset.ParallelForEach(
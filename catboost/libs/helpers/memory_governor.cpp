@@ -0,0 +1,55 @@
+#include "memory_governor.h"
+
+#include <util/stream/format.h>
+
+
+namespace NCB {
+
+    void TMemoryGovernor::Register(const TString& structureName, ui64 sizeInBytes) {
+        Usage[structureName] = sizeInBytes;
+    }
+
+    void TMemoryGovernor::Unregister(const TString& structureName) {
+        Usage.erase(structureName);
+    }
+
+    ui64 TMemoryGovernor::GetUsage(const TString& structureName) const {
+        const auto it = Usage.find(structureName);
+        return (it == Usage.end()) ? 0 : it->second;
+    }
+
+    ui64 TMemoryGovernor::GetTotalUsage() const {
+        ui64 total = 0;
+        for (const auto& [structureName, sizeInBytes] : Usage) {
+            Y_UNUSED(structureName);
+            total += sizeInBytes;
+        }
+        return total;
+    }
+
+    ui64 TMemoryGovernor::GetAvailable() const {
+        const ui64 total = GetTotalUsage();
+        return (total < RamLimit) ? (RamLimit - total) : 0;
+    }
+
+    bool TMemoryGovernor::Fits(ui64 additionalSizeInBytes) const {
+        const ui64 total = GetTotalUsage();
+        return (total <= RamLimit) && (additionalSizeInBytes <= RamLimit - total);
+    }
+
+    bool TMemoryGovernor::FitsWithout(const TString& structureName) const {
+        return (GetTotalUsage() - GetUsage(structureName)) <= RamLimit;
+    }
+
+    void TMemoryGovernor::OutputBreakdown(IOutputStream* out) const {
+        for (const auto& [structureName, sizeInBytes] : Usage) {
+            (*out) << structureName << ": " << HumanReadableSize(sizeInBytes, SF_BYTES) << '\n';
+        }
+        (*out) << "Total: " << HumanReadableSize(GetTotalUsage(), SF_BYTES);
+        if (RamLimit != Max<ui64>()) {
+            (*out) << " (limit " << HumanReadableSize(RamLimit, SF_BYTES) << ')';
+        }
+        (*out) << '\n';
+    }
+
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <util/generic/map.h>
+#include <util/generic/string.h>
+#include <util/generic/utility.h>
+#include <util/generic/vector.h>
+#include <util/stream/output.h>
+#include <util/system/types.h>
+
+#include <type_traits>
+
+
+namespace NCB {
+
+    namespace NPrivate {
+
+        template <class T>
+        struct TIsVector : std::false_type {};
+
+        template <class T, class TAlloc>
+        struct TIsVector<TVector<T, TAlloc>> : std::true_type {};
+
+    }
+
+    // capacity based, nested vectors are accounted recursively
+    template <class T, class TAlloc>
+    ui64 GetVectorMemoryUsage(const TVector<T, TAlloc>& data) {
+        ui64 result = sizeof(T) * data.capacity();
+        if constexpr (NPrivate::TIsVector<T>::value) {
+            for (const auto& element : data) {
+                result += GetVectorMemoryUsage(element);
+            }
+        }
+        return result;
+    }
+
+
+    /* Keeps track of memory used by named training data structures and checks it against the RAM limit.
+     * Not thread-safe: register sizes from the thread that owns the structures.
+     */
+    class TMemoryGovernor {
+    public:
+        explicit TMemoryGovernor(ui64 ramLimit = Max<ui64>())
+            : RamLimit(ramLimit)
+        {}
+
+        void SetRamLimit(ui64 ramLimit) {
+            RamLimit = ramLimit;
+        }
+
+        ui64 GetRamLimit() const {
+            return RamLimit;
+        }
+
+        // replaces previously registered size for structureName
+        void Register(const TString& structureName, ui64 sizeInBytes);
+        void Unregister(const TString& structureName);
+
+        ui64 GetUsage(const TString& structureName) const;
+        ui64 GetTotalUsage() const;
+
+        // 0 if already over limit
+        ui64 GetAvailable() const;
+
+        bool Fits(ui64 additionalSizeInBytes) const;
+        bool IsOverLimit() const {
+            return !Fits(0);
+        }
+
+        // whether usage would fit the limit if structureName is released
+        bool FitsWithout(const TString& structureName) const;
+
+        // one line per registered structure, sorted by name, then total and limit
+        void OutputBreakdown(IOutputStream* out) const;
+
+    private:
+        ui64 RamLimit;
+        TMap<TString, ui64> Usage; // structure name -> size in bytes
+    };
+
+}
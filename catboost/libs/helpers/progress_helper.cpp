@@ -1,2 +1,42 @@
 #include "progress_helper.h"
 
+
+void TAsyncProgressWriter::Finish() {
+    if (!WriterThread) {
+        return;
+    }
+    WriterThread->Join();
+    WriterThread.Reset();
+    if (WriteErrorMessage) {
+        ProgressHelper.LogWriteError(*WriteErrorMessage);
+    } else {
+        ProgressHelper.LogWriteSuccess(WrittenMd5);
+    }
+}
+
+void TAsyncProgressWriter::StartWriting(const TFsPath& path) {
+    AtomicSet(Writing, 1);
+    AtomicSet(PendingBufferSize, Buffer.Capacity());
+    WrittenMd5.clear();
+    WriteErrorMessage.Clear();
+    try {
+        WriterThread = SystemThreadFactory()->Run([this, path] () {
+            try {
+                WrittenMd5 = ProgressHelper.WriteAndGetMd5(path, [this] (IOutputStream* out) {
+                    out->Write(Buffer.Data(), Buffer.Size());
+                });
+            } catch (...) {
+                WriteErrorMessage = CurrentExceptionMessage();
+            }
+            // free memory as soon as possible, snapshots are written rarely
+            TBuffer().Swap(Buffer);
+            AtomicSet(PendingBufferSize, 0);
+            AtomicSet(Writing, 0);
+        });
+    } catch (...) {
+        TBuffer().Swap(Buffer);
+        AtomicSet(PendingBufferSize, 0);
+        AtomicSet(Writing, 0);
+        throw;
+    }
+}
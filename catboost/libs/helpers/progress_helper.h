@@ -4,11 +4,20 @@
 
 #include <catboost/libs/logging/logging.h>
 
+#include <util/stream/buffer.h>
 #include <util/stream/output.h>
 #include <util/stream/file.h>
 #include <util/folder/path.h>
+#include <util/generic/buffer.h>
 #include <util/generic/guid.h>
+#include <util/generic/maybe.h>
+#include <util/generic/noncopyable.h>
+#include <util/generic/ptr.h>
+#include <util/generic/string.h>
+#include <util/datetime/base.h>
+#include <util/system/atomic.h>
 #include <util/system/fs.h>
+#include <util/thread/factory.h>
 #include <util/ysaveload.h>
 
 #include <library/digest/md5/md5.h>
@@ -52,25 +61,51 @@ public:
     template <class TWriter>
     void Write(const TFsPath& path,
                TWriter&& writer) {
+        TString md5;
+        try {
+            md5 = WriteAndGetMd5(path, std::forward<TWriter>(writer));
+        } catch (...) {
+            LogWriteError(CurrentExceptionMessage());
+            return;
+        }
+        LogWriteSuccess(md5);
+    }
+
+    /* does not log anything, so it can be called from a background thread,
+     * throws on failure, the temporary file is removed in this case
+     */
+    template <class TWriter>
+    TString WriteAndGetMd5(const TFsPath& path,
+                           TWriter&& writer) {
         TString tempName = JoinFsPaths(path.Dirname(), CreateGuidAsString()) + ".tmp";
         try {
+            TString md5;
             {
                 TOFStream out(tempName);
                 TMD5Output md5out(&out);
                 ::Save(&md5out, Label);
                 writer(&md5out);
                 char md5buf[33];
-                if (CalcMd5) {
-                    CATBOOST_INFO_LOG << SavedMessage << " (md5sum: " << md5out.Sum(md5buf) << " )" << Endl;
-                }
+                md5 = md5out.Sum(md5buf);
             }
             NFs::Rename(tempName, path);
+            return md5;
         } catch (...) {
-            CATBOOST_WARNING_LOG << ExceptionMessage <<  CurrentExceptionMessage() << Endl;
             NFs::Remove(tempName);
+            throw;
+        }
+    }
+
+    void LogWriteSuccess(const TString& md5) const {
+        if (CalcMd5) {
+            CATBOOST_INFO_LOG << SavedMessage << " (md5sum: " << md5 << " )" << Endl;
         }
     }
 
+    void LogWriteError(const TString& errorMessage) const {
+        CATBOOST_WARNING_LOG << ExceptionMessage << errorMessage << Endl;
+    }
+
     template <class TReader>
     void CheckedLoad(const TFsPath& path,
                      TReader&& reader) {
@@ -87,3 +122,71 @@ private:
     TString SavedMessage;
     bool CalcMd5;
 };
+
+/* Writes progress to file in a background thread, so that training is not blocked by disk I/O and md5
+ * calculation.
+ * Serialization itself still runs in the caller thread into a memory buffer: this is what makes the saved
+ * file a consistent copy of the state at the time of the TryWrite call without copying the state objects,
+ * the time it takes is logged at debug level. The buffer (the size of serialized progress) is the additional
+ * memory needed and it is released as soon as the file is written.
+ * Results are logged from the caller thread by the next TryWrite or Finish call.
+ */
+class TAsyncProgressWriter : public TNonCopyable {
+public:
+    explicit TAsyncProgressWriter(const TString& label)
+        : ProgressHelper(label) {
+    }
+
+    ~TAsyncProgressWriter() {
+        Finish();
+    }
+
+    // returns false (and writes nothing) if the previous write has not been finished yet
+    template <class TWriter>
+    bool TryWrite(const TFsPath& path,
+                  TWriter&& writer) {
+        if (IsWriting()) {
+            return false;
+        }
+        Finish();
+        const TInstant serializationStart = TInstant::Now();
+        // progress size changes little between snapshots, so the buffer is not regrown by copying
+        Buffer.Reserve(LastSerializedSize);
+        {
+            TBufferOutput out(Buffer);
+            writer(&out);
+        }
+        LastSerializedSize = Buffer.Size();
+        CATBOOST_DEBUG_LOG << "Progress of " << Buffer.Size() << " bytes is serialized in "
+            << (TInstant::Now() - serializationStart).SecondsFloat() << " sec, writing it in background" << Endl;
+        StartWriting(path);
+        return true;
+    }
+
+    bool IsWriting() const {
+        return AtomicGet(Writing);
+    }
+
+    // waits until the background write is finished and logs its result
+    void Finish();
+
+    // memory used by serialized progress that is being written, 0 if nothing is being written
+    size_t GetPendingBufferSize() const {
+        return (size_t)AtomicGet(PendingBufferSize);
+    }
+
+private:
+    void StartWriting(const TFsPath& path);
+
+private:
+    TProgressHelper ProgressHelper;
+    TBuffer Buffer;
+    THolder<IThreadFactory::IThread> WriterThread;
+    TAtomic Writing = 0;
+    TAtomic PendingBufferSize = 0;
+    size_t LastSerializedSize = 0;
+
+    // set by the writer thread, read after it is joined
+    TString WrittenMd5;
+    TMaybe<TString> WriteErrorMessage;
+};
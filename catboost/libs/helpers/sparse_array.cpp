@@ -0,0 +1 @@
+#include "sparse_array.h"
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "exception.h"
+
+#include <library/binsaver/bin_saver.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/system/types.h>
+#include <util/system/yassert.h>
+
+#include <utility>
+
+
+namespace NCB {
+
+    /*
+     * Array of Size elements where only elements not equal to DefaultValue are stored.
+     * Indices are sorted in increasing order and unique.
+     */
+    template <class TValue, class TSize = ui32>
+    class TSparseArray {
+    public:
+        TSparseArray() = default;
+
+        TSparseArray(
+            TSize size,
+            TValue defaultValue,
+            TVector<TSize>&& indices,
+            TVector<TValue>&& values
+        )
+            : Size(size)
+            , DefaultValue(std::move(defaultValue))
+            , Indices(std::move(indices))
+            , Values(std::move(values))
+        {
+            CB_ENSURE_INTERNAL(Indices.size() == Values.size(), "TSparseArray: indices and values sizes differ");
+            for (auto i : xrange(Indices.size())) {
+                CB_ENSURE_INTERNAL(Indices[i] < Size, "TSparseArray: index " << Indices[i] << " is out of range");
+                CB_ENSURE_INTERNAL(
+                    (i == 0) || (Indices[i - 1] < Indices[i]),
+                    "TSparseArray: indices are not sorted or not unique"
+                );
+            }
+        }
+
+        // creates from unordered (index, value) pairs, pairs with default values are skipped
+        static TSparseArray CreateFromUnordered(
+            TSize size,
+            TValue defaultValue,
+            TVector<std::pair<TSize, TValue>>&& indexedValues
+        ) {
+            Sort(
+                indexedValues,
+                [] (const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; }
+            );
+            TVector<TSize> indices;
+            TVector<TValue> values;
+            for (const auto& [idx, value] : indexedValues) {
+                if (value == defaultValue) {
+                    continue;
+                }
+                indices.push_back(idx);
+                values.push_back(value);
+            }
+            return TSparseArray(size, std::move(defaultValue), std::move(indices), std::move(values));
+        }
+
+        static TSparseArray CreateFromDense(TConstArrayRef<TValue> dense, TValue defaultValue) {
+            TVector<TSize> indices;
+            TVector<TValue> values;
+            for (auto i : xrange(dense.size())) {
+                if (dense[i] != defaultValue) {
+                    indices.push_back(TSize(i));
+                    values.push_back(dense[i]);
+                }
+            }
+            return TSparseArray(TSize(dense.size()), std::move(defaultValue), std::move(indices), std::move(values));
+        }
+
+        SAVELOAD(Size, DefaultValue, Indices, Values)
+
+        bool operator==(const TSparseArray& rhs) const {
+            return (Size == rhs.Size) && (DefaultValue == rhs.DefaultValue) && (Indices == rhs.Indices)
+                && (Values == rhs.Values);
+        }
+
+        TSize GetSize() const {
+            return Size;
+        }
+
+        TSize GetNonDefaultSize() const {
+            return TSize(Indices.size());
+        }
+
+        const TValue& GetDefaultValue() const {
+            return DefaultValue;
+        }
+
+        TConstArrayRef<TSize> GetIndices() const {
+            return Indices;
+        }
+
+        TConstArrayRef<TValue> GetValues() const {
+            return Values;
+        }
+
+        // f is called with (index, value) for non-default elements only
+        template <class F>
+        void ForEachNonDefault(F&& f) const {
+            for (auto i : xrange(Indices.size())) {
+                f(Indices[i], Values[i]);
+            }
+        }
+
+        // f is called with (index, value) for all elements in index order
+        template <class F>
+        void ForEach(F&& f) const {
+            TSize idx = 0;
+            for (auto i : xrange(Indices.size())) {
+                for (; idx < Indices[i]; ++idx) {
+                    f(idx, DefaultValue);
+                }
+                f(idx, Values[i]);
+                ++idx;
+            }
+            for (; idx < Size; ++idx) {
+                f(idx, DefaultValue);
+            }
+        }
+
+        void ExtractValuesTo(TArrayRef<TValue> dst) const {
+            Y_ASSERT(dst.size() == Size);
+            Fill(dst.begin(), dst.end(), DefaultValue);
+            for (auto i : xrange(Indices.size())) {
+                dst[Indices[i]] = Values[i];
+            }
+        }
+
+        TVector<TValue> ExtractValues() const {
+            TVector<TValue> result;
+            result.yresize(Size);
+            ExtractValuesTo(result);
+            return result;
+        }
+
+        template <class TDstValue, class F>
+        TSparseArray<TDstValue, TSize> MapValues(TDstValue dstDefaultValue, F&& f) const {
+            TVector<TSize> indices;
+            TVector<TDstValue> values;
+            for (auto i : xrange(Indices.size())) {
+                TDstValue dstValue = f(Values[i]);
+                if (dstValue != dstDefaultValue) {
+                    indices.push_back(Indices[i]);
+                    values.push_back(dstValue);
+                }
+            }
+            return TSparseArray<TDstValue, TSize>(
+                Size,
+                std::move(dstDefaultValue),
+                std::move(indices),
+                std::move(values)
+            );
+        }
+
+    private:
+        TSize Size = 0;
+        TValue DefaultValue = TValue();
+        TVector<TSize> Indices;
+        TVector<TValue> Values;
+    };
+
+}
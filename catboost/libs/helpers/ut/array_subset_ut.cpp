@@ -473,6 +473,51 @@ Y_UNIT_TEST_SUITE(TArraySubset) {
         }
     }
 
+    Y_UNIT_TEST(TestGetSubsetOfComposedSubsets) {
+        TVector<int> v(100);
+        for (auto i : xrange(v.size())) {
+            v[i] = int(i) * 10;
+        }
+
+        // fold, then permutation of the fold, then subset of the permutation
+        NCB::TArraySubsetIndexing<size_t> foldIndexing(
+            NCB::TRangesSubset<size_t>(NCB::TSavedIndexRanges<size_t>(TVector<NCB::TIndexRange<size_t>>{{60, 100}, {0, 20}}))
+        );
+        TVector<size_t> permutation(foldIndexing.Size());
+        for (auto i : xrange(permutation.size())) {
+            permutation[i] = (i * 7) % permutation.size();
+        }
+        NCB::TArraySubsetIndexing<size_t> permutationIndexing{NCB::TIndexedSubset<size_t>(permutation)};
+        NCB::TArraySubsetIndexing<size_t> headIndexing( NCB::TFullSubset<size_t>(permutation.size()) );
+
+        const auto composedIndexing = NCB::Compose(NCB::Compose(foldIndexing, permutationIndexing), headIndexing);
+        NCB::TArraySubset<const TVector<int>> permutedSubset(&v, &composedIndexing);
+        UNIT_ASSERT_VALUES_EQUAL(permutedSubset.Size(), permutation.size());
+
+        TVector<int> expected;
+        for (auto srcIdx : permutation) {
+            expected.push_back(srcIdx < 40 ? v[60 + srcIdx] : v[srcIdx - 40]);
+        }
+
+        permutedSubset.ForEach(
+            [&] (size_t idx, int value) {
+                UNIT_ASSERT_VALUES_EQUAL(value, expected[idx]);
+            }
+        );
+
+        // materialization through the blocked gather
+        UNIT_ASSERT_VALUES_EQUAL(NCB::GetSubset<int>(v, composedIndexing), expected);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+        for (size_t blockSize : {size_t(1), size_t(7), size_t(17), size_t(1000)}) {
+            UNIT_ASSERT_VALUES_EQUAL(
+                NCB::GetSubset<int>(v, composedIndexing, TMaybe<NPar::TLocalExecutor*>(&localExecutor), TMaybe<size_t>(blockSize)),
+                expected
+            );
+        }
+    }
+
     Y_UNIT_TEST(TestBadCompose) {
         TVector<NCB::TArraySubsetIndexing<size_t>> srcs;
         {
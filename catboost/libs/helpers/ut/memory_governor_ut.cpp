@@ -0,0 +1,60 @@
+#include <catboost/libs/helpers/memory_governor.h>
+
+#include <util/generic/vector.h>
+#include <util/stream/str.h>
+
+#include <library/unittest/registar.h>
+
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(MemoryGovernor) {
+    Y_UNIT_TEST(GetVectorMemoryUsage) {
+        TVector<TVector<double>> data(2);
+        data[0].reserve(10);
+        data[1].reserve(3);
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetVectorMemoryUsage(data),
+            sizeof(TVector<double>) * data.capacity() + sizeof(double) * (data[0].capacity() + data[1].capacity())
+        );
+    }
+
+    Y_UNIT_TEST(Limit) {
+        TMemoryGovernor governor(1000);
+
+        governor.Register("Folds", 600);
+        governor.Register("Approxes", 300);
+        UNIT_ASSERT_VALUES_EQUAL(governor.GetTotalUsage(), 900);
+        UNIT_ASSERT_VALUES_EQUAL(governor.GetAvailable(), 100);
+        UNIT_ASSERT(governor.Fits(100));
+        UNIT_ASSERT(!governor.Fits(101));
+
+        // re-registration replaces the size
+        governor.Register("Folds", 800);
+        UNIT_ASSERT_VALUES_EQUAL(governor.GetUsage("Folds"), 800);
+        UNIT_ASSERT(governor.IsOverLimit());
+        UNIT_ASSERT_VALUES_EQUAL(governor.GetAvailable(), 0);
+
+        UNIT_ASSERT(governor.FitsWithout("Approxes"));
+        UNIT_ASSERT(governor.FitsWithout("Folds"));
+        UNIT_ASSERT(!governor.FitsWithout("Unknown"));
+
+        governor.Unregister("Approxes");
+        UNIT_ASSERT(!governor.IsOverLimit());
+        UNIT_ASSERT_VALUES_EQUAL(governor.GetUsage("Approxes"), 0);
+    }
+
+    Y_UNIT_TEST(OutputBreakdown) {
+        TMemoryGovernor governor;
+        governor.Register("B", 10);
+        governor.Register("A", 20);
+
+        TStringStream out;
+        governor.OutputBreakdown(&out);
+        const TString breakdown = out.Str();
+        UNIT_ASSERT(breakdown.find("A: ") < breakdown.find("B: "));
+        UNIT_ASSERT(breakdown.find("Total: ") != TString::npos);
+        UNIT_ASSERT(breakdown.find("limit") == TString::npos);
+    }
+}
@@ -0,0 +1,78 @@
+#include <catboost/libs/helpers/progress_helper.h>
+#include <catboost/libs/logging/logging.h>
+
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/fs.h>
+#include <util/system/thread.h>
+#include <util/ysaveload.h>
+
+#include <library/unittest/registar.h>
+
+
+static TVector<TThread::TId> LoggingThreadIds;
+
+static void SaveLoggingThreadId(const char* /*data*/, size_t /*length*/) {
+    LoggingThreadIds.push_back(TThread::CurrentThreadId());
+}
+
+
+Y_UNIT_TEST_SUITE(ProgressHelper) {
+    Y_UNIT_TEST(AsyncWriteAndLoad) {
+        const TString path = "async_progress.snapshot";
+        const TVector<double> progress = {0.1, 0.2, 0.3};
+
+        {
+            TAsyncProgressWriter writer("Test");
+            UNIT_ASSERT(writer.TryWrite(path, [&](IOutputStream* out) {
+                ::Save(out, progress);
+            }));
+            writer.Finish();
+            UNIT_ASSERT(!writer.IsWriting());
+            UNIT_ASSERT_VALUES_EQUAL(writer.GetPendingBufferSize(), 0);
+        }
+
+        TVector<double> loadedProgress;
+        TProgressHelper("Test").CheckedLoad(path, [&](TIFStream* in) {
+            ::Load(in, loadedProgress);
+        });
+        UNIT_ASSERT_VALUES_EQUAL(loadedProgress, progress);
+
+        UNIT_ASSERT_EXCEPTION(
+            TProgressHelper("Other").CheckedLoad(path, [&](TIFStream*) {}),
+            TCatBoostException
+        );
+        NFs::Remove(path);
+    }
+
+    Y_UNIT_TEST(AsyncWriteLogsFromCallerThread) {
+        const TVector<double> progress = {0.1, 0.2, 0.3};
+
+        LoggingThreadIds.clear();
+        SetCustomLoggingFunction(SaveLoggingThreadId, SaveLoggingThreadId);
+        {
+            TSetLoggingVerbose verboseLogging;
+            TAsyncProgressWriter writer("Test");
+
+            // successful write
+            UNIT_ASSERT(writer.TryWrite("async_progress.snapshot", [&](IOutputStream* out) {
+                ::Save(out, progress);
+            }));
+            writer.Finish();
+
+            // failed write, the directory does not exist
+            UNIT_ASSERT(writer.TryWrite("nonexistent_dir/async_progress.snapshot", [&](IOutputStream* out) {
+                ::Save(out, progress);
+            }));
+            writer.Finish();
+            UNIT_ASSERT(!NFs::Exists("nonexistent_dir/async_progress.snapshot"));
+        }
+        RestoreOriginalLogger();
+        NFs::Remove("async_progress.snapshot");
+
+        UNIT_ASSERT(LoggingThreadIds.size() >= 2);
+        for (auto threadId : LoggingThreadIds) {
+            UNIT_ASSERT_VALUES_EQUAL(threadId, TThread::CurrentThreadId());
+        }
+    }
+}
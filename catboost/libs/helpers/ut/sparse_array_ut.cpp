@@ -0,0 +1,60 @@
+#include <catboost/libs/helpers/sparse_array.h>
+
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+#include <utility>
+
+#include <library/unittest/registar.h>
+
+
+Y_UNIT_TEST_SUITE(TSparseArray) {
+    Y_UNIT_TEST(TestCreateFromUnordered) {
+        TVector<std::pair<ui32, float>> indexedValues = {{7, 2.0f}, {1, 1.0f}, {4, 0.0f}, {3, -1.0f}};
+        auto sparseArray = NCB::TSparseArray<float>::CreateFromUnordered(10, 0.0f, std::move(indexedValues));
+
+        UNIT_ASSERT_VALUES_EQUAL(sparseArray.GetSize(), 10);
+        UNIT_ASSERT_VALUES_EQUAL(sparseArray.GetNonDefaultSize(), 3);
+        UNIT_ASSERT_EQUAL(sparseArray.GetIndices(), (TConstArrayRef<ui32>{1, 3, 7}));
+        UNIT_ASSERT_EQUAL(sparseArray.GetValues(), (TConstArrayRef<float>{1.0f, -1.0f, 2.0f}));
+
+        TVector<float> expectedValues = {0.0f, 1.0f, 0.0f, -1.0f, 0.0f, 0.0f, 0.0f, 2.0f, 0.0f, 0.0f};
+        UNIT_ASSERT_EQUAL(sparseArray.ExtractValues(), expectedValues);
+
+        TVector<float> iteratedValues;
+        sparseArray.ForEach(
+            [&] (ui32 idx, float value) {
+                UNIT_ASSERT_VALUES_EQUAL(idx, iteratedValues.size());
+                iteratedValues.push_back(value);
+            }
+        );
+        UNIT_ASSERT_EQUAL(iteratedValues, expectedValues);
+
+        UNIT_ASSERT_EQUAL(NCB::TSparseArray<float>::CreateFromDense(expectedValues, 0.0f), sparseArray);
+    }
+
+    Y_UNIT_TEST(TestMapValues) {
+        auto sparseArray = NCB::TSparseArray<float>::CreateFromDense(
+            TVector<float>{0.0f, 0.5f, 0.0f, 2.0f, 3.0f},
+            0.0f
+        );
+        auto binsArray = sparseArray.MapValues<ui8>(
+            ui8(1),
+            [] (float value) { return value < 1.0f ? ui8(1) : ui8(2); }
+        );
+        UNIT_ASSERT_VALUES_EQUAL(binsArray.GetDefaultValue(), 1);
+        UNIT_ASSERT_EQUAL(binsArray.GetIndices(), (TConstArrayRef<ui32>{3, 4}));
+        UNIT_ASSERT_EQUAL(binsArray.ExtractValues(), (TVector<ui8>{1, 1, 1, 2, 2}));
+    }
+
+    Y_UNIT_TEST(TestBadIndices) {
+        UNIT_ASSERT_EXCEPTION(
+            NCB::TSparseArray<float>(3, 0.0f, TVector<ui32>{2, 1}, TVector<float>{1.0f, 2.0f}),
+            TCatBoostException
+        );
+        UNIT_ASSERT_EXCEPTION(
+            NCB::TSparseArray<float>(3, 0.0f, TVector<ui32>{3}, TVector<float>{1.0f}),
+            TCatBoostException
+        );
+    }
+}
@@ -0,0 +1,284 @@
+#include "incremental_metric.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
+#include <util/generic/utility.h>
+#include <util/generic/xrange.h>
+#include <util/system/yassert.h>
+
+#include <algorithm>
+
+
+static TVector<bool> CalcChangedLeaves(const TVector<TVector<double>>& leafDelta) {
+    TVector<bool> isLeafChanged(leafDelta.empty() ? 0 : leafDelta[0].size(), false);
+    for (const auto& leafDeltaDim : leafDelta) {
+        for (auto leafIdx : xrange(leafDeltaDim.size())) {
+            isLeafChanged[leafIdx] = isLeafChanged[leafIdx] || (leafDeltaDim[leafIdx] != 0.0);
+        }
+    }
+    return isLeafChanged;
+}
+
+/* TIncrementalAdditiveMetricCalcer */
+
+TIncrementalAdditiveMetricCalcer::TIncrementalAdditiveMetricCalcer(
+    const IMetric& metric,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int blockSize
+)
+    : Metric(metric)
+    , Target(target)
+    , Weight(weight)
+    , QueriesInfo(queriesInfo)
+    , IsPerObject(metric.GetErrorType() == EErrorType::PerObjectError)
+    , BlockSize(blockSize)
+{
+    CB_ENSURE_INTERNAL(metric.IsAdditiveMetric(), "Metric " << metric.GetDescription() << " is not additive");
+    CB_ENSURE_INTERNAL(blockSize > 0, "Block size should be positive");
+    if (IsPerObject) {
+        ElementCount = SafeIntegerCast<int>(target.size());
+    } else {
+        ElementCount = SafeIntegerCast<int>(queriesInfo.size());
+    }
+}
+
+std::pair<int, int> TIncrementalAdditiveMetricCalcer::GetBlockBounds(int blockIdx) const {
+    const int begin = blockIdx * BlockSize;
+    return {begin, Min(begin + BlockSize, ElementCount)};
+}
+
+std::pair<int, int> TIncrementalAdditiveMetricCalcer::GetBlockObjectBounds(int blockIdx) const {
+    const auto bounds = GetBlockBounds(blockIdx);
+    if (IsPerObject) {
+        return bounds;
+    }
+    return {QueriesInfo[bounds.first].Begin, QueriesInfo[bounds.second - 1].End};
+}
+
+void TIncrementalAdditiveMetricCalcer::AddLeafDelta(
+    TConstArrayRef<TIndexType> leafIndices,
+    const TVector<TVector<double>>& leafDelta,
+    NPar::TLocalExecutor* localExecutor
+) {
+    if (BlockStats.empty()) {
+        return;
+    }
+    const TVector<bool> isLeafChanged = CalcChangedLeaves(leafDelta);
+    NPar::ParallelFor(*localExecutor, 0, IsBlockDirty.size(), [&] (int blockIdx) {
+        if (IsBlockDirty[blockIdx]) {
+            return;
+        }
+        const auto objectBounds = GetBlockObjectBounds(blockIdx);
+        for (auto objectIdx : xrange(objectBounds.first, objectBounds.second)) {
+            if (isLeafChanged[leafIndices[objectIdx]]) {
+                IsBlockDirty[blockIdx] = 1;
+                return;
+            }
+        }
+    });
+}
+
+void TIncrementalAdditiveMetricCalcer::Reset() {
+    BlockStats.clear();
+    IsBlockDirty.clear();
+}
+
+TMetricHolder TIncrementalAdditiveMetricCalcer::Eval(
+    const TVector<TVector<double>>& approx,
+    NPar::TLocalExecutor* localExecutor
+) {
+    if (BlockStats.empty()) {
+        const int blockCount = (ElementCount + BlockSize - 1) / BlockSize;
+        BlockStats.resize(blockCount);
+        IsBlockDirty.assign(blockCount, 1);
+    }
+
+    TVector<int> dirtyBlocks;
+    for (auto blockIdx : xrange(IsBlockDirty.size())) {
+        if (IsBlockDirty[blockIdx]) {
+            dirtyBlocks.push_back(blockIdx);
+        }
+    }
+    localExecutor->ExecRangeWithThrow(
+        [&] (int dirtyBlockIdx) {
+            const int blockIdx = dirtyBlocks[dirtyBlockIdx];
+            const auto bounds = GetBlockBounds(blockIdx);
+            BlockStats[blockIdx] = Metric.Eval(
+                approx,
+                Target,
+                Weight,
+                QueriesInfo,
+                bounds.first,
+                bounds.second,
+                *localExecutor);
+            IsBlockDirty[blockIdx] = 0;
+        },
+        0,
+        dirtyBlocks.ysize(),
+        NPar::TLocalExecutor::WAIT_COMPLETE);
+
+    TMetricHolder result;
+    for (const auto& blockStats : BlockStats) {
+        result.Add(blockStats);
+    }
+    return result;
+}
+
+/* TIncrementalAucCalcer */
+
+TIncrementalAucCalcer::TIncrementalAucCalcer(
+    int approxDimensionIdx,
+    TVector<bool>&& isPositive,
+    TConstArrayRef<float> weight
+)
+    : ApproxDimensionIdx(approxDimensionIdx)
+    , IsPositive(std::move(isPositive))
+    , Weight(weight)
+{
+    CB_ENSURE_INTERNAL(Weight.empty() || Weight.size() == IsPositive.size(), "Weight and target sizes differ");
+}
+
+void TIncrementalAucCalcer::AddLeafDelta(
+    TConstArrayRef<TIndexType> leafIndices,
+    const TVector<TVector<double>>& leafDelta,
+    NPar::TLocalExecutor* /*localExecutor*/
+) {
+    if (Order.empty()) {
+        return;
+    }
+    const auto& leafDeltaDim = leafDelta[ApproxDimensionIdx];
+    if (AllOf(leafDeltaDim, [] (double delta) { return delta == 0.0; })) {
+        return;
+    }
+    ++PendingTreeCount;
+    if (PendingTreeCount == 1) {
+        Y_ASSERT(leafIndices.size() >= IsPositive.size());
+        PendingLeafIndices.assign(leafIndices.begin(), leafIndices.begin() + IsPositive.size());
+        PendingLeafCount = leafDeltaDim.size();
+    } else {
+        PendingLeafIndices.clear();
+    }
+}
+
+void TIncrementalAucCalcer::Reset() {
+    Order.clear();
+    PendingLeafIndices.clear();
+    PendingTreeCount = 0;
+}
+
+void TIncrementalAucCalcer::MergeLeafRuns(TConstArrayRef<double> approx, NPar::TLocalExecutor* localExecutor) {
+    // stable counting sort by leaf: every leaf becomes a run sorted by the new approx
+    TVector<ui32> runBegins(PendingLeafCount + 1, 0);
+    for (auto objectIdx : Order) {
+        ++runBegins[PendingLeafIndices[objectIdx] + 1];
+    }
+    for (auto leafIdx : xrange(PendingLeafCount)) {
+        runBegins[leafIdx + 1] += runBegins[leafIdx];
+    }
+    OrderBuffer.yresize(Order.size());
+    {
+        TVector<ui32> writePositions(runBegins.begin(), runBegins.end() - 1);
+        for (auto objectIdx : Order) {
+            OrderBuffer[writePositions[PendingLeafIndices[objectIdx]]++] = objectIdx;
+        }
+    }
+
+    const auto approxLess = [approx] (ui32 lhs, ui32 rhs) {
+        return approx[lhs] < approx[rhs];
+    };
+
+    // bottom-up merge of runs, pairs of runs are merged in parallel
+    TVector<ui32>* src = &OrderBuffer;
+    TVector<ui32>* dst = &Order;
+    while (runBegins.size() > 2) {
+        const int runCount = runBegins.ysize() - 1;
+        localExecutor->ExecRange(
+            [&] (int pairIdx) {
+                const ui32 begin = runBegins[2 * pairIdx];
+                const ui32 middle = runBegins[Min(2 * pairIdx + 1, runCount)];
+                const ui32 end = runBegins[Min(2 * pairIdx + 2, runCount)];
+                std::merge(
+                    src->begin() + begin,
+                    src->begin() + middle,
+                    src->begin() + middle,
+                    src->begin() + end,
+                    dst->begin() + begin,
+                    approxLess);
+            },
+            0,
+            (runCount + 1) / 2,
+            NPar::TLocalExecutor::WAIT_COMPLETE);
+
+        TVector<ui32> mergedRunBegins;
+        for (int runIdx = 0; runIdx < runCount; runIdx += 2) {
+            mergedRunBegins.push_back(runBegins[runIdx]);
+        }
+        mergedRunBegins.push_back(runBegins.back());
+        runBegins.swap(mergedRunBegins);
+        DoSwap(src, dst);
+    }
+    if (src != &Order) {
+        Order.swap(OrderBuffer);
+    }
+}
+
+TMetricHolder TIncrementalAucCalcer::Eval(
+    const TVector<TVector<double>>& approx,
+    NPar::TLocalExecutor* localExecutor
+) {
+    TConstArrayRef<double> approxDim = approx[ApproxDimensionIdx];
+    Y_ASSERT(approxDim.size() == IsPositive.size());
+
+    if (Order.empty() || PendingTreeCount > 1) {
+        Order.yresize(IsPositive.size());
+        Iota(Order.begin(), Order.end(), 0);
+        Sort(Order.begin(), Order.end(), [approxDim] (ui32 lhs, ui32 rhs) {
+            return approxDim[lhs] < approxDim[rhs];
+        });
+    } else if (PendingTreeCount == 1) {
+        MergeLeafRuns(approxDim, localExecutor);
+    }
+    PendingLeafIndices.clear();
+    PendingTreeCount = 0;
+
+    TMetricHolder error(2);
+    error.Stats[0] = CalcAucOnSortedObjects(Order, approxDim, IsPositive, Weight);
+    error.Stats[1] = 1.0;
+    return error;
+}
+
+double CalcAucOnSortedObjects(
+    TConstArrayRef<ui32> order,
+    TConstArrayRef<double> approx,
+    const TVector<bool>& isPositive,
+    TConstArrayRef<float> weight
+) {
+    double positiveWeightSum = 0;
+    double negativeWeightSum = 0;
+    double correctPairWeightSum = 0;
+    for (size_t groupBegin = 0; groupBegin < order.size();) {
+        // objects with equal approx are counted as half-correct pairs
+        double groupPositiveWeight = 0;
+        double groupNegativeWeight = 0;
+        size_t groupEnd = groupBegin;
+        for (; groupEnd < order.size() && approx[order[groupEnd]] == approx[order[groupBegin]]; ++groupEnd) {
+            const ui32 objectIdx = order[groupEnd];
+            const double objectWeight = weight.empty() ? 1.0 : weight[objectIdx];
+            if (isPositive[objectIdx]) {
+                groupPositiveWeight += objectWeight;
+            } else {
+                groupNegativeWeight += objectWeight;
+            }
+        }
+        correctPairWeightSum += groupPositiveWeight * (negativeWeightSum + 0.5 * groupNegativeWeight);
+        positiveWeightSum += groupPositiveWeight;
+        negativeWeightSum += groupNegativeWeight;
+        groupBegin = groupEnd;
+    }
+    const double pairWeightSum = positiveWeightSum * negativeWeightSum;
+    return pairWeightSum == 0 ? 0 : correctPairWeightSum / pairWeightSum;
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "metric.h"
+#include "metric_holder.h"
+
+#include <catboost/libs/data_types/query.h>
+#include <catboost/libs/options/restrictions.h>
+
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/ptr.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+/*
+ * Metric calcers that keep state between evaluations on the same dataset.
+ *
+ * Approxes of the dataset are expected to change only by adding trees, i.e.
+ *     approx[dim][objectIdx] += leafDelta[dim][leafIndices[objectIdx]]
+ * and every such change must be registered with AddLeafDelta before the next call to Eval.
+ * If changes were not registered (or state is lost for any other reason) call Reset,
+ * the next Eval then computes the metric from scratch.
+ */
+class IIncrementalMetricCalcer {
+public:
+    virtual ~IIncrementalMetricCalcer() = default;
+
+    virtual void AddLeafDelta(
+        TConstArrayRef<TIndexType> leafIndices, // [objectIdx]
+        const TVector<TVector<double>>& leafDelta, // [dim][leafIdx]
+        NPar::TLocalExecutor* localExecutor
+    ) = 0;
+
+    virtual void Reset() = 0;
+
+    virtual TMetricHolder Eval(
+        const TVector<TVector<double>>& approx,
+        NPar::TLocalExecutor* localExecutor
+    ) = 0;
+};
+
+
+/*
+ * Additive metrics: keeps metric statistics per block of objects (or queries for querywise
+ * and pairwise metrics) and recalculates only blocks that contain objects with changed approx.
+ */
+class TIncrementalAdditiveMetricCalcer final : public IIncrementalMetricCalcer {
+public:
+    TIncrementalAdditiveMetricCalcer(
+        const IMetric& metric,
+        TConstArrayRef<float> target,
+        TConstArrayRef<float> weight,
+        TConstArrayRef<TQueryInfo> queriesInfo,
+        int blockSize = 10000
+    );
+
+    void AddLeafDelta(
+        TConstArrayRef<TIndexType> leafIndices,
+        const TVector<TVector<double>>& leafDelta,
+        NPar::TLocalExecutor* localExecutor
+    ) override;
+
+    void Reset() override;
+
+    TMetricHolder Eval(
+        const TVector<TVector<double>>& approx,
+        NPar::TLocalExecutor* localExecutor
+    ) override;
+
+private:
+    // [begin, end) of objects for per-object metrics, of queries otherwise
+    std::pair<int, int> GetBlockBounds(int blockIdx) const;
+    std::pair<int, int> GetBlockObjectBounds(int blockIdx) const;
+
+private:
+    const IMetric& Metric;
+    TConstArrayRef<float> Target;
+    TConstArrayRef<float> Weight;
+    TConstArrayRef<TQueryInfo> QueriesInfo;
+    bool IsPerObject;
+    int BlockSize;
+    int ElementCount;
+
+    TVector<TMetricHolder> BlockStats;
+    TVector<ui8> IsBlockDirty; // not TVector<bool>: updated concurrently
+};
+
+
+/*
+ * AUC: keeps objects ordered by approx. Adding an oblivious tree shifts all objects of a leaf
+ * by the same value, so order inside a leaf is preserved and the new order is obtained
+ * by merging per-leaf runs instead of sorting: O(n log(leafCount)) instead of O(n log(n)).
+ * Only one tree between evaluations is merged incrementally, otherwise objects are resorted.
+ */
+class TIncrementalAucCalcer final : public IIncrementalMetricCalcer {
+public:
+    TIncrementalAucCalcer(
+        int approxDimensionIdx,
+        TVector<bool>&& isPositive,
+        TConstArrayRef<float> weight // can be empty
+    );
+
+    void AddLeafDelta(
+        TConstArrayRef<TIndexType> leafIndices,
+        const TVector<TVector<double>>& leafDelta,
+        NPar::TLocalExecutor* localExecutor
+    ) override;
+
+    void Reset() override;
+
+    TMetricHolder Eval(
+        const TVector<TVector<double>>& approx,
+        NPar::TLocalExecutor* localExecutor
+    ) override;
+
+private:
+    void MergeLeafRuns(TConstArrayRef<double> approx, NPar::TLocalExecutor* localExecutor);
+
+private:
+    int ApproxDimensionIdx;
+    TVector<bool> IsPositive;
+    TConstArrayRef<float> Weight;
+
+    TVector<ui32> Order; // objects sorted by approx, empty if not calculated yet
+    TVector<ui32> OrderBuffer;
+    TVector<TIndexType> PendingLeafIndices;
+    ui32 PendingLeafCount = 0;
+    int PendingTreeCount = 0;
+};
+
+
+double CalcAucOnSortedObjects(
+    TConstArrayRef<ui32> order,
+    TConstArrayRef<double> approx,
+    const TVector<bool>& isPositive,
+    TConstArrayRef<float> weight
+);
+
+
+// returns nullptr if metric has no incremental implementation
+THolder<IIncrementalMetricCalcer> MakeIncrementalMetricCalcer(
+    const IMetric& metric,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo
+);
@@ -6,6 +6,7 @@
 #include "dcg.h"
 #include "doc_comparator.h"
 #include "hinge_loss.h"
+#include "incremental_metric.h"
 #include "kappa.h"
 #include "llp.h"
 #include "pfound.h"
@@ -122,6 +123,49 @@ bool TMetric::NeedTarget() const {
     return GetErrorType() != EErrorType::PairwiseError;
 }
 
+TVector<int> GetObjectBlockBounds(int begin, int end, int maxBlockCount, int minBlockSize) {
+    if (begin >= end) {
+        return {begin}; // no blocks
+    }
+    NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
+    const int effectiveBlockCount = Min(maxBlockCount, (int)ceil((end - begin) * 1.0 / minBlockSize));
+    blockParams.SetBlockCount(effectiveBlockCount);
+
+    const int blockSize = blockParams.GetBlockSize();
+    TVector<int> blockBounds;
+    for (int blockIdx : xrange(blockParams.GetBlockCount())) {
+        blockBounds.push_back(begin + blockIdx * blockSize);
+    }
+    blockBounds.push_back(end);
+    return blockBounds;
+}
+
+TVector<int> GetQueryBlockBounds(
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryBegin,
+    int queryEnd,
+    int maxBlockCount,
+    int minBlockSize
+) {
+    if (queryBegin >= queryEnd) {
+        return {queryBegin}; // no blocks
+    }
+    TVector<int> blockBounds = {queryBegin};
+    const ui32 objectBegin = queriesInfo[queryBegin].Begin;
+    const ui32 objectCount = queriesInfo[queryEnd - 1].End - objectBegin;
+    const int blockCount = Max(1, Min(maxBlockCount, (int)ceil(objectCount * 1.0 / minBlockSize)));
+    const double blockObjectCount = objectCount * 1.0 / blockCount;
+    int blockIdx = 1;
+    for (int queryIdx = queryBegin + 1; queryIdx < queryEnd && blockIdx < blockCount; ++queryIdx) {
+        if (queriesInfo[queryIdx].Begin - objectBegin >= blockIdx * blockObjectCount) {
+            blockBounds.push_back(queryIdx);
+            ++blockIdx;
+        }
+    }
+    blockBounds.push_back(queryEnd);
+    return blockBounds;
+}
+
 static inline TConstArrayRef<double> GetRowRef(const TVector<TVector<double>>& matrix, size_t rowIdx) {
     if (matrix.empty()) {
         return TArrayRef<double>();
@@ -1976,6 +2020,9 @@ namespace {
             NPar::TLocalExecutor& executor) const override;
         TString GetDescription() const override;
         void GetBestValue(EMetricBestValue* valueType, float* bestValue) const override;
+        THolder<IIncrementalMetricCalcer> MakeIncrementalCalcer(
+            TConstArrayRef<float> target,
+            TConstArrayRef<float> weight) const;
 
     private:
         int PositiveClass = 1;
@@ -2057,6 +2104,20 @@ void TAUCMetric::GetBestValue(EMetricBestValue* valueType, float*) const {
     *valueType = EMetricBestValue::Max;
 }
 
+THolder<IIncrementalMetricCalcer> TAUCMetric::MakeIncrementalCalcer(
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight
+) const {
+    TVector<bool> isPositive(target.size());
+    for (auto idx : xrange(target.size())) {
+        isPositive[idx] = IsMultiClass ? (target[idx] == static_cast<float>(PositiveClass)) : (target[idx] > Border);
+    }
+    return MakeHolder<TIncrementalAucCalcer>(
+        IsMultiClass ? PositiveClass : 0,
+        std::move(isPositive),
+        UseWeights ? weight : TConstArrayRef<float>{});
+}
+
 /* Accuracy */
 
 namespace {
@@ -3208,14 +3269,17 @@ TMetricHolder TPrecisionAtKMetric::EvalSingleThread(
     Y_ASSERT(approxDelta.empty());
     Y_ASSERT(!isExpApprox);
     TMetricHolder error(2);
+    TVector<std::pair<double, float>> approxAndTargetBuffer; // reused by all queries of the block
     for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
         int queryBegin = queriesInfo[queryIndex].Begin;
         int queryEnd = queriesInfo[queryIndex].End;
 
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.begin() + queryBegin, target.begin() + queryEnd);
-
-        error.Stats[0] += CalcPrecisionAtK(approxCopy, targetCopy, TopSize, Border);
+        error.Stats[0] += CalcPrecisionAtK(
+            MakeArrayRef(approx[0].data() + queryBegin, queryEnd - queryBegin),
+            target.Slice(queryBegin, queryEnd - queryBegin),
+            TopSize,
+            Border,
+            &approxAndTargetBuffer);
         error.Stats[1]++;
     }
     return error;
@@ -3287,14 +3351,17 @@ TMetricHolder TRecallAtKMetric::EvalSingleThread(
     Y_ASSERT(approxDelta.empty());
     Y_ASSERT(!isExpApprox);
     TMetricHolder error(2);
+    TVector<std::pair<double, float>> approxAndTargetBuffer; // reused by all queries of the block
     for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
         int queryBegin = queriesInfo[queryIndex].Begin;
         int queryEnd = queriesInfo[queryIndex].End;
 
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.begin() + queryBegin, target.begin() + queryEnd);
-
-        error.Stats[0] += CalcRecallAtK(approxCopy, targetCopy, TopSize, Border);
+        error.Stats[0] += CalcRecallAtK(
+            MakeArrayRef(approx[0].data() + queryBegin, queryEnd - queryBegin),
+            target.Slice(queryBegin, queryEnd - queryBegin),
+            TopSize,
+            Border,
+            &approxAndTargetBuffer);
         error.Stats[1]++;
     }
     return error;
@@ -3367,14 +3434,17 @@ TMetricHolder TMAPKMetric::EvalSingleThread(
     Y_ASSERT(!isExpApprox);
     TMetricHolder error(2);
 
+    TVector<std::pair<double, float>> approxAndTargetBuffer; // reused by all queries of the block
     for (int queryIndex = queryStartIndex; queryIndex < queryEndIndex; ++queryIndex) {
         int queryBegin = queriesInfo[queryIndex].Begin;
         int queryEnd = queriesInfo[queryIndex].End;
 
-        TVector<double> approxCopy(approx[0].data() + queryBegin, approx[0].data() + queryEnd);
-        TVector<float> targetCopy(target.data() + queryBegin, target.data() + queryEnd);
-
-        error.Stats[0] += CalcAveragePrecisionK(approxCopy, targetCopy, TopSize, Border);
+        error.Stats[0] += CalcAveragePrecisionK(
+            MakeArrayRef(approx[0].data() + queryBegin, queryEnd - queryBegin),
+            target.Slice(queryBegin, queryEnd - queryBegin),
+            TopSize,
+            Border,
+            &approxAndTargetBuffer);
         error.Stats[1]++;
     }
     return error;
@@ -4456,6 +4526,22 @@ TMetricHolder EvalErrors(
 }
 
 
+THolder<IIncrementalMetricCalcer> MakeIncrementalMetricCalcer(
+    const IMetric& metric,
+    TConstArrayRef<float> target,
+    TConstArrayRef<float> weight,
+    TConstArrayRef<TQueryInfo> queriesInfo
+) {
+    if (metric.IsAdditiveMetric()) {
+        return MakeHolder<TIncrementalAdditiveMetricCalcer>(metric, target, weight, queriesInfo);
+    }
+    if (const auto* aucMetric = dynamic_cast<const TAUCMetric*>(&metric)) {
+        return aucMetric->MakeIncrementalCalcer(target, weight);
+    }
+    return nullptr;
+}
+
+
 static inline double BestQueryShift(const double* cursor,
                                     const float* targets,
                                     const float* weights,
@@ -141,6 +141,18 @@ private:
     TMap<TString, TString> Hints;
 };
 
+// Bounds of blocks for parallel evaluation of [begin, end), blocks contain at least minBlockSize objects
+// Empty range has no blocks (single bound is returned)
+TVector<int> GetObjectBlockBounds(int begin, int end, int maxBlockCount, int minBlockSize);
+
+// Same for queries [queryBegin, queryEnd), blocks are balanced by object count rather than query count
+TVector<int> GetQueryBlockBounds(
+    TConstArrayRef<TQueryInfo> queriesInfo,
+    int queryBegin,
+    int queryEnd,
+    int maxBlockCount,
+    int minBlockSize);
+
 template <class TImpl>
 struct TAdditiveMetric: public TMetric {
     TMetricHolder Eval(
@@ -166,21 +178,17 @@ struct TAdditiveMetric: public TMetric {
         int end,
         NPar::TLocalExecutor& executor
     ) const final {
-        NPar::TLocalExecutor::TExecRangeParams blockParams(begin, end);
-
         const int threadCount = executor.GetThreadCount() + 1;
         const int MinBlockSize = 10000;
-        const int effectiveBlockCount = Min(threadCount, (int)ceil((end - begin) * 1.0 / MinBlockSize));
-
-        blockParams.SetBlockCount(effectiveBlockCount);
-
-        const int blockSize = blockParams.GetBlockSize();
-        const ui32 blockCount = blockParams.GetBlockCount();
+        const TVector<int> blockBounds = GetErrorType() == EErrorType::PerObjectError
+            ? GetObjectBlockBounds(begin, end, threadCount, MinBlockSize)
+            : GetQueryBlockBounds(queriesInfo, begin, end, threadCount, MinBlockSize);
+        const int blockCount = blockBounds.ysize() - 1;
 
         TVector<TMetricHolder> results(blockCount);
         NPar::ParallelFor(executor, 0, blockCount, [&](int blockId) {
-            const int from = begin + blockId * blockSize;
-            const int to = Min<int>(begin + (blockId + 1) * blockSize, end);
+            const int from = blockBounds[blockId];
+            const int to = blockBounds[blockId + 1];
             Y_ASSERT(from < to);
             if (UseWeights.IsIgnored() || UseWeights)
                 results[blockId] = static_cast<const TImpl*>(this)->EvalSingleThread(approx, approxDelta, isExpApprox, target, weight, queriesInfo, from, to);
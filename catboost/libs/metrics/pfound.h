@@ -21,9 +21,13 @@ public:
 
     template <bool isExpApprox, bool hasDelta, class TRelevsType, class TApproxType>
     void AddQuery(const TRelevsType* relevs, const TApproxType* approxes, const TApproxType* approxDelta, float queryWeight, const ui32* subgroupData, ui32 querySize) {
-        TVector<int> qurls(querySize);
+        const ui32 depth = Min<ui32>(querySize, Depth);
+
+        // only first depth positions are looked at, so partial sort is enough
+        auto& qurls = QurlsBuffer;
+        qurls.yresize(querySize);
         std::iota(qurls.begin(), qurls.end(), 0);
-        Sort(qurls.begin(), qurls.end(), [&](int left, int right) -> bool {
+        PartialSort(qurls.begin(), qurls.begin() + depth, qurls.end(), [&](int left, int right) -> bool {
             if (hasDelta) {
                 if (isExpApprox) {
                     return CompareDocs(approxes[left] * approxDelta[left], relevs[left], approxes[right] * approxDelta[right], relevs[right]);
@@ -36,7 +40,6 @@ public:
         });
 
         double pLook = 1, pFound = 0;
-        const ui32 depth = Min<ui32>(querySize, Depth);
 
         TSet<ui32> subgroupIds;
         for (ui32 position = 0; position < depth; position++) {
@@ -70,4 +73,5 @@ private:
     const ui32 Depth = -1;
     const double Decay = 0.85f;
     TMetricHolder Statistic;
+    TVector<int> QurlsBuffer; // reused by all queries added to the calcer
 };
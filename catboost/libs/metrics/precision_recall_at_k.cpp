@@ -10,27 +10,27 @@ static size_t CalcSampleSize(size_t approxSize, int top) {
     return (top < 0 || approxSize < static_cast<size_t>(top)) ? approxSize : static_cast<size_t>(top);
 }
 
-static TVector<std::pair<double, float>> UnionApproxAndTarget(TConstArrayRef<double> approx,
-                                                              TConstArrayRef<float> target) {
-    TVector<std::pair<double, float>> pairs;
-    pairs.clear();
-
+static void UnionApproxAndTarget(TConstArrayRef<double> approx,
+                                 TConstArrayRef<float> target,
+                                 TVector<std::pair<double, float>>* pairs) {
+    pairs->yresize(approx.size());
     for (size_t index = 0; index < approx.size(); ++index) {
-        pairs.push_back(std::make_pair(approx[index], target[index]));
+        (*pairs)[index] = std::make_pair(approx[index], target[index]);
     }
-
-    return pairs;
 };
 
-static TVector<std::pair<double, float>> GetSortedApproxAndTarget(TConstArrayRef<double> approx,
-                                                                  TConstArrayRef<float> target,
-                                                                  size_t top) {
-    TVector<std::pair<double, float>> approxAndTarget = UnionApproxAndTarget(approx, target);
-    std::nth_element(approxAndTarget.begin(), approxAndTarget.begin() + top, approxAndTarget.end(),
-                [](const std::pair<double, float>& left, const std::pair<double, float>& right) {
-                    return CompareDocs(left.first, left.second, right.first, right.second);
-                });
-    return approxAndTarget;
+static bool CompareApproxAndTarget(const std::pair<double, float>& left, const std::pair<double, float>& right) {
+    return CompareDocs(left.first, left.second, right.first, right.second);
+}
+
+// only top elements are moved to the beginning, their order is not defined
+static void GetTopApproxAndTarget(TConstArrayRef<double> approx,
+                                  TConstArrayRef<float> target,
+                                  size_t top,
+                                  TVector<std::pair<double, float>>* approxAndTarget) {
+    UnionApproxAndTarget(approx, target, approxAndTarget);
+    std::nth_element(approxAndTarget->begin(), approxAndTarget->begin() + top, approxAndTarget->end(),
+                     CompareApproxAndTarget);
 };
 
 static int CalcRelevant(TConstArrayRef<std::pair<double, float>> approxAndTarget, double border, size_t size) {
@@ -46,30 +46,47 @@ static int CalcRelevant(TConstArrayRef<std::pair<double, float>> approxAndTarget
     return CalcRelevant(approxAndTarget, border, approxAndTarget.size());
 }
 
-double CalcPrecisionAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border) {
+double CalcPrecisionAtK(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    int top,
+    double border,
+    TVector<std::pair<double, float>>* approxAndTargetBuffer
+) {
     size_t size = CalcSampleSize(target.size(), top);
-    TVector<std::pair<double, float>> approxAndTarget = GetSortedApproxAndTarget(approx, target, size);
-    return CalcRelevant(approxAndTarget, border, size) / static_cast<double>(size);
+    GetTopApproxAndTarget(approx, target, size, approxAndTargetBuffer);
+    return CalcRelevant(*approxAndTargetBuffer, border, size) / static_cast<double>(size);
 }
 
-double CalcRecallAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border) {
+double CalcRecallAtK(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    int top,
+    double border,
+    TVector<std::pair<double, float>>* approxAndTargetBuffer
+) {
     size_t size = CalcSampleSize(target.size(), top);
-    TVector<std::pair<double, float>> approxAndTarget = GetSortedApproxAndTarget(approx, target, size);
-    int relevant = CalcRelevant(approxAndTarget, border);
-    return relevant != 0 ? CalcRelevant(approxAndTarget, border, size) / static_cast<double>(relevant) : 1;
+    GetTopApproxAndTarget(approx, target, size, approxAndTargetBuffer);
+    int relevant = CalcRelevant(*approxAndTargetBuffer, border);
+    return relevant != 0 ? CalcRelevant(*approxAndTargetBuffer, border, size) / static_cast<double>(relevant) : 1;
 }
 
-double CalcAveragePrecisionK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border) {
+double CalcAveragePrecisionK(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    int top,
+    double border,
+    TVector<std::pair<double, float>>* approxAndTargetBuffer
+) {
     double score = 0;
     double hits = 0;
 
     size_t size = CalcSampleSize(target.size(), top);
-    TVector<std::pair<double, float>> approxAndTarget = UnionApproxAndTarget(approx, target);
+    auto& approxAndTarget = *approxAndTargetBuffer;
+    UnionApproxAndTarget(approx, target, &approxAndTarget);
 
     PartialSort(approxAndTarget.begin(), approxAndTarget.begin() + size, approxAndTarget.end(),
-                [](const std::pair<double, float>& left, const std::pair<double, float>& right) {
-                    return CompareDocs(left.first, left.second, right.first, right.second);
-                });
+                CompareApproxAndTarget);
 
     for (size_t index = 0; index < approxAndTarget.size(); ++index) {
         if (approxAndTarget[index].second > border) {
@@ -81,3 +98,18 @@ double CalcAveragePrecisionK(TConstArrayRef<double> approx, TConstArrayRef<float
     }
     return hits > 0 ? score / Min<double>(hits, static_cast<size_t>(size)) : 0;
 }
+
+double CalcPrecisionAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border) {
+    TVector<std::pair<double, float>> approxAndTarget;
+    return CalcPrecisionAtK(approx, target, top, border, &approxAndTarget);
+}
+
+double CalcRecallAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border) {
+    TVector<std::pair<double, float>> approxAndTarget;
+    return CalcRecallAtK(approx, target, top, border, &approxAndTarget);
+}
+
+double CalcAveragePrecisionK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border) {
+    TVector<std::pair<double, float>> approxAndTarget;
+    return CalcAveragePrecisionK(approx, target, top, border, &approxAndTarget);
+}
@@ -2,8 +2,32 @@
 
 #include <util/generic/fwd.h>
 
+#include <utility>
+
 double CalcPrecisionAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border);
 
 double CalcRecallAtK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border);
 
 double CalcAveragePrecisionK(TConstArrayRef<double> approx, TConstArrayRef<float> target, int top, double border);
+
+// Same as above but use caller-provided scratch buffer to avoid allocation per query
+double CalcPrecisionAtK(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    int top,
+    double border,
+    TVector<std::pair<double, float>>* approxAndTargetBuffer);
+
+double CalcRecallAtK(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    int top,
+    double border,
+    TVector<std::pair<double, float>>* approxAndTargetBuffer);
+
+double CalcAveragePrecisionK(
+    TConstArrayRef<double> approx,
+    TConstArrayRef<float> target,
+    int top,
+    double border,
+    TVector<std::pair<double, float>>* approxAndTargetBuffer);
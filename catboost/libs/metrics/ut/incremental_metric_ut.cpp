@@ -0,0 +1,79 @@
+#include <catboost/libs/metrics/incremental_metric.h>
+#include <catboost/libs/metrics/metric.h>
+
+#include <library/threading/local_executor/local_executor.h>
+#include <library/unittest/registar.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+static void AddRandomTree(
+    ui32 leafCount,
+    double zeroLeafFraction,
+    TFastRng<ui64>* prng,
+    TVector<TVector<double>>* approx,
+    IIncrementalMetricCalcer* calcer,
+    NPar::TLocalExecutor* executor
+) {
+    const size_t objectCount = (*approx)[0].size();
+    TVector<TIndexType> leafIndices(objectCount);
+    for (auto& leafIdx : leafIndices) {
+        leafIdx = prng->Uniform(leafCount);
+    }
+    TVector<TVector<double>> leafDelta(approx->size(), TVector<double>(leafCount));
+    for (auto& leafDeltaDim : leafDelta) {
+        for (auto& delta : leafDeltaDim) {
+            // round values to get approx ties
+            delta = prng->GenRandReal1() < zeroLeafFraction ? 0.0 : (prng->Uniform(20) - 10.0) / 8.0;
+        }
+    }
+    for (auto dim : xrange(approx->size())) {
+        for (auto objectIdx : xrange(objectCount)) {
+            (*approx)[dim][objectIdx] += leafDelta[dim][leafIndices[objectIdx]];
+        }
+    }
+    calcer->AddLeafDelta(leafIndices, leafDelta, executor);
+}
+
+static void CheckIncrementalMetric(const TString& description, ui32 objectCount, int treesPerEval) {
+    NPar::TLocalExecutor executor;
+    executor.RunAdditionalThreads(3);
+
+    TFastRng<ui64> prng(0);
+    TVector<float> target(objectCount);
+    TVector<float> weight(objectCount);
+    for (auto idx : xrange(objectCount)) {
+        target[idx] = prng.Uniform(2);
+        weight[idx] = prng.GenRandReal1();
+    }
+    TVector<TVector<double>> approx(1, TVector<double>(objectCount, 0.0));
+
+    const auto metrics = CreateMetricsFromDescription({description}, /*approxDim*/ 1);
+    const auto& metric = metrics[0];
+    auto calcer = MakeIncrementalMetricCalcer(*metric, target, weight, /*queriesInfo*/ {});
+    UNIT_ASSERT(calcer);
+
+    for (auto iteration : xrange(10)) {
+        for (auto tree : xrange(treesPerEval)) {
+            Y_UNUSED(tree);
+            AddRandomTree(/*leafCount*/ 16, /*zeroLeafFraction*/ iteration % 2 ? 0.9 : 0.1, &prng, &approx, calcer.Get(), &executor);
+        }
+        const auto expected = EvalErrors(approx, target, weight, /*queriesInfo*/ {}, metric, &executor);
+        const auto actual = calcer->Eval(approx, &executor);
+        UNIT_ASSERT_DOUBLES_EQUAL(metric->GetFinalError(expected), metric->GetFinalError(actual), 1e-9);
+    }
+}
+
+Y_UNIT_TEST_SUITE(IncrementalMetricTests) {
+    Y_UNIT_TEST(TestAdditiveMetric) {
+        CheckIncrementalMetric("RMSE", 100000, 1);
+        CheckIncrementalMetric("Logloss", 100000, 3);
+    }
+
+    Y_UNIT_TEST(TestAuc) {
+        CheckIncrementalMetric("AUC", 10000, 1);
+        CheckIncrementalMetric("AUC:use_weights=true", 10000, 1);
+        CheckIncrementalMetric("AUC", 10000, 2);
+    }
+}
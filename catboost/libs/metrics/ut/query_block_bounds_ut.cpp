@@ -0,0 +1,48 @@
+#include <catboost/libs/metrics/metric.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/generic/vector.h>
+#include <util/generic/xrange.h>
+
+Y_UNIT_TEST_SUITE(QueryBlockBoundsTests) {
+    Y_UNIT_TEST(TestBalancedByObjectCount) {
+        // one big query followed by many small ones
+        TVector<TQueryInfo> queriesInfo;
+        queriesInfo.emplace_back(0, 1000);
+        for (auto queryIdx : xrange(1000)) {
+            queriesInfo.emplace_back(1000 + queryIdx, 1000 + queryIdx + 1);
+        }
+        const auto bounds = GetQueryBlockBounds(queriesInfo, 0, queriesInfo.size(), /*maxBlockCount*/ 2, /*minBlockSize*/ 1);
+        UNIT_ASSERT_VALUES_EQUAL(bounds, TVector<int>({0, 1, 1001}));
+    }
+
+    Y_UNIT_TEST(TestSmallRange) {
+        TVector<TQueryInfo> queriesInfo;
+        for (auto queryIdx : xrange(10)) {
+            queriesInfo.emplace_back(queryIdx * 10, (queryIdx + 1) * 10);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetQueryBlockBounds(queriesInfo, 2, 7, /*maxBlockCount*/ 8, /*minBlockSize*/ 10000),
+            TVector<int>({2, 7}));
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetQueryBlockBounds(queriesInfo, 0, 10, /*maxBlockCount*/ 5, /*minBlockSize*/ 20),
+            TVector<int>({0, 2, 4, 6, 8, 10}));
+    }
+
+    Y_UNIT_TEST(TestEmptyRange) {
+        TVector<TQueryInfo> queriesInfo;
+        for (auto queryIdx : xrange(10)) {
+            queriesInfo.emplace_back(queryIdx * 10, (queryIdx + 1) * 10);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetQueryBlockBounds(queriesInfo, 3, 3, /*maxBlockCount*/ 4, /*minBlockSize*/ 1),
+            TVector<int>({3}));
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetQueryBlockBounds(TConstArrayRef<TQueryInfo>(), 0, 0, /*maxBlockCount*/ 4, /*minBlockSize*/ 1),
+            TVector<int>({0}));
+        UNIT_ASSERT_VALUES_EQUAL(
+            GetObjectBlockBounds(5, 5, /*maxBlockCount*/ 4, /*minBlockSize*/ 1),
+            TVector<int>({5}));
+    }
+}
@@ -4,6 +4,7 @@
 
 #include <util/generic/hash.h>
 #include <util/stream/fwd.h>
+#include <util/stream/mem.h>
 #include <util/system/mutex.h>
 #include <util/system/guard.h>
 #include <util/system/yassert.h>
@@ -27,6 +28,9 @@ public:
     void Save(IOutputStream* s) const;
 
     void Load(IInputStream* s);
+
+    // Tables reference memory of the input, see TCtrValueTable::LoadThin
+    void LoadThin(TMemoryInput* s);
 };
 
 class TCtrDataStreamWriter {
@@ -2,6 +2,7 @@
 
 #include "flatbuffers_serializer_helper.h"
 
+#include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/flatbuffers/model.fbs.h>
 
 #include <util/generic/fwd.h>
@@ -69,3 +70,28 @@ void TCtrValueTable::LoadSolid(void* buf, size_t length) {
     solid.CTRBlob.assign(ctrValueTable->CTRBlob()->data(),
                          ctrValueTable->CTRBlob()->data() + ctrValueTable->CTRBlob()->size());
 }
+
+void TCtrValueTable::LoadThin(TMemoryInput* in) {
+    const ui32 size = LoadSize(in);
+    CB_ENSURE(in->Avail() >= size, "Unexpected end of ctr value table data");
+    const char* buf = in->Buf();
+    in->Skip(size);
+
+    auto ctrValueTable = flatbuffers::GetRoot<NCatBoostFbs::TCtrValueTable>(buf);
+    const ui8* indexHashData = ctrValueTable->IndexHashRaw()->data();
+    const ui8* ctrBlobData = ctrValueTable->CTRBlob()->data();
+    // buckets are packed, blob is accessed as arrays of int, float or TCtrMeanHistory
+    if (reinterpret_cast<uintptr_t>(ctrBlobData) % alignof(TCtrMeanHistory) != 0) {
+        LoadSolid(const_cast<char*>(buf), size);
+        return;
+    }
+    ModelCtrBase.FBDeserialize(ctrValueTable->ModelCtrBase());
+    CounterDenominator = ctrValueTable->CounterDenominator();
+    TargetClassesCount = ctrValueTable->TargetClassesCount();
+    TThinTable thin;
+    thin.IndexBuckets = MakeArrayRef(
+        reinterpret_cast<const NCatboost::TBucket*>(indexHashData),
+        ctrValueTable->IndexHashRaw()->size() / sizeof(NCatboost::TBucket));
+    thin.CTRBlob = MakeArrayRef(ctrBlobData, ctrValueTable->CTRBlob()->size());
+    Impl = thin;
+}
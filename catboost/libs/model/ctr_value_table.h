@@ -9,6 +9,7 @@
 #include <util/generic/variant.h>
 #include <util/generic/vector.h>
 #include <util/stream/fwd.h>
+#include <util/stream/mem.h>
 #include <util/system/types.h>
 
 #include <algorithm>
@@ -47,8 +48,11 @@ public:
     }
 
     bool operator==(const TCtrValueTable& other) const {
-        return std::tie(CounterDenominator, TargetClassesCount, Impl) ==
-               std::tie(other.CounterDenominator, other.TargetClassesCount, other.Impl);
+        // solid and thin tables with the same data are equal
+        return std::tie(CounterDenominator, TargetClassesCount) ==
+               std::tie(other.CounterDenominator, other.TargetClassesCount) &&
+               GetIndexHashViewer().GetBuckets() == other.GetIndexHashViewer().GetBuckets() &&
+               GetTypedArrayRefForBlobData<ui8>() == other.GetTypedArrayRefForBlobData<ui8>();
     }
 
     template <typename T>
@@ -101,6 +105,19 @@ public:
 
     void LoadSolid(void* buf, size_t length);
 
+    // Reference index and ctr data in the input memory without copying.
+    // Memory must outlive the table, use LoadSolid semantics if data is not properly aligned.
+    void LoadThin(TMemoryInput* in);
+
+    // Copy referenced data, so that the table no longer depends on external memory
+    void MakeSolid() {
+        if (HoldsAlternative<TThinTable>(Impl)) {
+            TSolidTable solid;
+            Get<TThinTable>(Impl).ToSolidTable(&solid);
+            Impl = std::move(solid);
+        }
+    }
+
 public:
     TModelCtrBase ModelCtrBase;
     int CounterDenominator = 0;
@@ -15,6 +15,11 @@ static_assert(SSE_BLOCK_SIZE * 8 == FORMULA_EVALUATION_BLOCK_SIZE);
 void TFeatureCachedTreeEvaluator::Calc(size_t treeStart, size_t treeEnd, TArrayRef<double> results) const {
     CB_ENSURE(results.size() == DocCount * Model.ObliviousTrees.ApproxDimension);
     Fill(results.begin(), results.end(), 0.0);
+    AddTrees(treeStart, treeEnd, results);
+}
+
+void TFeatureCachedTreeEvaluator::AddTrees(size_t treeStart, size_t treeEnd, TArrayRef<double> results) const {
+    CB_ENSURE(results.size() == DocCount * Model.ObliviousTrees.ApproxDimension);
 
     TVector<TCalcerIndexType> indexesVec(BlockSize);
     int id = 0;
@@ -33,6 +38,65 @@ void TFeatureCachedTreeEvaluator::Calc(size_t treeStart, size_t treeEnd, TArrayR
     }
 }
 
+void TFeatureCachedTreeEvaluator::CalcBinaryClassesWithEarlyExit(
+    size_t treeStart,
+    size_t treeEnd,
+    size_t treeStep,
+    double border,
+    TArrayRef<double> approx,
+    TArrayRef<ui8> classes
+) const {
+    CB_ENSURE(Model.ObliviousTrees.ApproxDimension == 1, "Early exit is supported only for one dimensional approx");
+    CB_ENSURE(approx.size() == DocCount && classes.size() == DocCount);
+    CB_ENSURE(treeStep > 0, "Tree step should be positive");
+    CB_ENSURE(treeStart <= treeEnd && treeEnd <= Model.GetTreeCount());
+    const auto& treeMinLeafValues = Model.ObliviousTrees.GetTreeMinLeafValues();
+    const auto& treeMaxLeafValues = Model.ObliviousTrees.GetTreeMaxLeafValues();
+    CB_ENSURE(treeMinLeafValues.size() == Model.GetTreeCount(), "Model has no leaf value bounds");
+
+    // bounds of the sum of leaf values of trees [treeStart + i, treeEnd)
+    TVector<double> restMin(treeEnd - treeStart + 1, 0.0);
+    TVector<double> restMax(treeEnd - treeStart + 1, 0.0);
+    for (size_t treeIdx = treeEnd; treeIdx > treeStart; --treeIdx) {
+        restMin[treeIdx - 1 - treeStart] = restMin[treeIdx - treeStart] + treeMinLeafValues[treeIdx - 1];
+        restMax[treeIdx - 1 - treeStart] = restMax[treeIdx - treeStart] + treeMaxLeafValues[treeIdx - 1];
+    }
+
+    TVector<TCalcerIndexType> indexesVec(BlockSize);
+    int id = 0;
+    for (size_t blockStart = 0; blockStart < DocCount; blockStart += BlockSize) {
+        const auto docCountInBlock = Min(BlockSize, DocCount - blockStart);
+        double* blockApprox = approx.data() + blockStart;
+        size_t stepStart = treeStart;
+        while (stepStart < treeEnd) {
+            const double minRest = restMin[stepStart - treeStart];
+            const double maxRest = restMax[stepStart - treeStart];
+            const bool isBlockDecided = AllOf(blockApprox, blockApprox + docCountInBlock, [=] (double value) {
+                return value + minRest > border || value + maxRest <= border;
+            });
+            if (isBlockDecided) {
+                break;
+            }
+            const size_t stepEnd = Min(stepStart + treeStep, treeEnd);
+            CalcFunction(
+                Model,
+                BinFeatures[id].data(),
+                docCountInBlock,
+                indexesVec.data(),
+                stepStart,
+                stepEnd,
+                blockApprox
+            );
+            stepStart = stepEnd;
+        }
+        const double minRest = restMin[stepStart - treeStart];
+        for (size_t docIdx = 0; docIdx < docCountInBlock; ++docIdx) {
+            classes[blockStart + docIdx] = blockApprox[docIdx] + minRest > border;
+        }
+        ++id;
+    }
+}
+
 template <bool NeedXorMask, size_t START_BLOCK, typename TIndexType>
 Y_FORCE_INLINE void CalcIndexesBasic(
         const ui8* __restrict binFeatures,
@@ -633,6 +633,25 @@ public:
     }
 
     void Calc(size_t treeStart, size_t treeEnd, TArrayRef<double> results) const;
+
+    // Adds approxes of trees [treeStart, treeEnd) to results
+    void AddTrees(size_t treeStart, size_t treeEnd, TArrayRef<double> results) const;
+
+    /**
+     * Binary classification with early exit, model ApproxDimension should be 1.
+     * Trees are applied to every block of objects by groups of treeStep trees. Application to the block
+     *  stops when for all its objects the remaining trees can't move approx across border, so easy
+     *  objects are decided by the first trees only.
+     * @param approx initial approxes (e.g. baseline) on input, partial approxes on output
+     * @param classes 1 if approx of all trees [treeStart, treeEnd) is greater than border, 0 otherwise
+     */
+    void CalcBinaryClassesWithEarlyExit(
+        size_t treeStart,
+        size_t treeEnd,
+        size_t treeStep,
+        double border,
+        TArrayRef<double> approx,
+        TArrayRef<ui8> classes) const;
 private:
     const TFullModel& Model;
     TVector<TVector<ui8>> BinFeatures;
@@ -29,6 +29,7 @@
 #include <util/generic/variant.h>
 #include <util/generic/xrange.h>
 #include <util/generic/ylimits.h>
+#include <util/memory/blob.h>
 #include <util/string/builder.h>
 #include <util/stream/buffer.h>
 #include <util/stream/file.h>
@@ -79,6 +80,14 @@ static NJson::TJsonValue RemoveInvalidParams(const NJson::TJsonValue& params) {
     return result;
 }
 
+static void RemoveInvalidModelParams(TFullModel* model) {
+    if (model->ModelInfo.contains("params")) {
+        NJson::TJsonValue paramsJson = ReadTJsonValue(model->ModelInfo.at("params"));
+        paramsJson["flat_params"] = RemoveInvalidParams(paramsJson["flat_params"]);
+        model->ModelInfo["params"] = ToString<NJson::TJsonValue>(paramsJson);
+    }
+}
+
 TFullModel ReadModel(IInputStream* modelStream, EModelType format) {
     TFullModel model;
     if (format == EModelType::CatboostBinary) {
@@ -91,11 +100,7 @@ TFullModel ReadModel(IInputStream* modelStream, EModelType format) {
         CB_ENSURE(coreMLModel.ParseFromString(modelStream->ReadAll()), "coreml model deserialization failed");
         NCatboost::NCoreML::ConvertCoreMLToCatboostModel(coreMLModel, &model);
     }
-    if (model.ModelInfo.contains("params")) {
-        NJson::TJsonValue paramsJson = ReadTJsonValue(model.ModelInfo.at("params"));
-        paramsJson["flat_params"] = RemoveInvalidParams(paramsJson["flat_params"]);
-        model.ModelInfo["params"] = ToString<NJson::TJsonValue>(paramsJson);
-    }
+    RemoveInvalidModelParams(&model);
     return model;
 }
 
@@ -105,6 +110,14 @@ TFullModel ReadModel(const TString& modelFile, EModelType format){
     return ReadModel(&f, format);
 }
 
+TFullModel ReadModelFromMappedFile(const TString& modelFile) {
+    CB_ENSURE(NFs::Exists(modelFile), "Model file doesn't exist: " << modelFile);
+    TFullModel model;
+    model.LoadNonOwning(TBlob::FromFile(modelFile));
+    RemoveInvalidModelParams(&model);
+    return model;
+}
+
 TFullModel ReadModel(const void* binaryBuffer, size_t binaryBufferSize, EModelType format)  {
     TBuffer buf((char*)binaryBuffer, binaryBufferSize);
     TBufferInput bs(buf);
@@ -139,14 +152,6 @@ void OutputModelOnnx(
     const TString& modelFile,
     const NJson::TJsonValue& userParameters) {
 
-    /* TODO(akhropov): the problem with OneHotFeatures is that raw 'float' values
-     * could be interpreted as nans so that equality comparison won't work for such splits
-     */
-    CB_ENSURE(
-        !model.HasCategoricalFeatures(),
-        "ONNX-ML format export does yet not support categorical features"
-    );
-
     onnx::ModelProto outModel;
 
     NCatboost::NOnnx::InitMetadata(model, userParameters, &outModel);
@@ -156,7 +161,14 @@ void OutputModelOnnx(
         graphName = userParameters["onnx_graph_name"].GetStringSafe();
     }
 
-    NCatboost::NOnnx::ConvertTreeToOnnxGraph(model, graphName, outModel.mutable_graph());
+    /* Categorical features hashes are passed in a separate int64 input in bit index encoding:
+     * raw 'float' values could be interpreted as nans so that equality comparison won't work for such splits
+     */
+    if (NCatboost::NOnnx::UseBitIndexEncoding(model, userParameters)) {
+        NCatboost::NOnnx::ConvertTreeToOnnxBitIndexGraph(model, graphName, outModel.mutable_graph());
+    } else {
+        NCatboost::NOnnx::ConvertTreeToOnnxGraph(model, graphName, outModel.mutable_graph());
+    }
 
     TString data;
     outModel.SerializeToString(&data);
@@ -331,10 +343,12 @@ void TObliviousTrees::UpdateRuntimeData() const {
     auto& ref = RuntimeData.GetRef();
 
     ref.TreeFirstLeafOffsets.resize(TreeSizes.size());
+    TVector<size_t> treeLeafCounts(TreeSizes.size());
     if (IsOblivious()) {
         size_t currentOffset = 0;
         for (size_t i = 0; i < TreeSizes.size(); ++i) {
             ref.TreeFirstLeafOffsets[i] = currentOffset;
+            treeLeafCounts[i] = size_t(1) << TreeSizes[i];
             currentOffset += (1 << TreeSizes[i]) * ApproxDimension;
         }
     } else {
@@ -361,6 +375,22 @@ void TObliviousTrees::UpdateRuntimeData() const {
             Y_ASSERT(valueNodeCount > 0);
             Y_ASSERT(maxLeafValueIndex == minLeafValueIndex + (valueNodeCount - 1) * ApproxDimension);
             ref.TreeFirstLeafOffsets[treeId] = minLeafValueIndex;
+            treeLeafCounts[treeId] = valueNodeCount;
+        }
+    }
+    // leaf values may be not set yet for models under construction
+    const bool hasLeafValues = AllOf(xrange(TreeSizes.size()), [&] (size_t treeId) {
+        return ref.TreeFirstLeafOffsets[treeId] + treeLeafCounts[treeId] * ApproxDimension <= LeafValues.size();
+    });
+    if (ApproxDimension == 1 && hasLeafValues) {
+        ref.TreeMinLeafValues.resize(TreeSizes.size());
+        ref.TreeMaxLeafValues.resize(TreeSizes.size());
+        for (size_t treeId = 0; treeId < TreeSizes.size(); ++treeId) {
+            const auto treeLeafValues = MakeArrayRef(
+                LeafValues.data() + ref.TreeFirstLeafOffsets[treeId],
+                treeLeafCounts[treeId]);
+            ref.TreeMinLeafValues[treeId] = *MinElement(treeLeafValues.begin(), treeLeafValues.end());
+            ref.TreeMaxLeafValues[treeId] = *MaxElement(treeLeafValues.begin(), treeLeafValues.end());
         }
     }
 
@@ -799,32 +829,30 @@ void TFullModel::Save(IOutputStream* s) const {
     }
 }
 
-void TFullModel::Load(IInputStream* s) {
+static TVector<TString> LoadModelCore(
+    const ui8* coreData,
+    size_t coreSize,
+    TObliviousTrees* obliviousTrees,
+    THashMap<TString, TString>* modelInfo
+) {
     using namespace flatbuffers;
     using namespace NCatBoostFbs;
-    ui32 fileDescriptor;
-    ::Load(s, fileDescriptor);
-    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
-    auto coreSize = ::LoadSize(s);
-    TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
-    s->LoadOrFail(arrayHolder.Get(), coreSize);
-
     {
-        flatbuffers::Verifier verifier(arrayHolder.Get(), coreSize);
+        flatbuffers::Verifier verifier(coreData, coreSize);
         CB_ENSURE(VerifyTModelCoreBuffer(verifier), "Flatbuffers model verification failed");
     }
-    auto fbModelCore = GetTModelCore(arrayHolder.Get());
+    auto fbModelCore = GetTModelCore(coreData);
     CB_ENSURE(
         fbModelCore->FormatVersion() && fbModelCore->FormatVersion()->str() == CURRENT_CORE_FORMAT_STRING,
         "Unsupported model format: " << fbModelCore->FormatVersion()->str()
     );
     if (fbModelCore->ObliviousTrees()) {
-        ObliviousTrees.FBDeserialize(fbModelCore->ObliviousTrees());
+        obliviousTrees->FBDeserialize(fbModelCore->ObliviousTrees());
     }
-    ModelInfo.clear();
+    modelInfo->clear();
     if (fbModelCore->InfoMap()) {
         for (auto keyVal : *fbModelCore->InfoMap()) {
-            ModelInfo[keyVal->Key()->str()] = keyVal->Value()->str();
+            (*modelInfo)[keyVal->Key()->str()] = keyVal->Value()->str();
         }
     }
     TVector<TString> modelParts;
@@ -835,13 +863,48 @@ void TFullModel::Load(IInputStream* s) {
     }
     if (!modelParts.empty()) {
         CB_ENSURE(modelParts.size() == 1, "only single part model supported now");
+        CB_ENSURE(modelParts[0] == TStaticCtrProvider().ModelPartIdentifier(), "only static ctr models supported");
+    }
+    return modelParts;
+}
+
+void TFullModel::Load(IInputStream* s) {
+    ui32 fileDescriptor;
+    ::Load(s, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(s);
+    TArrayHolder<ui8> arrayHolder = new ui8[coreSize];
+    s->LoadOrFail(arrayHolder.Get(), coreSize);
+
+    const TVector<TString> modelParts = LoadModelCore(arrayHolder.Get(), coreSize, &ObliviousTrees, &ModelInfo);
+    CtrProvider.Reset();
+    if (!modelParts.empty()) {
         CtrProvider = new TStaticCtrProvider;
-        CB_ENSURE(modelParts[0] == CtrProvider->ModelPartIdentifier(), "only static ctr models supported");
         CtrProvider->Load(s);
     }
     UpdateDynamicData();
 }
 
+void TFullModel::LoadNonOwning(const TBlob& modelBlob) {
+    TMemoryInput in(modelBlob.Data(), modelBlob.Size());
+    ui32 fileDescriptor;
+    ::Load(&in, fileDescriptor);
+    CB_ENSURE(fileDescriptor == GetModelFormatDescriptor(), "Incorrect model file descriptor");
+    auto coreSize = ::LoadSize(&in);
+    CB_ENSURE(in.Avail() >= coreSize, "Unexpected end of model data");
+    const ui8* coreData = reinterpret_cast<const ui8*>(in.Buf());
+    in.Skip(coreSize);
+
+    const TVector<TString> modelParts = LoadModelCore(coreData, coreSize, &ObliviousTrees, &ModelInfo);
+    CtrProvider.Reset();
+    if (!modelParts.empty()) {
+        TIntrusivePtr<TStaticCtrProvider> ctrProvider = new TStaticCtrProvider;
+        ctrProvider->LoadNonOwning(&in, modelBlob);
+        CtrProvider = ctrProvider;
+    }
+    UpdateDynamicData();
+}
+
 TVector<TString> GetModelUsedFeaturesNames(const TFullModel& model) {
     TVector<int> featuresIdxs;
     TVector<TString> featuresNames;
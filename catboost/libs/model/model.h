@@ -18,6 +18,7 @@
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/memory/blob.h>
 #include <util/stream/fwd.h>
 #include <util/stream/mem.h>
 #include <util/system/types.h>
@@ -119,6 +120,10 @@ public:
 
         //! Offset of first tree leaf in flat tree leafs array
         TVector<size_t> TreeFirstLeafOffsets;
+
+        //! Minimal and maximal leaf values of every tree, filled only if ApproxDimension == 1
+        TVector<double> TreeMinLeafValues;
+        TVector<double> TreeMaxLeafValues;
     };
 
 public:
@@ -344,6 +349,22 @@ public:
         return RuntimeData->TreeFirstLeafOffsets;
     }
 
+    /**
+     * Bounds of tree contributions to approx, e.g. for early exit in binary classification.
+     * Available only for models with ApproxDimension == 1
+     */
+    const TVector<double>& GetTreeMinLeafValues() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        CB_ENSURE(ApproxDimension == 1, "Leaf value bounds are available only for one dimensional approx");
+        return RuntimeData->TreeMinLeafValues;
+    }
+
+    const TVector<double>& GetTreeMaxLeafValues() const {
+        CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
+        CB_ENSURE(ApproxDimension == 1, "Leaf value bounds are available only for one dimensional approx");
+        return RuntimeData->TreeMaxLeafValues;
+    }
+
     const double* GetFirstLeafPtrForTree(size_t treeIdx) const {
         CB_ENSURE(RuntimeData.Defined(), "runtime data should be initialized");
         return &LeafValues[RuntimeData->TreeFirstLeafOffsets[treeIdx]];
@@ -541,6 +562,14 @@ public:
      */
     void Load(IInputStream* s);
 
+    /**
+     * Deserialize model from memory in binary format without copying CTR tables: they reference
+     *  the blob data, and the blob is held by the model. Tree structure is still copied.
+     * Useful with memory mapped files: read-only pages are shared between all processes that map the file.
+     * @param modelBlob model data in CatboostBinary format
+     */
+    void LoadNonOwning(const TBlob& modelBlob);
+
     //! Check if TFullModel instance has valid CTR provider.
     // If no ctr features present it will return true
     bool HasValidCtrProvider() const {
@@ -819,6 +848,13 @@ public:
 void OutputModel(const TFullModel& model, TStringBuf modelFile);
 void OutputModel(const TFullModel& model, IOutputStream* out);
 TFullModel ReadModel(const TString& modelFile, EModelType format = EModelType::CatboostBinary);
+
+/**
+ * Map model file into memory and load it with TFullModel::LoadNonOwning
+ * @param modelFile path to model in CatboostBinary format
+ */
+TFullModel ReadModelFromMappedFile(const TString& modelFile);
+
 TFullModel ReadModel(
     const void* binaryBuffer,
     size_t binaryBufferSize,
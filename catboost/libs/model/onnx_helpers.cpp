@@ -1,4 +1,6 @@
 #include "onnx_helpers.h"
+#include "hash.h"
+#include "static_ctr_provider.h"
 
 #include <contrib/libs/onnx/onnx/common/constants.h>
 
@@ -12,11 +14,16 @@
 
 #include <library/svnversion/svnversion.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/map.h>
 #include <util/generic/mapfindptr.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
 #include <util/generic/xrange.h>
+#include <util/string/builder.h>
 #include <util/string/join.h>
 #include <util/system/yassert.h>
 
@@ -34,6 +41,12 @@ void NCatboost::NOnnx::InitMetadata(
     opset->set_domain(onnx::AI_ONNX_ML_DOMAIN);
     opset->set_version(2);
 
+    if (UseBitIndexEncoding(model, userParameters)) {
+        onnx::OperatorSetIdProto* onnxOpset = onnxModel->add_opset_import();
+        onnxOpset->set_domain(onnx::ONNX_DOMAIN);
+        onnxOpset->set_version(9);
+    }
+
     onnxModel->set_producer_name("CatBoost");
     onnxModel->set_producer_version(PROGRAM_VERSION);
 
@@ -191,6 +204,13 @@ inline void SetAttributeValue(TConstArrayRef<TString> strings, onnx::AttributePr
     }
 }
 
+inline void SetAttributeValue(TConstArrayRef<float> floats, onnx::AttributeProto* attribute) {
+    attribute->set_type(onnx::AttributeProto_AttributeType_FLOATS);
+    for (auto f : floats) {
+        attribute->add_floats(f);
+    }
+}
+
 
 template <class T>
 static void AddAttribute(
@@ -233,6 +253,28 @@ static void InitProbabilitiesOutput(
 }
 
 
+static void AddZipMapNode(
+    const TVector<i64>& classLabelsInt64,
+    const TVector<TString>& classLabelsString,
+    onnx::GraphProto* onnxGraph) {
+
+    onnx::NodeProto* zipMapNode = onnxGraph->add_node();
+    zipMapNode->set_domain(onnx::AI_ONNX_ML_DOMAIN);
+    zipMapNode->set_op_type("ZipMap");
+
+    zipMapNode->add_input("probability_tensor");
+
+    InitProbabilitiesOutput(
+        "probabilities",
+        classLabelsString.empty() ? onnx::TensorProto_DataType_INT64 : onnx::TensorProto_DataType_STRING,
+        onnxGraph->add_output());
+
+    zipMapNode->add_output("probabilities");
+
+    AddClassLabelsAttribute(classLabelsInt64, classLabelsString, zipMapNode);
+}
+
+
 struct TTreesAttributes {
     // TreeEnsembleClassifier only
     onnx::AttributeProto* class_ids;
@@ -453,20 +495,7 @@ void NCatboost::NOnnx::ConvertTreeToOnnxGraph(
         treesNode->add_output("probability_tensor");
 
 
-        onnx::NodeProto* zipMapNode = onnxGraph->add_node();
-        zipMapNode->set_domain(onnx::AI_ONNX_ML_DOMAIN);
-        zipMapNode->set_op_type("ZipMap");
-
-        zipMapNode->add_input("probability_tensor");
-
-        InitProbabilitiesOutput(
-            "probabilities",
-            classLabelsString.empty() ? onnx::TensorProto_DataType_INT64 : onnx::TensorProto_DataType_STRING,
-            onnxGraph->add_output());
-
-        zipMapNode->add_output("probabilities");
-
-        AddClassLabelsAttribute(classLabelsInt64, classLabelsString, zipMapNode);
+        AddZipMapNode(classLabelsInt64, classLabelsString, onnxGraph);
     } else {
         treesNode->set_op_type("TreeEnsembleRegressor");
 
@@ -488,3 +517,598 @@ void NCatboost::NOnnx::ConvertTreeToOnnxGraph(
         AddTree(trees, treeIdx, isClassifierModel, &treesAttributes);
     }
 }
+
+
+bool NCatboost::NOnnx::UseBitIndexEncoding(const TFullModel& model, const NJson::TJsonValue& userParameters) {
+    const TString encoding = userParameters.Has("onnx_trees_encoding")
+        ? userParameters["onnx_trees_encoding"].GetStringSafe()
+        : TString("TreeEnsemble");
+    CB_ENSURE(
+        encoding == "TreeEnsemble" || encoding == "BitIndex",
+        "Unknown onnx_trees_encoding " << encoding << ", expected TreeEnsemble or BitIndex"
+    );
+    if (model.HasCategoricalFeatures()) {
+        CB_ENSURE(
+            !userParameters.Has("onnx_trees_encoding") || encoding == "BitIndex",
+            "Models with categorical features can be exported to ONNX-ML format only with BitIndex trees encoding"
+        );
+        return true;
+    }
+    return encoding == "BitIndex";
+}
+
+
+namespace {
+    class TOnnxGraphBuilder {
+    public:
+        explicit TOnnxGraphBuilder(onnx::GraphProto* graph)
+            : Graph(graph)
+        {}
+
+        TString AddInitializer(TStringBuf prefix, TConstArrayRef<i64> dims, TConstArrayRef<float> values) {
+            onnx::TensorProto* tensor = AddInitializerTensor(prefix, dims, onnx::TensorProto_DataType_FLOAT);
+            for (auto value : values) {
+                tensor->add_float_data(value);
+            }
+            return tensor->name();
+        }
+
+        TString AddInitializer(TStringBuf prefix, TConstArrayRef<i64> dims, TConstArrayRef<i64> values) {
+            onnx::TensorProto* tensor = AddInitializerTensor(prefix, dims, onnx::TensorProto_DataType_INT64);
+            for (auto value : values) {
+                tensor->add_int64_data(value);
+            }
+            return tensor->name();
+        }
+
+        TString AddBoolInitializer(TStringBuf prefix, TConstArrayRef<i64> dims, TConstArrayRef<ui8> values) {
+            onnx::TensorProto* tensor = AddInitializerTensor(prefix, dims, onnx::TensorProto_DataType_BOOL);
+            for (auto value : values) {
+                tensor->add_int32_data(value);
+            }
+            return tensor->name();
+        }
+
+        TString AddInitializer(TStringBuf prefix, TConstArrayRef<i64> dims, TConstArrayRef<TString> values) {
+            onnx::TensorProto* tensor = AddInitializerTensor(prefix, dims, onnx::TensorProto_DataType_STRING);
+            for (const auto& value : values) {
+                tensor->add_string_data(value);
+            }
+            return tensor->name();
+        }
+
+        // output name is generated from opType if not specified
+        onnx::NodeProto* AddNode(
+            const TString& opType,
+            TConstArrayRef<TString> inputs,
+            const TString& outputName = TString(),
+            const TString& domain = onnx::ONNX_DOMAIN) {
+
+            onnx::NodeProto* node = Graph->add_node();
+            node->set_op_type(opType);
+            node->set_domain(domain);
+            for (const auto& input : inputs) {
+                node->add_input(input);
+            }
+            node->add_output(outputName.empty() ? GetUniqueName(opType) : outputName);
+            return node;
+        }
+
+        TString AddCast(const TString& input, onnx::TensorProto_DataType to) {
+            onnx::NodeProto* node = AddNode("Cast", {input});
+            AddAttribute("to", i64(to), node);
+            return node->output(0);
+        }
+
+        TString AddGather(const TString& data, const TString& indices, i64 axis) {
+            onnx::NodeProto* node = AddNode("Gather", {data, indices});
+            AddAttribute("axis", axis, node);
+            return node->output(0);
+        }
+
+        TString AddConcat(TConstArrayRef<TString> inputs, i64 axis) {
+            if (inputs.size() == 1) {
+                return inputs[0];
+            }
+            onnx::NodeProto* node = AddNode("Concat", inputs);
+            AddAttribute("axis", axis, node);
+            return node->output(0);
+        }
+
+        TString AddUnsqueeze(const TString& input, i64 axis) {
+            onnx::NodeProto* node = AddNode("Unsqueeze", {input});
+            AddAttribute("axes", TVector<i64>{axis}, node);
+            return node->output(0);
+        }
+
+    private:
+        TString GetUniqueName(TStringBuf prefix) {
+            return TStringBuilder() << prefix << '_' << NameCounter++;
+        }
+
+        onnx::TensorProto* AddInitializerTensor(
+            TStringBuf prefix,
+            TConstArrayRef<i64> dims,
+            onnx::TensorProto_DataType dataType) {
+
+            onnx::TensorProto* tensor = Graph->add_initializer();
+            tensor->set_name(GetUniqueName(prefix));
+            tensor->set_data_type(dataType);
+            for (auto dim : dims) {
+                tensor->add_dims(dim);
+            }
+
+            // IR version 3 requires initializers to be listed as graph inputs
+            onnx::ValueInfoProto* input = Graph->add_input();
+            input->set_name(tensor->name());
+            onnx::TypeProto_Tensor* tensorType = input->mutable_type()->mutable_tensor_type();
+            tensorType->set_elem_type(dataType);
+            onnx::TensorShapeProto* tensorShape = tensorType->mutable_shape();
+            for (auto dim : dims) {
+                tensorShape->add_dim()->set_dim_value(dim);
+            }
+            return tensor;
+        }
+
+    private:
+        onnx::GraphProto* Graph;
+        ui32 NameCounter = 0;
+    };
+}
+
+
+// bool [N, splits.size()]
+static TString AddFloatSplitsBits(
+    const TObliviousTrees& trees,
+    TConstArrayRef<TFloatSplit> splits,
+    const TString& features,
+    TOnnxGraphBuilder* builder) {
+
+    TVector<i64> flatFeatureIndices;
+    TVector<float> borders;
+    TVector<ui8> isNanTrue;
+    for (const auto& split : splits) {
+        const auto& floatFeature = trees.FloatFeatures[split.FloatFeature];
+        flatFeatureIndices.push_back(floatFeature.FlatFeatureIndex);
+        borders.push_back(split.Split);
+        // NaN is less than all borders unless it is substituted by +inf
+        isNanTrue.push_back(
+            floatFeature.HasNans && floatFeature.NanValueTreatment == NCatBoostFbs::ENanValueTreatment_AsTrue);
+    }
+    const i64 splitCount = splits.size();
+
+    const TString values = builder->AddGather(
+        features,
+        builder->AddInitializer("float_split_features", {splitCount}, flatFeatureIndices),
+        /*axis*/ 1);
+    TString bits = builder->AddNode(
+        "Greater",
+        {values, builder->AddInitializer("float_split_borders", {splitCount}, borders)}
+    )->output(0);
+    if (AnyOf(isNanTrue, [] (ui8 isTrue) { return isTrue; })) {
+        const TString nanAsTrue = builder->AddNode(
+            "And",
+            {
+                builder->AddNode("IsNaN", {values})->output(0),
+                builder->AddBoolInitializer("float_split_nan_as_true", {splitCount}, isNanTrue)
+            }
+        )->output(0);
+        bits = builder->AddNode("Or", {bits, nanAsTrue})->output(0);
+    }
+    return bits;
+}
+
+
+// bool [N, splits.size()]
+static TString AddOneHotSplitsBits(
+    TConstArrayRef<TOneHotSplit> splits,
+    const TString& catFeatures,
+    TOnnxGraphBuilder* builder) {
+
+    TVector<i64> catFeatureIndices;
+    TVector<i64> values;
+    for (const auto& split : splits) {
+        catFeatureIndices.push_back(split.CatFeatureIdx);
+        values.push_back(split.Value);
+    }
+    const i64 splitCount = splits.size();
+
+    return builder->AddNode(
+        "Equal",
+        {
+            builder->AddGather(
+                catFeatures,
+                builder->AddInitializer("one_hot_split_features", {splitCount}, catFeatureIndices),
+                /*axis*/ 1),
+            builder->AddInitializer("one_hot_split_values", {splitCount}, values)
+        }
+    )->output(0);
+}
+
+
+// int64 [N], same as CalcHashes in ctr_provider.h
+static TString AddProjectionHash(
+    const TObliviousTrees& trees,
+    const TFeatureCombination& projection,
+    const TString& features,
+    const TString& catFeatures,
+    TOnnxGraphBuilder* builder) {
+
+    TVector<TString> components;
+    if (!projection.CatFeatures.empty()) {
+        const TVector<i64> catFeatureIndices(projection.CatFeatures.begin(), projection.CatFeatures.end());
+        components.push_back(
+            builder->AddGather(
+                catFeatures,
+                builder->AddInitializer("projection_cat_features", {catFeatureIndices.ysize()}, catFeatureIndices),
+                /*axis*/ 1));
+    }
+    if (!projection.BinFeatures.empty()) {
+        components.push_back(
+            builder->AddCast(
+                AddFloatSplitsBits(trees, projection.BinFeatures, features, builder),
+                onnx::TensorProto_DataType_INT64));
+    }
+    if (!projection.OneHotFeatures.empty()) {
+        components.push_back(
+            builder->AddCast(
+                AddOneHotSplitsBits(projection.OneHotFeatures, catFeatures, builder),
+                onnx::TensorProto_DataType_INT64));
+    }
+    const TString values = builder->AddConcat(components, /*axis*/ 1);
+    const size_t componentCount
+        = projection.CatFeatures.size() + projection.BinFeatures.size() + projection.OneHotFeatures.size();
+
+    // CalcHash(a, b) = MAGIC_MULT * (a + MAGIC_MULT * b), int64 arithmetic wraps the same way as ui64
+    const TString magicMult = builder->AddInitializer("hash_magic_mult", {}, TVector<i64>{0x4906ba494954cb65ll});
+    TString hash;
+    for (auto componentIdx : xrange(componentCount)) {
+        const TString component = builder->AddGather(
+            values,
+            builder->AddInitializer("projection_component", {}, TVector<i64>{i64(componentIdx)}),
+            /*axis*/ 1);
+        TString sum = builder->AddNode("Mul", {component, magicMult})->output(0);
+        if (!hash.empty()) {
+            sum = builder->AddNode("Add", {hash, sum})->output(0);
+        }
+        hash = builder->AddNode("Mul", {sum, magicMult})->output(0);
+    }
+    return hash;
+}
+
+
+// same as TStaticCtrProvider::CalcCtrs, returns value for hashes not found in the table
+static float GetCtrTableValues(
+    const TModelCtr& ctr,
+    const TCtrValueTable& learnCtr,
+    TVector<i64>* hashes,
+    TVector<float>* values) {
+
+    const ECtrType ctrType = ctr.Base.CtrType;
+    const int targetClassesCount = learnCtr.TargetClassesCount;
+    float emptyValue = ctr.Calc(0, 0);
+    if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+        emptyValue = ctr.Calc(0, learnCtr.CounterDenominator);
+    }
+
+    const auto calcValue = [&] (ui32 bucket) {
+        if (ctrType == ECtrType::BinarizedTargetMeanValue || ctrType == ECtrType::FloatTargetMeanValue) {
+            const TCtrMeanHistory& ctrMeanHistory = learnCtr.GetTypedArrayRefForBlobData<TCtrMeanHistory>()[bucket];
+            return ctr.Calc(ctrMeanHistory.Sum, ctrMeanHistory.Count);
+        } else if (ctrType == ECtrType::Counter || ctrType == ECtrType::FeatureFreq) {
+            return ctr.Calc(learnCtr.GetTypedArrayRefForBlobData<int>()[bucket], learnCtr.CounterDenominator);
+        }
+        const auto ctrHistory = learnCtr.GetTypedArrayRefForBlobData<int>().Slice(
+            bucket * targetClassesCount,
+            targetClassesCount);
+        int goodCount = 0;
+        int totalCount = 0;
+        if (ctrType == ECtrType::Buckets) {
+            goodCount = ctrHistory[ctr.TargetBorderIdx];
+            for (auto classCount : ctrHistory) {
+                totalCount += classCount;
+            }
+        } else if (targetClassesCount > 2) {
+            for (auto classId : xrange(targetClassesCount)) {
+                if (classId > ctr.TargetBorderIdx) {
+                    goodCount += ctrHistory[classId];
+                }
+                totalCount += ctrHistory[classId];
+            }
+        } else {
+            goodCount = ctrHistory[1];
+            totalCount = ctrHistory[0] + ctrHistory[1];
+        }
+        return ctr.Calc(goodCount, totalCount);
+    };
+
+    hashes->clear();
+    values->clear();
+    THashSet<ui64> addedHashes;
+    for (const auto& bucket : learnCtr.GetIndexHashViewer().GetBuckets()) {
+        if (bucket.IndexValue == NCatboost::TDenseIndexHashView::NotFoundIndex) {
+            continue;
+        }
+        if (!addedHashes.insert(bucket.Hash).second) {
+            continue;
+        }
+        hashes->push_back(static_cast<i64>(bucket.Hash));
+        values->push_back(calcValue(bucket.IndexValue));
+    }
+    return emptyValue;
+}
+
+
+// float [N, trees.CtrFeatures.size()]
+static TString AddCtrValues(
+    const TFullModel& model,
+    const TString& features,
+    const TString& catFeatures,
+    TOnnxGraphBuilder* builder) {
+
+    const TObliviousTrees& trees = model.ObliviousTrees;
+    const auto* ctrProvider = dynamic_cast<const TStaticCtrProvider*>(model.CtrProvider.Get());
+    CB_ENSURE(
+        ctrProvider && model.HasValidCtrProvider(),
+        "ONNX-ML format export of CTR features requires model with CTR tables"
+    );
+
+    TMap<TFeatureCombination, TString> projectionHashes;
+    TVector<TString> ctrColumns;
+    TVector<i64> hashes;
+    TVector<float> values;
+    for (const auto& ctrFeature : trees.CtrFeatures) {
+        const TModelCtr& ctr = ctrFeature.Ctr;
+        auto projectionHashIt = projectionHashes.find(ctr.Base.Projection);
+        if (projectionHashIt == projectionHashes.end()) {
+            projectionHashIt = projectionHashes.emplace(
+                ctr.Base.Projection,
+                AddProjectionHash(trees, ctr.Base.Projection, features, catFeatures, builder)
+            ).first;
+        }
+
+        const float emptyValue = GetCtrTableValues(
+            ctr,
+            ctrProvider->CtrData.LearnCtrs.at(ctr.Base),
+            &hashes,
+            &values);
+        onnx::NodeProto* lookupNode = builder->AddNode(
+            "LabelEncoder",
+            {projectionHashIt->second},
+            /*outputName*/ TString(),
+            onnx::AI_ONNX_ML_DOMAIN);
+        AddAttribute("keys_int64s", hashes, lookupNode);
+        AddAttribute("values_floats", values, lookupNode);
+        AddAttribute("default_float", emptyValue, lookupNode);
+
+        ctrColumns.push_back(builder->AddUnsqueeze(lookupNode->output(0), /*axis*/ 1));
+    }
+    return builder->AddConcat(ctrColumns, /*axis*/ 1);
+}
+
+
+// float [N] or [N, ApproxDimension]
+static TString AddBitIndexTrees(
+    const TFullModel& model,
+    const TString& features,
+    const TString& catFeatures,
+    TOnnxGraphBuilder* builder) {
+
+    const TObliviousTrees& trees = model.ObliviousTrees;
+    const auto& binFeatures = trees.GetBinFeatures();
+    CB_ENSURE(!binFeatures.empty(), "ONNX-ML format export of models without splits is not supported");
+
+    // columns of the binary features matrix: float splits, then one hot splits, then ctr splits
+    TVector<TFloatSplit> floatSplits;
+    TVector<TOneHotSplit> oneHotSplits;
+    TVector<i64> ctrSplitFeatures;
+    TVector<float> ctrSplitBorders;
+    for (const auto& split : binFeatures) {
+        if (split.Type == ESplitType::FloatFeature) {
+            floatSplits.push_back(split.FloatFeature);
+        } else if (split.Type == ESplitType::OneHotFeature) {
+            oneHotSplits.push_back(split.OneHotFeature);
+        } else {
+            Y_ASSERT(split.Type == ESplitType::OnlineCtr);
+            ctrSplitBorders.push_back(split.OnlineCtr.Border);
+        }
+    }
+    TVector<ui32> splitColumns(binFeatures.size());
+    {
+        THashMap<TModelCtr, i64> ctrFeatureIndices;
+        for (auto ctrFeatureIdx : xrange(trees.CtrFeatures.size())) {
+            ctrFeatureIndices[trees.CtrFeatures[ctrFeatureIdx].Ctr] = ctrFeatureIdx;
+        }
+        ui32 floatColumn = 0;
+        ui32 oneHotColumn = floatSplits.size();
+        ui32 ctrColumn = floatSplits.size() + oneHotSplits.size();
+        for (auto splitIdx : xrange(binFeatures.size())) {
+            const auto& split = binFeatures[splitIdx];
+            if (split.Type == ESplitType::FloatFeature) {
+                splitColumns[splitIdx] = floatColumn++;
+            } else if (split.Type == ESplitType::OneHotFeature) {
+                splitColumns[splitIdx] = oneHotColumn++;
+            } else {
+                splitColumns[splitIdx] = ctrColumn++;
+                ctrSplitFeatures.push_back(ctrFeatureIndices.at(split.OnlineCtr.Ctr));
+            }
+        }
+    }
+
+    TVector<TString> bitGroups;
+    if (!floatSplits.empty()) {
+        bitGroups.push_back(AddFloatSplitsBits(trees, floatSplits, features, builder));
+    }
+    if (!oneHotSplits.empty()) {
+        bitGroups.push_back(AddOneHotSplitsBits(oneHotSplits, catFeatures, builder));
+    }
+    if (!ctrSplitFeatures.empty()) {
+        const i64 ctrSplitCount = ctrSplitFeatures.size();
+        const TString ctrValues = builder->AddGather(
+            AddCtrValues(model, features, catFeatures, builder),
+            builder->AddInitializer("ctr_split_features", {ctrSplitCount}, ctrSplitFeatures),
+            /*axis*/ 1);
+        bitGroups.push_back(
+            builder->AddNode(
+                "Greater",
+                {ctrValues, builder->AddInitializer("ctr_split_borders", {ctrSplitCount}, ctrSplitBorders)}
+            )->output(0));
+    }
+    TString bits = builder->AddCast(builder->AddConcat(bitGroups, /*axis*/ 1), onnx::TensorProto_DataType_FLOAT);
+
+    /* split bits of every tree are gathered to [N, treeCount, maxDepth] and leaf index of every tree is
+     * their dot product with powers of two, so graph size is linear in the model size
+     */
+    const i64 splitCount = binFeatures.size();
+    const i64 treeCount = trees.GetTreeCount();
+    const i64 maxDepth = *MaxElement(trees.TreeSizes.begin(), trees.TreeSizes.end());
+    // shallower trees are padded with a zero column
+    const i64 zeroColumn = splitCount;
+    TVector<i64> treeSplitColumns(treeCount * maxDepth, zeroColumn);
+    TVector<i64> firstLeafIndices(treeCount);
+    for (auto treeIdx : xrange(treeCount)) {
+        const auto treeSplits = MakeArrayRef(trees.TreeSplits).Slice(
+            trees.TreeStartOffsets[treeIdx],
+            trees.TreeSizes[treeIdx]);
+        for (auto depth : xrange(treeSplits.size())) {
+            treeSplitColumns[treeIdx * maxDepth + depth] = splitColumns[treeSplits[depth]];
+        }
+        firstLeafIndices[treeIdx] = trees.GetFirstLeafOffsets()[treeIdx] / trees.ApproxDimension;
+    }
+    if (AnyOf(trees.TreeSizes, [=] (int treeSize) { return treeSize < maxDepth; })) {
+        const TString zeros = builder->AddNode(
+            "Mul",
+            {
+                builder->AddGather(
+                    bits,
+                    builder->AddInitializer("zero_column_source", {1}, TVector<i64>{0}),
+                    /*axis*/ 1),
+                builder->AddInitializer("zero", {}, TVector<float>{0.0f})
+            }
+        )->output(0);
+        bits = builder->AddConcat({bits, zeros}, /*axis*/ 1);
+    }
+    TVector<float> depthWeights(maxDepth);
+    for (auto depth : xrange(maxDepth)) {
+        depthWeights[depth] = float(1 << depth);
+    }
+    const TString treeBits = builder->AddGather(
+        bits,
+        builder->AddInitializer("tree_split_columns", {treeCount, maxDepth}, treeSplitColumns),
+        /*axis*/ 1);
+    const TString leafIndices = builder->AddNode(
+        "Add",
+        {
+            builder->AddCast(
+                builder->AddNode(
+                    "MatMul",
+                    {treeBits, builder->AddInitializer("depth_weights", {maxDepth}, depthWeights)}
+                )->output(0),
+                onnx::TensorProto_DataType_INT64),
+            builder->AddInitializer("first_leaf_indices", {treeCount}, firstLeafIndices)
+        }
+    )->output(0);
+
+    const TVector<float> leafValues(trees.LeafValues.begin(), trees.LeafValues.end());
+    const i64 leafCount = leafValues.size() / trees.ApproxDimension;
+    const TVector<i64> leafValuesDims = trees.ApproxDimension == 1
+        ? TVector<i64>{leafCount}
+        : TVector<i64>{leafCount, i64(trees.ApproxDimension)};
+    const TString treeValues = builder->AddGather(
+        builder->AddInitializer("leaf_values", leafValuesDims, leafValues),
+        leafIndices,
+        /*axis*/ 0);
+
+    onnx::NodeProto* sumNode = builder->AddNode("ReduceSum", {treeValues});
+    AddAttribute("axes", TVector<i64>{1}, sumNode);
+    AddAttribute("keepdims", i64(0), sumNode);
+    return sumNode->output(0);
+}
+
+
+void NCatboost::NOnnx::ConvertTreeToOnnxBitIndexGraph(
+    const TFullModel& model,
+    const TMaybe<TString>& onnxGraphName,
+    onnx::GraphProto* onnxGraph) {
+
+    const bool isClassifierModel = IsClassifierModel(model);
+
+    const TObliviousTrees& trees = model.ObliviousTrees;
+    CB_ENSURE(isClassifierModel || trees.ApproxDimension == 1, "Multidimensional regression is not supported");
+
+    onnxGraph->set_name(onnxGraphName.GetOrElse("CatBoostModel"));
+
+    const TString features = "features";
+    InitValueInfo(
+        features,
+        onnx::TensorProto_DataType_FLOAT,
+        trees.GetFlatFeatureVectorExpectedSize(),
+        onnxGraph->add_input());
+
+    TString catFeatures;
+    if (model.HasCategoricalFeatures()) {
+        catFeatures = "cat_features";
+        InitValueInfo(
+            catFeatures,
+            onnx::TensorProto_DataType_INT64,
+            trees.GetNumCatFeatures(),
+            onnxGraph->add_input());
+    }
+
+    TOnnxGraphBuilder builder(onnxGraph);
+    const TString approx = AddBitIndexTrees(model, features, catFeatures, &builder);
+
+    if (!isClassifierModel) {
+        builder.AddNode("Identity", {approx}, "predictions");
+        InitValueInfo(
+            "predictions",
+            onnx::TensorProto_DataType_FLOAT,
+            /*secondDim*/ Nothing(),
+            onnxGraph->add_output());
+        return;
+    }
+
+    TVector<i64> classLabelsInt64;
+    TVector<TString> classLabelsString;
+    GetClassLabels(model, &classLabelsInt64, &classLabelsString);
+
+    if (trees.ApproxDimension == 1) {
+        const TString positiveProbability = builder.AddUnsqueeze(
+            builder.AddNode("Sigmoid", {approx})->output(0),
+            /*axis*/ 1);
+        const TString negativeProbability = builder.AddNode(
+            "Sub",
+            {builder.AddInitializer("one", {1}, TVector<float>{1.0f}), positiveProbability}
+        )->output(0);
+        onnx::NodeProto* concatNode = builder.AddNode(
+            "Concat",
+            {negativeProbability, positiveProbability},
+            "probability_tensor");
+        AddAttribute("axis", i64(1), concatNode);
+    } else {
+        onnx::NodeProto* softmaxNode = builder.AddNode("Softmax", {approx}, "probability_tensor");
+        AddAttribute("axis", i64(1), softmaxNode);
+    }
+    InitValueInfo(
+        "probability_tensor",
+        onnx::TensorProto_DataType_FLOAT,
+        trees.ApproxDimension == 1 ? 2 : trees.ApproxDimension,
+        onnxGraph->add_value_info());
+
+    onnx::NodeProto* argMaxNode = builder.AddNode("ArgMax", {"probability_tensor"});
+    AddAttribute("axis", i64(1), argMaxNode);
+    AddAttribute("keepdims", i64(0), argMaxNode);
+    const i64 classCount = Max(classLabelsInt64.size(), classLabelsString.size());
+    const TString classLabels = classLabelsString.empty()
+        ? builder.AddInitializer("class_labels", {classCount}, classLabelsInt64)
+        : builder.AddInitializer("class_labels", {classCount}, classLabelsString);
+    onnx::NodeProto* labelNode = builder.AddNode("Gather", {classLabels, argMaxNode->output(0)}, "label");
+    AddAttribute("axis", i64(0), labelNode);
+    InitValueInfo(
+        "label",
+        classLabelsString.empty() ? onnx::TensorProto_DataType_INT64 : onnx::TensorProto_DataType_STRING,
+        /*secondDim*/ Nothing(),
+        onnxGraph->add_output());
+
+    AddZipMapNode(classLabelsInt64, classLabelsString, onnxGraph);
+}
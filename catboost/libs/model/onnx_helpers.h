@@ -21,5 +21,23 @@ namespace NCatboost {
             const TFullModel& model,
             const TMaybe<TString>& onnxGraphName, // "CatBoostModel" if not defined
             onnx::GraphProto* onnxGraph);
+
+        /* Trees are exported as TreeEnsembleRegressor/TreeEnsembleClassifier nodes by default.
+         * Models with categorical features (or if user parameter "onnx_trees_encoding" is "BitIndex")
+         * are exported in bit index form: binary features are calculated by vectorized comparisons,
+         * leaf indices of all oblivious trees by one MatMul with powers of two,
+         * CTRs by hashing feature combinations and LabelEncoder lookups.
+         */
+        bool UseBitIndexEncoding(const TFullModel& model, const NJson::TJsonValue& userParameters);
+
+        /* Inputs of the graph:
+         *  "features" - float [N, flat feature count], values at categorical features positions are ignored
+         *  "cat_features" - int64 [N, cat feature count], only if model has categorical features.
+         *      Values are hashes of categorical features as returned by CalcCatFeatureHashInt.
+         */
+        void ConvertTreeToOnnxBitIndexGraph(
+            const TFullModel& model,
+            const TMaybe<TString>& onnxGraphName, // "CatBoostModel" if not defined
+            onnx::GraphProto* onnxGraph);
     }
 }
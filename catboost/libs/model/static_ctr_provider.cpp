@@ -227,6 +227,7 @@ void TStaticCtrProvider::SetupBinFeatureIndexes(const TVector<TFloatFeature>& fl
 TIntrusivePtr<ICtrProvider> TStaticCtrProvider::Clone() const {
     TIntrusivePtr<TStaticCtrProvider> result = new TStaticCtrProvider();
     result->CtrData = CtrData;
+    result->CtrDataHolder = CtrDataHolder;
     return result;
 }
 
@@ -342,6 +343,13 @@ static void MergeBuckets(const TVector<const TCtrValueTable*>& tables, TCtrValue
     }
 }
 
+// merged provider does not hold memory of source providers
+static void MakeCtrTablesSolid(TCtrData* ctrData) {
+    for (auto& ctrBaseAndTable : ctrData->LearnCtrs) {
+        ctrBaseAndTable.second.MakeSolid();
+    }
+}
+
 TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(const TVector<const TStaticCtrProvider*>& providers, ECtrTableMergePolicy mergePolicy) {
     if (providers.empty()) {
         return TIntrusivePtr<TStaticCtrProvider>();
@@ -349,6 +357,7 @@ TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(const TVector<cons
     TIntrusivePtr<TStaticCtrProvider> result = new TStaticCtrProvider();
     if (providers.size() == 1) {
         result->CtrData = providers[0]->CtrData;
+        MakeCtrTablesSolid(&result->CtrData);
         return result;
     }
     THashMap<TModelCtrBase, TVector<const TCtrValueTable*>> valuesMap;
@@ -390,5 +399,6 @@ TIntrusivePtr<TStaticCtrProvider> MergeStaticCtrProvidersData(const TVector<cons
             Y_UNREACHABLE();
         }
     }
+    MakeCtrTablesSolid(&result->CtrData);
     return result;
 }
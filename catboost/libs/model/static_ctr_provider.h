@@ -7,6 +7,7 @@
 
 #include <util/generic/hash.h>
 #include <util/generic/utility.h>
+#include <util/memory/blob.h>
 
 #include <functional>
 
@@ -57,6 +58,13 @@ public:
 
     void Load(IInputStream* inp) override {
         ::Load(inp, CtrData);
+        CtrDataHolder.Drop();
+    }
+
+    // ctr tables reference memory of dataHolder, see TCtrData::LoadThin
+    void LoadNonOwning(TMemoryInput* inp, const TBlob& dataHolder) {
+        CtrData.LoadThin(inp);
+        CtrDataHolder = dataHolder;
     }
 
     TString ModelPartIdentifier() const override {
@@ -76,6 +84,7 @@ public:
 public:
     TCtrData CtrData;
 private:
+    TBlob CtrDataHolder; // keeps memory of thin ctr value tables alive
     THashMap<TFloatSplit, TBinFeatureIndexValue> FloatFeatureIndexes;
     THashMap<int, int> CatFeatureIndex;
     THashMap<TOneHotSplit, TBinFeatureIndexValue> OneHotFeatureIndexes;
@@ -1,9 +1,27 @@
 #include "model_test_helpers.h"
 
+#include <catboost/libs/model/static_ctr_provider.h>
+
 #include <library/unittest/registar.h>
 
+#include <util/memory/blob.h>
+
 using namespace std;
 
+static void CheckEqualCatModels(const TFullModel& expected, const TFullModel& actual) {
+    UNIT_ASSERT_EQUAL(expected, actual);
+    const auto& expectedCtrData = dynamic_cast<const TStaticCtrProvider&>(*expected.CtrProvider).CtrData;
+    const auto& actualCtrData = dynamic_cast<const TStaticCtrProvider&>(*actual.CtrProvider).CtrData;
+    UNIT_ASSERT_EQUAL(expectedCtrData, actualCtrData);
+
+    const TVector<TStringBuf> catFeatures[] = {{"a", "b", "c"}, {"d", "e", "f"}, {"g", "h", "k"}};
+    TVector<double> expectedPredictions(3);
+    TVector<double> actualPredictions(3);
+    expected.Calc({}, catFeatures, expectedPredictions);
+    actual.Calc({}, catFeatures, actualPredictions);
+    UNIT_ASSERT_EQUAL(expectedPredictions, actualPredictions);
+}
+
 void DoSerializeDeserialize(const TFullModel& model) {
     TStringStream strStream;
     model.Save(&strStream);
@@ -29,4 +47,23 @@ Y_UNIT_TEST_SUITE(TModelSerialization) {
         UNIT_ASSERT_EQUAL(trainedModel.ObliviousTrees.LeafValues, deserializedModel.ObliviousTrees.LeafValues);
         UNIT_ASSERT_EQUAL(trainedModel.ObliviousTrees.TreeSplits, deserializedModel.ObliviousTrees.TreeSplits);
     }
+
+    Y_UNIT_TEST(TestLoadNonOwning) {
+        const TString serializedModel = SerializeModel(TrainCatOnlyModel());
+        TFullModel trainedModel = DeserializeModel(serializedModel);
+        UNIT_ASSERT(trainedModel.CtrProvider);
+
+        TFullModel modelFromBlob;
+        modelFromBlob.LoadNonOwning(TBlob::NoCopy(serializedModel.data(), serializedModel.size()));
+        CheckEqualCatModels(trainedModel, modelFromBlob);
+
+        OutputModel(trainedModel, "model.cbm");
+        TFullModel mappedModel = ReadModelFromMappedFile("model.cbm");
+        CheckEqualCatModels(trainedModel, mappedModel);
+
+        // copy of the model keeps mapped memory alive
+        TFullModel mappedModelCopy = mappedModel;
+        mappedModel = TFullModel();
+        CheckEqualCatModels(trainedModel, mappedModelCopy);
+    }
 }
@@ -1,23 +1,87 @@
 #include "c_api.h"
 
 #include <catboost/libs/cat_feature/cat_feature.h>
+#include <catboost/libs/helpers/exception.h>
 #include <catboost/libs/model/model.h>
 
+#include <library/threading/local_executor/local_executor.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
 #include <util/generic/singleton.h>
+#include <util/generic/utility.h>
 #include <util/stream/file.h>
 #include <util/string/builder.h>
+#include <util/system/guard.h>
+#include <util/system/mutex.h>
+
+#define MODEL_CALCER_PTR(x) ((TModelCalcer*)(x))
+#define FULL_MODEL_PTR(x) (&MODEL_CALCER_PTR(x)->Model)
 
-#define FULL_MODEL_PTR(x) ((TFullModel*)(x))
+
+// object behind ModelCalcerHandle
+struct TModelCalcer {
+    TFullModel Model;
+
+    // local executor is created on the first multithreaded call and reused by subsequent calls on this handle
+    TMutex ExecutorLock;
+    THolder<NPar::TLocalExecutor> Executor;
+
+public:
+    NPar::TLocalExecutor* GetExecutor(int threadCount) {
+        with_lock (ExecutorLock) {
+            if (!Executor) {
+                Executor = MakeHolder<NPar::TLocalExecutor>();
+            }
+            const int additionalThreadCount = threadCount - 1 - Executor->GetThreadCount();
+            if (additionalThreadCount > 0) {
+                Executor->RunAdditionalThreads(additionalThreadCount);
+            }
+            return Executor.Get();
+        }
+    }
+};
 
 
 struct TErrorMessageHolder {
     TString Message;
 };
 
+// columns of flat features for objects [docBegin, docEnd), hashed categorical values are passed as float bits
+static TVector<TConstArrayRef<float>> GetTransposedFlatFeatures(
+    const TFullModel& model,
+    const float* floatFeatures, size_t floatFeaturesSize, size_t floatFeaturesStride,
+    const int* catFeatures, size_t catFeaturesSize, size_t catFeaturesStride,
+    size_t docBegin,
+    size_t docEnd) {
+    TVector<TConstArrayRef<float>> transposedFeatures(model.ObliviousTrees.GetFlatFeatureVectorExpectedSize());
+    for (const auto& floatFeature : model.ObliviousTrees.FloatFeatures) {
+        if (!floatFeature.UsedInModel()) {
+            continue;
+        }
+        const size_t featureIdx = floatFeature.FeatureIndex;
+        CB_ENSURE(featureIdx < floatFeaturesSize, "Model uses float feature " << featureIdx << ", but only " << floatFeaturesSize << " are provided");
+        transposedFeatures[floatFeature.FlatFeatureIndex] = TConstArrayRef<float>(
+            floatFeatures + featureIdx * floatFeaturesStride + docBegin,
+            docEnd - docBegin);
+    }
+    for (const auto& catFeature : model.ObliviousTrees.CatFeatures) {
+        if (!catFeature.UsedInModel) {
+            continue;
+        }
+        const size_t featureIdx = catFeature.FeatureIndex;
+        CB_ENSURE(featureIdx < catFeaturesSize, "Model uses categorical feature " << featureIdx << ", but only " << catFeaturesSize << " are provided");
+        transposedFeatures[catFeature.FlatFeatureIndex] = TConstArrayRef<float>(
+            reinterpret_cast<const float*>(catFeatures + featureIdx * catFeaturesStride + docBegin),
+            docEnd - docBegin);
+    }
+    return transposedFeatures;
+}
+
 extern "C" {
 EXPORT ModelCalcerHandle* ModelCalcerCreate() {
     try {
-        return new TFullModel;
+        return new TModelCalcer;
     } catch (...) {
         Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
     }
@@ -31,7 +95,7 @@ EXPORT const char* GetErrorString() {
 
 EXPORT void ModelCalcerDelete(ModelCalcerHandle* modelHandle) {
     if (modelHandle != nullptr) {
-        delete FULL_MODEL_PTR(modelHandle);
+        delete MODEL_CALCER_PTR(modelHandle);
     }
 }
 
@@ -137,6 +201,57 @@ EXPORT bool CalcModelPredictionWithHashedCatFeatures(ModelCalcerHandle* modelHan
     return true;
 }
 
+EXPORT bool CalcModelPredictionColumnMajor(
+        ModelCalcerHandle* modelHandle,
+        size_t docCount,
+        const float* floatFeatures, size_t floatFeaturesSize, size_t floatFeaturesStride,
+        const int* catFeatures, size_t catFeaturesSize, size_t catFeaturesStride,
+        int threadCount,
+        double* result, size_t resultSize) {
+    try {
+        const TFullModel& model = *FULL_MODEL_PTR(modelHandle);
+        const size_t approxDimension = model.GetDimensionsCount();
+        CB_ENSURE(resultSize == docCount * approxDimension, "Result size should be equal to " << docCount * approxDimension);
+        CB_ENSURE(floatFeaturesSize == 0 || floatFeaturesStride >= docCount, "Float features stride is less than object count");
+        CB_ENSURE(catFeaturesSize == 0 || catFeaturesStride >= docCount, "Categorical features stride is less than object count");
+        if (docCount == 0) {
+            return true;
+        }
+        const auto calcOnObjects = [&] (size_t docBegin, size_t docEnd) {
+            const auto transposedFeatures = GetTransposedFlatFeatures(
+                model,
+                floatFeatures, floatFeaturesSize, floatFeaturesStride,
+                catFeatures, catFeaturesSize, catFeaturesStride,
+                docBegin,
+                docEnd);
+            model.CalcFlatTransposed(
+                transposedFeatures,
+                0,
+                model.GetTreeCount(),
+                TArrayRef<double>(result + docBegin * approxDimension, (docEnd - docBegin) * approxDimension));
+        };
+        if (threadCount < 2) {
+            calcOnObjects(0, docCount);
+        } else {
+            NPar::TLocalExecutor* executor = MODEL_CALCER_PTR(modelHandle)->GetExecutor(threadCount);
+            NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(docCount));
+            blockParams.SetBlockCount(threadCount);
+            executor->ExecRangeWithThrow(
+                [&] (int blockIdx) {
+                    const size_t docBegin = blockIdx * blockParams.GetBlockSize();
+                    calcOnObjects(docBegin, Min(docBegin + blockParams.GetBlockSize(), docCount));
+                },
+                0,
+                blockParams.GetBlockCount(),
+                NPar::TLocalExecutor::WAIT_COMPLETE);
+        }
+    } catch (...) {
+        Singleton<TErrorMessageHolder>()->Message = CurrentExceptionMessage();
+        return false;
+    }
+    return true;
+}
+
 EXPORT int GetStringCatFeatureHash(const char* data, size_t size) {
     return CalcCatFeatureHash(TStringBuf(data, size));
 }
@@ -140,6 +140,35 @@ EXPORT bool CalcModelPredictionWithHashedCatFeatures(
     const int** catFeatures, size_t catFeaturesSize,
     double* result, size_t resultSize);
 
+/**
+ * Calculate raw model predictions on a batch of objects stored by columns, no per object pointers are needed.
+ * Features are passed to the model without copying.
+ * @param calcer model handle
+ * @param docCount object count
+ * @param floatFeatures column-major float feature values:
+ * value of float feature featureIdx for object docIdx is floatFeatures[featureIdx * floatFeaturesStride + docIdx]
+ * @param floatFeaturesSize float feature count
+ * @param floatFeaturesStride distance between columns of float features, should be at least docCount
+ * @param catFeatures column-major hashed categorical feature values (see GetStringCatFeatureHash),
+ * value of categorical feature featureIdx for object docIdx is catFeatures[featureIdx * catFeaturesStride + docIdx]
+ * Can be nullptr if catFeaturesSize is zero.
+ * @param catFeaturesSize categorical feature count
+ * @param catFeaturesStride distance between columns of categorical features, should be at least docCount
+ * @param threadCount number of threads to use, if less than 2 model is applied in the calling thread.
+ * Threads are created on the first call and reused by subsequent calls with the same modelHandle.
+ * @param result pointer to user allocated results vector
+ * @param resultSize result size should be equal to modelApproxDimension * docCount
+ * (e.g. for non multiclass models should be equal to docCount)
+ * @return false if error occured
+ */
+EXPORT bool CalcModelPredictionColumnMajor(
+    ModelCalcerHandle* modelHandle,
+    size_t docCount,
+    const float* floatFeatures, size_t floatFeaturesSize, size_t floatFeaturesStride,
+    const int* catFeatures, size_t catFeaturesSize, size_t catFeaturesStride,
+    int threadCount,
+    double* result, size_t resultSize);
+
 /**
  * Get hash for given string value
  * @param data we don't expect data to be zero terminated, so pass correct size
@@ -0,0 +1,211 @@
+#include <catboost/libs/model_interface/wrapped_calcer.h>
+
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/model/model.h>
+#include <catboost/libs/train_lib/train_model.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+static const ui32 FloatFeatureCount = 2;
+static const TVector<TString> CatFeatureValues = {"a", "b", "c", "d", "e"};
+
+
+// 2 float features and 1 categorical feature
+static TString TrainSerializedModel() {
+    TTempDir trainDir;
+
+    const ui32 objectCount = 1000;
+    TFastRng64 rng(0);
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                FloatFeatureCount + 1,
+                TVector<ui32>{FloatFeatureCount},
+                TVector<ui32>{},
+                TVector<TString>{});
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            TVector<float> target(objectCount, 0.0f);
+            for (auto featureIdx : xrange(FloatFeatureCount)) {
+                TVector<float> values(objectCount);
+                for (auto objectIdx : xrange(objectCount)) {
+                    values[objectIdx] = rng.GenRandReal1();
+                    target[objectIdx] += values[objectIdx];
+                }
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(values)));
+            }
+            TVector<TStringBuf> catValues(objectCount);
+            for (auto objectIdx : xrange(objectCount)) {
+                const size_t valueIdx = rng.Uniform(CatFeatureValues.size());
+                catValues[objectIdx] = CatFeatureValues[valueIdx];
+                target[objectIdx] += valueIdx;
+            }
+            visitor->AddCatFeature(FloatFeatureCount, catValues);
+
+            visitor->AddTarget(target);
+
+            visitor->Finish();
+        }
+    );
+    dataProviders.Test.push_back(dataProviders.Learn);
+
+    TFullModel model;
+    TEvalResult evalResult;
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 20);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("train_dir", trainDir.Name());
+    TrainModel(
+        params,
+        nullptr,
+        {},
+        {},
+        std::move(dataProviders),
+        "",
+        &model,
+        {&evalResult}
+    );
+
+    return SerializeModel(model);
+}
+
+struct TTestObjects {
+    // by objects, std containers are used by ModelCalcerWrapper
+    std::vector<std::vector<float>> FloatFeatures;
+    std::vector<std::vector<int>> CatFeatureHashes;
+
+public:
+    explicit TTestObjects(size_t objectCount) {
+        TFastRng64 rng(1);
+        for (auto objectIdx : xrange(objectCount)) {
+            Y_UNUSED(objectIdx);
+            std::vector<float> floatFeatures(FloatFeatureCount);
+            for (auto& value : floatFeatures) {
+                value = rng.GenRandReal1();
+            }
+            FloatFeatures.push_back(std::move(floatFeatures));
+            const TString& catValue = CatFeatureValues[rng.Uniform(CatFeatureValues.size())];
+            CatFeatureHashes.push_back({GetStringCatFeatureHash(catValue.data(), catValue.size())});
+        }
+    }
+
+    // column-major, columns are padded to stride
+    template <class T>
+    static std::vector<T> Transpose(const std::vector<std::vector<T>>& rows, size_t stride) {
+        const size_t columnCount = rows.empty() ? 0 : rows[0].size();
+        std::vector<T> result(columnCount * stride);
+        for (auto rowIdx : xrange(rows.size())) {
+            for (auto columnIdx : xrange(columnCount)) {
+                result[columnIdx * stride + rowIdx] = rows[rowIdx][columnIdx];
+            }
+        }
+        return result;
+    }
+};
+
+
+Y_UNIT_TEST_SUITE(CApiTests) {
+    Y_UNIT_TEST(CalcColumnMajorIsSameAsCalcHashed) {
+        const TString serializedModel = TrainSerializedModel();
+        ModelCalcerWrapper calcer(serializedModel.data(), serializedModel.size());
+
+        for (size_t objectCount : {1, 7, 1000}) {
+            const TTestObjects objects(objectCount);
+            const auto expected = calcer.CalcHashed(objects.FloatFeatures, objects.CatFeatureHashes);
+
+            for (int threadCount : {1, 4}) {
+                const auto result = calcer.CalcColumnMajor(
+                    objectCount,
+                    TTestObjects::Transpose(objects.FloatFeatures, objectCount),
+                    TTestObjects::Transpose(objects.CatFeatureHashes, objectCount),
+                    threadCount);
+                UNIT_ASSERT_EQUAL(result, expected);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(CalcModelPredictionColumnMajorWithStrides) {
+        const TString serializedModel = TrainSerializedModel();
+        ModelCalcerWrapper calcer(serializedModel.data(), serializedModel.size());
+        ModelCalcerHandle* handle = ModelCalcerCreate();
+        UNIT_ASSERT(LoadFullModelFromBuffer(handle, serializedModel.data(), serializedModel.size()));
+
+        const size_t objectCount = 100;
+        const TTestObjects objects(objectCount);
+        const auto expected = calcer.CalcHashed(objects.FloatFeatures, objects.CatFeatureHashes);
+
+        const size_t floatFeaturesStride = objectCount + 3;
+        const size_t catFeaturesStride = objectCount + 5;
+        const auto floatFeatures = TTestObjects::Transpose(objects.FloatFeatures, floatFeaturesStride);
+        const auto catFeatures = TTestObjects::Transpose(objects.CatFeatureHashes, catFeaturesStride);
+
+        // several calls reuse threads of the handle
+        for (int threadCount : {0, 3, 2, 5}) {
+            std::vector<double> result(objectCount);
+            UNIT_ASSERT(CalcModelPredictionColumnMajor(
+                handle,
+                objectCount,
+                floatFeatures.data(), FloatFeatureCount, floatFeaturesStride,
+                catFeatures.data(), 1, catFeaturesStride,
+                threadCount,
+                result.data(), result.size()));
+            UNIT_ASSERT_EQUAL(result, expected);
+        }
+
+        std::vector<double> result(objectCount);
+        UNIT_ASSERT(!CalcModelPredictionColumnMajor(
+            handle,
+            objectCount,
+            floatFeatures.data(), FloatFeatureCount, objectCount - 1,
+            catFeatures.data(), 1, catFeaturesStride,
+            1,
+            result.data(), result.size()));
+        UNIT_ASSERT(!CalcModelPredictionColumnMajor(
+            handle,
+            objectCount,
+            floatFeatures.data(), FloatFeatureCount, floatFeaturesStride,
+            nullptr, 0, 0,
+            1,
+            result.data(), result.size()));
+        UNIT_ASSERT(!CalcModelPredictionColumnMajor(
+            handle,
+            objectCount,
+            floatFeatures.data(), FloatFeatureCount, floatFeaturesStride,
+            catFeatures.data(), 1, catFeaturesStride,
+            1,
+            result.data(), result.size() - 1));
+
+        ModelCalcerDelete(handle);
+    }
+
+    Y_UNIT_TEST(CalcColumnMajorChecksFeaturesSize) {
+        const TString serializedModel = TrainSerializedModel();
+        ModelCalcerWrapper calcer(serializedModel.data(), serializedModel.size());
+
+        const size_t objectCount = 10;
+        const TTestObjects objects(objectCount);
+        auto floatFeatures = TTestObjects::Transpose(objects.FloatFeatures, objectCount);
+        floatFeatures.pop_back();
+        UNIT_ASSERT_EXCEPTION(
+            calcer.CalcColumnMajor(
+                objectCount,
+                floatFeatures,
+                TTestObjects::Transpose(objects.CatFeatureHashes, objectCount)),
+            std::runtime_error);
+    }
+}
@@ -7,6 +7,7 @@
 #include <vector>
 #include <functional>
 #include <memory>
+#include <stdexcept>
 
 /**
  * Model C API header-only wrapper class
@@ -198,6 +199,40 @@ public:
         return result;
     }
 
+    /**
+     * Evaluate model on column-major feature matrices without per object pointers
+     * @param docCount object count
+     * @param floatFeatures float feature values, floatFeatures[featureIdx * docCount + docIdx]
+     * @param catFeatureHashes hashed categorical feature values, catFeatureHashes[featureIdx * docCount + docIdx]
+     * @param threadCount number of threads to use
+     * @return vector of raw prediction values
+     * Sizes of floatFeatures and catFeatureHashes should be divisible by docCount.
+     */
+    std::vector<double> CalcColumnMajor(size_t docCount,
+                                        const std::vector<float>& floatFeatures,
+                                        const std::vector<int>& catFeatureHashes,
+                                        int threadCount = 1) const {
+        if (docCount == 0 ?
+            !floatFeatures.empty() || !catFeatureHashes.empty()
+            : floatFeatures.size() % docCount != 0 || catFeatureHashes.size() % docCount != 0) {
+            throw std::runtime_error("features sizes should be divisible by docCount");
+        }
+        std::vector<double> result(docCount * ::GetDimensionsCount(CalcerHolder.get()));
+        const size_t floatFeatureCount = docCount ? floatFeatures.size() / docCount : 0;
+        const size_t catFeatureCount = docCount ? catFeatureHashes.size() / docCount : 0;
+        if (!CalcModelPredictionColumnMajor(
+            CalcerHolder.get(),
+            docCount,
+            floatFeatures.data(), floatFeatureCount, docCount,
+            catFeatureHashes.data(), catFeatureCount, docCount,
+            threadCount,
+            result.data(), result.size())
+            ) {
+            throw std::runtime_error(GetErrorString());
+        }
+        return result;
+    }
+
 
     bool InitFromFile(const std::string& filename) {
         return LoadFullModelFromFile(CalcerHolder.get(), filename.c_str());
@@ -11,6 +11,7 @@ struct TCrossValidationParams {
     bool Stratified = false;
     double MaxTimeSpentOnFixedCostRatio = 0.05;
     ui32 DevMaxIterationsBatchSize = 100000; // useful primarily for tests
+    ui32 MaxConcurrentFoldCount = 0; // 0 means that it is limited only by used RAM estimate (on CPU)
 
 public:
     bool Initialized() const {
@@ -295,5 +295,6 @@ enum class EFeatureCalculatorType {
     BM25,
     CosDistanceWithClassCenter,
     GaussianHomoscedasticModel,
-    GaussianHeteroscedasticiModel
+    GaussianHeteroscedasticiModel,
+    KNN
 };
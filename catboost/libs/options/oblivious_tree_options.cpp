@@ -6,6 +6,8 @@
 
 #include <library/json/json_value.h>
 
+#include <util/generic/bitops.h>
+
 NCatboostOptions::TObliviousTreeLearnerOptions::TObliviousTreeLearnerOptions(ETaskType taskType)
     : MaxDepth("depth", 6)
       , LeavesEstimationIterations("leaf_estimation_iterations", 1)
@@ -108,7 +110,23 @@ void NCatboostOptions::TObliviousTreeLearnerOptions::Validate() const {
     const ui32 maxModelDepth = 16;
     CB_ENSURE(MaxDepth.Get() <= maxModelDepth, "Maximum depth is " << maxModelDepth);
     CB_ENSURE(DevScoreCalcObjBlockSize.GetUnchecked() > 0, "DevScoreCalcObjBlockSize must be > 0");
-    CB_ENSURE(DevExclusiveFeaturesBundleMaxBuckets.GetUnchecked() < (1U << 16), "DevExclusiveFeaturesBundleMaxBuckets must be less than 65536");
+    CB_ENSURE(DevExclusiveFeaturesBundleMaxBuckets.GetUnchecked() > 0, "DevExclusiveFeaturesBundleMaxBuckets must be > 0");
+    CB_ENSURE(
+        DevExclusiveFeaturesBundleMaxBuckets.GetUnchecked() <= (1U << 24),
+        "DevExclusiveFeaturesBundleMaxBuckets must not be greater than " << (1U << 24)
+    );
+    // bundle bucket index and leaf index must fit together into 32 bits for score calculation
+    CB_ENSURE(
+        MaxDepth.Get() + GetValueBitCount(DevExclusiveFeaturesBundleMaxBuckets.GetUnchecked()) <= 32,
+        "DevExclusiveFeaturesBundleMaxBuckets is too big for depth " << MaxDepth.Get()
+    );
+    // approx dimension is checked when it is known, here it is at least 1
+    CB_ENSURE(
+        (ui64(DevExclusiveFeaturesBundleMaxBuckets.GetUnchecked()) << MaxDepth.Get())
+            <= MaxExclusiveFeaturesBundleStatsCount,
+        "DevExclusiveFeaturesBundleMaxBuckets is too big for depth " << MaxDepth.Get()
+        << ": score stats of a bundle would not fit into memory"
+    );
     CB_ENSURE(
         (ExclusiveFeaturesBundleMaxConflictFraction.GetUnchecked() >= 0.f) && (ExclusiveFeaturesBundleMaxConflictFraction.GetUnchecked() < 1.f),
         "ExclusiveFeaturesBundleMaxConflictFraction should be in [0, 1)"
@@ -10,6 +10,11 @@ namespace NJson {
 }
 
 namespace NCatboostOptions {
+    /* limit for the count of score calculation stats of one exclusive features bundle:
+     * bundle buckets * 2^depth * approx dimension (~4 GB)
+     */
+    constexpr ui64 MaxExclusiveFeaturesBundleStatsCount = ui64(1) << 27;
+
     class TObliviousTreeLearnerOptions {
     public:
         explicit TObliviousTreeLearnerOptions(ETaskType taskType);
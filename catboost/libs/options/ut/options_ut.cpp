@@ -129,4 +129,19 @@ Y_UNIT_TEST_SUITE(TOptionsTest) {
         options.SetNotSpecifiedOptionsToDefaults();
         TestSaveLoad(options, ETaskType::GPU);
     }
+
+    Y_UNIT_TEST(TestExclusiveFeaturesBundleMaxBucketsValidation) {
+        auto validate = [] (ui32 depth, ui32 maxBuckets) {
+            TObliviousTreeLearnerOptions options(ETaskType::CPU);
+            options.MaxDepth.Set(depth);
+            options.DevExclusiveFeaturesBundleMaxBuckets.Set(maxBuckets);
+            options.Validate();
+        };
+
+        validate(16, 1 << 10);
+        validate(6, 1 << 21);
+        UNIT_ASSERT_EXCEPTION(validate(6, 1 << 22), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(validate(8, 1 << 24), TCatBoostException);
+        UNIT_ASSERT_EXCEPTION(validate(16, 1 << 12), TCatBoostException);
+    }
 }
@@ -2,6 +2,7 @@
 #include "quantized.h"
 
 #include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
+#include <catboost/idl/pool/proto/metainfo.pb.h>
 #include <catboost/libs/column_description/column.h>
 #include <catboost/libs/data_new/meta_info.h>
 #include <catboost/libs/data_new/unaligned_mem.h>
@@ -12,6 +13,7 @@
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/quantization_schema/serialization.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/cast.h>
 #include <util/generic/deque.h>
 #include <util/generic/mapfindptr.h>
@@ -37,9 +39,42 @@ using NCB::TPathWithScheme;
 using NCB::TQuantizedPool;
 using NCB::TUnalignedArrayBuf;
 
+// Ignored feature columns are not read from file at all
+static NCB::TLoadSubset GetLoadSubset(const TDatasetLoaderPullArgs& args) {
+    NCB::TLoadSubset loadSubset;
+    if (args.PoolPath.Scheme != "quantized") {
+        return loadSubset;
+    }
+
+    const auto poolMetainfo = NCB::LoadPoolMetainfo(args.PoolPath.Path);
+
+    // flat feature index -> column index, see GetColumnIndexToFlatIndexMap
+    TVector<ui32> featureColumnIndices;
+    for (const auto [columnIndex, columnType] : poolMetainfo.GetColumnIndexToType()) {
+        if (columnType == NCB::NIdl::CT_NUMERIC ||
+            columnType == NCB::NIdl::CT_CATEGORICAL ||
+            columnType == NCB::NIdl::CT_SPARSE)
+        {
+            featureColumnIndices.push_back(columnIndex);
+        }
+    }
+    Sort(featureColumnIndices);
+
+    for (const auto flatFeatureIdx : args.CommonArgs.IgnoredFeatures) {
+        if (flatFeatureIdx < featureColumnIndices.size()) {
+            loadSubset.IgnoredFeatureColumnIndices.insert(featureColumnIndices[flatFeatureIdx]);
+        }
+    }
+    for (const auto columnIndex : poolMetainfo.GetIgnoredColumnIndices()) {
+        loadSubset.IgnoredFeatureColumnIndices.insert(columnIndex);
+    }
+    return loadSubset;
+}
+
 NCB::TCBQuantizedDataLoader::TCBQuantizedDataLoader(TDatasetLoaderPullArgs&& args)
     : ObjectCount(0) // inited later
-    , QuantizedPool(std::forward<TQuantizedPool>(LoadQuantizedPool(args.PoolPath, GetLoadParameters())))
+    , QuantizedPool(
+        std::forward<TQuantizedPool>(LoadQuantizedPool(args.PoolPath, GetLoadParameters(), GetLoadSubset(args))))
     , PairsPath(args.CommonArgs.PairsFilePath)
     , GroupWeightsPath(args.CommonArgs.GroupWeightsFilePath)
     , BaselinePath(args.CommonArgs.BaselineFilePath)
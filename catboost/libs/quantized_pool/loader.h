@@ -45,11 +45,6 @@ namespace NCB {
         EObjectsOrder ObjectsOrder;
     };
 
-    struct TLoadSubset {
-        TIndexRange<ui32> Range = {0, Max<ui32>()};
-        bool SkipFeatures = false;
-    };
-
     struct IQuantizedPoolLoader {
         virtual ~IQuantizedPoolLoader() = default;
         virtual TQuantizedPool LoadQuantizedPool(
@@ -17,10 +17,12 @@
 #include <util/generic/array_ref.h>
 #include <util/generic/array_size.h>
 #include <util/generic/deque.h>
+#include <util/generic/mapfindptr.h>
 #include <util/generic/strbuf.h>
 #include <util/generic/string.h>
 #include <util/generic/utility.h>
 #include <util/generic/vector.h>
+#include <util/generic/xrange.h>
 #include <util/memory/blob.h>
 #include <util/stream/file.h>
 #include <util/stream/input.h>
@@ -474,27 +476,69 @@ namespace {
     };
 }
 
+// Copies chunk buffers from the mapped file to `pool->ColumnsDump` and makes chunks point there.
+static void CopyChunksToColumnsDump(
+    TVector<TConstArrayRef<char>> chunkBlobs,
+    NCB::TQuantizedPool* const pool) {
+
+    Sort(chunkBlobs, [] (const auto lhs, const auto rhs) { return lhs.data() < rhs.data(); });
+
+    // keep 16-byte alignment of flatbuffers
+    TVector<size_t> dumpOffsets;
+    dumpOffsets.reserve(chunkBlobs.size());
+    size_t dumpSize = 0;
+    for (const auto chunkBlob : chunkBlobs) {
+        dumpOffsets.push_back(RoundUpTo<size_t>(dumpSize, 16));
+        dumpSize = dumpOffsets.back() + chunkBlob.size();
+    }
+
+    pool->ColumnsDump.yresize(dumpSize);
+    for (auto i : xrange(chunkBlobs.size())) {
+        Copy(chunkBlobs[i].begin(), chunkBlobs[i].end(), pool->ColumnsDump.data() + dumpOffsets[i]);
+    }
+
+    for (auto& chunks : pool->Chunks) {
+        for (auto& chunk : chunks) {
+            const auto* const chunkPtr = reinterpret_cast<const char*>(chunk.Chunk);
+            const auto blobIt = UpperBound(
+                chunkBlobs.begin(),
+                chunkBlobs.end(),
+                chunkPtr,
+                [] (const char* ptr, const TConstArrayRef<char> chunkBlob) { return ptr < chunkBlob.data(); });
+            CB_ENSURE_INTERNAL(blobIt != chunkBlobs.begin(), "Chunk is not in the list of loaded chunks");
+            const auto blobIdx = blobIt - chunkBlobs.begin() - 1;
+            chunk.Chunk = reinterpret_cast<const NCB::NIdl::TQuantizedFeatureChunk*>(
+                pool->ColumnsDump.data() + dumpOffsets[blobIdx] + (chunkPtr - chunkBlobs[blobIdx].data()));
+        }
+    }
+}
+
 NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(
     NCB::TLoadQuantizedPoolParameters params,
     NCB::TLoadSubset loadSubset
 ) {
-    CB_ENSURE_INTERNAL(
-        loadSubset.Range == NCB::TLoadSubset().Range &&
-        loadSubset.SkipFeatures == NCB::TLoadSubset().SkipFeatures,
-        "Scheme quantized supports only default load subset"
-    );
+    // document ranges would require trimming of chunks and of target, weight and group data
+    CB_ENSURE(
+        loadSubset.Range == NCB::TLoadSubset().Range,
+        "Loading document ranges from quantized pools is not supported");
 
     NCB::TQuantizedPool pool;
 
-    pool.Blobs.push_back(params.LockMemory
+    // For a subset only the needed chunks are read from the mapped file (and copied to
+    // `pool.ColumnsDump`), so the whole file is neither locked nor kept mapped.
+    const bool loadFullPool = loadSubset.IsFull();
+    const TBlob fileBlob = (params.LockMemory && loadFullPool)
         ? TBlob::LockedFromFile(TString(PathWithScheme.Path))
-        : TBlob::FromFile(TString(PathWithScheme.Path)));
+        : TBlob::FromFile(TString(PathWithScheme.Path));
+    if (loadFullPool) {
+        pool.Blobs.push_back(fileBlob);
+    }
 
     // TODO(yazevnul): optionally precharge pool
 
     const TConstArrayRef<char> blob{
-        pool.Blobs.back().AsCharPtr(),
-        pool.Blobs.back().Size()};
+        fileBlob.AsCharPtr(),
+        fileBlob.Size()};
 
     ValidatePoolPart(blob);
 
@@ -527,6 +571,7 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(
         blob.size() - epilogOffsets.FeatureCountOffset - MagicEndSize - sizeof(ui64) + 4);
 
     TVector<TVector<NCB::TQuantizedPool::TChunkDescription>> stringColumnChunks;
+    TVector<TConstArrayRef<char>> loadedChunkBlobs; // used only if !loadFullPool
     THashMap<ui32, EColumn> stringColumnIndexToColumnType;
 
     ui32 featureCount;
@@ -561,6 +606,18 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(
         }
         auto& chunks = isFakeColumn ? stringColumnChunks.back() : pool.Chunks[localFeatureIndex];
 
+        bool isFeatureSkipped = false;
+        if (!isFakeColumn) {
+            const auto* const columnType = MapFindPtr(poolMetainfo.GetColumnIndexToType(), featureIndex);
+            const bool isFeatureColumn = columnType && (
+                *columnType == NCB::NIdl::CT_NUMERIC ||
+                *columnType == NCB::NIdl::CT_CATEGORICAL ||
+                *columnType == NCB::NIdl::CT_SPARSE);
+            isFeatureSkipped = isFeatureColumn && (
+                loadSubset.SkipFeatures ||
+                loadSubset.IgnoredFeatureColumnIndices.contains(featureIndex));
+        }
+
         ui32 chunkCount;
         ReadLittleEndian(&chunkCount, &epilog);
         ui32 chunkSize;
@@ -582,7 +639,14 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(
 
             ReadLittleEndian(&docsInChunkCount, &featureEpilogPtr);
 
+            if (isFeatureSkipped) {
+                continue;
+            }
+
             const TConstArrayRef<char> chunkBlob{blob.data() + chunkOffset, chunkSize};
+            if (!loadFullPool) {
+                loadedChunkBlobs.push_back(chunkBlob);
+            }
             // TODO(yazevnul): validate flatbuffer, including document count
             const auto* const chunk = flatbuffers::GetRoot<NCB::NIdl::TQuantizedFeatureChunk>(chunkBlob.data());
 
@@ -612,6 +676,10 @@ NCB::TQuantizedPool TFileQuantizedPoolLoader::LoadQuantizedPool(
         }
     }
 
+    if (!loadFullPool) {
+        CopyChunksToColumnsDump(std::move(loadedChunkBlobs), &pool);
+    }
+
     return pool;
 }
 
@@ -619,10 +687,11 @@ NCB::TQuantizedPoolLoaderFactory::TRegistrator<TFileQuantizedPoolLoader> FileQua
 
 NCB::TQuantizedPool NCB::LoadQuantizedPool(
     const NCB::TPathWithScheme& pathWithScheme,
-    const TLoadQuantizedPoolParameters& params
+    const TLoadQuantizedPoolParameters& params,
+    const TLoadSubset& loadSubset
 ) {
     const auto poolLoader = GetProcessor<IQuantizedPoolLoader, const TPathWithScheme&>(pathWithScheme, pathWithScheme);
-    return poolLoader->LoadQuantizedPool(params, /*loadSubset*/{});
+    return poolLoader->LoadQuantizedPool(params, loadSubset);
 }
 
 static NCB::TQuantizedPoolDigest GetQuantizedPoolDigest(
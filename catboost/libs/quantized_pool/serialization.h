@@ -1,9 +1,13 @@
 #pragma once
 
 #include <catboost/libs/data_util/path_with_scheme.h>
+#include <catboost/libs/index_range/index_range.h>
 
 #include <util/generic/fwd.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/ylimits.h>
 #include <util/stream/fwd.h>
+#include <util/system/types.h>
 
 namespace NCB {
     struct TQuantizedPool;
@@ -23,8 +27,25 @@ namespace NCB {
         bool Precharge = true;
     };
 
+    // Chunks that are not in the subset are not read from file, their columns get empty chunk lists.
+    struct TLoadSubset {
+        // only the default (all documents) is supported
+        TIndexRange<ui32> Range = {0, Max<ui32>()};
+        bool SkipFeatures = false;
+        // column indices of features (Num, Categ or Sparse columns) that are not loaded
+        THashSet<ui32> IgnoredFeatureColumnIndices;
+
+    public:
+        bool IsFull() const {
+            return (Range == TLoadSubset().Range) && !SkipFeatures && IgnoredFeatureColumnIndices.empty();
+        }
+    };
+
     // Load quantized pool saved by `SaveQuantizedPool` from file.
-    TQuantizedPool LoadQuantizedPool(const TPathWithScheme& pathWithScheme, const TLoadQuantizedPoolParameters& params);
+    TQuantizedPool LoadQuantizedPool(
+        const TPathWithScheme& pathWithScheme,
+        const TLoadQuantizedPoolParameters& params,
+        const TLoadSubset& loadSubset = {});
 
     NIdl::TPoolQuantizationSchema LoadQuantizationSchemaFromPool(TStringBuf path);
     NIdl::TPoolMetainfo LoadPoolMetainfo(TStringBuf path);
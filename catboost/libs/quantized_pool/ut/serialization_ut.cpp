@@ -10,6 +10,9 @@
 #include <catboost/idl/pool/flat/quantized_chunk_t.fbs.h>
 #include <catboost/idl/pool/proto/quantization_schema.pb.h>
 
+#include <catboost/libs/helpers/exception.h>
+
+
 #include <util/folder/dirut.h>
 #include <util/folder/path.h>
 #include <util/generic/algorithm.h>
@@ -22,6 +25,7 @@
 #include <util/stream/length.h>
 #include <util/stream/output.h>
 #include <util/system/fstat.h>
+#include <util/system/unaligned_mem.h>
 
 using NCB::NIdl::TFeatureQuantizationSchema;
 using NCB::NIdl::TPoolQuantizationSchema;
@@ -154,6 +158,40 @@ Y_UNIT_TEST_SUITE(SerializationTests) {
         UNIT_ASSERT_VALUES_EQUAL(loadedPoolAsText, poolAsText);
     }
 
+    Y_UNIT_TEST(TestLoadSubset) {
+        const auto pool = MakeQuantizedPool();
+        const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
+
+        {
+            TFileOutput output(path.GetPath());
+            NCB::SaveQuantizedPool(pool, &output);
+        }
+
+        const auto getChunkCount = [] (const NCB::TQuantizedPool& pool, size_t columnIndex) {
+            return pool.Chunks[pool.ColumnIndexToLocalIndex.at(columnIndex)].size();
+        };
+
+        NCB::TLoadSubset loadSubset;
+        loadSubset.IgnoredFeatureColumnIndices = {1};
+        const auto projectedPool = NCB::LoadQuantizedPool(
+            NCB::TPathWithScheme(path.GetPath(), "quantized"),
+            {false, false},
+            loadSubset);
+        UNIT_ASSERT(projectedPool.Blobs.empty());
+        UNIT_ASSERT_VALUES_EQUAL(getChunkCount(projectedPool, 1), 0);
+        UNIT_ASSERT_VALUES_EQUAL(getChunkCount(projectedPool, 5), 1);
+
+        const auto* const labels = projectedPool.Chunks[projectedPool.ColumnIndexToLocalIndex.at(5)][0].Chunk;
+        UNIT_ASSERT_VALUES_EQUAL(labels->Quants()->size(), 3 * sizeof(float));
+        UNIT_ASSERT_VALUES_EQUAL(ReadUnaligned<float>(labels->Quants()->data() + sizeof(float)), 1.5f);
+
+        loadSubset = NCB::TLoadSubset();
+        loadSubset.Range = {3, 10};
+        UNIT_ASSERT_EXCEPTION(
+            NCB::LoadQuantizedPool(NCB::TPathWithScheme(path.GetPath(), "quantized"), {false, false}, loadSubset),
+            TCatBoostException);
+    }
+
     Y_UNIT_TEST(TestLoadQuantizationSchema) {
         const auto pool = MakeQuantizedPool();
         const auto path = TFsPath(GetSystemTempDir()) / "quantized_pool.bin";
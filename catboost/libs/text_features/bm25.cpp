@@ -19,32 +19,46 @@ static inline double CalcTruncatedInvClassFreq(TConstArrayRef<ui32> inClassFreq,
     return Max<double>(log(numClasses - classesWithTerm + 0.5) - log(classesWithTerm + 0.5), eps);
 }
 
-static inline void ExtractTermFreq(TConstArrayRef<TDenseHash<ui32, ui32>> freq,
-                                   ui32 term,
-                                   TArrayRef<ui32> termFreq) {
-    for (ui32 clazz = 0; clazz < freq.size(); ++clazz) {
-        const auto& classFreqTable = freq[clazz];
-        auto termFreqIt = classFreqTable.find(term);
-        termFreq[clazz] = termFreqIt != classFreqTable.end() ? termFreqIt->second : 0;
-    }
+static inline double Score(double termFreq, double k, double lengthNorm) {
+    return termFreq * (k + 1) / (termFreq + lengthNorm);
 }
 
-static inline double Score(double termFreq, double k, double b, double meanLength, double classLength) {
-    return termFreq * (k + 1) / (termFreq + k * (1.0 - b + b * meanLength / classLength));
+TOnlineBM25::TOnlineBM25(ui32 numClasses, double truncateBorder)
+    : NumClasses(numClasses)
+    , TotalTokens(1)
+    , ClassTotalTokens(numClasses)
+    , Freq(numClasses) {
+    // inverse class frequency depends only on the number of classes with term, so it is computed once
+    TVector<ui32> inClassFreq(numClasses);
+    for (ui32 classesWithTerm = 0; classesWithTerm <= numClasses; ++classesWithTerm) {
+        TruncatedInvClassFreq.push_back(CalcTruncatedInvClassFreq(inClassFreq, truncateBorder));
+        if (classesWithTerm < numClasses) {
+            inClassFreq[classesWithTerm] = 1;
+        }
+    }
 }
 
 TVector<double> TOnlineBM25::CalcFeatures(const TText& text, double k, double b) const {
     TVector<double> scores(NumClasses);
-    TVector<ui32> termFreqInClass(NumClasses);
+
+    const double meanClassLength = TotalTokens * 1.0 / NumClasses;
+    TVector<double> lengthNorm(NumClasses);
+    for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+        lengthNorm[clazz] = k * (1.0 - b + b * meanClassLength / ClassTotalTokens[clazz]);
+    }
 
     for (const auto& [term, textFreq] : text) {
         Y_UNUSED(textFreq);
-        ExtractTermFreq(Freq, term, termFreqInClass);
-        double inverseClassFreq = CalcTruncatedInvClassFreq(termFreqInClass, TruncateBorder);
-        double meanClassLength = TotalTokens * 1.0 / NumClasses;
+        const ui32 row = Freq.FindRow(term);
+        if (row == TTokenClassCounts::UnknownRow) {
+            // term frequency is zero for all classes
+            continue;
+        }
+        const auto termFreqInClass = Freq.GetRow(row);
+        const double inverseClassFreq = TruncatedInvClassFreq[ClassesWithTerm[row]];
 
         for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
-            scores[clazz] += inverseClassFreq * Score(termFreqInClass[clazz], k, b, meanClassLength,  ClassTotalTokens[clazz]);
+            scores[clazz] += inverseClassFreq * Score(termFreqInClass[clazz], k, lengthNorm[clazz]);
         }
     }
     return scores;
@@ -59,10 +73,14 @@ TVector<double> TOnlineBM25::CalcFeaturesAndAddText(ui32 classId, const TText& t
 
 
 void TOnlineBM25::AddText(ui32 classId, const TText& text) {
-    auto& classCounts = Freq[classId];
-
     for (const auto& [term, termCount] : text) {
-        classCounts[term] += termCount;
+        const ui32 row = Freq.GetOrAddRow(term);
+        if (row == ClassesWithTerm.size()) {
+            ClassesWithTerm.push_back(0);
+        }
+        auto& classCount = Freq.At(row, classId);
+        ClassesWithTerm[row] += (classCount == 0);
+        classCount += termCount;
         ClassTotalTokens[classId] += termCount;
         TotalTokens += termCount;
     }
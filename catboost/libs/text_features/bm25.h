@@ -1,6 +1,7 @@
 #pragma once
 
 #include "text_dataset.h"
+#include "token_class_counts.h"
 #include <util/system/types.h>
 #include <util/generic/fwd.h>
 
@@ -15,13 +16,7 @@ namespace NCB {
     class TOnlineBM25 {
     public:
 
-        explicit TOnlineBM25(ui32 numClasses, double truncateBorder)
-            : NumClasses(numClasses)
-            , TotalTokens(1)
-            , ClassTotalTokens(numClasses)
-            , Freq(numClasses)
-            , TruncateBorder(truncateBorder) {
-        }
+        explicit TOnlineBM25(ui32 numClasses, double truncateBorder);
 
         TVector<double> CalcFeatures(const TText& text, double k = 1.5, double b = 0.75) const;
 
@@ -34,7 +29,8 @@ namespace NCB {
         ui32 NumClasses;
         ui64 TotalTokens;
         TVector<ui64> ClassTotalTokens;
-        TVector<TDenseHash<ui32, ui32>> Freq;
-        double TruncateBorder;
+        TTokenClassCounts Freq;
+        TVector<ui32> ClassesWithTerm; // [row of Freq]
+        TVector<double> TruncatedInvClassFreq; // [classes with term count]
     };
 }
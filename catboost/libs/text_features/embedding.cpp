@@ -1,7 +1,39 @@
 #include "embedding.h"
 
+#include <catboost/libs/helpers/exception.h>
+
 using namespace NCB;
 
+// average of known token vectors, getVector returns nullptr for unknown tokens
+template <class TGetVector>
+static void ApplyEmbedding(const TText& text, ui64 dim, TGetVector&& getVector, TVector<float>* dst) {
+    dst->clear();
+    dst->resize(dim);
+    auto& result = *dst;
+    double count = 0.5;
+    for (const auto& [token, tokenCount] : text) {
+        Y_UNUSED(tokenCount);
+        const float* vector = getVector(token);
+        if (vector) {
+            for (ui32 i = 0; i < dim; ++i) {
+                result[i] += vector[i];
+            }
+            ++count;
+        }
+    }
+    for (ui64 i = 0; i < result.size(); ++i) {
+        result[i] /= count;
+    }
+}
+
+static void ApplyEmbedding(const IEmbedding& embedding, const TTextDataSet& ds, TVector<TVector<float>>* dst, NPar::TLocalExecutor* executor) {
+    dst->resize(ds.SamplesCount());
+    auto texts = ds.GetTexts();
+    NPar::ParallelFor(*executor, 0, static_cast<ui32>(texts.size()), [&](ui32 idx) {
+        embedding.Apply(texts[idx], &(*dst)[idx]);
+    });
+}
+
 class TEmbedding final : public IEmbedding {
 public:
     explicit TEmbedding(TDenseHash<TTokenId, TVector<float>>&& embedding)
@@ -15,44 +47,63 @@ public:
 
 
     void Apply(const TTextDataSet& ds, TVector<TVector<float>>* dst, NPar::TLocalExecutor* executor) const override {
-        dst->resize(ds.SamplesCount());
-        auto texts = ds.GetTexts();
-        NPar::ParallelFor(*executor, 0, static_cast<ui32>(texts.size()), [&](ui32 idx) {
-            Apply(texts[idx], &(*dst)[idx]);
-        });
+        ApplyEmbedding(*this, ds, dst, executor);
     }
 
 
     void Apply(const TText& text, TVector<float>* dst) const {
-        dst->clear();
-        dst->resize(Dim());
-        auto& result = *dst;
-        double count = 0.5;
-        for (const auto& [token, tokenCount] : text) {
-            Y_UNUSED(tokenCount);
+        ApplyEmbedding(text, Dim(), [&] (TTokenId token) -> const float* {
             auto embedding = Embedding.find(token);
-            if (embedding != Embedding.end()) {
-                AddVector(embedding->second, result);
-                ++count;
-            }
-        }
-        for (ui64 i = 0; i < result.size(); ++i) {
-            result[i] /= count;
-        }
+            return embedding != Embedding.end() ? embedding->second.data() : nullptr;
+        }, dst);
     }
 private:
+    TDenseHash<TTokenId, TVector<float>> Embedding;
+
 
-    void AddVector(TConstArrayRef<float> what, TArrayRef<float> to) const {
-        for (ui32 i = 0; i < to.size(); ++i) {
-            to[i] += what[i];
+};
+
+class TBlobEmbedding final : public IEmbedding {
+public:
+    TBlobEmbedding(TBlob vectors, TDenseHash<TTokenId, ui32>&& tokenRows, ui32 dim)
+    : Vectors(std::move(vectors))
+    , TokenRows(std::move(tokenRows))
+    , Dimension(dim) {
+        CB_ENSURE(Vectors.Size() % (sizeof(float) * Dimension) == 0, "Embedding vectors size is not a multiple of dimension");
+        CB_ENSURE(reinterpret_cast<uintptr_t>(Vectors.Data()) % alignof(float) == 0, "Embedding vectors are not aligned");
+        const ui64 rowCount = Vectors.Size() / (sizeof(float) * Dimension);
+        for (const auto& [token, row] : TokenRows) {
+            Y_UNUSED(token);
+            CB_ENSURE(row < rowCount, "Embedding row " << row << " is out of bounds " << rowCount);
         }
     }
-private:
-    TDenseHash<TTokenId, TVector<float>> Embedding;
 
+    ui64 Dim() const override {
+        return Dimension;
+    }
+
+    void Apply(const TTextDataSet& ds, TVector<TVector<float>>* dst, NPar::TLocalExecutor* executor) const override {
+        ApplyEmbedding(*this, ds, dst, executor);
+    }
+
+    void Apply(const TText& text, TVector<float>* dst) const override {
+        const float* vectors = reinterpret_cast<const float*>(Vectors.Data());
+        ApplyEmbedding(text, Dimension, [&] (TTokenId token) -> const float* {
+            auto row = TokenRows.find(token);
+            return row != TokenRows.end() ? vectors + static_cast<ui64>(row->second) * Dimension : nullptr;
+        }, dst);
+    }
 
+private:
+    TBlob Vectors;
+    TDenseHash<TTokenId, ui32> TokenRows;
+    ui32 Dimension;
 };
 
 TEmbeddingPtr NCB::CreateEmbedding(TDenseHash<TTokenId, TVector<float>>&& hash) {
     return new TEmbedding(std::move(hash));
 }
+
+TEmbeddingPtr NCB::CreateEmbedding(TBlob vectors, TDenseHash<TTokenId, ui32>&& tokenRows, ui32 dim) {
+    return new TBlobEmbedding(std::move(vectors), std::move(tokenRows), dim);
+}
@@ -4,6 +4,7 @@
 #include "text_dataset_builder.h"
 #include <util/system/types.h>
 #include <util/generic/ptr.h>
+#include <util/memory/blob.h>
 #include <library/threading/local_executor/local_executor.h>
 
 namespace NCB {
@@ -23,6 +24,9 @@ namespace NCB {
 
 
     TEmbeddingPtr CreateEmbedding(TDenseHash<TTokenId, TVector<float>>&& hash);
+
+    // vectors are used in place: row tokenRows[token] of dim floats, blob could be memory mapped
+    TEmbeddingPtr CreateEmbedding(TBlob vectors, TDenseHash<TTokenId, ui32>&& tokenRows, ui32 dim);
 }
 
 
@@ -0,0 +1,28 @@
+#include "embedding_knn_features.h"
+
+TVector<double> NCB::TEmbeddingKnnFeatures::CalcFeatures(TConstArrayRef<float> embedding) const {
+    TVector<double> features(NumClasses);
+    const auto neighbors = Index.FindNearest(embedding, NeighborCount, SearchSize);
+    if (neighbors.empty()) {
+        return features;
+    }
+    for (const auto& [distance, id] : neighbors) {
+        Y_UNUSED(distance);
+        features[Classes[id]] += 1;
+    }
+    for (auto& feature : features) {
+        feature /= neighbors.size();
+    }
+    return features;
+}
+
+TVector<double> NCB::TEmbeddingKnnFeatures::CalcFeaturesAndAddEmbedding(ui32 classId, TConstArrayRef<float> embedding) {
+    auto result = CalcFeatures(embedding);
+    AddEmbedding(classId, embedding);
+    return result;
+}
+
+void NCB::TEmbeddingKnnFeatures::AddEmbedding(ui32 classId, TConstArrayRef<float> embedding) {
+    Index.Add(embedding);
+    Classes.push_back(classId);
+}
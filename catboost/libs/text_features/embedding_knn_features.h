@@ -0,0 +1,64 @@
+#pragma once
+
+#include "embedding.h"
+#include "hnsw_index.h"
+#include <util/system/types.h>
+#include <util/generic/vector.h>
+#include <util/generic/array_ref.h>
+
+namespace NCB {
+
+    /*
+     * kNN vote features: fraction of each class among nearest neighbours of the text embedding.
+     * Neighbours are searched in an incremental HNSW index of already added texts,
+     * so online features use only the preceding part of the permutation.
+     */
+    class TEmbeddingKnnFeatures {
+    public:
+
+        explicit TEmbeddingKnnFeatures(ui32 numClasses,
+                                       TEmbeddingPtr embedding,
+                                       ui32 neighborCount = 5,
+                                       ui32 searchSize = 32)
+            : NumClasses(numClasses)
+            , Embedding(std::move(embedding))
+            , NeighborCount(neighborCount)
+            , SearchSize(searchSize)
+            , Index(Embedding->Dim()) {
+        }
+
+        TVector<double> CalcFeatures(TConstArrayRef<float> embedding) const;
+
+        TVector<double> CalcFeaturesAndAddEmbedding(ui32 classId, TConstArrayRef<float> embedding);
+
+        void AddEmbedding(ui32 classId, TConstArrayRef<float> embedding);
+
+        TVector<double> CalcFeatures(const TText& text) const {
+            TVector<float> embedding;
+            Embedding->Apply(text, &embedding);
+            return CalcFeatures(embedding);
+        }
+
+        TVector<double> CalcFeaturesAndAddText(ui32 classId, const TText& text) {
+            TVector<float> embedding;
+            Embedding->Apply(text, &embedding);
+            return CalcFeaturesAndAddEmbedding(classId, embedding);
+        }
+
+        void AddText(ui32 classId, const TText& text) {
+            TVector<float> embedding;
+            Embedding->Apply(text, &embedding);
+            AddEmbedding(classId, embedding);
+        }
+
+    private:
+        ui32 NumClasses;
+        TEmbeddingPtr Embedding;
+        ui32 NeighborCount;
+        ui32 SearchSize;
+
+        THnswIndex Index;
+        TVector<ui32> Classes; // [id in Index]
+    };
+
+}
@@ -1,8 +1,12 @@
-#include "embedding.h"
+#include "embedding_loader.h"
 #include <catboost/libs/data_util/path_with_scheme.h>
 #include <catboost/libs/data_util/line_data_reader.h>
+#include <util/generic/cast.h>
+#include <util/memory/blob.h>
+#include <util/stream/mem.h>
 #include <util/string/iterator.h>
 #include <util/stream/file.h>
+#include <util/ysaveload.h>
 
 namespace NCB {
 
@@ -45,4 +49,68 @@ namespace NCB {
 
         return CreateEmbedding(std::move(embeddings));
     }
+
+    void ConvertEmbeddingToBinary(const TString& textPath, const TString& binaryPath) {
+        const auto delim = '\t';
+
+        TVector<TString> tokens;
+        TVector<float> vectors;
+        ui64 embeddingDim = 0;
+
+        TIFStream in(textPath);
+        TString line;
+        for (ui32 lineIdx = 0; in.ReadLine(line); ++lineIdx) {
+            TVector<TString> vals;
+            StringSplitter(line).Split(delim).Collect(&vals);
+            const auto wordEmbedding = ConvertToFloat(MakeConstArrayRef(vals).Slice(1));
+            CB_ENSURE(embeddingDim == 0 || embeddingDim == wordEmbedding.size(),
+                "Error: embedding size should be equal for all words. Line #" << lineIdx << ": " << embeddingDim << " ≠ " << wordEmbedding.size());
+            embeddingDim = wordEmbedding.size();
+            tokens.push_back(vals[0]);
+            vectors.insert(vectors.end(), wordEmbedding.begin(), wordEmbedding.end());
+        }
+
+        TOFStream out(binaryPath);
+        const ui64 tokenCount = tokens.size();
+        ::Save(&out, tokenCount);
+        ::Save(&out, embeddingDim);
+        out.Write(vectors.data(), vectors.size() * sizeof(float));
+        for (const auto& token : tokens) {
+            ::Save(&out, SafeIntegerCast<ui32>(token.size()));
+            out.Write(token.data(), token.size());
+        }
+        out.Finish();
+    }
+
+    TEmbeddingPtr LoadMappedEmbedding(const TString& binaryPath, const IDictionary& dictionary) {
+        const TBlob blob = TBlob::FromFile(binaryPath);
+        TMemoryInput in(blob.Data(), blob.Size());
+        ui64 tokenCount = 0;
+        ui64 embeddingDim = 0;
+        ::Load(&in, tokenCount);
+        ::Load(&in, embeddingDim);
+        CB_ENSURE(embeddingDim > 0, "Error: embedding dimension is zero in " << binaryPath);
+
+        const size_t vectorsOffset = in.Buf() - blob.AsCharPtr();
+        const size_t vectorsSize = tokenCount * embeddingDim * sizeof(float);
+        CB_ENSURE(blob.Size() >= vectorsOffset + vectorsSize, "Error: embedding file " << binaryPath << " is truncated");
+        in.Skip(vectorsSize);
+
+        TDenseHash<TTokenId, ui32> tokenRows;
+        const ui32 unknownToken = dictionary.GetUnknownTokenId();
+        for (ui32 row = 0; row < tokenCount; ++row) {
+            ui32 tokenSize = 0;
+            ::Load(&in, tokenSize);
+            CB_ENSURE(in.Avail() >= tokenSize, "Error: embedding file " << binaryPath << " is truncated");
+            const TStringBuf token(in.Buf(), tokenSize);
+            in.Skip(tokenSize);
+
+            auto tokenId = dictionary.Apply(token);
+            if (tokenId != unknownToken) {
+                tokenRows[TTokenId(tokenId)] = row;
+            }
+        }
+
+        return CreateEmbedding(blob.SubBlob(vectorsOffset, vectorsOffset + vectorsSize), std::move(tokenRows), embeddingDim);
+    }
 }
@@ -6,4 +6,13 @@ namespace NCB {
 
     TEmbeddingPtr LoadEmbedding(const TString& path, const IDictionary& dictionary);
 
+    /*
+     * Binary embedding format for memory mapping:
+     *     ui64 tokenCount, ui64 dim, float vectors[tokenCount][dim], then tokenCount times (ui32 size, token bytes)
+     * Vectors are not copied on load, only tokens are read to map them to dictionary ids.
+     */
+    void ConvertEmbeddingToBinary(const TString& textPath, const TString& binaryPath);
+
+    TEmbeddingPtr LoadMappedEmbedding(const TString& binaryPath, const IDictionary& dictionary);
+
 }
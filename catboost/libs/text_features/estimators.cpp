@@ -3,9 +3,12 @@
 #include "bm25.h"
 #include "bow.h"
 #include "embedding.h"
+#include "embedding_knn_features.h"
 #include "embedding_online_features.h"
 #include "embedding_loader.h"
 #include <library/containers/dense_hash/dense_hash.h>
+#include <library/threading/local_executor/local_executor.h>
+#include <util/generic/cast.h>
 #include <util/generic/hash_set.h>
 #include <util/generic/set.h>
 
@@ -31,7 +34,7 @@ namespace {
         void ComputeFeatures(
             TCalculatedFeatureVisitor learnVisitor,
             TConstArrayRef<TCalculatedFeatureVisitor> testVisitors,
-            NPar::TLocalExecutor*) const override {
+            NPar::TLocalExecutor* localExecutor) const override {
             auto estimator = CreateEstimator();
             {
                 const auto& ds = GetLearn();
@@ -43,12 +46,12 @@ namespace {
 
                 TVector<TTextDataSetPtr> learnDs{GetLearnPtr()};
                 TVector<TCalculatedFeatureVisitor> learnVisitors{std::move(learnVisitor)};
-                Calc(estimator, learnDs, learnVisitors);
+                Calc(estimator, learnDs, learnVisitors, localExecutor);
             }
             if (!testVisitors.empty()) {
                 CB_ENSURE(testVisitors.size() == NumberOfTests(),
                           "If specified, testVisitors should be the same number as test sets");
-                Calc(estimator, GetTests(), testVisitors);
+                Calc(estimator, GetTests(), testVisitors, localExecutor);
             }
         }
 
@@ -56,7 +59,7 @@ namespace {
             TConstArrayRef<ui32> learnPermutation,
             TCalculatedFeatureVisitor learnVisitor,
             TConstArrayRef<TCalculatedFeatureVisitor> testVisitors,
-            NPar::TLocalExecutor*) const override {
+            NPar::TLocalExecutor* localExecutor) const override {
             const ui32 featuresCount = GetFeaturesCount();
             auto estimator = CreateEstimator();
             {
@@ -78,26 +81,28 @@ namespace {
             if (!testVisitors.empty()) {
                 CB_ENSURE(testVisitors.size() == NumberOfTests(),
                           "If specified, testVisitors should be the same number as test sets");
-                Calc(estimator, GetTests(), testVisitors);
+                Calc(estimator, GetTests(), testVisitors, localExecutor);
             }
         }
     protected:
 
+        // estimator is not changed here, so documents are processed concurrently
         void Calc(const TEstimatorImpl& estimator,
                   TConstArrayRef<TTextDataSetPtr> dataSets,
-                  TConstArrayRef<TCalculatedFeatureVisitor> visitors) const {
+                  TConstArrayRef<TCalculatedFeatureVisitor> visitors,
+                  NPar::TLocalExecutor* localExecutor) const {
             const ui32 featuresCount = static_cast<const ui32>(GetFeaturesCount());
             for (ui32 id = 0; id < dataSets.size(); ++id) {
                 const auto& ds = *dataSets[id];
                 const ui64 samplesCount = ds.SamplesCount();
                 TVector<TVector<float>> features(featuresCount, TVector<float>(samplesCount));
 
-                for (ui64 line = 0; line < samplesCount; ++line) {
+                NPar::ParallelFor(*localExecutor, 0, SafeIntegerCast<ui32>(samplesCount), [&] (ui32 line) {
                     auto textFeatures = estimator.CalcFeatures(ds.GetText(line));
                     for (ui32 f = 0; f < featuresCount; ++f) {
                         features[f][line] = static_cast<float>(textFeatures[f]);
                     }
-                }
+                });
                 for (ui32 f = 0; f < featuresCount; ++f) {
                     visitors[id](f, features[f]);
                 }
@@ -240,6 +245,37 @@ namespace {
         TEmbeddingPtr Embedding;
         TSet<EFeatureCalculatorType> EnabledTypes;
     };
+
+    class TKNNEstimator final : public TBaseEstimator<TEmbeddingKnnFeatures> {
+    public:
+        TKNNEstimator(
+            TEmbeddingPtr embedding,
+            TTextClassificationTargetPtr target,
+            TTextDataSetPtr learnTexts,
+            TVector<TTextDataSetPtr> testText)
+            : TBaseEstimator(std::move(target), std::move(learnTexts), std::move(testText))
+            , Embedding(std::move(embedding)) {
+
+        }
+
+        TEstimatedFeaturesMeta FeaturesMeta() const override {
+            TEstimatedFeaturesMeta meta;
+            meta.FeaturesCount = GetFeaturesCount();
+            meta.Type.resize(meta.FeaturesCount, EFeatureCalculatorType::KNN);
+            return meta;
+        }
+
+    protected:
+        TEmbeddingKnnFeatures CreateEstimator() const {
+            return TEmbeddingKnnFeatures(GetTarget().NumClasses, Embedding);
+        }
+        ui64 GetFeaturesCount() const override {
+            return GetTarget().NumClasses;
+        }
+
+    private:
+        TEmbeddingPtr Embedding;
+    };
 }
 
 
@@ -272,6 +308,9 @@ TVector<TOnlineFeatureEstimatorPtr> NCB::CreateEstimators(
     if (!enabledEmbeddingCalculators.empty()) {
         estimators.push_back(new TEmbeddingOnlineFeaturesEstimator(embedding, target, learnTexts, testText, enabledEmbeddingCalculators));
     }
+    if (typesSet.contains(EFeatureCalculatorType::KNN)) {
+        estimators.push_back(new TKNNEstimator(embedding, target, learnTexts, testText));
+    }
     return estimators;
 }
 
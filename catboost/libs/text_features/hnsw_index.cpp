@@ -0,0 +1,197 @@
+#include "hnsw_index.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <library/containers/dense_hash/dense_hash.h>
+#include <library/dot_product/dot_product.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/queue.h>
+#include <util/generic/ymath.h>
+
+#include <functional>
+
+using namespace NCB;
+
+THnswIndex::THnswIndex(ui32 dim, ui32 maxNeighbors, ui32 constructionSearchSize, ui64 seed)
+    : Dimension(dim)
+    , MaxNeighbors(maxNeighbors)
+    , ConstructionSearchSize(constructionSearchSize)
+    , LevelMultiplier(1.0 / log(Max<double>(maxNeighbors, 2)))
+    , Rng(seed) {
+    CB_ENSURE(dim > 0, "Embedding dimension should be positive");
+    CB_ENSURE(maxNeighbors > 0, "Max neighbors count should be positive");
+}
+
+THnswIndex::TQuery THnswIndex::GetQuery(ui32 id) const {
+    return {Vectors.data() + static_cast<ui64>(id) * Dimension, SquaredNorms[id]};
+}
+
+float THnswIndex::Distance(const TQuery& query, ui32 id) const {
+    const float* vector = Vectors.data() + static_cast<ui64>(id) * Dimension;
+    return query.SquaredNorm + SquaredNorms[id] - 2 * DotProduct(query.Vector, vector, Dimension);
+}
+
+ui32 THnswIndex::GetMaxLinkCount(ui32 level) const {
+    return level == 0 ? 2 * MaxNeighbors : MaxNeighbors;
+}
+
+TArrayRef<ui32> THnswIndex::GetLinkSlots(ui32 id, ui32 level) {
+    if (level == 0) {
+        const ui64 slotCount = GetMaxLinkCount(0) + 1;
+        return MakeArrayRef(BaseLinks.data() + id * slotCount, slotCount);
+    }
+    const ui64 slotCount = GetMaxLinkCount(level) + 1;
+    return MakeArrayRef(UpperLinks[id].data() + (level - 1) * slotCount, slotCount);
+}
+
+TConstArrayRef<ui32> THnswIndex::GetLinks(ui32 id, ui32 level) const {
+    const ui32* slots = level == 0
+        ? BaseLinks.data() + id * static_cast<ui64>(GetMaxLinkCount(0) + 1)
+        : UpperLinks[id].data() + (level - 1) * static_cast<ui64>(GetMaxLinkCount(level) + 1);
+    return MakeArrayRef(slots + 1, slots[0]);
+}
+
+ui32 THnswIndex::GreedySearch(const TQuery& query, ui32 entryPoint, ui32 level) const {
+    ui32 current = entryPoint;
+    float currentDistance = Distance(query, current);
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (ui32 neighbor : GetLinks(current, level)) {
+            const float distance = Distance(query, neighbor);
+            if (distance < currentDistance) {
+                currentDistance = distance;
+                current = neighbor;
+                changed = true;
+            }
+        }
+    }
+    return current;
+}
+
+TVector<THnswIndex::TNeighbor> THnswIndex::SearchLayer(
+    const TQuery& query,
+    ui32 entryPoint,
+    ui32 searchSize,
+    ui32 level) const {
+
+    TDenseHashSet<ui32> visited(/*emptyKey*/Max<ui32>());
+    // nearest candidate on top
+    TPriorityQueue<TNeighbor, TVector<TNeighbor>, std::greater<TNeighbor>> candidates;
+    // farthest found on top
+    TPriorityQueue<TNeighbor> found;
+
+    const TNeighbor entry(Distance(query, entryPoint), entryPoint);
+    visited.Insert(entryPoint);
+    candidates.push(entry);
+    found.push(entry);
+    while (!candidates.empty()) {
+        const TNeighbor candidate = candidates.top();
+        if (candidate.first > found.top().first && found.size() >= searchSize) {
+            break;
+        }
+        candidates.pop();
+        for (ui32 neighbor : GetLinks(candidate.second, level)) {
+            if (!visited.Insert(neighbor)) {
+                continue;
+            }
+            const float distance = Distance(query, neighbor);
+            if (found.size() < searchSize || distance < found.top().first) {
+                candidates.emplace(distance, neighbor);
+                found.emplace(distance, neighbor);
+                if (found.size() > searchSize) {
+                    found.pop();
+                }
+            }
+        }
+    }
+
+    TVector<TNeighbor> result;
+    result.reserve(found.size());
+    for (; !found.empty(); found.pop()) {
+        result.push_back(found.top());
+    }
+    Reverse(result.begin(), result.end());
+    return result;
+}
+
+void THnswIndex::AddLink(ui32 id, ui32 neighbor, ui32 level) {
+    auto slots = GetLinkSlots(id, level);
+    const ui32 maxLinkCount = GetMaxLinkCount(level);
+    if (slots[0] < maxLinkCount) {
+        slots[++slots[0]] = neighbor;
+        return;
+    }
+    // keep the closest links
+    const auto query = GetQuery(id);
+    TVector<TNeighbor> links;
+    links.reserve(maxLinkCount + 1);
+    for (ui32 link : GetLinks(id, level)) {
+        links.emplace_back(Distance(query, link), link);
+    }
+    links.emplace_back(Distance(query, neighbor), neighbor);
+    PartialSort(links.begin(), links.begin() + maxLinkCount, links.end());
+    for (ui32 linkIdx = 0; linkIdx < maxLinkCount; ++linkIdx) {
+        slots[linkIdx + 1] = links[linkIdx].second;
+    }
+}
+
+ui32 THnswIndex::Add(TConstArrayRef<float> vector) {
+    CB_ENSURE(vector.size() == Dimension, "Vector size " << vector.size() << " differs from index dimension " << Dimension);
+    const ui32 id = Size();
+    Vectors.insert(Vectors.end(), vector.begin(), vector.end());
+    SquaredNorms.push_back(L2NormSquared(vector.data(), Dimension));
+    const ui32 level = static_cast<ui32>(-log(Rng.GenRandReal3()) * LevelMultiplier);
+    Levels.push_back(level);
+    BaseLinks.resize(BaseLinks.size() + GetMaxLinkCount(0) + 1, 0);
+    UpperLinks.emplace_back(static_cast<ui64>(level) * (GetMaxLinkCount(1) + 1), 0);
+
+    if (id == 0) {
+        EntryPoint = id;
+        MaxLevel = level;
+        return id;
+    }
+
+    const auto query = GetQuery(id);
+    ui32 current = EntryPoint;
+    for (ui32 searchLevel = MaxLevel; searchLevel > level; --searchLevel) {
+        current = GreedySearch(query, current, searchLevel);
+    }
+    for (i64 searchLevel = Min(level, MaxLevel); searchLevel >= 0; --searchLevel) {
+        const auto nearest = SearchLayer(query, current, ConstructionSearchSize, searchLevel);
+        const ui32 linkCount = Min<ui32>(nearest.size(), MaxNeighbors);
+        auto slots = GetLinkSlots(id, searchLevel);
+        slots[0] = linkCount;
+        for (ui32 linkIdx = 0; linkIdx < linkCount; ++linkIdx) {
+            slots[linkIdx + 1] = nearest[linkIdx].second;
+            AddLink(nearest[linkIdx].second, id, searchLevel);
+        }
+        current = nearest[0].second;
+    }
+    if (level > MaxLevel) {
+        MaxLevel = level;
+        EntryPoint = id;
+    }
+    return id;
+}
+
+TVector<THnswIndex::TNeighbor> THnswIndex::FindNearest(
+    TConstArrayRef<float> query,
+    ui32 neighborCount,
+    ui32 searchSize) const {
+
+    CB_ENSURE(query.size() == Dimension, "Query size " << query.size() << " differs from index dimension " << Dimension);
+    if (Size() == 0 || neighborCount == 0) {
+        return {};
+    }
+    const TQuery searchQuery{query.data(), L2NormSquared(query.data(), Dimension)};
+    ui32 current = EntryPoint;
+    for (ui32 searchLevel = MaxLevel; searchLevel > 0; --searchLevel) {
+        current = GreedySearch(searchQuery, current, searchLevel);
+    }
+    auto nearest = SearchLayer(searchQuery, current, Max(searchSize, neighborCount), 0);
+    if (nearest.size() > neighborCount) {
+        nearest.resize(neighborCount);
+    }
+    return nearest;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/random/fast.h>
+#include <util/system/types.h>
+
+#include <utility>
+
+namespace NCB {
+
+    /*
+     * Incremental HNSW (hierarchical navigable small world graph) index with squared L2 distance.
+     * Vectors are searchable immediately after Add, so neighbours among a prefix of a permutation
+     * are found by querying before adding.
+     * Level 0 links are stored in one flat array, upper levels (few nodes) per node.
+     * FindNearest does not modify the index and could be called concurrently.
+     */
+    class THnswIndex {
+    public:
+        using TNeighbor = std::pair<float, ui32>; // distance, id
+
+    public:
+        explicit THnswIndex(
+            ui32 dim,
+            ui32 maxNeighbors = 16,
+            ui32 constructionSearchSize = 100,
+            ui64 seed = 0);
+
+        ui32 Add(TConstArrayRef<float> vector);
+
+        // sorted by distance, at most neighborCount items
+        TVector<TNeighbor> FindNearest(TConstArrayRef<float> query, ui32 neighborCount, ui32 searchSize) const;
+
+        ui32 Size() const {
+            return Levels.size();
+        }
+
+        ui32 Dim() const {
+            return Dimension;
+        }
+
+    private:
+        struct TQuery {
+            const float* Vector;
+            float SquaredNorm;
+        };
+
+        TQuery GetQuery(ui32 id) const;
+        float Distance(const TQuery& query, ui32 id) const;
+
+        // slot 0 is the link count
+        TArrayRef<ui32> GetLinkSlots(ui32 id, ui32 level);
+        TConstArrayRef<ui32> GetLinks(ui32 id, ui32 level) const;
+        ui32 GetMaxLinkCount(ui32 level) const;
+
+        ui32 GreedySearch(const TQuery& query, ui32 entryPoint, ui32 level) const;
+        TVector<TNeighbor> SearchLayer(const TQuery& query, ui32 entryPoint, ui32 searchSize, ui32 level) const;
+        void AddLink(ui32 id, ui32 neighbor, ui32 level);
+
+    private:
+        ui32 Dimension;
+        ui32 MaxNeighbors;
+        ui32 ConstructionSearchSize;
+        double LevelMultiplier;
+        TFastRng64 Rng;
+
+        TVector<float> Vectors; // [id * Dimension + i]
+        TVector<float> SquaredNorms;
+        TVector<ui32> Levels;
+        TVector<ui32> BaseLinks; // [id * (2 * MaxNeighbors + 1) + slot]
+        TVector<TVector<ui32>> UpperLinks; // [id][(level - 1) * (MaxNeighbors + 1) + slot]
+        ui32 EntryPoint = 0;
+        ui32 MaxLevel = 0;
+    };
+}
@@ -1,74 +1,68 @@
 #include "naive_bayesian.h"
 #include "helpers.h"
 #include "text_dataset.h"
-#include <library/containers/dense_hash/dense_hash.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/ymath.h>
 
 using namespace NCB;
 
-double TMultinomialOnlineNaiveBayes::LogProb(
-    const TDenseHash<ui32, ui32>& freqTable,
-    double classSamples,
-    double classTokensCount,
-    const TText& text,
-    double classPrior,
-    double tokenPrior) const {
+void TMultinomialOnlineNaiveBayes::AddText(ui32 classId, const TText& text)  {
+    for (const auto& [term, termCount] : text) {
+        const ui32 row = Counts.GetOrAddRow(term);
+        if (LogCounts.size() < static_cast<ui64>(row + 1) * NumClasses) {
+            LogCounts.resize(static_cast<ui64>(row + 1) * NumClasses, LogTokenPrior);
+        }
+        auto& classCount = Counts.At(row, classId);
+        classCount += termCount;
+        LogCounts[static_cast<ui64>(row) * NumClasses + classId] = log(TokenPrior + classCount);
+        ClassTotalTokens[classId] += termCount;
+    }
+    ++ClassDocs[classId];
+}
 
-    double value = log(classSamples + classPrior);
+TVector<double> TMultinomialOnlineNaiveBayes::CalcFeatures(const TText& text) const  {
+    TVector<double> logProbs(NumClasses);
+    TVector<double> classTokensCount(NumClasses);
+    for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+        logProbs[clazz] = log(ClassDocs[clazz] + ClassPrior);
+        classTokensCount[clazz] = ClassTotalTokens[clazz];
+        classTokensCount[clazz] += TokenPrior * (Counts.RowCount() + 1);
+    }
 
-    classTokensCount += tokenPrior * (KnownTokens.Size() + 1);
     double textLen = 0;
-
     for (const auto& [token, count] : text) {
         textLen += count;
 
-        auto tokenCountPtr = freqTable.find(token);
-        double num = tokenPrior;
-
-        if (tokenCountPtr != freqTable.end()) {
-            num += tokenCountPtr->second;
-        } else {
-            //unseen word, adjust prior
-            classTokensCount += tokenPrior;
+        const ui32 row = Counts.FindRow(token);
+        if (row == TTokenClassCounts::UnknownRow) {
+            for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+                //unseen word, adjust prior
+                classTokensCount[clazz] += TokenPrior;
+                logProbs[clazz] += LogTokenPrior;
+            }
+            continue;
+        }
+        const auto tokenCounts = Counts.GetRow(row);
+        const double* tokenLogCounts = LogCounts.data() + static_cast<ui64>(row) * NumClasses;
+        for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
+            if (tokenCounts[clazz] == 0) {
+                //unseen in class word, adjust prior
+                classTokensCount[clazz] += TokenPrior;
+            }
+            logProbs[clazz] += tokenLogCounts[clazz];
         }
-        value += log(num);
     }
 
     //denum
-    value -= textLen * log(classTokensCount);
-
-    return value;
-}
-
-void TMultinomialOnlineNaiveBayes::AddText(ui32 classId, const TText& text)  {
-    auto& classCounts = Counts[classId];
-
-    for (const auto& [term, termCount] : text) {
-        KnownTokens.Insert(term);
-        classCounts[term] += termCount;
-        ClassTotalTokens[classId] += termCount;
-    }
-    ++ClassDocs[classId];
-}
-
-TVector<double> TMultinomialOnlineNaiveBayes::CalcFeatures(const TText& text, double classPrior, double tokenPrior) const  {
-    TVector<double> logProbs(NumClasses);
     for (ui32 clazz = 0; clazz < NumClasses; ++clazz) {
-        logProbs[clazz] = LogProb(Counts[clazz],
-                                  ClassDocs[clazz],
-                                  ClassTotalTokens[clazz],
-                                  text,
-                                  classPrior,
-                                  tokenPrior
-                                  );
+        logProbs[clazz] -= textLen * log(classTokensCount[clazz]);
     }
     Softmax(logProbs);
     return logProbs;
 }
 
-TVector<double> TMultinomialOnlineNaiveBayes::CalcFeaturesAndAddText(ui32 classId, const TText& text, double classPrior, double tokenPrior) {
-    auto result = CalcFeatures(text, classPrior, tokenPrior);
+TVector<double> TMultinomialOnlineNaiveBayes::CalcFeaturesAndAddText(ui32 classId, const TText& text) {
+    auto result = CalcFeatures(text);
     AddText(classId, text);
     return result;
 }
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "text_dataset.h"
+#include "token_class_counts.h"
 #include <util/system/types.h>
 #include <util/generic/fwd.h>
+#include <util/generic/ymath.h>
 
 namespace NCB {
 
@@ -12,33 +14,31 @@ namespace NCB {
     class TMultinomialOnlineNaiveBayes {
     public:
 
-        explicit TMultinomialOnlineNaiveBayes(ui32 numClasses)
+        explicit TMultinomialOnlineNaiveBayes(ui32 numClasses, double classPrior = 0.5, double tokenPrior = 0.5)
             : NumClasses(numClasses)
+            , ClassPrior(classPrior)
+            , TokenPrior(tokenPrior)
+            , LogTokenPrior(log(tokenPrior))
             , ClassDocs(numClasses)
             , ClassTotalTokens(numClasses)
             , Counts(numClasses) {
         }
 
-        TVector<double> CalcFeatures(const TText& text, double classPrior = 0.5, double tokenPrior = 0.5) const;
+        TVector<double> CalcFeatures(const TText& text) const;
 
-        TVector<double> CalcFeaturesAndAddText(ui32 classId, const TText& text, double classPrior = 0.5, double tokenPrior = 0.5);
+        TVector<double> CalcFeaturesAndAddText(ui32 classId, const TText& text);
 
         void AddText(ui32 classId, const TText& text);
 
-    private:
-
-        double LogProb(const TDenseHash<ui32, ui32>& freqTable,
-                       double classSamples,
-                       double classTokensCount,
-                       const TText& text,
-                       double classPrior,
-                       double tokenPrior) const;
-
     private:
         ui32 NumClasses;
+        double ClassPrior;
+        double TokenPrior;
+        double LogTokenPrior;
         TVector<ui32> ClassDocs;
         TVector<ui64> ClassTotalTokens;
-        TVector<TDenseHash<ui32, ui32>> Counts;
-        TDenseHashSet<ui32> KnownTokens;
+        TTokenClassCounts Counts;
+        // log(count + TokenPrior) for every entry of Counts, updated with counts
+        TVector<double> LogCounts;
     };
 }
@@ -2,9 +2,10 @@
 
 using namespace NCB;
 
-NCB::TText NCB::TokensToText(
+template <typename TTokenType>
+static TText TokensToTextImpl(
     const IDictionary& dictionary,
-    TConstArrayRef<TString> tokens) {
+    TConstArrayRef<TTokenType> tokens) {
 
     TText result;
     TVector<ui32> tokenIds;
@@ -15,12 +16,48 @@ NCB::TText NCB::TokensToText(
     return result;
 }
 
+NCB::TText NCB::TokensToText(
+    const IDictionary& dictionary,
+    TConstArrayRef<TString> tokens) {
+
+    return TokensToTextImpl(dictionary, tokens);
+}
+
+NCB::TText NCB::TokensToText(
+    const IDictionary& dictionary,
+    TConstArrayRef<TStringBuf> tokens) {
+
+    return TokensToTextImpl(dictionary, tokens);
+}
+
+TVector<TVector<TStringBuf>> NCB::TokenizeTexts(
+    TConstArrayRef<TStringBuf> texts,
+    const ITokenizer& tokenizer,
+    NPar::TLocalExecutor* localExecutor) {
+
+    TVector<TVector<TStringBuf>> tokenizedTexts(texts.size());
+    NPar::ParallelFor(*localExecutor, 0, texts.size(), [&] (int textIdx) {
+        tokenizer.TokenizeWithoutCopy(texts[textIdx], &tokenizedTexts[textIdx]);
+    });
+    return tokenizedTexts;
+}
+
 void TTextDataSetBuilder::AddText(const TStringBuf text) {
-    TVector<TString> tokens;
-    Tokenizer->Tokenize(text, &tokens);
+    TVector<TStringBuf> tokens;
+    Tokenizer->TokenizeWithoutCopy(text, &tokens);
     Texts.push_back(TokensToText(*Dictionary, tokens));
 }
 
+void TTextDataSetBuilder::AddTexts(TConstArrayRef<TStringBuf> texts, NPar::TLocalExecutor* localExecutor) {
+    const size_t firstTextIdx = Texts.size();
+    Texts.resize(firstTextIdx + texts.size());
+    NPar::ParallelFor(*localExecutor, 0, texts.size(), [&] (int textIdx) {
+        TVector<TStringBuf> tokens;
+        Tokenizer->TokenizeWithoutCopy(texts[textIdx], &tokens);
+        Texts[firstTextIdx + textIdx] = TokensToText(*Dictionary, tokens);
+    });
+}
+
 TIntrusivePtr<TTextDataSet> TTextDataSetBuilder::Build() {
     CB_ENSURE(!WasBuilt, "Build could be done only once");
     WasBuilt = true;
@@ -3,6 +3,9 @@
 #include "tokenizer.h"
 #include "text_dataset.h"
 #include "dictionary.h"
+
+#include <library/threading/local_executor/local_executor.h>
+
 #include <array>
 #include <util/generic/fwd.h>
 
@@ -13,6 +16,13 @@ namespace NCB {
     using TDictionaryPtr = TIntrusivePtr<IDictionary>;
 
     TText TokensToText(const IDictionary& dictionary, TConstArrayRef<TString> tokens);
+    TText TokensToText(const IDictionary& dictionary, TConstArrayRef<TStringBuf> tokens);
+
+    // Tokens are views into texts, they could be passed to dictionary builders' Add
+    TVector<TVector<TStringBuf>> TokenizeTexts(
+        TConstArrayRef<TStringBuf> texts,
+        const ITokenizer& tokenizer,
+        NPar::TLocalExecutor* localExecutor);
 
     inline TText TokenToText(const IDictionary& dictionary, TString token) {
         std::array<TString, 1> tmp{token};
@@ -30,6 +40,7 @@ namespace NCB {
         }
 
         void AddText(TStringBuf text);
+        void AddTexts(TConstArrayRef<TStringBuf> texts, NPar::TLocalExecutor* localExecutor);
 
         TIntrusivePtr<TTextDataSet> Build();
 
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "text_dataset.h"
+
+#include <library/containers/dense_hash/dense_hash.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+namespace NCB {
+
+    /*
+     * Token x class count matrix. Every known token owns a row of NumClasses counts,
+     * rows are stored contiguously in the order tokens were first added,
+     * so all class counts of a token are read with one lookup.
+     */
+    class TTokenClassCounts {
+    public:
+        static constexpr ui32 UnknownRow = Max<ui32>();
+
+    public:
+        explicit TTokenClassCounts(ui32 numClasses)
+            : NumClasses(numClasses) {
+        }
+
+        ui32 FindRow(TTokenId token) const {
+            auto rowIt = TokenToRow.find(token);
+            return rowIt != TokenToRow.end() ? rowIt->second : UnknownRow;
+        }
+
+        // allocates zero row for unknown token
+        ui32 GetOrAddRow(TTokenId token) {
+            auto rowIt = TokenToRow.find(token);
+            if (rowIt != TokenToRow.end()) {
+                return rowIt->second;
+            }
+            const ui32 row = RowCount();
+            TokenToRow[token] = row;
+            Counts.resize(Counts.size() + NumClasses, 0);
+            return row;
+        }
+
+        ui32 RowCount() const {
+            return TokenToRow.Size();
+        }
+
+        TConstArrayRef<ui32> GetRow(ui32 row) const {
+            return MakeArrayRef(Counts.data() + static_cast<ui64>(row) * NumClasses, NumClasses);
+        }
+
+        ui32& At(ui32 row, ui32 classId) {
+            return Counts[static_cast<ui64>(row) * NumClasses + classId];
+        }
+
+    private:
+        ui32 NumClasses;
+        TDenseHash<TTokenId, ui32> TokenToRow;
+        TVector<ui32> Counts;
+    };
+}
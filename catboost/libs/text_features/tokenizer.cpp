@@ -14,6 +14,13 @@ namespace {
                 tokens->push_back(TString(token));
             }
         }
+
+        void TokenizeWithoutCopy(TStringBuf inputString, TVector<TStringBuf>* tokens) const override {
+            tokens->clear();
+            for (const auto& token : StringSplitter(inputString).Split(' ')) {
+                tokens->push_back(token);
+            }
+        }
     };
 }
 
@@ -11,6 +11,8 @@ namespace NCB {
     class ITokenizer : public TThrRefBase {
     public:
         virtual void Tokenize(TStringBuf inputString, TVector<TString>* tokens) const = 0;
+        // tokens are views into inputString, nothing is allocated except tokens vector growth
+        virtual void TokenizeWithoutCopy(TStringBuf inputString, TVector<TStringBuf>* tokens) const = 0;
     };
 
     using TTokenizerPtr = TIntrusivePtr<ITokenizer>;
@@ -0,0 +1,92 @@
+#include <library/unittest/registar.h>
+#include <catboost/libs/text_features/hnsw_index.h>
+#include <catboost/libs/text_features/embedding_knn_features.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(HnswIndexTest) {
+
+    TVector<float> RandomVec(ui32 dim, TFastRng64* rand) {
+        TVector<float> res(dim);
+        for (auto& val : res) {
+            val = rand->GenRandReal1();
+        }
+        return res;
+    }
+
+    TVector<ui32> BruteForceNearest(const TVector<TVector<float>>& vectors, ui32 size, TConstArrayRef<float> query, ui32 neighborCount) {
+        TVector<std::pair<float, ui32>> distances;
+        for (ui32 id : xrange(size)) {
+            float distance = 0;
+            for (ui32 i : xrange(query.size())) {
+                distance += (vectors[id][i] - query[i]) * (vectors[id][i] - query[i]);
+            }
+            distances.emplace_back(distance, id);
+        }
+        Sort(distances);
+        TVector<ui32> result;
+        for (ui32 i : xrange(Min<size_t>(neighborCount, distances.size()))) {
+            result.push_back(distances[i].second);
+        }
+        return result;
+    }
+
+    Y_UNIT_TEST(TestRecall) {
+        const ui32 dim = 16;
+        const ui32 size = 3000;
+        const ui32 neighborCount = 10;
+        TFastRng64 rng(0);
+
+        TVector<TVector<float>> vectors;
+        THnswIndex index(dim);
+        for (ui32 id : xrange(size)) {
+            vectors.push_back(RandomVec(dim, &rng));
+            UNIT_ASSERT_VALUES_EQUAL(index.Add(vectors.back()), id);
+        }
+        UNIT_ASSERT_VALUES_EQUAL(index.Size(), size);
+
+        ui32 found = 0;
+        ui32 total = 0;
+        for (ui32 queryIdx : xrange(100)) {
+            Y_UNUSED(queryIdx);
+            const auto query = RandomVec(dim, &rng);
+            const auto nearest = index.FindNearest(query, neighborCount, 64);
+            UNIT_ASSERT_VALUES_EQUAL(nearest.size(), neighborCount);
+            for (ui32 i : xrange(1u, neighborCount)) {
+                UNIT_ASSERT(nearest[i - 1].first <= nearest[i].first);
+            }
+            const auto expected = BruteForceNearest(vectors, size, query, neighborCount);
+            for (const auto& [distance, id] : nearest) {
+                Y_UNUSED(distance);
+                found += IsIn(expected, id);
+            }
+            total += neighborCount;
+        }
+        UNIT_ASSERT_C(found >= 0.9 * total, found << " of " << total);
+    }
+
+    Y_UNIT_TEST(TestSmallIndexIsExact) {
+        const ui32 dim = 4;
+        TFastRng64 rng(1);
+        TVector<TVector<float>> vectors;
+        THnswIndex index(dim);
+        UNIT_ASSERT(index.FindNearest(RandomVec(dim, &rng), 3, 10).empty());
+        for (ui32 id : xrange(10)) {
+            Y_UNUSED(id);
+            vectors.push_back(RandomVec(dim, &rng));
+            index.Add(vectors.back());
+
+            const auto query = RandomVec(dim, &rng);
+            const auto nearest = index.FindNearest(query, 3, 20);
+            const auto expected = BruteForceNearest(vectors, vectors.size(), query, 3);
+            UNIT_ASSERT_VALUES_EQUAL(nearest.size(), expected.size());
+            for (ui32 i : xrange(nearest.size())) {
+                UNIT_ASSERT_VALUES_EQUAL(nearest[i].second, expected[i]);
+            }
+        }
+    }
+}
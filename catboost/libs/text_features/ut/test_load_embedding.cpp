@@ -95,4 +95,26 @@ Y_UNIT_TEST_SUITE(EmbeddingTest) {
         }
     }
 
+    Y_UNIT_TEST(TestMappedEmbeddingLoad) {
+        TFastRng64 rng(0);
+        TDictionaryBuilder builder{NTextProcessing::NDictionary::TDictionaryBuilderOptions{1, -1},  NTextProcessing::NDictionary::TDictionaryOptions()};
+        auto embedding = GenerateEmbedding(500, 50, &rng, &builder);
+        DumpEmbedding(embedding, "embedding.txt");
+        ConvertEmbeddingToBinary("embedding.txt", "embedding.bin");
+
+        auto dict = builder.FinishBuilding();
+        auto embeddingFromText = LoadEmbedding("embedding.txt", *dict);
+        auto embeddingFromBinary = LoadMappedEmbedding("embedding.bin", *dict);
+        UNIT_ASSERT_VALUES_EQUAL(embeddingFromText->Dim(), embeddingFromBinary->Dim());
+
+        TVector<float> textVec;
+        TVector<float> binaryVec;
+        for (const auto& [word, vec] : embedding) {
+            Y_UNUSED(vec);
+            const TText& text = TokenToText(*dict, word);
+            embeddingFromText->Apply(text, &textVec);
+            embeddingFromBinary->Apply(text, &binaryVec);
+            EnsureVecEqual(textVec, binaryVec);
+        }
+    }
 }
@@ -0,0 +1,142 @@
+#include <library/unittest/registar.h>
+#include <util/generic/hash.h>
+#include <util/generic/hash_set.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+#include <util/random/fast.h>
+#include <catboost/libs/text_features/bm25.h>
+#include <catboost/libs/text_features/helpers.h>
+#include <catboost/libs/text_features/naive_bayesian.h>
+using namespace NCB;
+
+
+Y_UNIT_TEST_SUITE(OnlineTextEstimatorsTest) {
+
+    TText RandomText(ui32 tokenCount, TFastRng64* rand) {
+        TText text;
+        const ui32 length = 1 + rand->Uniform(10);
+        for (ui32 i = 0; i < length; ++i) {
+            text[TTokenId(rand->Uniform(tokenCount))]++;
+        }
+        return text;
+    }
+
+    // straightforward implementations: per class hash tables, logs computed per token
+    struct TReferenceNaiveBayes {
+        explicit TReferenceNaiveBayes(ui32 numClasses)
+            : ClassDocs(numClasses)
+            , ClassTotalTokens(numClasses)
+            , Counts(numClasses) {
+        }
+
+        TVector<double> CalcFeatures(const TText& text) const {
+            const double prior = 0.5;
+            TVector<double> logProbs;
+            for (auto clazz : xrange(Counts.size())) {
+                double value = log(ClassDocs[clazz] + prior);
+                double classTokensCount = ClassTotalTokens[clazz];
+                classTokensCount += prior * (KnownTokens.size() + 1);
+                double textLen = 0;
+                for (const auto& [token, count] : text) {
+                    textLen += count;
+                    double num = prior;
+                    if (Counts[clazz].contains(ui32(token))) {
+                        num += Counts[clazz].at(ui32(token));
+                    } else {
+                        classTokensCount += prior;
+                    }
+                    value += log(num);
+                }
+                value -= textLen * log(classTokensCount);
+                logProbs.push_back(value);
+            }
+            Softmax(logProbs);
+            return logProbs;
+        }
+
+        void AddText(ui32 classId, const TText& text) {
+            for (const auto& [token, count] : text) {
+                KnownTokens.insert(ui32(token));
+                Counts[classId][ui32(token)] += count;
+                ClassTotalTokens[classId] += count;
+            }
+            ++ClassDocs[classId];
+        }
+
+        TVector<ui32> ClassDocs;
+        TVector<ui64> ClassTotalTokens;
+        TVector<THashMap<ui32, ui32>> Counts;
+        THashSet<ui32> KnownTokens;
+    };
+
+    struct TReferenceBM25 {
+        explicit TReferenceBM25(ui32 numClasses)
+            : ClassTotalTokens(numClasses)
+            , Freq(numClasses) {
+        }
+
+        TVector<double> CalcFeatures(const TText& text) const {
+            const double k = 1.5;
+            const double b = 0.75;
+            const ui32 numClasses = Freq.size();
+            TVector<double> scores(numClasses);
+            for (const auto& [token, textFreq] : text) {
+                Y_UNUSED(textFreq);
+                double classesWithTerm = 0;
+                for (const auto& classFreq : Freq) {
+                    classesWithTerm += classFreq.contains(ui32(token));
+                }
+                const double inverseClassFreq = Max<double>(
+                    log(numClasses - classesWithTerm + 0.5) - log(classesWithTerm + 0.5),
+                    1e-3);
+                const double meanClassLength = TotalTokens * 1.0 / numClasses;
+                for (ui32 clazz = 0; clazz < numClasses; ++clazz) {
+                    const double termFreq = Freq[clazz].contains(ui32(token)) ? Freq[clazz].at(ui32(token)) : 0;
+                    scores[clazz] += inverseClassFreq * termFreq * (k + 1)
+                        / (termFreq + k * (1.0 - b + b * meanClassLength / ClassTotalTokens[clazz]));
+                }
+            }
+            return scores;
+        }
+
+        void AddText(ui32 classId, const TText& text) {
+            for (const auto& [token, count] : text) {
+                Freq[classId][ui32(token)] += count;
+                ClassTotalTokens[classId] += count;
+                TotalTokens += count;
+            }
+        }
+
+        ui64 TotalTokens = 1;
+        TVector<ui64> ClassTotalTokens;
+        TVector<THashMap<ui32, ui32>> Freq;
+    };
+
+    template <class TEstimator, class TReference>
+    void CheckOnlineEstimator(TEstimator estimator, TReference reference, ui32 numClasses) {
+        TFastRng64 rand(0);
+        for (ui32 docIdx = 0; docIdx < 1000; ++docIdx) {
+            const auto text = RandomText(/*tokenCount*/ 100, &rand);
+            const ui32 classId = rand.Uniform(numClasses);
+            const auto expected = reference.CalcFeatures(text);
+            const auto actual = estimator.CalcFeaturesAndAddText(classId, text);
+            reference.AddText(classId, text);
+            UNIT_ASSERT_VALUES_EQUAL(expected.size(), actual.size());
+            for (auto i : xrange(expected.size())) {
+                UNIT_ASSERT_DOUBLES_EQUAL(expected[i], actual[i], 1e-9);
+            }
+        }
+    }
+
+    Y_UNIT_TEST(TestNaiveBayes) {
+        for (ui32 numClasses : {2, 5}) {
+            CheckOnlineEstimator(TMultinomialOnlineNaiveBayes(numClasses), TReferenceNaiveBayes(numClasses), numClasses);
+        }
+    }
+
+    Y_UNIT_TEST(TestBM25) {
+        for (ui32 numClasses : {2, 5}) {
+            CheckOnlineEstimator(TOnlineBM25(numClasses, 1e-3), TReferenceBM25(numClasses), numClasses);
+        }
+    }
+}
@@ -26,6 +26,7 @@
 
 #include <util/folder/tempdir.h>
 #include <util/generic/algorithm.h>
+#include <util/generic/cast.h>
 #include <util/generic/mapfindptr.h>
 #include <util/generic/scope.h>
 #include <util/generic/ymath.h>
@@ -175,6 +176,9 @@ struct TFoldContext {
 
     TRestorableFastRng64 Rand;
 
+    TMaybe<ui64> TrainingStructuresRamLimit; // CPU only, see TTrainModelInternalOptions
+    ui64 TrainingStructuresPeakRamUsage = 0; // max over trained batches
+
 public:
     TFoldContext(
         size_t foldIdx,
@@ -203,13 +207,13 @@ public:
         ui32 maxIterationsBatchSize,
         size_t globalMaxIteration,
         bool isErrorTrackerActive,
-        ELoggingLevel loggingLevel,
         IModelTrainer* modelTrainer,
         NPar::TLocalExecutor* localExecutor,
         TMaybe<ui32>* upToIteration) { // exclusive bound, if not inited - init from profile data
 
-        // don't output data from folds training
-        TSetLoggingSilent silentMode;
+        /* logging level is process-global and folds might be trained concurrently,
+         * so the caller is responsible for silencing output from folds training
+         */
 
         const size_t batchStartIteration = MetricValuesOnTest.size();
         const bool estimateUpToIteration = !upToIteration->Defined();
@@ -218,6 +222,9 @@ public:
         TTrainModelInternalOptions internalOptions;
         internalOptions.CalcMetricsOnly = true;
         internalOptions.ForceCalcEvalMetricOnEveryIteration = isErrorTrackerActive;
+        internalOptions.TrainingStructuresRamLimit = TrainingStructuresRamLimit;
+        ui64 batchPeakRamUsage = 0;
+        internalOptions.TrainingStructuresPeakRamUsage = &batchPeakRamUsage;
 
         THPTimer trainTimer;
         NCB::TFeatureEstimators featureEstimators;
@@ -238,12 +245,8 @@ public:
                 }
 
                 if (estimateUpToIteration) {
-                    TSetLogging inThisScope(loggingLevel);
-
                     batchIterationsTime += metricsAndTimeHistory.TimeHistory.back().IterationTime;
 
-                    TMaybe<ui32> prevUpToIteration = *upToIteration;
-
                     *upToIteration = EstimateUpToIteration(
                         iteration,
                         batchStartIteration,
@@ -252,11 +255,6 @@ public:
                         maxTimeSpentOnFixedCostRatio,
                         maxIterationsBatchSize,
                         globalMaxIteration);
-
-                    if (*upToIteration != prevUpToIteration) {
-                        CATBOOST_INFO_LOG << "CrossValidation: batch iterations upper bound estimate = "
-                            << **upToIteration << Endl;
-                    }
                 }
 
                 bool calcMetrics = DivisibleOrLastIteration(
@@ -300,10 +298,37 @@ public:
             TVector<TEvalResult*>{&LastUpdateEvalResult},
             /*metricsAndTimeHistory*/nullptr
         );
+        TrainingStructuresPeakRamUsage = Max(TrainingStructuresPeakRamUsage, batchPeakRamUsage);
     }
 };
 
 
+/* foldsRamLimit is shared by training structures of concurrently trained folds,
+ * foldPeakRamUsage is the peak usage accounted by the memory governor of an already trained fold
+ */
+static size_t GetMaxConcurrentlyTrainedFoldCount(
+    const TCrossValidationParams& cvParams,
+    size_t foldCount,
+    ui64 foldsRamLimit,
+    ui64 foldPeakRamUsage
+) {
+    size_t result = foldCount;
+    if (cvParams.MaxConcurrentFoldCount) {
+        result = Min<size_t>(result, cvParams.MaxConcurrentFoldCount);
+    }
+
+    if (foldsRamLimit != Max<ui64>()) {
+        const size_t fittingFoldCount = Max<size_t>(foldsRamLimit / Max<ui64>(foldPeakRamUsage, 1), 1);
+        if (fittingFoldCount < result) {
+            CATBOOST_WARNING_LOG << "Cross-validation folds are trained " << fittingFoldCount
+                << " at once to fit in used_ram_limit" << Endl;
+            result = fittingFoldCount;
+        }
+    }
+    return Max<size_t>(result, 1);
+}
+
+
 static void UpdatePermutationBlockSize(
     ETaskType taskType,
     TConstArrayRef<TTrainingDataProviders> foldsData,
@@ -541,6 +566,19 @@ void CrossValidate(
 
     ui32 globalMaxIteration = catBoostOptions.BoostingOptions->IterationCount;
 
+    /* Folds share quantized datasets, so training structures of all folds share one budget: the part of
+     * used_ram_limit left after the datasets are prepared. The first fold is trained alone and gets the whole
+     * budget, its peak usage accounted by the memory governor determines how many of other folds are trained
+     * concurrently, each of them in an equal share of the budget.
+     */
+    const ui64 foldsRamLimit = (taskType == ETaskType::CPU) ?
+        GetTrainingStructuresRamLimit(catBoostOptions.SystemOptions.Get())
+        : Max<ui64>();
+    if (taskType == ETaskType::CPU) {
+        foldContexts[0].TrainingStructuresRamLimit = foldsRamLimit;
+    }
+    TMaybe<size_t> maxConcurrentFoldCount; // inited after the first batch of the first fold
+
     TProfileInfo profile(globalMaxIteration);
 
     ui32 iteration = 0;
@@ -557,7 +595,8 @@ void CrossValidate(
          */
         TMaybe<ui32> batchEndIteration;
 
-        for (auto foldIdx : xrange(foldContexts.size())) {
+        TVector<double> foldBatchTimes(foldContexts.size()); // [foldIdx], in sec
+        auto trainFoldBatch = [&] (size_t foldIdx) {
             THPTimer timer;
 
             foldContexts[foldIdx].TrainBatch(
@@ -571,15 +610,66 @@ void CrossValidate(
                 cvParams.DevMaxIterationsBatchSize,
                 globalMaxIteration,
                 errorTracker.IsActive(),
-                catBoostOptions.LoggingLevel,
                 modelTrainerHolder.Get(),
                 &localExecutor,
                 &batchEndIteration);
 
+            foldBatchTimes[foldIdx] = timer.Passed();
+        };
+
+        {
+            // don't output data from folds training
+            TSetLoggingSilent silentMode;
+
+            // the first fold estimates batch size
+            trainFoldBatch(0);
             Y_ASSERT(batchEndIteration); // should be inited right after the first iteration of the first fold
+
+            if (!maxConcurrentFoldCount) {
+                maxConcurrentFoldCount = (taskType == ETaskType::CPU) ?
+                    GetMaxConcurrentlyTrainedFoldCount(
+                        cvParams,
+                        foldContexts.size() - 1,
+                        foldsRamLimit,
+                        foldContexts[0].TrainingStructuresPeakRamUsage)
+                    : 1;
+                CATBOOST_DEBUG_LOG << "CrossValidation: max concurrently trained folds count = "
+                    << *maxConcurrentFoldCount << Endl;
+                if ((taskType == ETaskType::CPU) && (foldsRamLimit != Max<ui64>())) {
+                    for (auto foldIdx : xrange<size_t>(1, foldContexts.size())) {
+                        foldContexts[foldIdx].TrainingStructuresRamLimit = foldsRamLimit / *maxConcurrentFoldCount;
+                    }
+                }
+            }
+
+            /* other folds share quantized data and have a fixed batch end, so on CPU they are trained
+             * concurrently (no more than maxConcurrentFoldCount at once): one fold is usually not enough
+             * to load all threads, and nested parallel loops of all folds are interleaved on the same
+             * local executor
+             */
+            for (size_t waveBegin = 1; waveBegin < foldContexts.size(); waveBegin += *maxConcurrentFoldCount) {
+                const size_t waveEnd = Min(waveBegin + *maxConcurrentFoldCount, foldContexts.size());
+                if (waveEnd - waveBegin > 1) {
+                    localExecutor.ExecRangeWithThrow(
+                        [&] (int foldIdx) {
+                            trainFoldBatch(foldIdx);
+                        },
+                        SafeIntegerCast<int>(waveBegin),
+                        SafeIntegerCast<int>(waveEnd),
+                        NPar::TLocalExecutor::WAIT_COMPLETE);
+                } else {
+                    trainFoldBatch(waveBegin);
+                }
+            }
+        }
+
+        CATBOOST_INFO_LOG << "CrossValidation: batch iterations upper bound estimate = "
+            << *batchEndIteration << Endl;
+
+        for (auto foldIdx : xrange(foldContexts.size())) {
             CATBOOST_INFO_LOG << "CrossValidation: Processed batch of iterations [" << batchStartIteration
                 << ',' << *batchEndIteration << ") for fold " << foldIdx << '/' << cvParams.FoldCount
-                << " in " << FloatToString(timer.Passed(), PREC_NDIGITS, 2) << " sec" << Endl;
+                << " in " << FloatToString(foldBatchTimes[foldIdx], PREC_NDIGITS, 2) << " sec" << Endl;
         }
 
         while (true) {
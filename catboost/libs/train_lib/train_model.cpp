@@ -292,8 +292,17 @@ static void InitializeSamplingStructures(
     const bool isPairwiseScoring = IsPairwiseScoring(ctx->Params.LossFunctionDescription->GetLossFunction());
     const int defaultCalcStatsObjBlockSize = static_cast<int>(ctx->Params.ObliviousTreeOptions->DevScoreCalcObjBlockSize);
 
+    // pairwise stats for sparse features are calculated densely
+    const bool hasSparseFeatures = !isPairwiseScoring && data.Learn->ObjectsData->HasSparseFloatFeatures();
+
     if (ctx->UseTreeLevelCaching()) {
-        ctx->SmallestSplitSideDocs.Create(ctx->LearnProgress.Folds, isPairwiseScoring, defaultCalcStatsObjBlockSize);
+        ctx->SmallestSplitSideDocs.Create(
+            ctx->LearnProgress.Folds,
+            isPairwiseScoring,
+            defaultCalcStatsObjBlockSize,
+            /*sampleRate*/ 1.0f,
+            hasSparseFeatures
+        );
         ctx->PrevTreeLevelStats.Create(
             ctx->LearnProgress.Folds,
             CountNonCtrBuckets(
@@ -306,8 +315,28 @@ static void InitializeSamplingStructures(
         ctx->LearnProgress.Folds,
         isPairwiseScoring,
         defaultCalcStatsObjBlockSize,
-        GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig)
+        GetBernoulliSampleRate(ctx->Params.ObliviousTreeOptions->BootstrapConfig),
+        hasSparseFeatures
     ); // TODO(espetrov): create only if sample rate < 1
+
+    ctx->UpdateMemoryUsage();
+    ctx->OutputMemoryUsage();
+}
+
+static void CheckExclusiveFeaturesBundlesStatsSize(
+    const TQuantizedForCPUObjectsDataProvider& objectsData,
+    ui32 depth,
+    ui32 approxDimension
+) {
+    for (const auto& bundle : objectsData.GetExclusiveFeatureBundlesMetaData()) {
+        const ui64 statsCount = (ui64(bundle.GetBinCount()) << depth) * approxDimension;
+        CB_ENSURE(
+            statsCount <= NCatboostOptions::MaxExclusiveFeaturesBundleStatsCount,
+            "Exclusive features bundle with " << bundle.GetBinCount() << " buckets is too big for depth "
+            << depth << " and approx dimension " << approxDimension
+            << ": decrease dev_efb_max_buckets or depth"
+        );
+    }
 }
 
 static void LogThatStoppingOccured(const TErrorTracker& errorTracker) {
@@ -430,7 +459,7 @@ static void Train(
         }
     }
 
-    ctx->SaveProgress();
+    ctx->SaveProgress(/*waitForCompletion*/ true);
 
     if (hasTest) {
         (*testMultiApprox) = ctx->LearnProgress.TestApprox;
@@ -538,13 +567,21 @@ namespace {
             if (ctx.LearnProgress.ApproxDimension > 1) {
                 ctx.LearnProgress.LabelConverter = labelConverter;
             }
+            CheckExclusiveFeaturesBundlesStatsSize(
+                *trainingDataForCpu.Learn->ObjectsData,
+                ctx.Params.ObliviousTreeOptions->MaxDepth.Get(),
+                SafeIntegerCast<ui32>(ctx.LearnProgress.ApproxDimension)
+            );
 
             ctx.OutputMeta();
 
             ctx.LearnProgress.FloatFeatures = CreateFloatFeatures(quantizedFeaturesInfo);
             ctx.LearnProgress.CatFeatures = CreateCatFeatures(quantizedFeaturesInfo);
 
-            ctx.InitContext(trainingDataForCpu);
+            const ui64 trainingStructuresRamLimit = internalOptions.TrainingStructuresRamLimit.Defined() ?
+                *internalOptions.TrainingStructuresRamLimit
+                : GetTrainingStructuresRamLimit(ctx.Params.SystemOptions.Get());
+            ctx.InitContext(trainingDataForCpu, trainingStructuresRamLimit);
 
             DumpMemUsage("Before start train");
 
@@ -573,6 +610,9 @@ namespace {
             if (metricsAndTimeHistory) {
                 *metricsAndTimeHistory = ctx.LearnProgress.MetricsAndTimeHistory;
             }
+            if (internalOptions.TrainingStructuresPeakRamUsage) {
+                *internalOptions.TrainingStructuresPeakRamUsage = ctx.GetPeakMemoryUsage();
+            }
 
             if (internalOptions.CalcMetricsOnly) {
                 return;
@@ -33,6 +33,15 @@ struct TTrainModelInternalOptions {
 
     // force it even if overfitting detector is disabled, used in Cross-Validation
     bool ForceCalcEvalMetricOnEveryIteration = false;
+
+    /* Part of used_ram_limit available to training structures (CPU only), used in Cross-Validation
+     * to share one budget between concurrently trained folds.
+     * If not defined, it is used_ram_limit minus memory used by the process when the training starts.
+     */
+    TMaybe<ui64> TrainingStructuresRamLimit;
+
+    // if not nullptr, peak memory usage of training structures is returned here (CPU only)
+    ui64* TrainingStructuresPeakRamUsage = nullptr;
 };
 
 
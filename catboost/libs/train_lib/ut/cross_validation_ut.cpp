@@ -0,0 +1,125 @@
+#include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/logging/logging.h>
+#include <catboost/libs/train_lib/cross_validation.h>
+
+#include <library/unittest/registar.h>
+
+#include <util/folder/tempdir.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+
+
+using namespace NCB;
+
+
+static TDataProviderPtr RandomFloatPool(ui32 objectCount, ui32 featureCount, ui64 seed) {
+    TFastRng<ui64> prng(seed);
+
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                featureCount,
+                TVector<ui32>{},
+                TVector<ui32>{},
+                TVector<TString>{}
+            );
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            for (auto featureIdx : xrange(featureCount)) {
+                TVector<float> feature(objectCount);
+                for (auto& value : feature) {
+                    value = prng.GenRandReal1();
+                }
+                visitor->AddFloatFeature(
+                    featureIdx,
+                    TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(feature))
+                );
+            }
+
+            TVector<float> target(objectCount);
+            for (auto& value : target) {
+                value = prng.GenRandReal1();
+            }
+            visitor->AddTarget(target);
+
+            visitor->Finish();
+        }
+    );
+}
+
+static TVector<TCVResult> RunCrossValidation(
+    TDataProviderPtr data,
+    ui32 maxConcurrentFoldCount,
+    const TString& usedRamLimit = "unlimited"
+) {
+    TTempDir trainDir;
+
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 30);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("thread_count", 4);
+    params.InsertValue("used_ram_limit", usedRamLimit);
+    params.InsertValue("train_dir", trainDir.Name());
+
+    TCrossValidationParams cvParams;
+    cvParams.FoldCount = 4;
+    cvParams.PartitionRandSeed = 2;
+    cvParams.MaxConcurrentFoldCount = maxConcurrentFoldCount;
+    cvParams.DevMaxIterationsBatchSize = 7; // to have several batches
+
+    TVector<TCVResult> results;
+    CrossValidate(params, Nothing(), Nothing(), data, cvParams, &results);
+    return results;
+}
+
+static void AssertSameResults(const TVector<TCVResult>& results, const TVector<TCVResult>& expectedResults) {
+    UNIT_ASSERT_VALUES_EQUAL(results.size(), expectedResults.size());
+    for (auto metricIdx : xrange(results.size())) {
+        const auto& result = results[metricIdx];
+        const auto& expectedResult = expectedResults[metricIdx];
+
+        UNIT_ASSERT_VALUES_EQUAL(result.Metric, expectedResult.Metric);
+        UNIT_ASSERT_VALUES_EQUAL(result.Iterations, expectedResult.Iterations);
+        UNIT_ASSERT_VALUES_EQUAL(result.AverageTrain, expectedResult.AverageTrain);
+        UNIT_ASSERT_VALUES_EQUAL(result.StdDevTrain, expectedResult.StdDevTrain);
+        UNIT_ASSERT_VALUES_EQUAL(result.AverageTest, expectedResult.AverageTest);
+        UNIT_ASSERT_VALUES_EQUAL(result.StdDevTest, expectedResult.StdDevTest);
+    }
+}
+
+static TString CapturedLog;
+
+static void CaptureLog(const char* data, size_t length) {
+    CapturedLog.append(data, length);
+}
+
+
+Y_UNIT_TEST_SUITE(CrossValidationTests) {
+    Y_UNIT_TEST(ConcurrentFoldsTrainingIsSameAsSequential) {
+        TDataProviderPtr data = RandomFloatPool(500, 3, 20190315);
+
+        const TVector<TCVResult> expectedResults = RunCrossValidation(data, 1);
+
+        for (ui32 maxConcurrentFoldCount : {0u, 2u}) {
+            AssertSameResults(RunCrossValidation(data, maxConcurrentFoldCount), expectedResults);
+        }
+    }
+
+    // nothing is left for training structures, so folds are trained one by one
+    Y_UNIT_TEST(FoldsAreTrainedSequentiallyIfRamLimitIsExhausted) {
+        TDataProviderPtr data = RandomFloatPool(500, 3, 20190316);
+
+        const TVector<TCVResult> expectedResults = RunCrossValidation(data, 1);
+
+        CapturedLog.clear();
+        SetCustomLoggingFunction(CaptureLog, CaptureLog);
+        const TVector<TCVResult> results = RunCrossValidation(data, 0, "1kb");
+        RestoreOriginalLogger();
+
+        UNIT_ASSERT(CapturedLog.Contains("Cross-validation folds are trained 1 at once to fit in used_ram_limit"));
+        AssertSameResults(results, expectedResults);
+    }
+}
@@ -1,15 +1,21 @@
 
+#include <catboost/libs/algo/data.h>
 #include <catboost/libs/data_new/data_provider_builders.h>
+#include <catboost/libs/helpers/restorable_rng.h>
 #include <catboost/libs/helpers/vector_helpers.h>
+#include <catboost/libs/logging/logging.h>
 #include <catboost/libs/model/model.h>
+#include <catboost/libs/options/plain_options_helper.h>
 #include <catboost/libs/train_lib/train_model.h>
 
+#include <library/threading/local_executor/local_executor.h>
 #include <library/unittest/registar.h>
 
 #include <util/folder/tempdir.h>
 #include <util/generic/array_ref.h>
 #include <util/generic/xrange.h>
 #include <util/random/fast.h>
+#include <util/string/cast.h>
 
 #include <limits>
 
@@ -66,6 +72,161 @@ static TDataProviderPtr SmallFloatPool() {
     );
 }
 
+static TDataProviderPtr RandomPoolWithCatFeatures(ui32 objectCount, ui64 seed) {
+    TFastRng<ui64> prng(seed);
+
+    return CreateDataProvider(
+        [&] (IRawFeaturesOrderDataVisitor* visitor) {
+            TDataMetaInfo metaInfo;
+            metaInfo.HasTarget = true;
+            metaInfo.FeaturesLayout = MakeIntrusive<TFeaturesLayout>(
+                (ui32)3,
+                TVector<ui32>{1, 2},
+                TVector<ui32>{},
+                TVector<TString>{}
+            );
+
+            visitor->Start(metaInfo, objectCount, EObjectsOrder::Undefined, {});
+
+            TVector<float> floatFeature(objectCount);
+            FillWithRandom(floatFeature, prng);
+            visitor->AddFloatFeature(
+                0,
+                TMaybeOwningConstArrayHolder<float>::CreateOwning(std::move(floatFeature))
+            );
+            for (ui32 catFeatureIdx : {1, 2}) {
+                // enough unique values to be used in CTRs, not one-hot encoded
+                TVector<TString> catFeature(objectCount);
+                for (auto& value : catFeature) {
+                    value = ToString(prng.Uniform(10));
+                }
+                visitor->AddCatFeature(catFeatureIdx, TConstArrayRef<TString>(catFeature));
+            }
+
+            TVector<float> target(objectCount);
+            FillWithRandom(target, prng);
+            visitor->AddTarget(target);
+
+            visitor->Finish();
+        }
+    );
+}
+
+static TString CapturedLog;
+
+static void CaptureLog(const char* data, size_t length) {
+    CapturedLog.append(data, length);
+}
+
+static TFullModel TrainWithRamLimit(TDataProviderPtr data, const TString& usedRamLimit) {
+    TTempDir trainDir;
+
+    NJson::TJsonValue params;
+    params.InsertValue("iterations", 20);
+    params.InsertValue("random_seed", 1);
+    params.InsertValue("boosting_type", "Plain");
+    // one learning fold so that it can't be dropped to fit the limit
+    params.InsertValue("permutation_count", 2);
+    params.InsertValue("used_ram_limit", usedRamLimit);
+    params.InsertValue("train_dir", trainDir.Name());
+
+    TDataProviders dataProviders;
+    dataProviders.Learn = data;
+
+    TFullModel model;
+    TEvalResult evalResult;
+    TrainModel(params, nullptr, {}, {}, std::move(dataProviders), "", &model, {&evalResult});
+    return model;
+}
+
+/* Trains with the budget for training structures set like for cross-validation folds.
+ * Logging is silenced like in cross-validation, warnings must still be printed.
+ */
+static TFullModel TrainWithTrainingStructuresRamLimit(
+    TDataProviderPtr data,
+    ui32 permutationCount,
+    TMaybe<ui64> trainingStructuresRamLimit,
+    ui64* peakRamUsage
+) {
+    TTempDir trainDir;
+
+    NJson::TJsonValue plainParams;
+    plainParams.InsertValue("iterations", 20);
+    plainParams.InsertValue("random_seed", 1);
+    plainParams.InsertValue("boosting_type", "Plain");
+    plainParams.InsertValue("permutation_count", permutationCount);
+    plainParams.InsertValue("thread_count", 4);
+    plainParams.InsertValue("logging_level", "Silent");
+    plainParams.InsertValue("train_dir", trainDir.Name());
+
+    NJson::TJsonValue jsonParams;
+    NJson::TJsonValue outputJsonParams;
+    NCatboostOptions::PlainJsonToOptions(plainParams, &jsonParams, &outputJsonParams);
+    NCatboostOptions::TCatBoostOptions catBoostOptions(NCatboostOptions::LoadOptions(jsonParams));
+    NCatboostOptions::TOutputFilesOptions outputOptions;
+    outputOptions.Load(outputJsonParams);
+
+    NPar::TLocalExecutor localExecutor;
+    localExecutor.RunAdditionalThreads(3);
+    TRestorableFastRng64 rand(1);
+    TLabelConverter labelConverter;
+
+    TDataProviders pools;
+    pools.Learn = data;
+    TTrainingDataProviders trainingData = GetTrainingData(
+        std::move(pools),
+        /*bordersFile*/ Nothing(),
+        /*ensureConsecutiveLearnFeaturesDataForCpu*/ true,
+        /*allowWriteFiles*/ false,
+        /*quantizedFeaturesInfo*/ nullptr,
+        &catBoostOptions,
+        &labelConverter,
+        &localExecutor,
+        &rand);
+
+    TTrainModelInternalOptions internalOptions;
+    internalOptions.TrainingStructuresRamLimit = trainingStructuresRamLimit;
+    internalOptions.TrainingStructuresPeakRamUsage = peakRamUsage;
+
+    TSetLoggingSilent silentMode;
+    TFullModel model;
+    THolder<IModelTrainer> modelTrainer(TTrainerFactory::Construct(ETaskType::CPU));
+    modelTrainer->TrainModel(
+        internalOptions,
+        jsonParams,
+        outputOptions,
+        /*objectiveDescriptor*/ Nothing(),
+        /*evalMetricDescriptor*/ Nothing(),
+        /*onEndIterationCallback*/ Nothing(),
+        TFeatureEstimators(),
+        std::move(trainingData),
+        labelConverter,
+        &localExecutor,
+        &rand,
+        &model,
+        /*evalResultPtrs*/ {},
+        /*metricsAndTimeHistory*/ nullptr);
+    return model;
+}
+
+static void AssertSameTrees(const TFullModel& model, const TFullModel& expectedModel) {
+    const auto& trees = model.ObliviousTrees;
+    const auto& expectedTrees = expectedModel.ObliviousTrees;
+    UNIT_ASSERT_EQUAL(trees.TreeSplits, expectedTrees.TreeSplits);
+    UNIT_ASSERT_VALUES_EQUAL(trees.LeafValues.size(), expectedTrees.LeafValues.size());
+    for (auto i : xrange(trees.LeafValues.size())) {
+        UNIT_ASSERT_DOUBLES_EQUAL(trees.LeafValues[i], expectedTrees.LeafValues[i], 1e-9);
+    }
+}
+
+static size_t CountOccurrences(const TString& text, TStringBuf pattern) {
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != TString::npos; pos = text.find(pattern, pos + 1)) {
+        ++count;
+    }
+    return count;
+}
+
 Y_UNIT_TEST_SUITE(TrainModelTests) {
     Y_UNIT_TEST(TrainWithoutNansTestWithNans) {
         // Train doesn't have NaNs, so TrainModel implicitly forbids them (during quantization), but
@@ -247,4 +408,79 @@ Y_UNIT_TEST_SUITE(TrainModelTests) {
 
         UNIT_ASSERT_VALUES_UNEQUAL(predictions[0][0], predictions[1][0]);
     }
+
+    Y_UNIT_TEST(OnlineCtrsAreKeptIfRamLimitIsUnreachable) {
+        const TStringBuf unreachableLimitWarning = "even without online CTRs cache";
+
+        TDataProviderPtr data = RandomPoolWithCatFeatures(1000, 20190418);
+
+        CapturedLog.clear();
+        SetCustomLoggingFunction(CaptureLog, CaptureLog);
+        const TFullModel unlimitedModel = TrainWithRamLimit(data, "unlimited");
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(CapturedLog, unreachableLimitWarning), 0);
+
+        // training structures don't fit even without online CTRs, so they are not evicted in each iteration
+        CapturedLog.clear();
+        const TFullModel limitedModel = TrainWithRamLimit(data, "1kb");
+        RestoreOriginalLogger();
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(CapturedLog, unreachableLimitWarning), 1);
+
+        // RAM limit degrades only caching, trained models must be the same
+        AssertSameTrees(limitedModel, unlimitedModel);
+    }
+
+    Y_UNIT_TEST(OnlineCtrsAreEvictedToFitRamLimit) {
+        const TStringBuf evictionWarning = "Online CTRs cache is evicted";
+        const TStringBuf unreachableLimitWarning = "even without online CTRs cache";
+
+        TDataProviderPtr data = RandomPoolWithCatFeatures(1000, 20190418);
+
+        // one learning fold so that it can't be dropped to fit the limit
+        ui64 peakRamUsage = 0;
+        CapturedLog.clear();
+        SetCustomLoggingFunction(CaptureLog, CaptureLog);
+        const TFullModel unlimitedModel = TrainWithTrainingStructuresRamLimit(data, 2, Nothing(), &peakRamUsage);
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(CapturedLog, evictionWarning), 0);
+
+        // peak usage is reached with online CTRs cached, without them the usage fits
+        CapturedLog.clear();
+        ui64 limitedPeakRamUsage = 0;
+        const TFullModel limitedModel = TrainWithTrainingStructuresRamLimit(
+            data,
+            2,
+            peakRamUsage - 1,
+            &limitedPeakRamUsage);
+        RestoreOriginalLogger();
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(CapturedLog, evictionWarning), 1);
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(CapturedLog, unreachableLimitWarning), 0);
+
+        // evicted CTRs are recomputed, trained models must be the same
+        AssertSameTrees(limitedModel, unlimitedModel);
+    }
+
+    Y_UNIT_TEST(LearningFoldsCountIsReducedToFitRamLimit) {
+        const TStringBuf foldsReductionWarning = "Learning folds count is reduced to 1";
+
+        TDataProviderPtr data = RandomPoolWithCatFeatures(1000, 20190419);
+
+        // 3 learning folds
+        ui64 peakRamUsage = 0;
+        CapturedLog.clear();
+        SetCustomLoggingFunction(CaptureLog, CaptureLog);
+        TrainWithTrainingStructuresRamLimit(data, 4, Nothing(), &peakRamUsage);
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(CapturedLog, foldsReductionWarning), 0);
+
+        // less than two learning folds with the averaging fold
+        CapturedLog.clear();
+        ui64 limitedPeakRamUsage = 0;
+        const TFullModel limitedModel = TrainWithTrainingStructuresRamLimit(
+            data,
+            4,
+            peakRamUsage / 3,
+            &limitedPeakRamUsage);
+        RestoreOriginalLogger();
+        UNIT_ASSERT_VALUES_EQUAL(CountOccurrences(CapturedLog, foldsReductionWarning), 1);
+        UNIT_ASSERT(limitedPeakRamUsage < peakRamUsage);
+        UNIT_ASSERT_VALUES_EQUAL(limitedModel.ObliviousTrees.TreeSizes.size(), 20);
+    }
 }
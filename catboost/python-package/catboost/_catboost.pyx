@@ -418,6 +418,12 @@ cdef extern from "catboost/libs/data_new/visitor.h" namespace "NCB":
         void AddFloatFeature(ui32 flatFeatureIdx, TMaybeOwningConstArrayHolder[float] features) except +ProcessException
         void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef[TString] feature) except +ProcessException
         void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef[TStringBuf] feature) except +ProcessException
+        void AddCatFeature(ui32 flatFeatureIdx, TConstArrayRef[i64] feature) except +ProcessException
+        void AddCatFeature(
+            ui32 flatFeatureIdx,
+            TConstArrayRef[TString] uniqueValues,
+            TConstArrayRef[ui32] valueIndices
+        ) except +ProcessException
 
         void AddCatFeature(ui32 flatFeatureIdx, TMaybeOwningConstArrayHolder[ui32] features) except +ProcessException
 
@@ -516,6 +522,7 @@ cdef extern from "catboost/libs/model/model.h":
 
     cdef void OutputModel(const TFullModel& model, const TString& modelFile) except +ProcessException
     cdef TFullModel ReadModel(const TString& modelFile, EModelType format) nogil except +ProcessException
+    cdef TFullModel ReadModelFromMappedFile(const TString& modelFile) nogil except +ProcessException
     cdef TString SerializeModel(const TFullModel& model) except +ProcessException
     cdef TFullModel DeserializeModel(const TString& serializeModelString) nogil except +ProcessException
     cdef TVector[TString] GetModelUsedFeaturesNames(const TFullModel& model) except +ProcessException
@@ -614,6 +621,7 @@ cdef extern from "catboost/libs/options/cross_validation_params.h":
         bool_t Stratified
         double MaxTimeSpentOnFixedCostRatio
         ui32 DevMaxIterationsBatchSize
+        ui32 MaxConcurrentFoldCount
 
 cdef extern from "catboost/libs/options/check_train_options.h":
     cdef void CheckFitParams(
@@ -678,6 +686,11 @@ cdef extern from "catboost/libs/algo/apply.h":
             TVector[double]* flatApprox,
             TVector[TVector[double]]* approx
         ) nogil except +ProcessException
+        void AddTreesToFlatApprox(
+            int begin,
+            int end,
+            TArrayRef[double] flatApprox
+        ) nogil except +ProcessException
 
     cdef cppclass TLeafIndexCalcerOnPool:
         TLeafIndexCalcerOnPool(
@@ -711,6 +724,41 @@ cdef extern from "catboost/libs/algo/apply.h":
         int threadCount
     ) nogil except +ProcessException
             
+    cdef TVector[TVector[double]] PredictBinaryClassesWithEarlyExit(
+        const TFullModel& model,
+        const TDataProvider& data,
+        bool_t verbose,
+        int begin,
+        int end,
+        int threadCount
+    ) nogil except +ProcessException
+
+    cdef TVector[TVector[double]] ApplyModelMultiOnDenseFeatures(
+        const TFullModel& model,
+        const float* features,
+        size_t objectCount,
+        size_t featureCount,
+        size_t objectStride,
+        size_t featureStride,
+        const EPredictionType predictionType,
+        int begin,
+        int end,
+        int threadCount
+    ) nogil except +ProcessException
+
+    cdef TVector[TVector[double]] ApplyModelMultiOnDenseFeatures(
+        const TFullModel& model,
+        const double* features,
+        size_t objectCount,
+        size_t featureCount,
+        size_t objectStride,
+        size_t featureStride,
+        const EPredictionType predictionType,
+        int begin,
+        int end,
+        int threadCount
+    ) nogil except +ProcessException
+
     cdef TVector[ui32] CalcLeafIndexesMulti(
         const TFullModel& model,
         TIntrusivePtr[TObjectsDataProvider] objectsData,
@@ -1534,6 +1582,65 @@ cdef get_cat_factor_bytes_representation(
         )
 
 
+cdef _add_cat_feature_from_pd_categorical(
+    ui32 flat_feature_idx,
+    column_data,
+    IRawFeaturesOrderDataVisitor* builder_visitor
+):
+    """
+        each category is converted to string once, objects are specified by category codes
+    """
+    cdef TString factor_string
+    cdef TVector[TString] unique_values
+    cdef np.ndarray value_indices
+    cdef ui32 doc_count = len(column_data)
+    cdef ui32 category_idx
+
+    codes = column_data.cat.codes.values
+    if doc_count > 0 and codes.min() < 0:
+        doc_idx = np.argmax(codes < 0)
+        # raises error for missing value
+        get_cat_factor_bytes_representation(doc_idx, flat_feature_idx, column_data.iloc[doc_idx], &factor_string)
+
+    categories = column_data.cat.categories
+    is_category_used = np.bincount(codes, minlength=len(categories)) > 0
+    unique_values.resize(len(categories))
+    for category_idx in range(len(categories)):
+        if not is_category_used[category_idx]:
+            continue
+        try:
+            get_id_object_bytes_string_representation(categories[category_idx], &unique_values[category_idx])
+        except CatBoostError:
+            get_cat_factor_bytes_representation(
+                np.argmax(codes == category_idx),
+                flat_feature_idx,
+                categories[category_idx],
+                &factor_string
+            )
+
+    value_indices = np.ascontiguousarray(codes, dtype=np.uint32)
+    builder_visitor[0].AddCatFeature(
+        flat_feature_idx,
+        <TConstArrayRef[TString]>unique_values,
+        TConstArrayRef[ui32](<ui32*>value_indices.data, doc_count)
+    )
+
+
+cdef _add_cat_feature_from_integers(
+    ui32 flat_feature_idx,
+    np.ndarray column_values,
+    IRawFeaturesOrderDataVisitor* builder_visitor
+):
+    """
+        integers are hashed in bulk, without conversion of each value to python string
+    """
+    cdef np.ndarray values = np.ascontiguousarray(column_values, dtype=np.int64)
+    builder_visitor[0].AddCatFeature(
+        flat_feature_idx,
+        TConstArrayRef[i64](<i64*>values.data, len(values))
+    )
+
+
 # returns new data holders array
 cdef object _set_features_order_data_pd_data_frame(
     data_frame,
@@ -1562,7 +1669,14 @@ cdef object _set_features_order_data_pd_data_frame(
         column_type_is_pandas_Categorical = column_data.dtype.name == 'category'
         if not column_type_is_pandas_Categorical:
             column_values = column_data.values
-        if is_cat_feature_mask[flat_feature_idx]:
+        if is_cat_feature_mask[flat_feature_idx] and column_type_is_pandas_Categorical:
+            _add_cat_feature_from_pd_categorical(flat_feature_idx, column_data, builder_visitor)
+        elif (is_cat_feature_mask[flat_feature_idx] and
+              np.issubdtype(column_values.dtype, np.integer) and
+              column_values.dtype != np.uint64
+            ):
+            _add_cat_feature_from_integers(flat_feature_idx, column_values, builder_visitor)
+        elif is_cat_feature_mask[flat_feature_idx]:
             cat_factor_data.clear()
             for doc_idx in range(doc_count):
                 get_cat_factor_bytes_representation(
@@ -2534,6 +2648,69 @@ cdef class _CatBoost:
             )
         return _convert_to_visible_labels(predictionType, pred, thread_count, self.__model)
 
+    cpdef _base_predict_classes_with_early_exit(self, _PoolBase pool, int ntree_start, int ntree_end,
+                                                 int thread_count, bool_t verbose):
+        cdef TVector[TVector[double]] pred
+        thread_count = UpdateThreadCount(thread_count);
+        with nogil:
+            pred = PredictBinaryClassesWithEarlyExit(
+                dereference(self.__model),
+                dereference(pool.__pool.Get()),
+                verbose,
+                ntree_start,
+                ntree_end,
+                thread_count
+            )
+        return _convert_to_visible_labels(EPredictionType_Class, pred, thread_count, self.__model)
+
+    cpdef _base_predict_on_dense_features(self, data, str prediction_type, int ntree_start, int ntree_end,
+                                          int thread_count, bool_t convert_to_visible_labels):
+        """
+        data - 2d np.ndarray with dtype float32 or float64 and positive strides, it is used without copying
+        """
+        cdef const float [:,:] float_data
+        cdef const double [:,:] double_data
+        cdef TVector[TVector[double]] pred
+        cdef EPredictionType predictionType = PyPredictionType(prediction_type).predictionType
+        cdef size_t object_count = data.shape[0]
+        cdef size_t feature_count = data.shape[1]
+        thread_count = UpdateThreadCount(thread_count);
+        if object_count == 0 or feature_count == 0:
+            raise CatBoostError('Data to predict on should have at least one object and one feature')
+        if data.dtype == np.float32:
+            float_data = data
+            with nogil:
+                pred = ApplyModelMultiOnDenseFeatures(
+                    dereference(self.__model),
+                    &float_data[0, 0],
+                    object_count,
+                    feature_count,
+                    float_data.strides[0] // sizeof(float),
+                    float_data.strides[1] // sizeof(float),
+                    predictionType,
+                    ntree_start,
+                    ntree_end,
+                    thread_count
+                )
+        else:
+            double_data = data
+            with nogil:
+                pred = ApplyModelMultiOnDenseFeatures(
+                    dereference(self.__model),
+                    &double_data[0, 0],
+                    object_count,
+                    feature_count,
+                    double_data.strides[0] // sizeof(double),
+                    double_data.strides[1] // sizeof(double),
+                    predictionType,
+                    ntree_start,
+                    ntree_end,
+                    thread_count
+                )
+        if convert_to_visible_labels:
+            return _convert_to_visible_labels(predictionType, pred, thread_count, self.__model)
+        return _2d_vector_of_double_to_np_array(pred)
+
     cpdef _staged_predict_iterator(self, _PoolBase pool, str prediction_type, int ntree_start, int ntree_end, int eval_period, int thread_count, verbose):
         thread_count = UpdateThreadCount(thread_count);
         stagedPredictIterator = _StagedPredictIterator(prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
@@ -2661,6 +2838,11 @@ cdef class _CatBoost:
         tmp_model = ReadModel(to_arcadia_string(model_file), modelType)
         self.__model.Swap(tmp_model)
 
+    cpdef _load_mapped_model(self, model_file):
+        cdef TFullModel tmp_model
+        tmp_model = ReadModelFromMappedFile(to_arcadia_string(model_file))
+        self.__model.Swap(tmp_model)
+
     cpdef _save_model(self, output_file, format, export_parameters, _PoolBase pool):
         cdef EModelType modelType = string_to_model_type(format)
 
@@ -2809,7 +2991,7 @@ cdef class _MetadataHashProxy:
 
 cpdef _cv(dict params, _PoolBase pool, int fold_count, bool_t inverted, int partition_random_seed,
           bool_t shuffle, bool_t stratified, bool_t as_pandas, double max_time_spent_on_fixed_cost_ratio,
-          int dev_max_iterations_batch_size):
+          int dev_max_iterations_batch_size, int max_concurrent_fold_count):
     prep_params = _PreprocessParams(params)
     cdef TCrossValidationParams cvParams
     cdef TVector[TCVResult] results
@@ -2821,6 +3003,7 @@ cpdef _cv(dict params, _PoolBase pool, int fold_count, bool_t inverted, int part
     cvParams.Inverted = inverted
     cvParams.MaxTimeSpentOnFixedCostRatio = max_time_spent_on_fixed_cost_ratio
     cvParams.DevMaxIterationsBatchSize = <ui32>dev_max_iterations_batch_size
+    cvParams.MaxConcurrentFoldCount = <ui32>max_concurrent_fold_count
 
     with nogil:
         SetPythonInterruptHandler()
@@ -2911,6 +3094,12 @@ cdef class _StagedPredictIterator:
             pool.__pool.Get()[0].ObjectsData,
             &self.__executor
         )
+        cdef size_t object_count = pool.__pool.Get()[0].ObjectsData.Get()[0].GetObjectCount()
+        cdef size_t approx_dimension = dereference(self.__model).ObliviousTrees.ApproxDimension
+        self.__flatApprox.resize(object_count * approx_dimension, 0.)
+        self.__approx.resize(approx_dimension)
+        for dim in range(approx_dimension):
+            self.__approx[dim].resize(object_count)
 
     def __dealloc__(self):
         del self.__modelCalcerOnPool
@@ -2922,20 +3111,19 @@ cdef class _StagedPredictIterator:
         if self.ntree_start >= self.ntree_end:
             raise StopIteration
 
-        dereference(self.__modelCalcerOnPool).ApplyModelMulti(
-            PyPredictionType('InternalRawFormulaVal').predictionType,
+        # only trees of the next stage are added to the running approx
+        dereference(self.__modelCalcerOnPool).AddTreesToFlatApprox(
             self.ntree_start,
             min(self.ntree_start + self.eval_period, self.ntree_end),
-            &self.__flatApprox,
-            &self.__pred
+            TArrayRef[double](self.__flatApprox.data(), self.__flatApprox.size())
         )
 
-        if self.__approx.empty():
-            self.__approx.swap(self.__pred)
-        else:
-            for i in range(self.__approx.size()):
-                for j in range(self.__approx[0].size()):
-                    self.__approx[i][j] += self.__pred[i][j]
+        cdef size_t approx_dimension = self.__approx.size()
+        cdef size_t object_count = self.__approx[0].size()
+        cdef size_t dim, object_idx
+        for dim in range(approx_dimension):
+            for object_idx in range(object_count):
+                self.__approx[dim][object_idx] = self.__flatApprox[object_idx * approx_dimension + dim]
 
         self.ntree_start += self.eval_period
         self.__pred = PrepareEvalForInternalApprox(self.predictionType, dereference(self.__model), self.__approx, self.thread_count)
@@ -941,6 +941,12 @@ class _CatBoostBase(object):
     def _base_predict_multi(self, pool, prediction_type, ntree_start, ntree_end, thread_count, verbose):
         return self._object._base_predict_multi(pool, prediction_type, ntree_start, ntree_end, thread_count, verbose)
 
+    def _base_predict_classes_with_early_exit(self, pool, ntree_start, ntree_end, thread_count, verbose):
+        return self._object._base_predict_classes_with_early_exit(pool, ntree_start, ntree_end, thread_count, verbose)
+
+    def _base_predict_on_dense_features(self, data, prediction_type, ntree_start, ntree_end, thread_count, convert_to_visible_labels):
+        return self._object._base_predict_on_dense_features(data, prediction_type, ntree_start, ntree_end, thread_count, convert_to_visible_labels)
+
     def _staged_predict_iterator(self, pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose):
         return self._object._staged_predict_iterator(pool, prediction_type, ntree_start, ntree_end, eval_period, thread_count, verbose)
 
@@ -983,6 +989,12 @@ class _CatBoostBase(object):
         for key, value in iteritems(self._get_params()):
             self._init_params[key] = value
 
+    def _load_mapped_model(self, model_file):
+        self._object._load_mapped_model(model_file)
+        self._set_trained_model_attributes()
+        for key, value in iteritems(self._get_params()):
+            self._init_params[key] = value
+
     def _serialize_model(self):
         return self._object._serialize_model()
 
@@ -1093,6 +1105,27 @@ def _is_data_single_object(data):
     return len(np.shape(data)) == 1
 
 
+def _get_dense_float_features(data, data_is_single_object):
+    """
+    Returns 2d numpy.ndarray with float32 or float64 features if data can be predicted on
+    without building Pool, otherwise returns None.
+    DataFrame columns are taken by position, as Pool does.
+    """
+    if isinstance(data, DataFrame):
+        if not all(dtype in (np.float32, np.float64) for dtype in data.dtypes):
+            return None
+        data = data.values
+    elif not isinstance(data, np.ndarray) or data.dtype not in (np.float32, np.float64):
+        return None
+    if data_is_single_object:
+        data = data.reshape(1, -1)
+    if data.ndim != 2 or 0 in data.shape:
+        return None
+    if any(stride <= 0 for stride in data.strides):
+        data = np.ascontiguousarray(data)
+    return data
+
+
 class CatBoost(_CatBoostBase):
     """
     CatBoost model. Contains training, prediction and evaluation methods.
@@ -1335,22 +1368,33 @@ class CatBoost(_CatBoostBase):
             raise CatBoostError("There is no trained model to use {}(). Use fit() to train model. Then use this method.".format(parent_method_name))
 
         data_is_single_object = _is_data_single_object(data)
-        if not isinstance(data, Pool):
-            data = Pool(
-                data=[data] if data_is_single_object else data,
-                cat_features=self._get_cat_feature_indices() if not isinstance(data, FeaturesData) else None
-            )
         if not isinstance(prediction_type, STRING_TYPES):
             raise CatBoostError("Invalid prediction_type type={}: must be str().".format(type(prediction_type)))
         if prediction_type not in ('Class', 'RawFormulaVal', 'Probability'):
             raise CatBoostError("Invalid value of prediction_type={}: must be Class, RawFormulaVal or Probability.".format(prediction_type))
 
         loss_function_type = _get_loss_function(self._get_params())
-
         # TODO(kirillovs): very bad solution. user should be able to use custom multiclass losses
-        if loss_function_type is not None and (loss_function_type == 'MultiClass' or loss_function_type == 'MultiClassOneVsAll'):
-            return np.transpose(self._base_predict_multi(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
-        predictions = np.array(self._base_predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
+        is_multiclass = loss_function_type is not None and (loss_function_type == 'MultiClass' or loss_function_type == 'MultiClassOneVsAll')
+
+        # numeric matrices are passed to the model as is, building Pool for them costs more than applying the model
+        dense_features = None
+        if not isinstance(data, (Pool, FeaturesData)) and not self._get_cat_feature_indices():
+            dense_features = _get_dense_float_features(data, data_is_single_object)
+        if dense_features is not None:
+            predictions = self._base_predict_on_dense_features(dense_features, prediction_type, ntree_start, ntree_end, thread_count, is_multiclass)
+            if is_multiclass:
+                return np.transpose(predictions)
+            predictions = predictions[0]
+        else:
+            if not isinstance(data, Pool):
+                data = Pool(
+                    data=[data] if data_is_single_object else data,
+                    cat_features=self._get_cat_feature_indices() if not isinstance(data, FeaturesData) else None
+                )
+            if is_multiclass:
+                return np.transpose(self._base_predict_multi(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
+            predictions = np.array(self._base_predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose))
         if prediction_type == 'Probability':
             predictions = np.transpose([1 - predictions, predictions])
         return predictions[0] if data_is_single_object else predictions
@@ -1962,6 +2006,14 @@ class CatBoost(_CatBoostBase):
                 * coreml_model_version : string
                 * coreml_model_author : string
                 * coreml_model_license: string
+            Parameters for ONNX-ML export:
+                * onnx_graph_name : string
+                * onnx_domain : string
+                * onnx_model_version : int
+                * onnx_doc_string : string
+                * onnx_trees_encoding : string - either 'TreeEnsemble' (default) or 'BitIndex'.
+                    Models with categorical features are always exported with 'BitIndex' encoding,
+                    hashes of categorical features are passed in a separate 'cat_features' input.
         pool : catboost.Pool or list or numpy.array or pandas.DataFrame or pandas.Series or catboost.FeaturesData
             Training pool.
         """
@@ -1976,7 +2028,7 @@ class CatBoost(_CatBoostBase):
             )
         self._save_model(fname, format, export_parameters, pool)
 
-    def load_model(self, fname, format='catboost'):
+    def load_model(self, fname, format='catboost', use_mmap=False):
         """
         Load model from a file.
 
@@ -1984,10 +2036,24 @@ class CatBoost(_CatBoostBase):
         ----------
         fname : string
             Input file name.
+
+        format : string, optional (default='catboost')
+            Input file format.
+
+        use_mmap : bool, optional (default=False)
+            Map the model file into memory instead of reading it. Supported only for 'catboost' format.
+            CTR tables are not copied, so processes that map the same file (e.g. from /dev/shm)
+            share their memory. Pickling stores the serialized model, so the pickle is self-contained.
+            The file must not be changed while the model is in use.
         """
         if not isinstance(fname, STRING_TYPES):
             raise CatBoostError("Invalid fname type={}: must be str().".format(type(fname)))
-        self._load_model(fname, format)
+        if use_mmap:
+            if format != 'catboost':
+                raise CatBoostError("use_mmap is supported only for models in 'catboost' format.")
+            self._load_mapped_model(fname)
+        else:
+            self._load_model(fname, format)
         return self
 
     def get_param(self, key):
@@ -2566,7 +2632,7 @@ class CatBoostClassifier(CatBoost):
                   silent, early_stopping_rounds, save_snapshot, snapshot_file, snapshot_interval)
         return self
 
-    def predict(self, data, prediction_type='Class', ntree_start=0, ntree_end=0, thread_count=-1, verbose=None):
+    def predict(self, data, prediction_type='Class', ntree_start=0, ntree_end=0, thread_count=-1, verbose=None, early_exit=False):
         """
         Predict with data.
 
@@ -2599,6 +2665,11 @@ class CatBoostClassifier(CatBoost):
         verbose : bool, optional (default=False)
             If True, writes the evaluation metric measured set to stderr.
 
+        early_exit : bool, optional (default=False)
+            Only for prediction_type='Class' and binary classification.
+            Stop applying trees to a block of objects once the remaining trees can't change
+            the classes of its objects, so confidently classified objects are decided by the first trees.
+
         Returns
         -------
         prediction:
@@ -2612,6 +2683,22 @@ class CatBoostClassifier(CatBoost):
                 - 'Probability' : two-dimensional numpy.ndarray with shape (number_of_objects x number_of_classes)
                   with probability for every class for each object.
         """
+        if early_exit:
+            if prediction_type != 'Class':
+                raise CatBoostError("early_exit is supported only for prediction_type='Class'.")
+            if not self.is_fitted():
+                raise CatBoostError("There is no trained model to use predict(). Use fit() to train model. Then use this method.")
+            verbose = verbose or self.get_param('verbose')
+            if verbose is None:
+                verbose = False
+            data_is_single_object = _is_data_single_object(data)
+            if not isinstance(data, Pool):
+                data = Pool(
+                    data=[data] if data_is_single_object else data,
+                    cat_features=self._get_cat_feature_indices() if not isinstance(data, FeaturesData) else None
+                )
+            predictions = np.array(self._base_predict_classes_with_early_exit(data, ntree_start, ntree_end, thread_count, verbose)[0])
+            return predictions[0] if data_is_single_object else predictions
         return self._predict(data, prediction_type, ntree_start, ntree_end, thread_count, verbose, 'predict')
 
     def predict_proba(self, data, ntree_start=0, ntree_end=0, thread_count=-1, verbose=None):
@@ -3230,7 +3317,7 @@ def cv(pool=None, params=None, dtrain=None, iterations=None, num_boost_round=Non
        shuffle=True, logging_level=None, stratified=False, as_pandas=True, metric_period=None,
        verbose=None, verbose_eval=None, plot=False, early_stopping_rounds=None,
        save_snapshot=None, snapshot_file=None, snapshot_interval=None, max_time_spent_on_fixed_cost_ratio=0.05,
-       dev_max_iterations_batch_size=100000):
+       dev_max_iterations_batch_size=100000, max_concurrent_fold_count=0):
     """
     Cross-validate the CatBoost model.
 
@@ -3329,6 +3416,10 @@ def cv(pool=None, params=None, dtrain=None, iterations=None, num_boost_round=Non
         Should be used only for testing, max_time_spent_on_fixed_cost_ratio is the prefered parameter to be
         used in normal operation.
 
+    max_concurrent_fold_count: int [default:0]
+        Max number of folds trained concurrently on CPU.
+        0 means that it is limited only by used_ram_limit.
+
     Returns
     -------
     cv results : pandas.core.frame.DataFrame with cross-validation results
@@ -3411,9 +3502,13 @@ def cv(pool=None, params=None, dtrain=None, iterations=None, num_boost_round=Non
                                 " vs " + str(pool.get_cat_feature_indices()))
         del params['cat_features']
 
+    if max_concurrent_fold_count < 0:
+        raise CatBoostError("max_concurrent_fold_count should be non-negative.")
+
     with log_fixup(), plot_wrapper(plot, [_get_train_dir(params)]):
         return _cv(params, pool, fold_count, inverted, partition_random_seed, shuffle, stratified,
-                   as_pandas, max_time_spent_on_fixed_cost_ratio, dev_max_iterations_batch_size)
+                   as_pandas, max_time_spent_on_fixed_cost_ratio, dev_max_iterations_batch_size,
+                   max_concurrent_fold_count)
 
 
 class BatchMetricCalcer(_MetricCalcerBase):
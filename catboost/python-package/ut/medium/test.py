@@ -318,6 +318,30 @@ def test_dataframe_with_pandas_categorical_columns():
     return local_canonical_file(preds_path)
 
 
+def test_dataframe_with_integer_and_pandas_categorical_cat_columns_equals_string_columns():
+    prng = np.random.RandomState(seed=0)
+    int_values = prng.randint(-5, 100, size=50)
+    str_values = prng.choice(['a', 'b', 'c', 'd'], size=50)
+
+    df = DataFrame()
+    df['int_cat'] = int_values.astype(np.int16)
+    df['pd_cat'] = Categorical(str_values, categories=['d', 'c', 'b', 'a', 'unused'])
+    df['int_pd_cat'] = Series(int_values, dtype='category')
+
+    string_df = DataFrame()
+    string_df['int_cat'] = [str(value) for value in int_values]
+    string_df['pd_cat'] = str_values
+    string_df['int_pd_cat'] = [str(value) for value in int_values]
+
+    pool = Pool(df, cat_features=[0, 1, 2])
+    string_pool = Pool(string_df, cat_features=[0, 1, 2])
+    assert _check_data(pool.get_features(), string_pool.get_features())
+
+    df['pd_cat'] = Categorical([np.nan] + list(str_values[1:]))
+    with pytest.raises(CatBoostError):
+        Pool(df, cat_features=[0, 1, 2])
+
+
 # feature_matrix is (doc_count x feature_count)
 def get_features_data_from_matrix(feature_matrix, cat_feature_indices, order='C'):
     object_count = len(feature_matrix)
@@ -694,6 +718,46 @@ def test_predict_and_predict_proba_on_single_object(problem):
             assert np.array_equal(pred_probabilities[test_object_idx], model.predict_proba(test_data.values[test_object_idx]))
 
 
+@pytest.mark.parametrize('loss_function', ['RMSE', 'Logloss', 'MultiClass'])
+def test_predict_on_dense_features_equals_predict_on_pool(loss_function):
+    prng = np.random.RandomState(seed=0)
+    features = prng.random_sample((200, 10))
+    features[prng.random_sample(features.shape) < 0.05] = np.nan
+    label = prng.randint(0, 3 if loss_function == 'MultiClass' else 2, size=200)
+    model = CatBoost({'iterations': 10, 'loss_function': loss_function})
+    model.fit(Pool(features, label))
+
+    prediction_types = ['RawFormulaVal', 'Class'] + (['Probability'] if loss_function != 'RMSE' else [])
+    for prediction_type in prediction_types:
+        expected = model.predict(Pool(features), prediction_type=prediction_type)
+        for dense_features in [
+            features,
+            features.astype(np.float32),
+            np.asfortranarray(features),
+            np.asfortranarray(features.astype(np.float32)),
+            DataFrame(features)
+        ]:
+            assert np.array_equal(expected, model.predict(dense_features, prediction_type=prediction_type))
+        single_object_prediction = model.predict(features[5], prediction_type=prediction_type)
+        assert np.array_equal(expected[5:6] if loss_function == 'MultiClass' else expected[5], single_object_prediction)
+
+
+def test_predict_on_dataframe_with_reordered_columns_equals_predict_on_pool():
+    prng = np.random.RandomState(seed=0)
+    feature_names = ['f{}'.format(i) for i in range(5)]
+    train_data = DataFrame(prng.random_sample((200, 5)), columns=feature_names)
+    label = prng.randint(0, 2, size=200)
+    model = CatBoost({'iterations': 10, 'loss_function': 'Logloss'})
+    model.fit(Pool(train_data, label))
+
+    # columns are taken by position both with and without Pool
+    test_data = DataFrame(prng.random_sample((50, 5)), columns=list(reversed(feature_names)))
+    for prediction_type in ['RawFormulaVal', 'Class', 'Probability']:
+        expected = model.predict(Pool(test_data), prediction_type=prediction_type)
+        assert np.array_equal(expected, model.predict(test_data, prediction_type=prediction_type))
+        assert np.array_equal(expected, model.predict(test_data.values, prediction_type=prediction_type))
+
+
 def test_model_pickling(task_type):
     train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     test_pool = Pool(TEST_FILE, column_description=CD_FILE)
@@ -899,6 +963,40 @@ def test_onnx_export(problem_type):
     return compare_canonical_models(output_onnx_model_path)
 
 
+@pytest.mark.parametrize('problem_type', ['binclass', 'regression'])
+def test_onnx_export_with_cat_features(problem_type):
+    train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    model = CatBoost(
+        {
+            'loss_function': 'Logloss' if problem_type == 'binclass' else 'RMSE',
+            'iterations': 20,
+            'depth': 4,
+            'one_hot_max_size': 4,
+            'thread_count': 4
+        }
+    )
+    model.fit(train_pool)
+
+    output_model_path = test_output_path(OUTPUT_MODEL_PATH)
+    output_onnx_model_path = test_output_path(OUTPUT_ONNX_MODEL_PATH)
+    model.save_model(output_model_path)
+    model.save_model(output_onnx_model_path, format="onnx")
+
+    # flat features are all columns except target
+    features_path = test_output_path('features.tsv')
+    with open(TEST_FILE) as test_file, open(features_path, 'w') as features_file:
+        for line in test_file:
+            columns = line.rstrip('\n').split('\t')
+            features_file.write('\t'.join(columns[:TARGET_IDX] + columns[TARGET_IDX + 1:]) + '\n')
+
+    subprocess.check_call(
+        (model_diff_tool, output_model_path, output_onnx_model_path, '--input-path', features_path, '--diff-limit', '1e-5')
+    )
+    subprocess.check_call(
+        (model_diff_tool, output_model_path, output_onnx_model_path, '--objects-count', '1000', '--diff-limit', '1e-5')
+    )
+
+
 def test_predict_class(task_type):
     train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     test_pool = Pool(TEST_FILE, column_description=CD_FILE)
@@ -987,6 +1085,26 @@ def test_save_model(task_type):
     assert _check_data(pred1, pred2)
 
 
+def test_load_mapped_model():
+    train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    test_pool = Pool(TEST_FILE, column_description=CD_FILE)
+    model = CatBoost({'iterations': 10, 'random_seed': 0})
+    model.fit(train_pool)
+    output_model_path = test_output_path(OUTPUT_MODEL_PATH)
+    model.save_model(output_model_path)
+    mapped_model = CatBoost().load_model(output_model_path, use_mmap=True)
+    pred = model.predict(test_pool)
+    assert _check_data(pred, mapped_model.predict(test_pool))
+
+    # pickle holds the model itself, not a reference to the mapped file
+    pickled_model = pickle.dumps(mapped_model)
+    os.remove(output_model_path)
+    assert _check_data(pred, pickle.loads(pickled_model).predict(test_pool))
+
+    mapped_model.shrink(5)
+    assert _check_data(mapped_model.predict(test_pool), pickle.loads(pickle.dumps(mapped_model)).predict(test_pool))
+
+
 def test_multiclass(task_type):
     pool = Pool(CLOUDNESS_TRAIN_FILE, column_description=CLOUDNESS_CD_FILE)
     classifier = CatBoostClassifier(iterations=2, loss_function='MultiClass', thread_count=8, task_type=task_type, devices='0')
@@ -1307,6 +1425,33 @@ def test_staged_predict(task_type):
     return local_canonical_file(preds_path)
 
 
+def test_predict_class_with_early_exit():
+    train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    test_pool = Pool(TEST_FILE, column_description=CD_FILE)
+    model = CatBoostClassifier(iterations=100, learning_rate=0.3, random_seed=0)
+    model.fit(train_pool)
+    assert np.array_equal(model.predict(test_pool), model.predict(test_pool, early_exit=True))
+    assert np.array_equal(
+        model.predict(test_pool, ntree_start=10, ntree_end=50),
+        model.predict(test_pool, ntree_start=10, ntree_end=50, early_exit=True)
+    )
+
+
+def test_predict_class_with_early_exit_on_string_labels():
+    class_names = ['negative', 'positive']
+    prng = np.random.RandomState(seed=0)
+    features = prng.random_sample((200, 10))
+    label = prng.choice(class_names, size=200)
+    model = CatBoostClassifier(iterations=50, learning_rate=0.3, random_seed=0, class_names=class_names)
+    model.fit(Pool(features, label))
+
+    expected = model.predict(features)
+    predictions = model.predict(features, early_exit=True)
+    assert np.array_equal(expected, predictions)
+    assert expected.dtype == predictions.dtype
+    assert model.predict(features[5], early_exit=True) == expected[5]
+
+
 @pytest.mark.parametrize('problem', ['Classifier', 'Regressor'])
 def test_staged_predict_and_predict_proba_on_single_object(problem):
     train_pool = Pool(TRAIN_FILE, column_description=CD_FILE)
@@ -3064,6 +3209,25 @@ def test_cv_fold_count_alias(task_type):
     assert results_fold_count.equals(results_nfold)
 
 
+def test_cv_max_concurrent_fold_count():
+    pool = Pool(TRAIN_FILE, column_description=CD_FILE)
+    params = {
+        "iterations": 10,
+        "learning_rate": 0.03,
+        "loss_function": "Logloss",
+        "eval_metric": "AUC",
+    }
+    sequential_results = cv(pool=pool, params=params, fold_count=4, max_concurrent_fold_count=1,
+                            dev_max_iterations_batch_size=4)
+    for max_concurrent_fold_count in [0, 2]:
+        results = cv(pool=pool, params=params, fold_count=4, max_concurrent_fold_count=max_concurrent_fold_count,
+                     dev_max_iterations_batch_size=4)
+        assert results.equals(sequential_results)
+
+    with pytest.raises(CatBoostError):
+        cv(pool=pool, params=params, fold_count=4, max_concurrent_fold_count=-1)
+
+
 def test_predict_loss_function_alias(task_type):
     pool = Pool(TRAIN_FILE, column_description=CD_FILE)
     test = Pool(TEST_FILE, column_description=CD_FILE)
@@ -73,6 +73,45 @@ impl Model {
         Ok(prediction)
     }
 
+    /// Calculate raw model predictions on column-major feature matrices without building per object pointer arrays.
+    /// Value of float feature `i` for object `j` is `float_features[i * object_count + j]`,
+    /// value of categorical feature `i` for object `j` is `hashed_cat_features[i * object_count + j]`
+    /// (categorical values are hashed with `GetStringCatFeatureHash`).
+    /// If `thread_count` is greater than 1 threads are created on the first call and reused by subsequent calls.
+    pub fn calc_model_prediction_column_major(
+        &self,
+        object_count: usize,
+        float_features: &[f32],
+        hashed_cat_features: &[i32],
+        thread_count: i32,
+    ) -> CatBoostResult<Vec<f64>> {
+        if object_count == 0 {
+            return Ok(Vec::new());
+        }
+        assert!(
+            float_features.len() % object_count == 0 && hashed_cat_features.len() % object_count == 0,
+            "features sizes should be divisible by object_count"
+        );
+
+        let mut prediction = vec![0.0; object_count * self.get_dimensions_count()];
+        CatBoostError::check_return_value(unsafe {
+            catboost_sys::CalcModelPredictionColumnMajor(
+                self.handle,
+                object_count,
+                float_features.as_ptr(),
+                float_features.len() / object_count,
+                object_count,
+                hashed_cat_features.as_ptr(),
+                hashed_cat_features.len() / object_count,
+                object_count,
+                thread_count,
+                prediction.as_mut_ptr(),
+                prediction.len(),
+            )
+        })?;
+        Ok(prediction)
+    }
+
     /// Get expected float feature count for model
     pub fn get_float_features_count(&self) -> usize {
         unsafe { catboost_sys::GetFloatFeaturesCount(self.handle) }
@@ -133,6 +172,34 @@ mod tests {
         assert_eq!(prediction[2], -0.0013677527881450977);
     }
 
+    #[test]
+    fn calc_prediction_column_major() {
+        let model = Model::load("tmp/model.bin").unwrap();
+        let hashed_cat_features = ["north", "south", "south"]
+            .iter()
+            .map(|value| unsafe {
+                catboost_sys::GetStringCatFeatureHash(
+                    value.as_ptr() as *const std::os::raw::c_char,
+                    value.len(),
+                )
+            })
+            .collect::<Vec<_>>();
+        for thread_count in &[1, 2] {
+            let prediction = model
+                .calc_model_prediction_column_major(
+                    3,
+                    &[-10.0, 30.0, 40.0, 5.0, 1.0, 0.1, 753.0, 760.0, 705.0],
+                    &hashed_cat_features,
+                    *thread_count,
+                )
+                .unwrap();
+
+            assert_eq!(prediction[0], 0.9980003729960197);
+            assert_eq!(prediction[1], 0.00249414628534181);
+            assert_eq!(prediction[2], -0.0013677527881450977);
+        }
+    }
+
     #[test]
     fn get_model_stats() {
         let model = Model::load("tmp/model.bin").unwrap();
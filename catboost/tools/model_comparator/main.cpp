@@ -1,12 +1,23 @@
 
 #include "onnx.h"
+#include "onnx_evaluator.h"
 
+#include <catboost/libs/cat_feature/cat_feature.h>
 #include <catboost/libs/model/model.h>
 #include <catboost/libs/logging/logging.h>
 #include <catboost/libs/options/json_helper.h>
 #include <library/getopt/small/last_getopt.h>
 
+#include <util/datetime/cputimer.h>
+#include <util/generic/algorithm.h>
+#include <util/generic/xrange.h>
+#include <util/random/fast.h>
+#include <util/stream/file.h>
+#include <util/string/cast.h>
+#include <util/string/split.h>
+
 #include <cmath>
+#include <limits>
 
 
 using namespace NCB;
@@ -80,6 +91,166 @@ TFullModel ReadModelAny(const TString& fileName) {
     return model;
 }
 
+struct TFlatFeatures {
+    TVector<float> Features; // [objectIdx * flatFeatureCount + flatFeatureIdx], cat features as hashes bit casted to float
+    TVector<i64> CatFeatures; // [objectIdx * catFeatureCount + catFeatureIdx]
+    size_t ObjectCount = 0;
+};
+
+static void AddObject(const TFullModel& model, TConstArrayRef<float> floatValues, TConstArrayRef<int> catHashes, TFlatFeatures* data) {
+    const auto& trees = model.ObliviousTrees;
+    const size_t flatFeatureCount = trees.GetFlatFeatureVectorExpectedSize();
+    const size_t offset = data->Features.size();
+    data->Features.resize(offset + flatFeatureCount, 0.0f);
+    for (const auto& floatFeature : trees.FloatFeatures) {
+        data->Features[offset + floatFeature.FlatFeatureIndex] = floatValues[floatFeature.FeatureIndex];
+    }
+    for (const auto& catFeature : trees.CatFeatures) {
+        const int hash = catHashes[catFeature.FeatureIndex];
+        data->Features[offset + catFeature.FlatFeatureIndex] = ConvertCatFeatureHashToFloat(hash);
+        data->CatFeatures.push_back(hash);
+    }
+    ++data->ObjectCount;
+}
+
+// rows of tab separated flat features, categorical features values are strings
+static TFlatFeatures ReadFlatFeatures(const TFullModel& model, const TString& path) {
+    const auto& trees = model.ObliviousTrees;
+    TVector<int> flatToCatFeature(trees.GetFlatFeatureVectorExpectedSize(), -1);
+    for (const auto& catFeature : trees.CatFeatures) {
+        flatToCatFeature[catFeature.FlatFeatureIndex] = catFeature.FeatureIndex;
+    }
+    TVector<int> flatToFloatFeature(trees.GetFlatFeatureVectorExpectedSize(), -1);
+    for (const auto& floatFeature : trees.FloatFeatures) {
+        flatToFloatFeature[floatFeature.FlatFeatureIndex] = floatFeature.FeatureIndex;
+    }
+
+    TFlatFeatures data;
+    TVector<float> floatValues(trees.GetNumFloatFeatures());
+    TVector<int> catHashes(trees.GetNumCatFeatures());
+    TIFStream in(path);
+    TString line;
+    while (in.ReadLine(line)) {
+        const TVector<TString> values = StringSplitter(line).Split('\t');
+        CB_ENSURE(values.size() >= flatToCatFeature.size(), "Too few features in line " << data.ObjectCount);
+        for (auto flatFeatureIdx : xrange(flatToCatFeature.size())) {
+            if (flatToCatFeature[flatFeatureIdx] >= 0) {
+                catHashes[flatToCatFeature[flatFeatureIdx]] = CalcCatFeatureHashInt(values[flatFeatureIdx]);
+            } else if (flatToFloatFeature[flatFeatureIdx] >= 0) {
+                floatValues[flatToFloatFeature[flatFeatureIdx]] = FromString<float>(values[flatFeatureIdx]);
+            }
+        }
+        AddObject(model, floatValues, catHashes, &data);
+    }
+    return data;
+}
+
+// float features are spread around borders, categorical features are small integers or one hot values
+static TFlatFeatures GenerateFlatFeatures(const TFullModel& model, size_t objectCount) {
+    const auto& trees = model.ObliviousTrees;
+    TVector<TVector<int>> catValues(trees.GetNumCatFeatures());
+    for (auto& values : catValues) {
+        for (auto value : xrange(20)) {
+            values.push_back(CalcCatFeatureHashInt(ToString(value)));
+        }
+    }
+    for (const auto& oneHotFeature : trees.OneHotFeatures) {
+        auto& values = catValues[oneHotFeature.CatFeatureIndex];
+        values.insert(values.end(), oneHotFeature.Values.begin(), oneHotFeature.Values.end());
+    }
+
+    TFastRng64 rng(0);
+    TFlatFeatures data;
+    TVector<float> floatValues(trees.GetNumFloatFeatures());
+    TVector<int> catHashes(trees.GetNumCatFeatures());
+    for (auto objectIdx : xrange(objectCount)) {
+        Y_UNUSED(objectIdx);
+        for (const auto& floatFeature : trees.FloatFeatures) {
+            float& value = floatValues[floatFeature.FeatureIndex];
+            if (floatFeature.Borders.empty()) {
+                value = rng.GenRandReal1();
+            } else if (floatFeature.HasNans && rng.GenRandReal1() < 0.05) {
+                value = std::numeric_limits<float>::quiet_NaN();
+            } else {
+                const float minValue = floatFeature.Borders.front() - 1.0f;
+                const float maxValue = floatFeature.Borders.back() + 1.0f;
+                value = minValue + (maxValue - minValue) * rng.GenRandReal1();
+            }
+        }
+        for (auto catFeatureIdx : xrange(catHashes.size())) {
+            catHashes[catFeatureIdx] = catValues[catFeatureIdx][rng.Uniform(catValues[catFeatureIdx].size())];
+        }
+        AddObject(model, floatValues, catHashes, &data);
+    }
+    return data;
+}
+
+static void TransformToProbabilities(const TFullModel& model, TVector<double>* approx) {
+    const size_t approxDimension = model.ObliviousTrees.ApproxDimension;
+    if (approxDimension == 1) {
+        TVector<double> probabilities;
+        for (auto value : *approx) {
+            const double probability = 1.0 / (1.0 + std::exp(-value));
+            probabilities.push_back(1.0 - probability);
+            probabilities.push_back(probability);
+        }
+        approx->swap(probabilities);
+        return;
+    }
+    for (size_t offset = 0; offset < approx->size(); offset += approxDimension) {
+        double* values = approx->data() + offset;
+        const double maxValue = *MaxElement(values, values + approxDimension);
+        double sum = 0;
+        for (auto i : xrange(approxDimension)) {
+            values[i] = std::exp(values[i] - maxValue);
+            sum += values[i];
+        }
+        for (auto i : xrange(approxDimension)) {
+            values[i] /= sum;
+        }
+    }
+}
+
+// compares predictions of ONNX model and CatBoost model on the same data, reports evaluation speed
+static int CompareOnnxPredictions(
+    const TFullModel& model,
+    const onnx::ModelProto& onnxModel,
+    const TFlatFeatures& data,
+    double diffLimit) {
+
+    const NCB::TOnnxBitIndexEvaluator evaluator(onnxModel);
+
+    TVector<TConstArrayRef<float>> features;
+    const size_t flatFeatureCount = model.ObliviousTrees.GetFlatFeatureVectorExpectedSize();
+    for (auto objectIdx : xrange(data.ObjectCount)) {
+        features.push_back(MakeArrayRef(data.Features).Slice(objectIdx * flatFeatureCount, flatFeatureCount));
+    }
+    TVector<double> expected(data.ObjectCount * model.ObliviousTrees.ApproxDimension);
+    TSimpleTimer timer;
+    model.CalcFlat(features, expected);
+    const TDuration catboostTime = timer.Get();
+
+    timer.Reset();
+    const TVector<float> actual = evaluator.Calc(data.Features, data.CatFeatures, data.ObjectCount);
+    const TDuration onnxTime = timer.Get();
+
+    if (evaluator.IsClassifier()) {
+        TransformToProbabilities(model, &expected);
+    }
+    CB_ENSURE(actual.size() == expected.size(), "Prediction sizes differ: " << actual.size() << " vs " << expected.size());
+    double maxDiff = 0.0;
+    for (auto i : xrange(actual.size())) {
+        maxDiff = Max(maxDiff, std::abs(actual[i] - expected[i]));
+    }
+
+    Clog << "Objects: " << data.ObjectCount << Endl;
+    Clog << "CatBoost CalcFlat time: " << catboostTime << ", ONNX reference evaluation time: " << onnxTime << Endl;
+    Clog << "Note: ONNX time is of the reference evaluator, throughput with a real ONNX runtime is not verified" << Endl;
+    Clog << "Maximum observed absolute diff of " << (evaluator.IsClassifier() ? "probabilities" : "predictions")
+        << " is " << maxDiff << ", limit is " << diffLimit << Endl;
+    return maxDiff <= diffLimit ? 0 : 1;
+}
+
 static bool CompareModelInfo(const THashMap<TString, TString>& modelInfo1, const THashMap<TString, TString>& modelInfo2) {
     if (modelInfo1.size() != modelInfo2.size()) {
         return false;
@@ -106,11 +277,20 @@ static bool CompareModelInfo(const THashMap<TString, TString>& modelInfo1, const
 int main(int argc, char** argv) {
     using namespace NLastGetopt;
     double diffLimit = 0.0;
+    size_t objectCount = 10000;
+    TString inputPath;
     TOpts opts = NLastGetopt::TOpts::Default();
     opts.AddLongOption("diff-limit").RequiredArgument("THR")
         .Help("Tolerate elementwise relative difference less than THR")
         .DefaultValue(0.0)
         .StoreResult(&diffLimit);
+    opts.AddLongOption("objects-count").RequiredArgument("N")
+        .Help("Number of generated objects to compare predictions of ONNX and CatBoost models")
+        .DefaultValue(10000)
+        .StoreResult(&objectCount);
+    opts.AddLongOption("input-path").RequiredArgument("PATH")
+        .Help("Tab separated flat features to compare predictions of ONNX and CatBoost models (instead of generated)")
+        .StoreResult(&inputPath);
     opts.SetFreeArgsMin(2);
     opts.SetFreeArgsMax(2);
     opts.SetFreeArgTitle(0, "MODEL1");
@@ -134,17 +314,21 @@ int main(int argc, char** argv) {
              << "MODEL2 = " << freeArgs[1] << Endl;
         return 1;
     }
-    if (onnxModel1 && !onnxModel2) {
-        Clog << "Cannot compare (not implemented)\n"
-            << "ONNX MODEL1 = " << freeArgs[0] << Endl
-            << "non-ONNX MODEL2 = " << freeArgs[1] << Endl;
-        return 2;
-    }
-    if (!onnxModel1 && onnxModel2) {
-        Clog << "Cannot compare (not implemented)\n"
-            << "non-ONNX MODEL1 = " << freeArgs[0] << Endl
-            << "ONNX MODEL2 = " << freeArgs[1] << Endl;
-        return 2;
+    if (onnxModel1 || onnxModel2) {
+        const auto& onnxModel = onnxModel1 ? *onnxModel1 : *onnxModel2;
+        const TString& modelPath = onnxModel1 ? freeArgs[1] : freeArgs[0];
+        Clog << "ONNX MODEL = " << freeArgs[onnxModel1 ? 0 : 1] << Endl
+            << "non-ONNX MODEL = " << modelPath << Endl;
+        try {
+            const TFullModel model = ReadModelAny(modelPath);
+            const TFlatFeatures data = inputPath.empty()
+                ? GenerateFlatFeatures(model, objectCount)
+                : ReadFlatFeatures(model, inputPath);
+            return CompareOnnxPredictions(model, onnxModel, data, diffLimit);
+        } catch (const TCatBoostException& e) {
+            Clog << "Cannot compare (not implemented): " << e.what() << Endl;
+            return 2;
+        }
     }
 
     // both models are non-ONNX - compare loaded as TFullModel
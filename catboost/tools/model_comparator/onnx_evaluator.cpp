@@ -0,0 +1,463 @@
+#include "onnx_evaluator.h"
+
+#include <catboost/libs/helpers/exception.h>
+
+#include <util/generic/algorithm.h>
+#include <util/generic/is_in.h>
+#include <util/generic/xrange.h>
+#include <util/generic/ymath.h>
+
+#include <cmath>
+
+
+namespace NCB {
+
+    using TTensor = TOnnxBitIndexEvaluator::TTensor;
+
+    static const onnx::AttributeProto* FindAttribute(const onnx::NodeProto& node, TStringBuf name) {
+        for (const auto& attribute : node.attribute()) {
+            if (attribute.name() == name) {
+                return &attribute;
+            }
+        }
+        return nullptr;
+    }
+
+    static i64 GetIntAttribute(const onnx::NodeProto& node, TStringBuf name, i64 defaultValue) {
+        const auto* attribute = FindAttribute(node, name);
+        return attribute ? attribute->i() : defaultValue;
+    }
+
+    static TVector<i64> GetIntsAttribute(const onnx::NodeProto& node, TStringBuf name) {
+        const auto* attribute = FindAttribute(node, name);
+        CB_ENSURE(attribute, "Node " << node.op_type() << " has no attribute " << name);
+        return TVector<i64>(attribute->ints().begin(), attribute->ints().end());
+    }
+
+    static size_t GetSize(TConstArrayRef<i64> shape) {
+        size_t size = 1;
+        for (auto dim : shape) {
+            size *= dim;
+        }
+        return size;
+    }
+
+    static i64 NormalizeAxis(i64 axis, size_t rank) {
+        return axis < 0 ? axis + rank : axis;
+    }
+
+    static TVector<i64> GetBroadcastShape(const TVector<i64>& lhs, const TVector<i64>& rhs) {
+        const size_t rank = Max(lhs.size(), rhs.size());
+        TVector<i64> result(rank);
+        for (auto dimIdx : xrange(rank)) {
+            const i64 lhsDim = dimIdx + lhs.size() >= rank ? lhs[dimIdx + lhs.size() - rank] : 1;
+            const i64 rhsDim = dimIdx + rhs.size() >= rank ? rhs[dimIdx + rhs.size() - rank] : 1;
+            CB_ENSURE(lhsDim == rhsDim || lhsDim == 1 || rhsDim == 1, "Shapes can not be broadcasted");
+            result[dimIdx] = lhsDim == 1 ? rhsDim : lhsDim;
+        }
+        return result;
+    }
+
+    // offset of the input element for every element of the broadcasted output
+    static TVector<size_t> GetBroadcastOffsets(const TVector<i64>& inputShape, const TVector<i64>& outputShape) {
+        const size_t rank = outputShape.size();
+        TVector<size_t> strides(rank, 0);
+        size_t stride = 1;
+        for (auto i : xrange(inputShape.size())) {
+            const i64 inputDim = inputShape[inputShape.size() - 1 - i];
+            if (inputDim != 1) {
+                strides[rank - 1 - i] = stride;
+            }
+            stride *= inputDim;
+        }
+
+        TVector<size_t> offsets(GetSize(outputShape));
+        TVector<i64> index(rank, 0);
+        size_t offset = 0;
+        for (auto& result : offsets) {
+            result = offset;
+            for (size_t dimIdx = rank; dimIdx-- > 0;) {
+                ++index[dimIdx];
+                offset += strides[dimIdx];
+                if (index[dimIdx] < outputShape[dimIdx]) {
+                    break;
+                }
+                offset -= strides[dimIdx] * index[dimIdx];
+                index[dimIdx] = 0;
+            }
+        }
+        return offsets;
+    }
+
+    template <class TResult, class TLhs, class TRhs, class TOp>
+    static void CalcBinary(
+        const TVector<TLhs>& lhs,
+        const TVector<i64>& lhsShape,
+        const TVector<TRhs>& rhs,
+        const TVector<i64>& rhsShape,
+        const TOp& op,
+        TVector<TResult>* result,
+        TVector<i64>* resultShape) {
+
+        *resultShape = GetBroadcastShape(lhsShape, rhsShape);
+        const auto lhsOffsets = GetBroadcastOffsets(lhsShape, *resultShape);
+        const auto rhsOffsets = GetBroadcastOffsets(rhsShape, *resultShape);
+        result->yresize(lhsOffsets.size());
+        for (auto i : xrange(lhsOffsets.size())) {
+            (*result)[i] = op(lhs[lhsOffsets[i]], rhs[rhsOffsets[i]]);
+        }
+    }
+
+    template <class T>
+    static TVector<T> Gather(const TVector<T>& data, const TVector<i64>& dataShape, const TVector<i64>& indices, i64 axis) {
+        const size_t outerSize = GetSize(MakeArrayRef(dataShape).Slice(0, axis));
+        const i64 axisSize = dataShape[axis];
+        const size_t innerSize = GetSize(MakeArrayRef(dataShape).Slice(axis + 1));
+        TVector<T> result;
+        result.reserve(outerSize * indices.size() * innerSize);
+        for (auto outerIdx : xrange(outerSize)) {
+            for (auto index : indices) {
+                CB_ENSURE(index >= 0 && index < axisSize, "Gather index " << index << " is out of range");
+                const auto begin = data.begin() + (outerIdx * axisSize + index) * innerSize;
+                result.insert(result.end(), begin, begin + innerSize);
+            }
+        }
+        return result;
+    }
+
+    template <class T>
+    static void Concat(
+        const TVector<const TVector<T>*>& inputs,
+        const TVector<const TVector<i64>*>& shapes,
+        i64 axis,
+        TVector<T>* result) {
+
+        const size_t outerSize = GetSize(MakeArrayRef(*shapes[0]).Slice(0, axis));
+        for (auto outerIdx : xrange(outerSize)) {
+            for (auto inputIdx : xrange(inputs.size())) {
+                const size_t blockSize = GetSize(MakeArrayRef(*shapes[inputIdx]).Slice(axis));
+                const auto begin = inputs[inputIdx]->begin() + outerIdx * blockSize;
+                result->insert(result->end(), begin, begin + blockSize);
+            }
+        }
+    }
+
+    static TTensor GetInitializer(const onnx::TensorProto& tensorProto) {
+        TTensor tensor;
+        tensor.DataType = tensorProto.data_type();
+        tensor.Shape.assign(tensorProto.dims().begin(), tensorProto.dims().end());
+        switch (tensor.DataType) {
+            case onnx::TensorProto_DataType_FLOAT:
+                tensor.Floats.assign(tensorProto.float_data().begin(), tensorProto.float_data().end());
+                break;
+            case onnx::TensorProto_DataType_INT64:
+                tensor.Ints.assign(tensorProto.int64_data().begin(), tensorProto.int64_data().end());
+                break;
+            case onnx::TensorProto_DataType_BOOL:
+                tensor.Ints.assign(tensorProto.int32_data().begin(), tensorProto.int32_data().end());
+                break;
+            case onnx::TensorProto_DataType_STRING:
+                tensor.Strings.assign(tensorProto.string_data().begin(), tensorProto.string_data().end());
+                break;
+            default:
+                CB_ENSURE(false, "Unsupported initializer data type " << tensor.DataType);
+        }
+        return tensor;
+    }
+
+    TOnnxBitIndexEvaluator::TOnnxBitIndexEvaluator(const onnx::ModelProto& model)
+        : Graph(model.graph())
+    {
+        static const TVector<TString> supportedOps = {
+            "Add", "And", "ArgMax", "Cast", "Concat", "Equal", "Gather", "Greater", "Identity", "IsNaN",
+            "LabelEncoder", "MatMul", "Mul", "Or", "ReduceSum", "Sigmoid", "Softmax", "Sub", "Unsqueeze",
+            "ZipMap"
+        };
+        for (const auto& node : Graph.node()) {
+            CB_ENSURE(IsIn(supportedOps, node.op_type()), "Operator " << node.op_type() << " is not supported");
+        }
+
+        for (const auto& initializer : Graph.initializer()) {
+            Initializers[initializer.name()] = GetInitializer(initializer);
+        }
+        for (const auto& input : Graph.input()) {
+            const auto& shape = input.type().tensor_type().shape();
+            if (input.name() == "features") {
+                FlatFeatureCount = shape.dim(1).dim_value();
+            } else if (input.name() == "cat_features") {
+                CatFeatureCount = shape.dim(1).dim_value();
+                HasCatFeaturesInput = true;
+            }
+        }
+        for (const auto& output : Graph.output()) {
+            if (output.name() == "predictions") {
+                OutputName = output.name();
+            }
+        }
+        if (OutputName.empty()) {
+            OutputName = "probability_tensor";
+        }
+
+        LabelEncoderMaps.resize(Graph.node_size());
+        for (auto nodeIdx : xrange(Graph.node_size())) {
+            const auto& node = Graph.node(nodeIdx);
+            if (node.op_type() != "LabelEncoder") {
+                continue;
+            }
+            const auto* keys = FindAttribute(node, "keys_int64s");
+            const auto* values = FindAttribute(node, "values_floats");
+            CB_ENSURE(keys && values && keys->ints_size() == values->floats_size(), "Unsupported LabelEncoder");
+            for (auto i : xrange(keys->ints_size())) {
+                LabelEncoderMaps[nodeIdx][keys->ints(i)] = values->floats(i);
+            }
+        }
+    }
+
+    TVector<float> TOnnxBitIndexEvaluator::Calc(
+        TConstArrayRef<float> features,
+        TConstArrayRef<i64> catFeatures,
+        size_t objectCount) const {
+
+        THashMap<TString, TTensor> values = Initializers;
+
+        TTensor& featuresTensor = values["features"];
+        featuresTensor.DataType = onnx::TensorProto_DataType_FLOAT;
+        featuresTensor.Shape = {i64(objectCount), FlatFeatureCount};
+        featuresTensor.Floats.assign(features.begin(), features.end());
+        CB_ENSURE(featuresTensor.Floats.size() == GetSize(featuresTensor.Shape), "Wrong features size");
+
+        if (HasCatFeaturesInput) {
+            TTensor& catFeaturesTensor = values["cat_features"];
+            catFeaturesTensor.DataType = onnx::TensorProto_DataType_INT64;
+            catFeaturesTensor.Shape = {i64(objectCount), CatFeatureCount};
+            catFeaturesTensor.Ints.assign(catFeatures.begin(), catFeatures.end());
+            CB_ENSURE(catFeaturesTensor.Ints.size() == GetSize(catFeaturesTensor.Shape), "Wrong cat features size");
+        }
+
+        for (auto nodeIdx : xrange(Graph.node_size())) {
+            CalcNode(nodeIdx, &values);
+        }
+        return values.at(OutputName).Floats;
+    }
+
+    void TOnnxBitIndexEvaluator::CalcNode(int nodeIdx, THashMap<TString, TTensor>* values) const {
+        const onnx::NodeProto& node = Graph.node(nodeIdx);
+        const TString& opType = node.op_type();
+        if (opType == "ZipMap") {
+            return;
+        }
+
+        TVector<const TTensor*> inputs;
+        for (const auto& inputName : node.input()) {
+            inputs.push_back(&values->at(inputName));
+        }
+        TTensor result;
+        const TTensor& input = *inputs[0];
+        const bool isFloatInput = input.DataType == onnx::TensorProto_DataType_FLOAT;
+
+        const auto calcBinary = [&] (int resultType, const auto& floatOp, const auto& intOp) {
+            result.DataType = resultType;
+            const TTensor& rhs = *inputs[1];
+            if (isFloatInput) {
+                if (resultType == onnx::TensorProto_DataType_FLOAT) {
+                    CalcBinary(input.Floats, input.Shape, rhs.Floats, rhs.Shape, floatOp, &result.Floats, &result.Shape);
+                } else {
+                    CalcBinary(input.Floats, input.Shape, rhs.Floats, rhs.Shape, floatOp, &result.Ints, &result.Shape);
+                }
+            } else {
+                CalcBinary(input.Ints, input.Shape, rhs.Ints, rhs.Shape, intOp, &result.Ints, &result.Shape);
+            }
+        };
+        // int64 arithmetic wraps around as in the exported hashes
+        const auto wrap = [] (ui64 value) { return static_cast<i64>(value); };
+
+        if (opType == "Add") {
+            calcBinary(
+                input.DataType,
+                [] (float lhs, float rhs) { return lhs + rhs; },
+                [&] (i64 lhs, i64 rhs) { return wrap(ui64(lhs) + ui64(rhs)); });
+        } else if (opType == "Sub") {
+            calcBinary(
+                input.DataType,
+                [] (float lhs, float rhs) { return lhs - rhs; },
+                [&] (i64 lhs, i64 rhs) { return wrap(ui64(lhs) - ui64(rhs)); });
+        } else if (opType == "Mul") {
+            calcBinary(
+                input.DataType,
+                [] (float lhs, float rhs) { return lhs * rhs; },
+                [&] (i64 lhs, i64 rhs) { return wrap(ui64(lhs) * ui64(rhs)); });
+        } else if (opType == "Greater") {
+            calcBinary(
+                onnx::TensorProto_DataType_BOOL,
+                [] (float lhs, float rhs) { return i64(lhs > rhs); },
+                [] (i64 lhs, i64 rhs) { return i64(lhs > rhs); });
+        } else if (opType == "Equal") {
+            calcBinary(
+                onnx::TensorProto_DataType_BOOL,
+                [] (float lhs, float rhs) { return i64(lhs == rhs); },
+                [] (i64 lhs, i64 rhs) { return i64(lhs == rhs); });
+        } else if (opType == "And") {
+            calcBinary(
+                onnx::TensorProto_DataType_BOOL,
+                [] (float, float) { return i64(0); },
+                [] (i64 lhs, i64 rhs) { return i64(lhs && rhs); });
+        } else if (opType == "Or") {
+            calcBinary(
+                onnx::TensorProto_DataType_BOOL,
+                [] (float, float) { return i64(0); },
+                [] (i64 lhs, i64 rhs) { return i64(lhs || rhs); });
+        } else if (opType == "IsNaN") {
+            result.DataType = onnx::TensorProto_DataType_BOOL;
+            result.Shape = input.Shape;
+            for (auto value : input.Floats) {
+                result.Ints.push_back(std::isnan(value));
+            }
+        } else if (opType == "Cast") {
+            result.DataType = GetIntAttribute(node, "to", 0);
+            result.Shape = input.Shape;
+            if (result.DataType == onnx::TensorProto_DataType_FLOAT) {
+                result.Floats = isFloatInput ? input.Floats : TVector<float>(input.Ints.begin(), input.Ints.end());
+            } else {
+                CB_ENSURE(result.DataType == onnx::TensorProto_DataType_INT64, "Unsupported Cast");
+                result.Ints = isFloatInput ? TVector<i64>(input.Floats.begin(), input.Floats.end()) : input.Ints;
+            }
+        } else if (opType == "Identity") {
+            result = input;
+        } else if (opType == "Gather") {
+            const i64 axis = NormalizeAxis(GetIntAttribute(node, "axis", 0), input.Shape.size());
+            const TTensor& indices = *inputs[1];
+            result.DataType = input.DataType;
+            result.Shape.assign(input.Shape.begin(), input.Shape.begin() + axis);
+            result.Shape.insert(result.Shape.end(), indices.Shape.begin(), indices.Shape.end());
+            result.Shape.insert(result.Shape.end(), input.Shape.begin() + axis + 1, input.Shape.end());
+            if (isFloatInput) {
+                result.Floats = Gather(input.Floats, input.Shape, indices.Ints, axis);
+            } else if (input.DataType == onnx::TensorProto_DataType_STRING) {
+                result.Strings = Gather(input.Strings, input.Shape, indices.Ints, axis);
+            } else {
+                result.Ints = Gather(input.Ints, input.Shape, indices.Ints, axis);
+            }
+        } else if (opType == "Concat") {
+            const i64 axis = NormalizeAxis(GetIntAttribute(node, "axis", 0), input.Shape.size());
+            result.DataType = input.DataType;
+            result.Shape = input.Shape;
+            result.Shape[axis] = 0;
+            TVector<const TVector<float>*> floats;
+            TVector<const TVector<i64>*> ints;
+            TVector<const TVector<i64>*> shapes;
+            for (const auto* tensor : inputs) {
+                result.Shape[axis] += tensor->Shape[axis];
+                floats.push_back(&tensor->Floats);
+                ints.push_back(&tensor->Ints);
+                shapes.push_back(&tensor->Shape);
+            }
+            if (isFloatInput) {
+                Concat(floats, shapes, axis, &result.Floats);
+            } else {
+                Concat(ints, shapes, axis, &result.Ints);
+            }
+        } else if (opType == "Unsqueeze") {
+            result = input;
+            for (auto axis : GetIntsAttribute(node, "axes")) {
+                result.Shape.insert(result.Shape.begin() + axis, 1);
+            }
+        } else if (opType == "MatMul") {
+            // [..., innerSize] x [innerSize, columnCount] or [..., innerSize] x [innerSize]
+            const TTensor& rhs = *inputs[1];
+            CB_ENSURE(
+                input.Shape.size() >= 2 && (rhs.Shape.size() == 1 || (input.Shape.size() == 2 && rhs.Shape.size() == 2))
+                    && input.Shape.back() == rhs.Shape[0],
+                "Unsupported MatMul");
+            const i64 innerSize = input.Shape.back();
+            const i64 rowCount = GetSize(MakeArrayRef(input.Shape).Slice(0, input.Shape.size() - 1));
+            const i64 columnCount = rhs.Shape.size() == 2 ? rhs.Shape[1] : 1;
+            result.DataType = onnx::TensorProto_DataType_FLOAT;
+            result.Shape.assign(input.Shape.begin(), input.Shape.end() - 1);
+            if (rhs.Shape.size() == 2) {
+                result.Shape.push_back(columnCount);
+            }
+            result.Floats.assign(rowCount * columnCount, 0.0f);
+            for (auto row : xrange(rowCount)) {
+                float* resultRow = result.Floats.data() + row * columnCount;
+                for (auto k : xrange(innerSize)) {
+                    const float lhs = input.Floats[row * innerSize + k];
+                    if (lhs == 0.0f) {
+                        continue;
+                    }
+                    const float* rhsRow = rhs.Floats.data() + k * columnCount;
+                    for (auto column : xrange(columnCount)) {
+                        resultRow[column] += lhs * rhsRow[column];
+                    }
+                }
+            }
+        } else if (opType == "ReduceSum") {
+            const auto axes = GetIntsAttribute(node, "axes");
+            CB_ENSURE(axes.size() == 1, "Unsupported ReduceSum");
+            const i64 axis = NormalizeAxis(axes[0], input.Shape.size());
+            const size_t outerSize = GetSize(MakeArrayRef(input.Shape).Slice(0, axis));
+            const i64 axisSize = input.Shape[axis];
+            const size_t innerSize = GetSize(MakeArrayRef(input.Shape).Slice(axis + 1));
+            result.DataType = onnx::TensorProto_DataType_FLOAT;
+            result.Shape = input.Shape;
+            if (GetIntAttribute(node, "keepdims", 1)) {
+                result.Shape[axis] = 1;
+            } else {
+                result.Shape.erase(result.Shape.begin() + axis);
+            }
+            result.Floats.assign(outerSize * innerSize, 0.0f);
+            for (auto outerIdx : xrange(outerSize)) {
+                for (auto axisIdx : xrange(axisSize)) {
+                    const float* src = input.Floats.data() + (outerIdx * axisSize + axisIdx) * innerSize;
+                    float* dst = result.Floats.data() + outerIdx * innerSize;
+                    for (auto innerIdx : xrange(innerSize)) {
+                        dst[innerIdx] += src[innerIdx];
+                    }
+                }
+            }
+        } else if (opType == "LabelEncoder") {
+            const auto& map = LabelEncoderMaps[nodeIdx];
+            const auto* defaultValue = FindAttribute(node, "default_float");
+            result.DataType = onnx::TensorProto_DataType_FLOAT;
+            result.Shape = input.Shape;
+            for (auto key : input.Ints) {
+                const auto it = map.find(key);
+                result.Floats.push_back(it != map.end() ? it->second : (defaultValue ? defaultValue->f() : -0.0f));
+            }
+        } else if (opType == "Sigmoid") {
+            result = input;
+            for (auto& value : result.Floats) {
+                value = 1.0f / (1.0f + std::exp(-value));
+            }
+        } else if (opType == "Softmax" || opType == "ArgMax") {
+            CB_ENSURE(input.Shape.size() == 2 && GetIntAttribute(node, "axis", 1) == 1, "Unsupported " << opType);
+            const i64 rowCount = input.Shape[0];
+            const i64 columnCount = input.Shape[1];
+            if (opType == "Softmax") {
+                result = input;
+                for (auto row : xrange(rowCount)) {
+                    float* values = result.Floats.data() + row * columnCount;
+                    const float maxValue = *MaxElement(values, values + columnCount);
+                    float sum = 0;
+                    for (auto column : xrange(columnCount)) {
+                        values[column] = std::exp(values[column] - maxValue);
+                        sum += values[column];
+                    }
+                    for (auto column : xrange(columnCount)) {
+                        values[column] /= sum;
+                    }
+                }
+            } else {
+                result.DataType = onnx::TensorProto_DataType_INT64;
+                result.Shape = {rowCount};
+                for (auto row : xrange(rowCount)) {
+                    const float* values = input.Floats.data() + row * columnCount;
+                    result.Ints.push_back(MaxElement(values, values + columnCount) - values);
+                }
+            }
+        } else {
+            CB_ENSURE(false, "Operator " << opType << " is not supported");
+        }
+        (*values)[node.output(0)] = std::move(result);
+    }
+
+}
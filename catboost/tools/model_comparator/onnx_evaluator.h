@@ -0,0 +1,62 @@
+#pragma once
+
+#include <contrib/libs/onnx/proto/onnx_ml.pb.h>
+
+#include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/string.h>
+#include <util/generic/vector.h>
+#include <util/system/types.h>
+
+
+namespace NCB {
+
+    /*
+     * Reference evaluator of ONNX graphs exported by CatBoost in bit index trees encoding.
+     * Supports only operators used in such graphs, tensors are evaluated node by node
+     * for the whole batch of objects.
+     */
+    class TOnnxBitIndexEvaluator {
+    public:
+        struct TTensor {
+            int DataType = 0;
+            TVector<i64> Shape;
+            TVector<float> Floats; // FLOAT
+            TVector<i64> Ints; // INT64, BOOL
+            TVector<TString> Strings; // STRING
+        };
+
+    public:
+        explicit TOnnxBitIndexEvaluator(const onnx::ModelProto& model);
+
+        bool HasCatFeatures() const {
+            return HasCatFeaturesInput;
+        }
+
+        bool IsClassifier() const {
+            return OutputName == "probability_tensor";
+        }
+
+        /* features: [objectIdx * flatFeatureCount + flatFeatureIdx]
+         * catFeatures: [objectIdx * catFeatureCount + catFeatureIdx], hashes as CalcCatFeatureHashInt
+         * returns "predictions" for regressors, "probability_tensor" for classifiers: [objectIdx * dim + i]
+         */
+        TVector<float> Calc(
+            TConstArrayRef<float> features,
+            TConstArrayRef<i64> catFeatures,
+            size_t objectCount) const;
+
+    private:
+        void CalcNode(int nodeIdx, THashMap<TString, TTensor>* values) const;
+
+    private:
+        onnx::GraphProto Graph;
+        THashMap<TString, TTensor> Initializers;
+        i64 FlatFeatureCount = 0;
+        i64 CatFeatureCount = 0;
+        bool HasCatFeaturesInput = false;
+        TString OutputName;
+        TVector<THashMap<i64, float>> LabelEncoderMaps; // [nodeIdx]
+    };
+
+}
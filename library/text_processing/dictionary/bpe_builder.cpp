@@ -5,7 +5,10 @@
 #include <library/containers/dense_hash/dense_hash.h>
 #include <library/containers/heap_dict/heap_dict.h>
 
+#include <util/generic/algorithm.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/hash.h>
+#include <util/generic/xrange.h>
 
 using NTextProcessing::NDictionary::EEndOfWordTokenPolicy;
 using namespace NTextProcessing::NDictionary;
@@ -75,14 +78,52 @@ void TBpeDictionaryBuilder::Add(TConstArrayRef<TString> tokens, ui64 weight) {
     AddImpl(tokens, weight, SkipUnknown, *Alphabet, &Lines, &Counts);
 }
 
-THolder<TBpeDictionary> TBpeDictionaryBuilder::FinishBuilding() {
+void TBpeDictionaryBuilder::Add(
+    TConstArrayRef<TVector<TStringBuf>> tokenizedTexts,
+    NPar::TLocalExecutor* localExecutor,
+    ui64 weight
+) {
+    if (tokenizedTexts.empty()) {
+        return;
+    }
+    const auto blockParams = GetObjectBlockParams(tokenizedTexts.size(), localExecutor);
+    TVector<TVector<TVector<TTokenId>>> blockLines(blockParams.GetBlockCount());
+    TVector<TVector<ui64>> blockCounts(blockParams.GetBlockCount());
+    localExecutor->ExecRangeWithThrow(
+        [&] (int blockIdx) {
+            const auto bounds = GetObjectBlockBounds(blockParams, blockIdx);
+            for (int textIdx : xrange(bounds.first, bounds.second)) {
+                AddImpl(
+                    MakeConstArrayRef(tokenizedTexts[textIdx]),
+                    weight,
+                    SkipUnknown,
+                    *Alphabet,
+                    &blockLines[blockIdx],
+                    &blockCounts[blockIdx]
+                );
+            }
+        },
+        0,
+        blockParams.GetBlockCount(),
+        NPar::TLocalExecutor::WAIT_COMPLETE
+    );
+    for (auto blockIdx : xrange(blockParams.GetBlockCount())) {
+        for (auto& line : blockLines[blockIdx]) {
+            Lines.push_back(std::move(line));
+        }
+        Counts.insert(Counts.end(), blockCounts[blockIdx].begin(), blockCounts[blockIdx].end());
+    }
+}
+
+THolder<TBpeDictionary> TBpeDictionaryBuilder::FinishBuilding(NPar::TLocalExecutor* localExecutor) {
     Y_ENSURE(!IsBuildingFinish, "FinishBuilding method should be called only once.");
     IsBuildingFinish = true;
-    CalcMostFrequentUnits();
+    NPar::TLocalExecutor sequentialExecutor;
+    CalcMostFrequentUnits(localExecutor ? localExecutor : &sequentialExecutor);
     return new TBpeDictionary(std::move(Alphabet), std::move(ResultingBpeUnits));
 }
 
-void TBpeDictionaryBuilder::CalcMostFrequentUnits() {
+void TBpeDictionaryBuilder::CalcMostFrequentUnits(NPar::TLocalExecutor* localExecutor) {
     ResultingBpeUnits.clear();
 
     using TPair = std::pair<TTokenId, TTokenId>;
@@ -101,19 +142,56 @@ void TBpeDictionaryBuilder::CalcMostFrequentUnits() {
 
     Cerr << "Preparing stats..." << Endl;
     TPairStats pairStats;
-    for (size_t i = 0; i < Lines.size(); ++i) {
-        const auto& line = Lines[i];
-        ui64 count = Counts[i];
-        for (size_t j = 0; j + 1 < line.size(); ++j) {
-            TPair pair(line[j], line[j + 1]);
-            auto& stat = pairStats[pair];
-            stat.SmallerTokenId = Min(pair.first, pair.second);
-            stat.LargerTokenId = Max(pair.first, pair.second);
-            stat.Count += count;
-            stat.SrcStrIds.Insert(i);
+    {
+        // every shard owns pairs with the same hash remainder and scans all lines in order,
+        // pairs are put into the heap in sorted order to make ties independent of the shard count
+        const int shardCount = localExecutor->GetThreadCount() + 1;
+        TVector<THashMap<TPair, TPairStat>> shardPairStats(shardCount);
+        localExecutor->ExecRangeWithThrow(
+            [&] (int shardIdx) {
+                auto& stats = shardPairStats[shardIdx];
+                for (size_t i = 0; i < Lines.size(); ++i) {
+                    const auto& line = Lines[i];
+                    ui64 count = Counts[i];
+                    for (size_t j = 0; j + 1 < line.size(); ++j) {
+                        TPair pair(line[j], line[j + 1]);
+                        if (THash<TPair>()(pair) % shardCount != static_cast<size_t>(shardIdx)) {
+                            continue;
+                        }
+                        auto& stat = stats[pair];
+                        stat.SmallerTokenId = Min(pair.first, pair.second);
+                        stat.LargerTokenId = Max(pair.first, pair.second);
+                        stat.Count += count;
+                        stat.SrcStrIds.Insert(i);
+                    }
+                }
+            },
+            0,
+            shardCount,
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+        TVector<std::pair<TPair, TPairStat*>> sortedStats;
+        for (auto& stats : shardPairStats) {
+            for (auto& [pair, stat] : stats) {
+                sortedStats.emplace_back(pair, &stat);
+            }
+        }
+        Sort(sortedStats, [] (const auto& lhs, const auto& rhs) {
+            return lhs.first < rhs.first;
+        });
+        for (auto& [pair, stat] : sortedStats) {
+            pairStats[pair] = std::move(*stat);
         }
     }
 
+    // changes of pair counts caused by rewriting of a line, applied in the order they happened
+    struct TPairUpdate {
+        TPair Pair;
+        bool IsAdded;
+    };
+    TVector<ui32> srcStrIds;
+    TVector<TVector<TPairUpdate>> lineUpdates;
+
     TTokenId newTokenId = Alphabet->GetMinUnusedTokenId();
 
     Cerr << "Training..." << Endl;
@@ -129,48 +207,55 @@ void TBpeDictionaryBuilder::CalcMostFrequentUnits() {
         ui64 bestCount = best.second.Count;
         ResultingBpeUnits.emplace_back(TBpeDictionary::TBpeUnit{bestPair.first, bestPair.second, bestCount});
 
-        auto srcStrIds = best.second.SrcStrIds;
-        for (size_t strId : srcStrIds) {
-            auto& line = Lines[strId];
-            ui64 lineCount = Counts[strId];
+        srcStrIds.clear();
+        for (ui32 strId : best.second.SrcStrIds) {
+            srcStrIds.push_back(strId);
+        }
+        lineUpdates.resize(srcStrIds.size());
+        NPar::ParallelFor(*localExecutor, 0, srcStrIds.size(), [&] (int idx) {
+            auto& line = Lines[srcStrIds[idx]];
+            auto& updates = lineUpdates[idx];
+            updates.clear();
             for (size_t i = line.size() - 1; i >= 1;) {
                 TPair pair(line[i - 1], line[i]);
                 if (pair == bestPair) {
                     if (i - 1) {
-                        TPair left(line[i - 2], line[i - 1]);
-                        auto it = pairStats.find(left);
-                        it->second.Count -= lineCount;
-                        if (it->second.Count == 0) {
-                            pairStats.erase(it);
-                        }
+                        updates.push_back({TPair(line[i - 2], line[i - 1]), /*IsAdded*/false});
                     }
                     if (i + 1 < line.size()) {
-                        TPair right(line[i], line[i + 1]);
-                        auto it = pairStats.find(right);
-                        it->second.Count -= lineCount;
-                        if (it->second.Count == 0) {
-                            pairStats.erase(it);
-                        }
+                        updates.push_back({TPair(line[i], line[i + 1]), /*IsAdded*/false});
                     }
                     line[i - 1] = newTokenId;
                     line.erase(line.begin() + i);
                     if (i - 1) {
-                        TPair left(line[i - 2], line[i - 1]);
-                        auto& stat = pairStats[left];
-                        stat.Count += lineCount;
-                        stat.SrcStrIds.Insert(strId);
+                        updates.push_back({TPair(line[i - 2], line[i - 1]), /*IsAdded*/true});
                     }
                     if (i < line.size()) {
-                        TPair right(line[i - 1], line[i]);
-                        auto& stat = pairStats[right];
-                        stat.Count += lineCount;
-                        stat.SrcStrIds.Insert(strId);
+                        updates.push_back({TPair(line[i - 1], line[i]), /*IsAdded*/true});
                     }
                     i -= Min<ui64>(i, 2);
                 } else {
                     --i;
                 }
             }
+        });
+
+        for (size_t idx : xrange(srcStrIds.size())) {
+            const ui32 strId = srcStrIds[idx];
+            const ui64 lineCount = Counts[strId];
+            for (const auto& update : lineUpdates[idx]) {
+                if (update.IsAdded) {
+                    auto& stat = pairStats[update.Pair];
+                    stat.Count += lineCount;
+                    stat.SrcStrIds.Insert(strId);
+                } else {
+                    auto it = pairStats.find(update.Pair);
+                    it->second.Count -= lineCount;
+                    if (it->second.Count == 0) {
+                        pairStats.erase(it);
+                    }
+                }
+            }
         }
         pairStats.erase(bestPair);
     }
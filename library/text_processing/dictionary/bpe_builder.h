@@ -3,6 +3,8 @@
 #include "bpe_dictionary.h"
 #include "frequency_based_dictionary.h"
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/array_ref.h>
 #include <util/generic/fwd.h>
 
@@ -21,11 +23,17 @@ namespace NTextProcessing::NDictionary {
 
         void Add(TConstArrayRef<TString> tokens, ui64 weight = 1);
         void Add(TConstArrayRef<TStringBuf> tokens, ui64 weight = 1);
+        // texts are converted to lines of alphabet tokens concurrently, lines order is preserved
+        void Add(TConstArrayRef<TVector<TStringBuf>> tokenizedTexts, NPar::TLocalExecutor* localExecutor, ui64 weight = 1);
 
-        THolder<TBpeDictionary> FinishBuilding();
+        /*
+         * If localExecutor is not nullptr, pair statistics are collected and lines are rewritten
+         * by its threads. The result does not depend on the thread count.
+         * */
+        THolder<TBpeDictionary> FinishBuilding(NPar::TLocalExecutor* localExecutor = nullptr);
 
     private:
-        void CalcMostFrequentUnits();
+        void CalcMostFrequentUnits(NPar::TLocalExecutor* localExecutor);
 
         ui32 NumUnits;
         bool SkipUnknown;
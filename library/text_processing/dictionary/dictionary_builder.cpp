@@ -25,6 +25,7 @@ namespace NTextProcessing::NDictionary {
         }
         virtual void Add(TConstArrayRef<TString> tokens, ui64 weight) = 0;
         virtual void Add(TConstArrayRef<TStringBuf> tokens, ui64 weight) = 0;
+        virtual void Add(TConstArrayRef<TVector<TStringBuf>> tokenizedTexts, ui64 weight, NPar::TLocalExecutor* localExecutor) = 0;
         virtual THolder<TDictionary> FinishBuilding() = 0;
 
         virtual ~IDictionaryBuilderImpl() = default;
@@ -47,17 +48,19 @@ namespace NTextProcessing::NDictionary {
         }
 
         void Add(TConstArrayRef<TString> tokens, ui64 weight) override {
-            AddImpl(tokens, weight);
+            AddImpl(tokens, weight, &TokenToCount);
         }
 
         void Add(TConstArrayRef<TStringBuf> tokens, ui64 weight) override {
-            AddImpl(tokens, weight);
+            AddImpl(tokens, weight, &TokenToCount);
         }
 
+        void Add(TConstArrayRef<TVector<TStringBuf>> tokenizedTexts, ui64 weight, NPar::TLocalExecutor* localExecutor) override;
+
         THolder<TDictionary> FinishBuilding() override;
     private:
         template <typename TTokenType>
-        void AddImpl(TConstArrayRef<TTokenType> tokens, ui64 weight);
+        void AddImpl(TConstArrayRef<TTokenType> tokens, ui64 weight, NFH::TFlatHashMap<TString, ui64>* tokenToCount) const;
 
         NFH::TFlatHashMap<TString, ui64> TokenToCount;
 
@@ -80,17 +83,24 @@ namespace NTextProcessing::NDictionary {
         }
 
         void Add(TConstArrayRef<TString> tokens, ui64 weight) override {
-            AddImpl(tokens, weight);
+            AddImpl(tokens, weight, &TokenToInternalId, &InternalIdsToCount);
         }
 
         void Add(TConstArrayRef<TStringBuf> tokens, ui64 weight) override {
-            AddImpl(tokens, weight);
+            AddImpl(tokens, weight, &TokenToInternalId, &InternalIdsToCount);
         }
 
+        void Add(TConstArrayRef<TVector<TStringBuf>> tokenizedTexts, ui64 weight, NPar::TLocalExecutor* localExecutor) override;
+
         THolder<TDictionary> FinishBuilding() override;
     private:
-        template <typename TTokenType>
-        void AddImpl(TConstArrayRef<TTokenType> tokens, ui64 weight);
+        template <typename TTokenType, typename TTokenToInternalId>
+        void AddImpl(
+            TConstArrayRef<TTokenType> tokens,
+            ui64 weight,
+            TTokenToInternalId* tokenToInternalId,
+            TInternalIdsMap<GramOrder, ui64>* internalIdsToCount
+        ) const;
         void Filter();
         void FilterInternalIdToTokenMapping();
 
@@ -108,14 +118,18 @@ namespace NTextProcessing::NDictionary {
     // TUnigramDictionaryBuilderImpl
 
     template <typename TTokenType>
-    void TUnigramDictionaryBuilderImpl::AddImpl(TConstArrayRef<TTokenType> tokens, ui64 weight) {
+    void TUnigramDictionaryBuilderImpl::AddImpl(
+        TConstArrayRef<TTokenType> tokens,
+        ui64 weight,
+        NFH::TFlatHashMap<TString, ui64>* tokenToCount
+    ) const {
         if (DictionaryOptions.TokenLevelType == ETokenLevelType::Word) {
             for (const auto& token : tokens) {
-                TokenToCount[token] += weight;
+                (*tokenToCount)[token] += weight;
             }
         } else {
             auto updateTokenToCountFunc = [&] (TStringBuf token) {
-                TokenToCount[token] += weight;
+                (*tokenToCount)[token] += weight;
             };
             ApplyFuncToLetterNGrams(
                 tokens,
@@ -126,6 +140,40 @@ namespace NTextProcessing::NDictionary {
         }
     }
 
+    void TUnigramDictionaryBuilderImpl::Add(
+        TConstArrayRef<TVector<TStringBuf>> tokenizedTexts,
+        ui64 weight,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        if (tokenizedTexts.empty()) {
+            return;
+        }
+        const auto blockParams = GetObjectBlockParams(tokenizedTexts.size(), localExecutor);
+        TVector<NFH::TFlatHashMap<TString, ui64>> blockTokenToCount(blockParams.GetBlockCount());
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                const auto bounds = GetObjectBlockBounds(blockParams, blockIdx);
+                for (int textIdx : xrange(bounds.first, bounds.second)) {
+                    AddImpl(MakeConstArrayRef(tokenizedTexts[textIdx]), weight, &blockTokenToCount[blockIdx]);
+                }
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        for (auto& tokenToCount : blockTokenToCount) {
+            if (TokenToCount.empty()) {
+                TokenToCount = std::move(tokenToCount);
+                continue;
+            }
+            for (const auto& [token, count] : tokenToCount) {
+                TokenToCount[token] += count;
+            }
+            tokenToCount.clear();
+        }
+    }
+
     THolder<TDictionary> TUnigramDictionaryBuilderImpl::FinishBuilding() {
         Y_ENSURE(!IsBuildingFinish, "FinishBuilding method should be called only once.");
         IsBuildingFinish = true;
@@ -188,8 +236,13 @@ namespace NTextProcessing::NDictionary {
     }
 
     template <ui32 GramOrder>
-    template <typename TTokenType>
-    void TMultigramDictionaryBuilderImpl<GramOrder>::AddImpl(TConstArrayRef<TTokenType> rawTokens, ui64 weight) {
+    template <typename TTokenType, typename TTokenToInternalId>
+    void TMultigramDictionaryBuilderImpl<GramOrder>::AddImpl(
+        TConstArrayRef<TTokenType> rawTokens,
+        ui64 weight,
+        TTokenToInternalId* tokenToInternalId,
+        TInternalIdsMap<GramOrder, ui64>* internalIdsToCount
+    ) const {
         TVector<TTokenType> vectorWithEndOfSentence;
         auto tokens = AppendEndOfSentenceTokenIfNeed(
             rawTokens,
@@ -207,26 +260,73 @@ namespace NTextProcessing::NDictionary {
 
             for (ui32 gramIndex = 0; gramIndex < GramOrder; ++gramIndex) {
                 const auto& token = tokens[gramIndex];
-                key[gramIndex] = GetInternalWordTokenId(token, &TokenToInternalId);
+                key[gramIndex] = GetInternalWordTokenId(token, tokenToInternalId);
             }
-            InternalIdsToCount[key] += weight;
+            (*internalIdsToCount)[key] += weight;
 
             for (ui32 tokenIndex = GramOrder; tokenIndex < tokenCount; ++tokenIndex) {
-                ShiftAndAddId(GetInternalWordTokenId(tokens[tokenIndex], &TokenToInternalId), &key);
-                InternalIdsToCount[key] += weight;
+                ShiftAndAddId(GetInternalWordTokenId(tokens[tokenIndex], tokenToInternalId), &key);
+                (*internalIdsToCount)[key] += weight;
             }
         } else {
             const auto endTokenIndex = GetEndTokenIndex(tokenCount, GramOrder, skipStep);
             for (ui32 tokenIndex = 0; tokenIndex < endTokenIndex; ++tokenIndex) {
                 for (ui32 gramIndex = 0; gramIndex < GramOrder; ++gramIndex) {
                     const auto& token = tokens[tokenIndex + gramIndex * (skipStep + 1)];
-                    key[gramIndex] = GetInternalWordTokenId(token, &TokenToInternalId);
+                    key[gramIndex] = GetInternalWordTokenId(token, tokenToInternalId);
                 }
-                InternalIdsToCount[key] += weight;
+                (*internalIdsToCount)[key] += weight;
             }
         }
     }
 
+    template <ui32 GramOrder>
+    void TMultigramDictionaryBuilderImpl<GramOrder>::Add(
+        TConstArrayRef<TVector<TStringBuf>> tokenizedTexts,
+        ui64 weight,
+        NPar::TLocalExecutor* localExecutor
+    ) {
+        if (tokenizedTexts.empty()) {
+            return;
+        }
+        // every block numbers its tokens independently, tokens are views into tokenizedTexts
+        const auto blockParams = GetObjectBlockParams(tokenizedTexts.size(), localExecutor);
+        TVector<NFH::TFlatHashMap<TStringBuf, TInternalTokenId>> blockTokenToInternalId(blockParams.GetBlockCount());
+        TVector<TInternalIdsMap<GramOrder, ui64>> blockInternalIdsToCount(blockParams.GetBlockCount());
+        localExecutor->ExecRangeWithThrow(
+            [&] (int blockIdx) {
+                const auto bounds = GetObjectBlockBounds(blockParams, blockIdx);
+                for (int textIdx : xrange(bounds.first, bounds.second)) {
+                    AddImpl(
+                        MakeConstArrayRef(tokenizedTexts[textIdx]),
+                        weight,
+                        &blockTokenToInternalId[blockIdx],
+                        &blockInternalIdsToCount[blockIdx]
+                    );
+                }
+            },
+            0,
+            blockParams.GetBlockCount(),
+            NPar::TLocalExecutor::WAIT_COMPLETE
+        );
+
+        for (auto blockIdx : xrange(blockParams.GetBlockCount())) {
+            const auto& tokenToInternalId = blockTokenToInternalId[blockIdx];
+            TVector<TInternalTokenId> blockIdToInternalId(tokenToInternalId.size());
+            for (const auto& [token, blockId] : tokenToInternalId) {
+                blockIdToInternalId[blockId] = GetInternalWordTokenId(token, &TokenToInternalId);
+            }
+            TMultiInternalTokenId<GramOrder> key;
+            for (const auto& [blockKey, count] : blockInternalIdsToCount[blockIdx]) {
+                for (ui32 gramIndex = 0; gramIndex < GramOrder; ++gramIndex) {
+                    key[gramIndex] = blockIdToInternalId[blockKey[gramIndex]];
+                }
+                InternalIdsToCount[key] += count;
+            }
+            blockInternalIdsToCount[blockIdx].clear();
+        }
+    }
+
     template <ui32 GramOrder>
     static bool CompareNGram(
         const TMultiInternalTokenId<GramOrder>& leftNGram,
@@ -383,6 +483,14 @@ namespace NTextProcessing::NDictionary {
         DictionaryBuilderImpl->Add(tokens, weight);
     }
 
+    void TDictionaryBuilder::Add(
+        TConstArrayRef<TVector<TStringBuf>> tokenizedTexts,
+        NPar::TLocalExecutor* localExecutor,
+        ui64 weight
+    ) {
+        DictionaryBuilderImpl->Add(tokenizedTexts, weight, localExecutor);
+    }
+
     THolder<TDictionary> TDictionaryBuilder::FinishBuilding() {
         return DictionaryBuilderImpl->FinishBuilding();
     }
@@ -3,6 +3,8 @@
 #include "frequency_based_dictionary.h"
 #include "options.h"
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/generic/array_ref.h>
 
 namespace NTextProcessing::NDictionary {
@@ -36,6 +38,17 @@ namespace NTextProcessing::NDictionary {
         void Add(TConstArrayRef<TString> tokens, ui64 weight = 1);
         void Add(TConstArrayRef<TStringBuf> tokens, ui64 weight = 1);
 
+        /*
+         * This method is intended for adding many token sequences at once.
+         * Sequences are split into blocks counted concurrently by localExecutor threads
+         * into per-block maps, the maps are merged afterwards.
+         * The result does not depend on the thread count.
+         * Example:
+         *      TVector<TVector<TStringBuf>> sentences = {{"he", "likes", "apples"}, {"she", "does", "not"}};
+         *      dictionaryBuilder.Add(sentences, &localExecutor);
+         * */
+        void Add(TConstArrayRef<TVector<TStringBuf>> tokenizedTexts, NPar::TLocalExecutor* localExecutor, ui64 weight = 1);
+
         THolder<TDictionary> FinishBuilding();
 
     private:
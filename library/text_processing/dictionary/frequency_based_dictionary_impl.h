@@ -34,10 +34,10 @@ namespace NTextProcessing::NDictionary {
     template <ui32 GramOrder, typename TValue>
     using TInternalIdsMap = NFH::TFlatHashMap<TMultiInternalTokenId<GramOrder>, TValue>;
 
-    template <typename TTokenType>
+    template <typename TTokenType, typename TTokenToInternalId>
     TInternalTokenId GetInternalWordTokenId(
         const TTokenType& token,
-        NFH::TFlatHashMap<TString, TInternalTokenId>* tokenToInternalId
+        TTokenToInternalId* tokenToInternalId
     ) {
         const auto it = tokenToInternalId->find(token);
         if (it != tokenToInternalId->end()) {
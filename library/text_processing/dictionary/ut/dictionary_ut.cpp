@@ -1,8 +1,14 @@
+#include <library/text_processing/dictionary/bpe_builder.h>
 #include <library/text_processing/dictionary/dictionary_builder.h>
 
 #include <library/threading/local_executor/local_executor.h>
 #include <library/unittest/registar.h>
 
+#include <util/random/fast.h>
+#include <util/stream/str.h>
+#include <util/string/cast.h>
+#include <util/string/iterator.h>
+
 using NTextProcessing::NDictionary::IDictionary;
 using NTextProcessing::NDictionary::TDictionaryOptions;
 using NTextProcessing::NDictionary::TDictionaryBuilderOptions;
@@ -10,6 +16,35 @@ using NTextProcessing::NDictionary::TDictionaryBuilder;
 using NTextProcessing::NDictionary::ETokenLevelType;
 using NTextProcessing::NDictionary::TTokenId;
 using NTextProcessing::NDictionary::EUnknownTokenPolicy;
+using NTextProcessing::NDictionary::TBpeDictionaryBuilder;
+
+static TVector<TString> GenerateTexts(ui32 textCount, ui32 vocabularySize, TFastRng<ui64>* prng) {
+    TVector<TString> texts;
+    for (ui32 textIdx = 0; textIdx < textCount; ++textIdx) {
+        TString text;
+        const ui32 tokenCount = 1 + prng->Uniform(20);
+        for (ui32 tokenIdx = 0; tokenIdx < tokenCount; ++tokenIdx) {
+            text += (tokenIdx ? " " : "") + ToString(prng->Uniform(vocabularySize));
+        }
+        texts.push_back(text);
+    }
+    return texts;
+}
+
+static TVector<TVector<TStringBuf>> SplitTexts(const TVector<TString>& texts) {
+    TVector<TVector<TStringBuf>> tokenizedTexts;
+    for (const auto& text : texts) {
+        StringSplitter(text).Split(' ').Collect(&tokenizedTexts.emplace_back());
+    }
+    return tokenizedTexts;
+}
+
+template <typename TDictionaryHolder>
+static TString SaveToString(const TDictionaryHolder& dictionary) {
+    TStringStream stream;
+    dictionary->Save(&stream);
+    return stream.Str();
+}
 
 Y_UNIT_TEST_SUITE(DictionaryTests) {
 
@@ -287,4 +322,68 @@ Y_UNIT_TEST_SUITE(DictionaryTests) {
 
     }
 
+    Y_UNIT_TEST(DictionaryParallelBuildingTest) {
+
+        TFastRng<ui64> prng(0);
+        const auto texts = GenerateTexts(/*textCount*/ 1000, /*vocabularySize*/ 100, &prng);
+        const auto tokenizedTexts = SplitTexts(texts);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        for (auto [gramOrder, tokenLevelType] : {
+            std::make_pair(1, ETokenLevelType::Word),
+            std::make_pair(2, ETokenLevelType::Word),
+            std::make_pair(3, ETokenLevelType::Letter)
+        }) {
+            TDictionaryOptions dictionaryOptions;
+            dictionaryOptions.GramOrder = gramOrder;
+            dictionaryOptions.TokenLevelType = tokenLevelType;
+            TDictionaryBuilderOptions dictionaryBuilderOptions;
+            dictionaryBuilderOptions.OccurrenceLowerBound = 2;
+
+            TDictionaryBuilder sequentialBuilder(dictionaryBuilderOptions, dictionaryOptions);
+            for (const auto& tokens : tokenizedTexts) {
+                sequentialBuilder.Add(tokens);
+            }
+            TDictionaryBuilder parallelBuilder(dictionaryBuilderOptions, dictionaryOptions);
+            parallelBuilder.Add(tokenizedTexts, &localExecutor);
+
+            UNIT_ASSERT_VALUES_EQUAL(
+                SaveToString(sequentialBuilder.FinishBuilding()),
+                SaveToString(parallelBuilder.FinishBuilding()));
+        }
+    }
+
+    Y_UNIT_TEST(BpeParallelBuildingTest) {
+
+        TFastRng<ui64> prng(0);
+        const auto texts = GenerateTexts(/*textCount*/ 1000, /*vocabularySize*/ 20, &prng);
+        const auto tokenizedTexts = SplitTexts(texts);
+
+        NPar::TLocalExecutor localExecutor;
+        localExecutor.RunAdditionalThreads(3);
+
+        auto buildAlphabet = [&] () {
+            TDictionaryOptions dictionaryOptions;
+            dictionaryOptions.GramOrder = 1;
+            dictionaryOptions.TokenLevelType = ETokenLevelType::Word;
+            TDictionaryBuilderOptions dictionaryBuilderOptions;
+            dictionaryBuilderOptions.OccurrenceLowerBound = 0;
+            TDictionaryBuilder builder(dictionaryBuilderOptions, dictionaryOptions);
+            builder.Add(tokenizedTexts, &localExecutor);
+            return builder.FinishBuilding();
+        };
+
+        TBpeDictionaryBuilder sequentialBuilder(/*numUnits*/ 50, /*skipUnknown*/ false, buildAlphabet());
+        for (const auto& tokens : tokenizedTexts) {
+            sequentialBuilder.Add(tokens);
+        }
+        TBpeDictionaryBuilder parallelBuilder(/*numUnits*/ 50, /*skipUnknown*/ false, buildAlphabet());
+        parallelBuilder.Add(tokenizedTexts, &localExecutor);
+
+        UNIT_ASSERT_VALUES_EQUAL(
+            SaveToString(sequentialBuilder.FinishBuilding()),
+            SaveToString(parallelBuilder.FinishBuilding(&localExecutor)));
+    }
 }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <library/threading/local_executor/local_executor.h>
+
 #include <util/charset/utf8.h>
 #include <util/generic/array_ref.h>
+#include <util/generic/cast.h>
 #include <util/generic/deque.h>
 #include <util/generic/string.h>
 #include <util/generic/vector.h>
@@ -15,6 +18,19 @@ namespace NTextProcessing::NDictionary {
         return maxDictionarySize == -1 ? Max<ui32>() : maxDictionarySize;
     }
 
+    // One block of objects per thread of localExecutor (including the caller), objectCount should be positive.
+    inline NPar::TLocalExecutor::TExecRangeParams GetObjectBlockParams(size_t objectCount, NPar::TLocalExecutor* localExecutor) {
+        Y_ENSURE(objectCount > 0, "Object count should be positive.");
+        NPar::TLocalExecutor::TExecRangeParams blockParams(0, SafeIntegerCast<int>(objectCount));
+        blockParams.SetBlockCount(localExecutor->GetThreadCount() + 1);
+        return blockParams;
+    }
+
+    inline std::pair<int, int> GetObjectBlockBounds(const NPar::TLocalExecutor::TExecRangeParams& blockParams, int blockIdx) {
+        const int begin = blockParams.FirstId + blockIdx * blockParams.GetBlockSize();
+        return {begin, Min(begin + blockParams.GetBlockSize(), blockParams.LastId)};
+    }
+
     template <typename TTokenType>
     static void GetLetterIndices(const TTokenType& token, TVector<ui32>* letterStartIndices) {
         letterStartIndices->clear();